@@ -36,6 +36,8 @@
 
 #include <OpenMS/ANALYSIS/ID/ConsensusIDAlgorithm.h>
 
+#include <memory>
+
 namespace OpenMS
 {
   /**
@@ -47,6 +49,8 @@ namespace OpenMS
 
     Derived classes should implement getSimilarity_(), which defines how similarity of two peptide sequences is quantified.
 
+    Computed similarities are cached. Several instances of the same algorithm (e.g. one per thread) can share their cache via shareSimilarityCache().
+
     @htmlinclude OpenMS_ConsensusIDAlgorithmSimilarity.parameters
     
     @ingroup Analysis_ID
@@ -54,20 +58,40 @@ namespace OpenMS
   class OPENMS_DLLAPI ConsensusIDAlgorithmSimilarity :
     public ConsensusIDAlgorithm
   {
+  public:
+    /**
+       @brief Use the same cache of sequence similarities as @p other
+
+       Access to the cache is thread-safe, so the two instances can be applied in different threads.
+       The cache is only valid for one algorithm and parameter set, so a parameter change afterwards starts a new cache.
+
+       @throw Exception::IllegalArgument if the algorithms or their parameters differ
+    */
+    void shareSimilarityCache(const ConsensusIDAlgorithmSimilarity& other);
+
   protected:
     /// Default constructor
     ConsensusIDAlgorithmSimilarity();
 
-    /// Mapping: pair of peptide sequences -> sequence similarity
-    typedef std::map<std::pair<AASequence, AASequence>, double> SimilarityCache;
+    /// Mapping: pair of peptide sequences -> sequence similarity (split into shards with one lock each, see .cpp)
+    class SimilarityCache;
+
+    /// Cache for already computed sequence similarities (possibly shared with other instances)
+    std::shared_ptr<SimilarityCache> similarities_;
+
+    /// Look up the similarity of a pair of sequences in the cache (thread-safe)
+    bool getCachedSimilarity_(const std::pair<AASequence, AASequence>& seq_pair, double& similarity) const;
+
+    /// Store the similarity of a pair of sequences in the cache (thread-safe)
+    void setCachedSimilarity_(const std::pair<AASequence, AASequence>& seq_pair, double similarity);
 
-    /// Cache for already computed sequence similarities
-    SimilarityCache similarities_;
+    /// Start a new, empty cache (e.g. after parameter changes)
+    void resetSimilarityCache_();
 
     /**
        @brief Sequence similarity calculation (to be implemented by subclasses).
 
-       Implementations should use/update the cache of previously computed similarities.
+       Implementations should use/update the cache of previously computed similarities (see getCachedSimilarity_() and setCachedSimilarity_()) and must be thread-safe.
 
        @return Similarity between two sequences in the range [0, 1]
     */
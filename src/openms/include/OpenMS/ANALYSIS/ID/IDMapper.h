@@ -256,6 +256,20 @@ protected:
     /// check if distance constraint is fulfilled (using @p rt_tolerance_, @p mz_tolerance_ and @p measure_)
     bool isMatch_(const double rt_distance, const double mz_theoretical, const double mz_observed) const;
 
+    /// position of a consensus feature (or of one of its sub-features), used to look up matches by m/z
+    struct IndexedPosition_
+    {
+      double mz;
+      double rt;
+      Int charge;
+      Size cm_index; ///< index of the consensus feature in the map
+      Size handle_index; ///< position of the sub-feature in the consensus feature (0 for centroids)
+    };
+
+    /// collect all of the m/z-sorted @p positions that match @p rt, @p mz and one of @p charges (see isMatch_)
+    void findMatches_(const std::vector<IndexedPosition_>& positions, const double rt, const double mz,
+                      const IntList& charges, std::vector<const IndexedPosition_*>& matches) const;
+
     /// helper function that checks if all peptide hits are annotated with RT and MZ meta values
     void checkHits_(const std::vector<PeptideIdentification>& ids) const;
 
@@ -543,9 +543,9 @@ public:
 
         for (std::vector<PeptideHit>::iterator it2 = hits.begin(); it2 != hits.end(); ++it2)
         {
-          // clear protein accessions
-          it2->setPeptideEvidences(std::vector<PeptideEvidence>());
-          
+          // protein accessions of this hit (replacing the old ones)
+          std::vector<PeptideEvidence> evidences;
+
           //
           // is this a decoy hit?
           //
@@ -560,7 +560,7 @@ public:
             prot_indices.insert(it_i->protein_index);
             const String& accession = protein_accessions[it_i->protein_index];
             PeptideEvidence pe(accession, it_i->position, it_i->position + (int)it2->getSequence().size() - 1, it_i->AABefore, it_i->AAAfter);
-            it2->addPeptideEvidence(pe);
+            evidences.push_back(pe);
 
             runidx_to_protidx[run_idx].insert(it_i->protein_index); // fill protein hits
 
@@ -573,6 +573,7 @@ public:
               matches_target = true;
             }
           }
+          it2->setPeptideEvidences(std::move(evidences));
 
           if (matches_decoy && matches_target)
           {
@@ -42,6 +42,7 @@
 
 namespace OpenMS
 {
+class ColumnarSpectrum;
 
 class OPENMS_DLLAPI SimpleSearchEngineAlgorithm :
   public DefaultParamHandler,
@@ -85,6 +86,9 @@ class OPENMS_DLLAPI SimpleSearchEngineAlgorithm :
       }
     };
 
+    /// Index of the theoretical fragments of a batch of candidate peptides (defined in the .cpp)
+    struct FragmentIndex_;
+
     /// @brief filter, deisotope, decharge spectra
     static void preprocessSpectra_(PeakMap& exp, double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm);
 
@@ -110,6 +114,22 @@ class OPENMS_DLLAPI SimpleSearchEngineAlgorithm :
       const String& enzyme,
       const String& database_name) const;
 
+    /**
+      @brief score all spectra against the candidates of a (batch) index
+
+      If the fragment index was built, candidates are preselected by the number of experimental peaks matching their
+      fragments in the index, otherwise all candidates with matching precursor mass are scored. For
+      @p fragment_index_min_shared_peaks_ = 1 the same hits are reported in both cases.
+      Each spectrum is scored by one thread, so its hits in @p annotated_hits are updated without locking.
+      @param precursor_masses per spectrum all precursor masses (incl. isotope corrections) it can be matched with
+    */
+    void scoreFragmentIndex_(const FragmentIndex_& index,
+      const std::vector<ColumnarSpectrum>& spectra,
+      const std::vector<std::vector<double> >& precursor_masses,
+      bool precursor_mass_tolerance_unit_ppm,
+      bool fragment_mass_tolerance_unit_ppm,
+      std::vector<std::vector<AnnotatedHit_> >& annotated_hits) const;
+
     double precursor_mass_tolerance_;
     String precursor_mass_tolerance_unit_;
 
@@ -141,6 +161,10 @@ class OPENMS_DLLAPI SimpleSearchEngineAlgorithm :
     String peptide_motif_;
 
     Size report_top_hits_;
+
+    bool fragment_index_enabled_;
+    Size fragment_index_min_shared_peaks_;
+    Size fragment_index_protein_batch_size_;
 };
 
 } // namespace
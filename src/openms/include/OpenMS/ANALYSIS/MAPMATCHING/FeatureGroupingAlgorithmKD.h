@@ -231,14 +231,14 @@ private:
     template <typename MapType>
     void group_(const std::vector<MapType>& input_maps, ConsensusMap& out);
 
-    /// Run the actual clustering algorithm
-    void runClustering_(const KDTreeFeatureMaps& kd_data, ConsensusMap& out);
+    /// Run the actual clustering algorithm (@p feature_distance is not shared between threads, as its evaluation may modify it)
+    void runClustering_(const KDTreeFeatureMaps& kd_data, FeatureDistance& feature_distance, ConsensusMap& out) const;
 
     /// Update maximum possible sizes of potential consensus features for indices specified in @p update_these
-    void updateClusterProxies_(std::set<ClusterProxyKD>& potential_clusters, std::vector<ClusterProxyKD>& cluster_for_idx, const std::set<Size>& update_these, const std::vector<Int>& assigned, const KDTreeFeatureMaps& kd_data);
+    void updateClusterProxies_(std::set<ClusterProxyKD>& potential_clusters, std::vector<ClusterProxyKD>& cluster_for_idx, const std::set<Size>& update_these, const std::vector<Int>& assigned, const KDTreeFeatureMaps& kd_data, FeatureDistance& feature_distance) const;
 
     /// Compute the current best cluster with center index @p i (mutates @p proxy and @p cf_indices)
-    ClusterProxyKD computeBestClusterForCenter_(Size i, std::vector<Size>& cf_indices, const std::vector<Int>& assigned, const KDTreeFeatureMaps& kd_data) const;
+    ClusterProxyKD computeBestClusterForCenter_(Size i, std::vector<Size>& cf_indices, const std::vector<Int>& assigned, const KDTreeFeatureMaps& kd_data, FeatureDistance& feature_distance) const;
 
     /// Construct consensus feature and add to out map
     void addConsensusFeature_(const std::vector<Size>& indices, const KDTreeFeatureMaps& kd_data, ConsensusMap& out) const;
@@ -98,6 +98,12 @@ public:
      * @param ppm Whether mz_extraction_window is in ppm or in Th
      * @param filter Which function to apply in m/z space (currently "tophat" only)
      *
+     * The coordinates are indexed by their RT windows, so that each spectrum
+     * only visits the coordinates whose window contains its retention time.
+     * With OpenMP, spectra are extracted in parallel (using one lightClone()
+     * of @p input per thread); the output is identical to a sequential
+     * extraction.
+     *
     */
     void extractChromatograms(const OpenSwath::SpectrumAccessPtr input,
         std::vector< OpenSwath::ChromatogramPtr >& output,
@@ -182,6 +188,9 @@ public:
 
 private:
 
+    /// Index of extraction coordinates by their RT windows (see extractChromatograms())
+    class RTIndex_;
+
     int getFilterNr_(const String& filter);
 
   };
@@ -58,7 +58,8 @@ namespace OpenMS
     @note This implementation is @a not thread-safe since it keeps internally a
     single file access pointer which it moves when accessing a specific
     data item. The caller is responsible to ensure that access is performed
-    atomically.
+    atomically. SpectrumAccessOpenMSCachedMapped provides a thread-safe
+    alternative based on a memory-mapped file.
 
   */
   class OPENMS_DLLAPI SpectrumAccessOpenMSCached :
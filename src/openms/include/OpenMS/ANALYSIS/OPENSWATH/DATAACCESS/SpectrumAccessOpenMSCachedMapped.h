@@ -0,0 +1,146 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <OpenMS/FORMAT/HANDLERS/CachedMzMLMappedReader.h>
+
+#include <OpenMS/OPENSWATHALGO/DATAACCESS/ISpectrumAccess.h>
+
+#include <boost/shared_ptr.hpp>
+
+namespace OpenMS
+{
+
+  /**
+    @brief An implementation of the Spectrum Access interface using a memory-mapped cache file
+
+    This class implements the OpenSWATH Spectrum Access interface
+    (ISpectrumAccess) on top of a cached mzML file (see CachedmzML), mapping
+    the binary data into memory instead of reading it through a file stream.
+    Opening a file only builds the offset index, data is paged in by the
+    operating system when a spectrum or chromatogram is accessed.
+
+    In contrast to SpectrumAccessOpenMSCached, this implementation is
+    thread-safe: the mapped file and the meta data are immutable and shared
+    between all light clones, so lightClone() does not copy any data and
+    multiple threads may access the same object concurrently.
+
+    getSpectrumViewById() and getChromatogramViewById() provide zero-copy
+    access to the mapped data, while getSpectrumById() and
+    getChromatogramById() copy the data into the OpenSwath data structures
+    required by the interface.
+  */
+  class OPENMS_DLLAPI SpectrumAccessOpenMSCachedMapped :
+    public OpenSwath::ISpectrumAccess
+  {
+
+public:
+    typedef OpenMS::PeakMap MSExperimentType;
+    typedef Internal::CachedMzMLMappedReader::RecordView RecordView;
+
+    /**
+      @brief Constructor, maps the cached file and loads the meta data
+
+      @param filename The filename of the .mzML file (it is assumed a second
+      file .mzML.cached exists).
+
+      @throws Exception::FileNotFound is thrown if the file is not found
+      @throws Exception::ParseError is thrown if the file cannot be parsed
+    */
+    explicit SpectrumAccessOpenMSCachedMapped(const String& filename);
+
+    /**
+      @brief Destructor
+    */
+    ~SpectrumAccessOpenMSCachedMapped() override;
+
+    /// Copy constructor (shares the mapped file and the meta data)
+    SpectrumAccessOpenMSCachedMapped(const SpectrumAccessOpenMSCachedMapped& rhs);
+
+    /// Light clone operator (actual data will not get copied)
+    boost::shared_ptr<OpenSwath::ISpectrumAccess> lightClone() const override;
+
+    OpenSwath::SpectrumPtr getSpectrumById(int id) override;
+
+    OpenSwath::SpectrumMeta getSpectrumMetaById(int id) const override;
+
+    std::vector<std::size_t> getSpectraByRT(double RT, double deltaRT) const override;
+
+    size_t getNrSpectra() const override;
+
+    SpectrumSettings getSpectraMetaInfo(int id) const;
+
+    OpenSwath::ChromatogramPtr getChromatogramById(int id) override;
+
+    size_t getNrChromatograms() const override;
+
+    ChromatogramSettings getChromatogramMetaInfo(int id) const;
+
+    std::string getChromatogramNativeID(int id) const override;
+
+    /**
+      @brief Zero-copy access to a spectrum
+
+      Fills @p view with views into the mapped file, which stay valid as long
+      as this object (or one of its clones) is alive.
+    */
+    void getSpectrumViewById(int id, RecordView& view) const;
+
+    /**
+      @brief Zero-copy access to a chromatogram
+
+      Fills @p view with views into the mapped file, which stay valid as long
+      as this object (or one of its clones) is alive.
+    */
+    void getChromatogramViewById(int id, RecordView& view) const;
+
+    /// Meta data of all spectra and chromatograms (without peak data)
+    const MSExperimentType& getMetaData() const;
+
+protected:
+
+    /// The mapped cache file (shared between all clones)
+    boost::shared_ptr<const Internal::CachedMzMLMappedReader> reader_;
+
+    /// Meta data (shared between all clones)
+    boost::shared_ptr<const MSExperimentType> meta_ms_experiment_;
+  };
+
+} //end namespace
+
@@ -8,6 +8,7 @@ MRMFeatureAccessOpenMS.h
 SimpleOpenMSSpectraAccessFactory.h
 SpectrumAccessOpenMS.h
 SpectrumAccessOpenMSCached.h
+SpectrumAccessOpenMSCachedMapped.h
 SpectrumAccessOpenMSInMemory.h
 SpectrumAccessSqMass.h
 SpectrumAccessTransforming.h
@@ -133,6 +133,9 @@ private:
       bool followUpValid(const double rt);
     };
 
+    /// A selected quantification spectrum together with its extracted reporter signals (see extractChannels()).
+    struct QuantSpectrum_;
+
     /// The used quantitation method (itraq4plex, tmt6plex,..).
     const IsobaricQuantitationMethod* quant_method_;
 
@@ -191,6 +194,16 @@ private:
     */
     double computePrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PuritySate_& pState) const;
 
+    /**
+      @brief Computes precursor purity and reporter ion signals of a selected quantification spectrum.
+
+      Only reads from @p ms_exp_data and writes to @p qs, so it can be called for several spectra in parallel.
+
+      @param qs The spectrum to process; receives the results.
+      @param ms_exp_data The experiment containing the spectrum.
+    */
+    void processQuantSpectrum_(QuantSpectrum_& qs, const PeakMap& ms_exp_data) const;
+
     /**
       @brief Computes the purity of the precursor given an iterator pointing to the MS/MS spectrum and a reference to the potential precursor spectrum.
 
@@ -222,6 +235,9 @@ protected:
 
     /// implemented for DefaultParamHandler
     void updateMembers_() override;
+
+    /// Number of quantification spectra whose reporter signals are computed in parallel before they are added to the output map.
+    Size block_size_;
   };
 } // namespace
 
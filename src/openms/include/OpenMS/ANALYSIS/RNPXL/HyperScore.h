@@ -35,6 +35,7 @@
 #pragma once
 
 #include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/KERNEL/ColumnarSpectrum.h>
 #include <OpenMS/CONCEPT/Types.h>
 #include <OpenMS/CONCEPT/Macros.h>
 #include <vector>
@@ -63,9 +64,37 @@ struct OPENMS_DLLAPI HyperScore
 
   static double compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const PeakSpectrum& exp_spectrum, const PeakSpectrum& theo_spectrum);
 
+  /** @brief compute the (ln transformed) X!Tandem HyperScore on an experimental spectrum in columnar layout
+
+      Produces the same result as the overload above (the same closest-peak matching as MatchedIterator is used),
+      but performs the peak matching directly on the contiguous m/z and intensity columns of @p exp_spectrum.
+      Useful if the same experimental spectrum is scored against many candidates.
+   */
+  static double compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const ColumnarSpectrum& exp_spectrum, const PeakSpectrum& theo_spectrum);
+
+  /** @brief compute the (ln transformed) X!Tandem HyperScore for a theoretical spectrum given as plain arrays
+
+      Same as the overload above, for callers that keep theoretical fragments in their own (e.g. indexed) storage.
+      @param theo_mz fragment m/z values (sorted ascending)
+      @param theo_intensity fragment intensities
+      @param theo_ion_types fragment ion types as returned by getIonType()
+      @param theo_size number of fragments
+   */
+  static double compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const ColumnarSpectrum& exp_spectrum,
+    const double* theo_mz, const float* theo_intensity, const char* theo_ion_types, Size theo_size);
+
+  /// @brief ion type of a fragment annotation (as generated by TheoreticalSpectrumGenerator) as counted by the HyperScore: 'y', 'b' or 0 for any other ion
+  static char getIonType(const String& ion_name);
+
   private:
     /// helper to compute the log factorial
     static double logfactorial_(const int x, int base = 2);
+
+    /// helper to count matching y- and b-ions based on the ion type
+    static void countIon_(char ion_type, int& y_ion_count, int& b_ion_count);
+
+    /// helper to compute the HyperScore from the dot product and ion counts
+    static double score_(double dot_product, int y_ion_count, int b_ion_count);
 };
 
 }
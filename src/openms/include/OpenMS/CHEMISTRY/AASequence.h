@@ -508,6 +508,26 @@ protected:
     /// supplementing/deduction of the sequence to its ionic form.
     double getMonoWeight(Residue::ResidueType type = Residue::Full, Int charge = 0) const;
 
+    /**
+      @brief Returns the mono isotopic weights of all prefixes of the peptide
+
+      Entry i equals getPrefix(i + 1).getMonoWeight(@p type, @p charge), e.g.
+      the weights of the b-ion series for Residue::BIon. All weights are
+      computed in one pass over the sequence instead of one pass per prefix.
+
+      @exception Exception::InvalidValue is thrown if the sequence contains the unknown residue 'X'
+    */
+    std::vector<double> getPrefixMonoWeights(Residue::ResidueType type = Residue::Full, Int charge = 0) const;
+
+    /**
+      @brief Returns the average weights of all prefixes of the peptide
+
+      Entry i equals getPrefix(i + 1).getAverageWeight(@p type, @p charge).
+
+      @exception Exception::InvalidValue is thrown if the sequence contains the unknown residue 'X'
+    */
+    std::vector<double> getPrefixAverageWeights(Residue::ResidueType type = Residue::Full, Int charge = 0) const;
+
     /// returns a pointer to the residue at given position
     const Residue& operator[](Size index) const;
 
@@ -38,6 +38,7 @@
 #include <OpenMS/DATASTRUCTURES/String.h>
 #include <OpenMS/CHEMISTRY/ResidueModification.h>
 
+#include <atomic>
 #include <set>
 #include <unordered_map>
 
@@ -89,6 +90,14 @@ public:
     /// Returns the number of modifications read from the unimod.xml file
     Size getNumberOfModifications() const;
 
+    /**
+       @brief Returns a counter that is incremented whenever modifications are added or changed
+
+       Unlike the other accessors, this does not lock the database, so it is cheap enough to validate caches of
+       results that depend on the known modifications (e.g. parsed sequences) on every access.
+    */
+    Size getGeneration() const;
+
     /**
        @brief Returns the modification with the given index.
        note: out-of-bounds check is only performed in debug mode.
@@ -204,6 +213,9 @@ protected:
     /// Stores the mappings of (unique) names to the modifications
     std::unordered_map<String, std::set<const ResidueModification*> > modification_names_;
 
+    /// Incremented (while holding the lock) on every change of @p mods_ or @p modification_names_
+    std::atomic<Size> generation_;
+
     /** @brief Helper function to check if a residue matches the origin for a modification
      *
      * Special cases are handled as follows:
@@ -43,6 +43,8 @@
 #include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <new>
+#include <vector>
 
 namespace OpenMS
 {
@@ -61,6 +63,11 @@ namespace OpenMS
     of OpenMS::DistanceMatrix::updateMinElement, see the respective methods
     documentation.
 
+    The elements below the main diagonal are stored row by row in a single
+    contiguous allocation, so creating, copying and scanning the matrix (e.g.
+    in OpenMS::DistanceMatrix::updateMinElement) works on one linear block of
+    memory. Large matrices are filled, copied and scanned in parallel.
+
     @ingroup Datastructures
   */
   template <typename Value>
@@ -95,38 +102,11 @@ public:
       @throw Exception::OutOfMemory if requested dimensionsize is to big to fit into memory
     */
     DistanceMatrix(SizeType dimensionsize, Value value = Value()) :
-      matrix_(new ValueType*[dimensionsize]), init_size_(dimensionsize), dimensionsize_(dimensionsize), min_element_(0, 0)
+      matrix_(nullptr), init_size_(0), dimensionsize_(0), min_element_(0, 0)
     {
-      matrix_[0] = NULL;
-      SizeType i = 1;
-      for (i = 1; i < dimensionsize; ++i)
-      {
-        matrix_[i] = new ValueType[i];
-        if (matrix_[i] == NULL)
-        {
-          SizeType j = i;
-          for (i = 1; i < j; i++)
-          {
-            delete[] matrix_[i];
-          }
-          delete[] matrix_;
-          matrix_ = NULL;
-          dimensionsize_ = 0;
-          init_size_ = 0;
-          throw Exception::OutOfMemory(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, (UInt)((((dimensionsize - 2) * (dimensionsize - 1)) / 2) * sizeof(ValueType)));
-        }
-      }
-      if (matrix_ != NULL)
-      {
-        for (i = 1; i < dimensionsize; ++i)
-        {
-          for (SizeType j = 0; j < i; ++j)
-          {
-            matrix_[i][j] = value;
-          }
-        }
-        min_element_ = std::make_pair(1, 0);
-      }
+      allocate_(dimensionsize);
+      fill_(value);
+      min_element_ = std::make_pair(1, 0);
     }
 
     /**
@@ -136,47 +116,16 @@ public:
       @throw Exception::OutOfMemory if requested dimensionsize is to big to fit into memory
     */
     DistanceMatrix(const DistanceMatrix& source) :
-      matrix_(new ValueType*[source.dimensionsize_]),
-      init_size_(source.dimensionsize_),
-      dimensionsize_(source.dimensionsize_),
-      min_element_(source.min_element_)
+      matrix_(nullptr), init_size_(0), dimensionsize_(0), min_element_(0, 0)
     {
-      matrix_[0] = NULL;
-      SizeType i = 1;
-      for (i = 1; i < dimensionsize_; ++i)
-      {
-        matrix_[i] = new ValueType[i];
-        if (matrix_[i] == NULL)
-        {
-          SizeType j = i;
-          for (i = 1; i < j; i++)
-          {
-            delete[] matrix_[i];
-          }
-          delete[] matrix_;
-          matrix_ = NULL;
-          dimensionsize_ = 0;
-          init_size_ = 0;
-          min_element_ = std::make_pair(0, 0);
-          throw Exception::OutOfMemory(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, (UInt)((((dimensionsize_ - 2) * (dimensionsize_ - 1)) / 2) * sizeof(ValueType)));
-        }
-      }
-      if (matrix_ != NULL)
-      {
-        for (i = 1; i < dimensionsize_; ++i)
-        {
-          std::copy(source.matrix_[i], source.matrix_[i] + i, matrix_[i]);
-        }
-      }
+      allocate_(source.dimensionsize_);
+      copy_(source.matrix_);
+      min_element_ = source.min_element_;
     }
 
     /// destructor
     ~DistanceMatrix()
     {
-      for (SizeType i = 1; i < init_size_; i++)
-      {
-        delete[] matrix_[i];
-      }
       delete[] matrix_;
     }
 
@@ -224,7 +173,7 @@ public:
       {
         std::swap(i, j);
       }
-      return (const ValueType)(matrix_[i][j]);
+      return (const ValueType)(at_(i, j));
     }
 
     /**
@@ -249,7 +198,7 @@ public:
       {
         std::swap(i, j);
       }
-      return matrix_[i][j];
+      return at_(i, j);
     }
 
     /**
@@ -275,21 +224,21 @@ public:
         }
         if (i != min_element_.first && j != min_element_.second)
         {
-          matrix_[i][j] = value;
-          if (value < matrix_[min_element_.first][min_element_.second]) // keep min_element_ up-to-date
+          at_(i, j) = value;
+          if (value < at_(min_element_.first, min_element_.second)) // keep min_element_ up-to-date
           {
             min_element_ = std::make_pair(i, j);
           }
         }
         else
         {
-          if (value <= matrix_[min_element_.first][min_element_.second])
+          if (value <= at_(min_element_.first, min_element_.second))
           {
-            matrix_[i][j] = value;
+            at_(i, j) = value;
           }
           else
           {
-            matrix_[i][j] = value;
+            at_(i, j) = value;
             updateMinElement();
           }
         }
@@ -319,17 +268,13 @@ public:
         {
           std::swap(i, j);
         }
-        matrix_[i][j] = value;
+        at_(i, j) = value;
       }
     }
 
     /// reset all
     void clear()
     {
-      for (SizeType i = 1; i < init_size_; i++)
-      {
-        delete[] matrix_[i];
-      }
       delete[] matrix_;
       matrix_ = nullptr;
       min_element_ = std::make_pair(0, 0);
@@ -348,42 +293,10 @@ public:
     */
     void resize(SizeType dimensionsize, Value value = Value())
     {
-      for (SizeType j = 1; j < init_size_; j++)
-      {
-        delete[] matrix_[j];
-      }
-      delete[] matrix_;
-      dimensionsize_ = dimensionsize;
-      init_size_ = dimensionsize;
       min_element_ = std::make_pair(0, 0);
-      matrix_ = new ValueType*[dimensionsize_];
-      for (SizeType j = 1; j < dimensionsize_; ++j)
-      {
-        matrix_[j] = new ValueType[j];
-        if (matrix_[j] == nullptr)
-        {
-          for (SizeType k = 1; k < j; ++k)
-          {
-            delete[] matrix_[k];
-          }
-          delete[] matrix_;
-          matrix_ = nullptr;
-          dimensionsize_ = 0;
-          init_size_ = 0;
-          throw Exception::OutOfMemory(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, (UInt)((((dimensionsize_ - 2) * (dimensionsize_ - 1)) / 2) * sizeof(Value)));
-        }
-      }
-      if (matrix_ != nullptr)
-      {
-        for (SizeType j = 0; j < dimensionsize; ++j)
-        {
-          for (SizeType k = 0; k < j; ++k)
-          {
-            matrix_[j][k] = value;
-          }
-        }
-        min_element_ = std::make_pair(1, 0);
-      }
+      allocate_(dimensionsize);
+      fill_(value);
+      min_element_ = std::make_pair(1, 0);
     }
 
     /**
@@ -400,17 +313,15 @@ public:
       {
         throw Exception::OutOfRange(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
       }
-      //delete row j and therefor overwrite with row j+1 and iterate like this to last row
-      SizeType i = j + 1;
-      while (i < dimensionsize_ && matrix_[i] != nullptr)
+      // rows before j are unaffected; every following row i moves up into the
+      // (smaller) slot of row i-1, leaving out its jth element. Targets always
+      // lie before their sources in the packed storage, so copying front to
+      // back in place is safe. The allocation itself is not shrunk.
+      for (SizeType i = j + 1; i < dimensionsize_; ++i)
       {
-        //left out in the copy is each rows jth element, pointer working here as iterators just fine
-        std::copy(matrix_[i] + j + 1, matrix_[i] + i, std::copy(matrix_[i], matrix_[i] + j, matrix_[i - 1]));
-        ++i;
+        ValueType* row = matrix_ + rowOffset_(i);
+        std::copy(row + j + 1, row + i, std::copy(row, row + j, matrix_ + rowOffset_(i - 1)));
       }
-      //last row is freed and the pointer set to NULL (outer array's size is not changed)
-      delete[] matrix_[i - 1];
-      matrix_[i - 1] = nullptr;
       --dimensionsize_;
     }
 
@@ -423,6 +334,10 @@ public:
     /**
       @brief keep track of the actual minimum element after altering the matrix
 
+      The stored elements are scanned in blocks (in parallel for large
+      matrices). Of several minimal elements the first one in row-major order
+      is reported.
+
       @throw Exception::OutOfRange thrown if there is no element to access
     */
     void updateMinElement()
@@ -433,17 +348,30 @@ public:
       {
         throw Exception::OutOfRange(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
       }
-      if (dimensionsize_ != 1) //else matrix has one element: (1,0)
+      if (dimensionsize_ > 2) //else matrix has at most one element: (1,0)
       {
-        ValueType* row_min_;
-        for (SizeType r = 2; r < dimensionsize_ && matrix_[r] != nullptr; ++r)
+        const SizeType n_elements = rowOffset_(dimensionsize_);
+        const SizeType block_size = 1 << 14;
+        const SizeType n_blocks = (n_elements + block_size - 1) / block_size;
+        std::vector<SizeType> block_min(n_blocks);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (n_blocks >= 8)
+#endif
+        for (SignedSize b = 0; b < (SignedSize)n_blocks; ++b)
+        {
+          const SizeType first = b * block_size;
+          block_min[b] = minIndex_(first, (std::min)(first + block_size, n_elements));
+        }
+        // blocks are compared in order, so ties are resolved as in a sequential scan
+        SizeType min_index = block_min[0];
+        for (SizeType b = 1; b < n_blocks; ++b)
         {
-          row_min_ = std::min_element(matrix_[r], matrix_[r] + r);
-          if (*row_min_ < matrix_[min_element_.first][min_element_.second])
+          if (matrix_[block_min[b]] < matrix_[min_index])
           {
-            min_element_ = std::make_pair(r, row_min_ - matrix_[r]);
+            min_index = block_min[b];
           }
         }
+        min_element_ = coordinates_(min_index);
       }
     }
 
@@ -455,17 +383,8 @@ public:
     bool operator==(DistanceMatrix<ValueType> const& rhs) const
     {
       OPENMS_PRECONDITION(dimensionsize_ == rhs.dimensionsize_, "DistanceMatrices have different sizes.");
-      for (Size i = 1; i < rhs.dimensionsize(); ++i)
-      {
-        for (Size j = 0; j < i; ++j)
-        {
-          if (matrix_[i][j] != rhs.matrix_[i][j])
-          {
-            return false;
-          }
-        }
-      }
-      return true;
+      const SizeType n_elements = rowOffset_(rhs.dimensionsize());
+      return std::equal(matrix_, matrix_ + n_elements, rhs.matrix_);
     }
 
     /**
@@ -483,15 +402,138 @@ public:
     }
 
 protected:
-    /// sparse element not to be included in base container
-    ValueType** matrix_;
-    /// number of actually stored rows
-    SizeType init_size_; // actual size of outer array
+    /**
+      @brief elements below the main diagonal, packed row by row into a single array
+
+      Row i (i > 0) holds the i elements (i,0) ... (i,i-1) and starts at
+      position rowOffset_(i).
+    */
+    ValueType* matrix_;
+    /// number of rows the storage was allocated for
+    SizeType init_size_;
     /// number of accessibly stored rows (i.e. number of columns)
     SizeType dimensionsize_; //number of virtual elements: ((dimensionsize-1)*(dimensionsize))/2
     /// index of minimal element(i.e. number in underlying SparseVector)
     std::pair<SizeType, SizeType> min_element_;
 
+    /// position of the first element of row @p i in matrix_ (also the number of elements in rows 0 to i-1)
+    static SizeType rowOffset_(SizeType i)
+    {
+      return i == 0 ? 0 : (i * (i - 1)) / 2;
+    }
+
+    /// element (i,j) with j < i
+    ValueType& at_(SizeType i, SizeType j)
+    {
+      return matrix_[rowOffset_(i) + j];
+    }
+
+    /// element (i,j) with j < i
+    const ValueType& at_(SizeType i, SizeType j) const
+    {
+      return matrix_[rowOffset_(i) + j];
+    }
+
+    /// row and column of the element at position @p index of matrix_
+    static std::pair<SizeType, SizeType> coordinates_(SizeType index)
+    {
+      SizeType i = (SizeType)((1.0 + std::sqrt(1.0 + 8.0 * (double)index)) / 2.0);
+      // correct for floating point inaccuracies
+      while (i > 1 && rowOffset_(i) > index) --i;
+      while (rowOffset_(i + 1) <= index) ++i;
+      return std::make_pair(i, index - rowOffset_(i));
+    }
+
+    /// position of the first minimal element of matrix_ in [@p first, @p last)
+    SizeType minIndex_(SizeType first, SizeType last) const
+    {
+      // branch-free minimum over independent lanes (vectorizable), then locate its first occurrence
+      const SizeType n_lanes = 8;
+      ValueType lane_min[n_lanes];
+      std::fill(lane_min, lane_min + n_lanes, matrix_[first]);
+      SizeType k = first;
+      for (; k + n_lanes <= last; k += n_lanes)
+      {
+        for (SizeType l = 0; l < n_lanes; ++l)
+        {
+          lane_min[l] = matrix_[k + l] < lane_min[l] ? matrix_[k + l] : lane_min[l];
+        }
+      }
+      ValueType min_value = *std::min_element(lane_min, lane_min + n_lanes);
+      for (; k < last; ++k)
+      {
+        min_value = matrix_[k] < min_value ? matrix_[k] : min_value;
+      }
+      for (k = first; k < last; ++k)
+      {
+        if (matrix_[k] == min_value)
+        {
+          return k;
+        }
+      }
+      // only reached for values without ordering (e.g. NaN)
+      return std::min_element(matrix_ + first, matrix_ + last) - matrix_;
+    }
+
+    /**
+      @brief (re-)allocates the storage for @p dimensionsize rows; content is undefined afterwards
+
+      @throw Exception::OutOfMemory if the storage does not fit into memory
+    */
+    void allocate_(SizeType dimensionsize)
+    {
+      delete[] matrix_;
+      matrix_ = nullptr;
+      dimensionsize_ = 0;
+      init_size_ = 0;
+      const SizeType n_elements = rowOffset_(dimensionsize);
+      if (n_elements > 0)
+      {
+        try
+        {
+          matrix_ = new ValueType[n_elements];
+        }
+        catch (std::bad_alloc&)
+        {
+          throw Exception::OutOfMemory(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, n_elements * sizeof(ValueType));
+        }
+      }
+      dimensionsize_ = dimensionsize;
+      init_size_ = dimensionsize;
+    }
+
+    /// sets all stored elements to @p value (in parallel for large matrices)
+    void fill_(const ValueType& value)
+    {
+      const SizeType n_elements = rowOffset_(dimensionsize_);
+      const SizeType block_size = 1 << 16;
+      const SizeType n_blocks = (n_elements + block_size - 1) / block_size;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (n_blocks >= 8)
+#endif
+      for (SignedSize b = 0; b < (SignedSize)n_blocks; ++b)
+      {
+        const SizeType first = b * block_size;
+        std::fill(matrix_ + first, matrix_ + (std::min)(first + block_size, n_elements), value);
+      }
+    }
+
+    /// copies all stored elements from @p source (in parallel for large matrices)
+    void copy_(const ValueType* source)
+    {
+      const SizeType n_elements = rowOffset_(dimensionsize_);
+      const SizeType block_size = 1 << 16;
+      const SizeType n_blocks = (n_elements + block_size - 1) / block_size;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (n_blocks >= 8)
+#endif
+      for (SignedSize b = 0; b < (SignedSize)n_blocks; ++b)
+      {
+        const SizeType first = b * block_size;
+        std::copy(source + first, source + (std::min)(first + block_size, n_elements), matrix_ + first);
+      }
+    }
+
 private:
     /// assignment operator (unsafe)
     DistanceMatrix& operator=(const DistanceMatrix& rhs)
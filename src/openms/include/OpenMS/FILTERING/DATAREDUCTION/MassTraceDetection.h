@@ -65,6 +65,11 @@ namespace OpenMS
       length as well as having the minimal sample rate criterion fulfilled) get
       added to the result.
 
+      Apices are processed in order of decreasing intensity. With OpenMP, traces
+      are extended concurrently in disjoint m/z ranges; traces whose m/z window
+      crosses into a neighbouring range are (re-)extended sequentially, so the
+      result is identical to the sequential algorithm.
+
       @htmlinclude OpenMS_MassTraceDetection.parameters
 
       @ingroup Quantitation
@@ -102,16 +107,36 @@ namespace OpenMS
 
     private:
 
-        typedef std::multimap<double, std::pair<Size, Size> > MapIdxSortedByInt;
+        /// A potential chromatographic apex (see run())
+        struct Apex_;
+
+        /// Noise-filtered MS1 peaks of the input map in flat, scan-major arrays (see run())
+        struct PeakData_;
+
+        /// The result of extending a single apex (see extendTrace_())
+        struct TraceCandidate_;
 
         /// The internal run method
-        void run_(const MapIdxSortedByInt& chrom_apices,
-                  const Size peak_count,
-                  const PeakMap & work_exp,
-                  const std::vector<Size>& spec_offsets,
+        void run_(const std::vector<Apex_>& chrom_apices,
+                  const PeakData_& peaks,
                   std::vector<MassTrace> & found_masstraces,
                   const Size max_traces = 0);
 
+        /**
+          @brief Extends a mass trace in both RT directions starting from @p apex
+
+          Only peaks with m/z in [@p mz_lo, @p mz_hi) are accessed: if the m/z
+          search window of the trace leaves this range, extension is aborted and
+          false is returned. Otherwise @p candidate holds the collected trace
+          (if it passed the length and quality criteria) and true is returned.
+        */
+        bool extendTrace_(const PeakData_& peaks,
+                          const Apex_& apex,
+                          const std::vector<char>& peak_visited,
+                          double mz_lo,
+                          double mz_hi,
+                          TraceCandidate_& candidate);
+
         // parameter stuff
         double mass_error_ppm_;
         double noise_threshold_int_;
@@ -40,8 +40,16 @@
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
+
+#include <exception>
+#include <iterator>
+#include <set>
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
   /**
@@ -63,6 +71,14 @@ namespace OpenMS
     found to be in the last (&highest) bin, a warning will be given.  In this
     case you should increase <i>max_intensity</i> (and optionally the
     <i>bin_count</i>).
+    Alternatively, the exact median of the intensities in the window can be
+    used (param: <i>exact_median</i>); <i>bin_count</i> and the maximal
+    intensity are ignored then.
+
+    Both the histogram and the intensities for the exact median are updated
+    incrementally while the window slides over the data.  To estimate many
+    spectra (e.g. a whole MSExperiment) at once, use estimateBatch(), which
+    processes them in parallel.
 
     Changing any of the parameters will invalidate the S/N values (which will invoke a recomputation on the next request).
 
@@ -135,6 +151,9 @@ public:
 
       defaults_.setValue("noise_for_empty_window", std::pow(10.0, 20), "noise value used for sparse windows", ListUtils::create<String>("advanced"));
 
+      defaults_.setValue("exact_median", "false", "Use the exact median of the intensities in a window instead of the histogram-based estimate ('bin_count' and the maximal intensity are ignored then)", ListUtils::create<String>("advanced"));
+      defaults_.setValidStrings("exact_median", ListUtils::create<String>("true,false"));
+
       defaults_.setValue("write_log_messages", "true", "Write out log messages in case of sparse windows or median in rightmost histogram bin");
       defaults_.setValidStrings("write_log_messages", ListUtils::create<String>("true,false"));
 
@@ -179,6 +198,72 @@ public:
       return histogram_oob_percent_;
     }
 
+    /**
+      @brief Estimate the S/N ratios of all data points in a list of spectra (or chromatograms) in parallel
+
+      The result is the same as calling init() and getSignalToNoise() for each data point of each container.
+      Progress is reported once for the whole batch (one step per container), not per container.
+
+      @param containers The spectra (e.g. MSExperiment::getSpectra()) or chromatograms
+      @param stn Output: S/N ratio of data point @em j of container @em i in <tt>stn[i][j]</tt>
+
+      @exception Throws Exception::InvalidValue
+    */
+    void estimateBatch(const std::vector<Container>& containers, std::vector<std::vector<double> >& stn) const
+    {
+      stn.clear();
+      stn.resize(containers.size());
+
+      Size progress = 0;
+      SignalToNoiseEstimator<Container>::startProgress(0, containers.size(), "noise estimation of data");
+
+      Size errCount = 0;
+      std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+      {
+        // each thread works on its own copy, the statistics are not thread-safe
+        SignalToNoiseEstimatorMedian estimator(*this);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 10)
+#endif
+        for (SignedSize i = 0; i < (SignedSize)containers.size(); ++i)
+        {
+          // parallel exception catching and re-throwing business
+          if (errCount) continue;
+          try
+          {
+            estimator.computeSTNValues_(containers[i].begin(), containers[i].end(), stn[i], false);
+          }
+          catch (...)
+          {
+#ifdef _OPENMP
+#pragma omp critical (SignalToNoiseEstimatorMedian_estimateBatch)
+#endif
+            {
+              if (!errCount) error = std::current_exception();
+              ++errCount;
+            }
+          }
+
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+          ++progress;
+          IF_MASTERTHREAD
+          {
+            SignalToNoiseEstimator<Container>::setProgress(progress);
+          }
+        }
+      }
+      SignalToNoiseEstimator<Container>::endProgress();
+      if (error)
+      {
+        std::rethrow_exception(error);
+      }
+    }
+
 protected:
 
 
@@ -189,6 +274,30 @@ protected:
         @exception Throws Exception::InvalidValue
     */
     void computeSTN_(const PeakIterator & scan_first_, const PeakIterator & scan_last_) override
+    {
+      // reset the results
+      stn_estimates_.clear();
+
+      // with log type NONE, progress is not reported at all (the estimator may then be used concurrently, e.g. by the PeakPickerHiRes)
+      std::vector<double> stn;
+      computeSTNValues_(scan_first_, scan_last_, stn, SignalToNoiseEstimator<Container>::getLogType() != ProgressLogger::NONE);
+
+      PeakIterator run = scan_first_;
+      for (Size i = 0; i < stn.size(); ++i, ++run)
+      {
+        stn_estimates_[*run] = stn[i];
+      }
+    }
+
+    /** Calculate signal-to-noise values for all data points given (in order), by using a sliding window approach
+
+        @param scan_first_ first element in the scan
+        @param scan_last_ last element in the scan (disregarded)
+        @param stn S/N values of the data points (output)
+        @param report_progress Report progress per data point. Must be false when called concurrently (progress logging is not thread-safe).
+        @exception Throws Exception::InvalidValue
+    */
+    void computeSTNValues_(const PeakIterator & scan_first_, const PeakIterator & scan_last_, std::vector<double> & stn, bool report_progress)
     {
       // reset counter for sparse windows
       sparse_window_percent_ = 0;
@@ -196,10 +305,14 @@ protected:
       histogram_oob_percent_ = 0;
 
       // reset the results
-      stn_estimates_.clear();
+      stn.assign(std::distance(scan_first_, scan_last_), 0.0);
 
-      // maximal range of histogram needs to be calculated first
-      if (auto_mode_ == AUTOMAXBYSTDEV)
+      // maximal range of histogram needs to be calculated first (unless it is not used)
+      if (exact_median_)
+      {
+        // no histogram
+      }
+      else if (auto_mode_ == AUTOMAXBYSTDEV)
       {
         // use MEAN+auto_max_intensity_*STDEV as threshold
         GaussianEstimate gauss_global = SignalToNoiseEstimator<Container>::estimate_(scan_first_, scan_last_);
@@ -270,7 +383,7 @@ protected:
         }
       }
 
-      if (max_intensity_ < 0)
+      if (!exact_median_ && (max_intensity_ < 0))
       {
         std::cerr << "TODO SignalToNoiseEstimatorMedian: the max_intensity_ value should be positive! " << max_intensity_ << std::endl;
         return;
@@ -295,10 +408,15 @@ protected:
       // bin in which a datapoint would fall
       int to_bin = 0;
 
-      // index of bin where the median is located
+      // index of bin where the median is located; it is moved from window to
+      // window (instead of searching the histogram from the start each time)
       int median_bin = 0;
-      // additive number of elements from left to x in histogram
-      int element_inc_count = 0;
+      // number of elements in the bins left of "median_bin"
+      int elements_below_median_bin = 0;
+
+      // intensities in the current window for the exact median: the lower half
+      // (including the middle element for odd sizes) and the upper half
+      std::multiset<double> lower_half, upper_half;
 
       // tracks elements in current window, which may vary because of unevenly spaced data
       int elements_in_window = 0;
@@ -318,7 +436,7 @@ protected:
         ++windows_overall;
         ++run;
       }
-      SignalToNoiseEstimator<Container>::startProgress(0, windows_overall, "noise estimation of data");
+      if (report_progress) SignalToNoiseEstimator<Container>::startProgress(0, windows_overall, "noise estimation of data");
 
       // MAIN LOOP
       while (window_pos_center != scan_last_)
@@ -327,8 +445,24 @@ protected:
         // erase all elements from histogram that will leave the window on the LEFT side
         while ((*window_pos_borderleft).getMZ() <  (*window_pos_center).getMZ() - window_half_size)
         {
-          to_bin = std::max(std::min<int>((int)((*window_pos_borderleft).getIntensity() / bin_size), bin_count_minus_1), 0);
-          --histogram[to_bin];
+          if (exact_median_)
+          {
+            double intensity = (*window_pos_borderleft).getIntensity();
+            if (!lower_half.empty() && (intensity <= *lower_half.rbegin()))
+            {
+              lower_half.erase(lower_half.find(intensity));
+            }
+            else
+            {
+              upper_half.erase(upper_half.find(intensity));
+            }
+          }
+          else
+          {
+            to_bin = std::max(std::min<int>((int)((*window_pos_borderleft).getIntensity() / bin_size), bin_count_minus_1), 0);
+            --histogram[to_bin];
+            if (to_bin < median_bin) --elements_below_median_bin;
+          }
           --elements_in_window;
           ++window_pos_borderleft;
         }
@@ -338,27 +472,77 @@ protected:
               && ((*window_pos_borderright).getMZ() <= (*window_pos_center).getMZ() + window_half_size))
         {
           //std::cerr << (*window_pos_borderright).getIntensity() << " " << bin_size << " " << bin_count_minus_1 << std::endl;
-          to_bin = std::max(std::min<int>((int)((*window_pos_borderright).getIntensity() / bin_size), bin_count_minus_1), 0);
-          ++histogram[to_bin];
+          if (exact_median_)
+          {
+            double intensity = (*window_pos_borderright).getIntensity();
+            bool to_lower = lower_half.empty() ?
+                            (upper_half.empty() || (intensity <= *upper_half.begin())) :
+                            (intensity <= *lower_half.rbegin());
+            if (to_lower)
+            {
+              lower_half.insert(intensity);
+            }
+            else
+            {
+              upper_half.insert(intensity);
+            }
+          }
+          else
+          {
+            to_bin = std::max(std::min<int>((int)((*window_pos_borderright).getIntensity() / bin_size), bin_count_minus_1), 0);
+            ++histogram[to_bin];
+            if (to_bin < median_bin) ++elements_below_median_bin;
+          }
           ++elements_in_window;
           ++window_pos_borderright;
         }
 
+        if (exact_median_)
+        {
+          // rebalance the two halves
+          while (lower_half.size() > upper_half.size() + 1)
+          {
+            typename std::multiset<double>::iterator last = --lower_half.end();
+            upper_half.insert(*last);
+            lower_half.erase(last);
+          }
+          while (upper_half.size() > lower_half.size())
+          {
+            lower_half.insert(*upper_half.begin());
+            upper_half.erase(upper_half.begin());
+          }
+        }
+
         if (elements_in_window < min_required_elements_)
         {
           noise = noise_for_empty_window_;
           ++sparse_window_percent_;
         }
+        else if (exact_median_)
+        {
+          double median = *lower_half.rbegin();
+          if (lower_half.size() == upper_half.size())
+          {
+            median = (median + *upper_half.begin()) / 2;
+          }
+
+          // just avoid division by 0
+          noise = std::max(1.0, median);
+        }
         else
         {
-          // find bin i where ceil[elements_in_window/2] <= sum_c(0..i){ histogram[c] }
-          median_bin = -1;
-          element_inc_count = 0;
+          // find bin i where ceil[elements_in_window/2] <= sum_c(0..i){ histogram[c] },
+          // starting from the median bin of the previous window
           element_in_window_half = (elements_in_window + 1) / 2;
-          while (median_bin < bin_count_minus_1 && element_inc_count < element_in_window_half)
+          while (median_bin > 0 && elements_below_median_bin >= element_in_window_half)
+          {
+            --median_bin;
+            elements_below_median_bin -= histogram[median_bin];
+          }
+          while (elements_below_median_bin + histogram[median_bin] < element_in_window_half)
           {
+            elements_below_median_bin += histogram[median_bin];
             ++median_bin;
-            element_inc_count += histogram[median_bin];
           }
 
           // increase the error count
@@ -369,18 +553,18 @@ protected:
         }
 
         // store result
-        stn_estimates_[*window_pos_center] = (*window_pos_center).getIntensity() / noise;
+        stn[window_count] = (*window_pos_center).getIntensity() / noise;
 
 
         // advance the window center by one datapoint
         ++window_pos_center;
         ++window_count;
         // update progress
-        SignalToNoiseEstimator<Container>::setProgress(window_count);
+        if (report_progress) SignalToNoiseEstimator<Container>::setProgress(window_count);
 
       } // end while
 
-      SignalToNoiseEstimator<Container>::endProgress();
+      if (report_progress) SignalToNoiseEstimator<Container>::endProgress();
 
       sparse_window_percent_ = sparse_window_percent_ * 100 / window_count;
       histogram_oob_percent_ = histogram_oob_percent_ * 100 / window_count;
@@ -417,6 +601,7 @@ protected:
       bin_count_               = param_.getValue("bin_count");
       min_required_elements_   = param_.getValue("min_required_elements");
       noise_for_empty_window_  = (double)param_.getValue("noise_for_empty_window");
+      exact_median_            = param_.getValue("exact_median").toBool();
       write_log_messages_      = (bool)param_.getValue("write_log_messages").toBool();
       is_result_valid_         = false;
     }
@@ -438,6 +623,8 @@ protected:
     /// used as noise value for windows which cover less than "min_required_elements_"
     /// use a very high value if you want to get a low S/N result
     double noise_for_empty_window_;
+    /// use the exact median instead of the histogram-based estimate?
+    bool exact_median_;
 
     // whether to write out log messages in the case of failure
     bool write_log_messages_;
@@ -187,12 +187,7 @@ public:
     */
     void filter(MSSpectrum & spectrum)
     {
-      // copy the data AND META DATA to the output container
-      MSSpectrum output = spectrum;
-      // filter
-      filter(spectrum.begin(), spectrum.end(), output.begin());
-      // swap back
-      std::swap(spectrum, output);
+      filterInPlace_(spectrum);
     }
 
     /**
@@ -200,35 +195,79 @@ public:
     */
     void filter(MSChromatogram & chromatogram)
     {
-      // copy the data AND META DATA to the output container
-      MSChromatogram output = chromatogram;
-      // filter
-      filter(chromatogram.begin(), chromatogram.end(), output.begin());
-      // swap back
-      std::swap(chromatogram, output);
+      filterInPlace_(chromatogram);
     }
 
     /**
       @brief Removed the noise from an MSExperiment containing profile data.
+
+      Spectra and chromatograms are smoothed in parallel (if OpenMP is enabled).
     */
-    void filterExperiment(PeakMap & map)
+    void filterExperiment(PeakMap & map);
+
+protected:
+    /**
+      @brief Smoothes the intensities of a spectrum or chromatogram in place
+
+      Equivalent to filter(first, last, d_first) on a copy of @p container,
+      but only the raw intensities are copied (into a contiguous buffer),
+      not the peaks and meta data.
+    */
+    template <typename ContainerT>
+    void filterInPlace_(ContainerT & container) const
     {
-      Size progress = 0;
-      startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
-      for (Size i = 0; i < map.size(); ++i)
+      const Size n = container.size();
+      if (frame_size_ > n) { return; }
+
+      std::vector<double> raw(n);
+      for (Size p = 0; p < n; ++p)
+      {
+        raw[p] = container[p].getIntensity();
+      }
+
+      const Size mid = frame_size_ / 2;
+      const double* data = &raw[0];
+      const double* coeffs = &coeffs_[0];
+
+      // compute the transient on
+      for (Size p = 0; p <= mid; ++p)
       {
-        filter(map[i]);
-        setProgress(++progress);
+        const double* c = coeffs + (p + 1) * frame_size_ - 1;
+        double help = 0;
+        for (Size j = 0; j < frame_size_; ++j)
+        {
+          help += data[j] * *(c - j);
+        }
+        container[p].setIntensity(std::max(0.0, help));
       }
-      for (Size i = 0; i < map.getChromatograms().size(); ++i)
+
+      // compute the steady state output
+      const double* c_steady = coeffs + mid * frame_size_;
+      for (Size p = mid + 1; p < n - mid; ++p)
       {
-        filter(map.getChromatogram(i));
-        setProgress(++progress);
+        const double* d = data + p - mid;
+        double help = 0;
+        for (Size j = 0; j < frame_size_; ++j)
+        {
+          help += d[j] * c_steady[j];
+        }
+        container[p].setIntensity(std::max(0.0, help));
+      }
+
+      // compute the transient off
+      const double* d_off = data + n - frame_size_;
+      for (Size p = n - mid; p < n; ++p)
+      {
+        const double* c = coeffs + (n - 1 - p) * frame_size_;
+        double help = 0;
+        for (Size j = 0; j < frame_size_; ++j)
+        {
+          help += d_off[j] * c[j];
+        }
+        container[p].setIntensity(std::max(0.0, help));
       }
-      endProgress();
     }
 
-protected:
     /// Coefficients
     std::vector<double> coeffs_;
 
@@ -35,17 +35,16 @@
 #pragma once
 
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
-#include <OpenMS/COMPARISON/CLUSTERING/CompleteLinkage.h>
-#include <OpenMS/COMPARISON/CLUSTERING/SingleLinkage.h>
-#include <OpenMS/COMPARISON/CLUSTERING/ClusterAnalyzer.h>
-#include <OpenMS/COMPARISON/CLUSTERING/ClusterHierarchical.h>
+#include <OpenMS/COMPARISON/CLUSTERING/HashGrid.h>
 #include <OpenMS/COMPARISON/SPECTRA/SpectrumAlignment.h>
 #include <OpenMS/FILTERING/DATAREDUCTION/SplineInterpolatedPeaks.h>
 #include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/KERNEL/RangeUtils.h>
 #include <OpenMS/KERNEL/BaseFeature.h>
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
+#include <exception>
 #include <vector>
 
 namespace OpenMS
@@ -199,95 +198,126 @@ public:
       exp.sortSpectra();
     }
 
-    /// merges spectra with similar precursors (must have MS2 level)
+    /**
+      @brief merges spectra with similar precursors (must have MS2 level)
+
+      Spectra are merged by single linkage clustering of their precursors:
+      all spectra connected by a chain of precursor pairs within the RT and
+      m/z tolerances end up in one block. Only these neighbouring pairs are
+      considered (they are found using a HashGrid with cells of the size of
+      the tolerances), so time and memory are linear in the number of
+      spectra for realistic data.
+    */
     template <typename MapType>
     void mergeSpectraPrecursors(MapType& exp)
     {
-
       // convert spectra's precursors to clusterizable data
-      Size data_size;
-      std::vector<BinaryTreeNode> tree;
-      Map<Size, Size> index_mapping;
-      // local scope to save memory - we do not need the clustering stuff later
+      std::vector<BaseFeature> data;
+      std::vector<Size> index_mapping; // index in data ==> experiment index
+      for (Size i = 0; i < exp.size(); ++i)
       {
-        std::vector<BaseFeature> data;
-
-        for (Size i = 0; i < exp.size(); ++i)
+        if (exp[i].getMSLevel() != 2)
         {
-          if (exp[i].getMSLevel() != 2)
-          {
-            continue;
-          }
+          continue;
+        }
 
-          // remember which index in distance data ==> experiment index
-          index_mapping[data.size()] = i;
+        // remember which index in distance data ==> experiment index
+        index_mapping.push_back(i);
 
-          // make cluster element
-          BaseFeature bf;
-          bf.setRT(exp[i].getRT());
-          std::vector<Precursor> pcs = exp[i].getPrecursors();
-          if (pcs.empty())
-          {
-            throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Scan #") + String(i) + " does not contain any precursor information! Unable to cluster!");
-          }
-          if (pcs.size() > 1)
-          {
-            OPENMS_LOG_WARN << "More than one precursor found. Using first one!" << std::endl;
-          }
-          bf.setMZ(pcs[0].getMZ());
-          data.push_back(bf);
+        // make cluster element
+        BaseFeature bf;
+        bf.setRT(exp[i].getRT());
+        std::vector<Precursor> pcs = exp[i].getPrecursors();
+        if (pcs.empty())
+        {
+          throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Scan #") + String(i) + " does not contain any precursor information! Unable to cluster!");
         }
-        data_size = data.size();
-
-        SpectraDistance_ llc;
-        llc.setParameters(param_.copy("precursor_method:", true));
-        SingleLinkage sl;
-        DistanceMatrix<float> dist; // will be filled
-        ClusterHierarchical ch;
+        if (pcs.size() > 1)
+        {
+          OPENMS_LOG_WARN << "More than one precursor found. Using first one!" << std::endl;
+        }
+        bf.setMZ(pcs[0].getMZ());
+        data.push_back(bf);
+      }
 
-        //ch.setThreshold(0.99);
-        // clustering ; threshold is implicitly at 1.0, i.e. distances of 1.0 (== similarity 0) will not be clustered
-        ch.cluster<BaseFeature, SpectraDistance_>(data, llc, sl, tree, dist);
+      SpectraDistance_ llc;
+      llc.setParameters(param_.copy("precursor_method:", true));
+
+      // sparse neighbourhood: pairs within the tolerances are in the same or in
+      // adjacent grid cells (cells are slightly larger than the tolerances to
+      // be safe from rounding)
+      typedef HashGrid<Size> GridType;
+      double rt_tolerance = param_.getValue("precursor_method:rt_tolerance");
+      double mz_tolerance = param_.getValue("precursor_method:mz_tolerance");
+      GridType grid(GridType::ClusterCenter(rt_tolerance > 0 ? rt_tolerance * 1.01 : 1.0,
+                                            mz_tolerance > 0 ? mz_tolerance * 1.01 : 1.0));
+      for (Size i = 0; i < data.size(); ++i)
+      {
+        grid.insert(std::make_pair(GridType::ClusterCenter(data[i].getRT(), data[i].getMZ()), i));
       }
 
-      // extract the clusters
-      ClusterAnalyzer ca;
-      std::vector<std::vector<Size> > clusters;
-      // count number of real tree nodes (not the -1 ones):
-      Size node_count = 0;
-      for (Size ii = 0; ii < tree.size(); ++ii)
+      // single linkage clustering cut at distance 1 (== similarity 0), i.e.
+      // connected components of the neighbourhood graph (union-find, the root
+      // of a component is its smallest element)
+      std::vector<Size> parent(data.size());
+      for (Size i = 0; i < parent.size(); ++i)
       {
-        if (tree[ii].distance >= 1)
+        parent[i] = i;
+      }
+      auto findRoot = [&parent](Size i)
+      {
+        while (parent[i] != i)
         {
-          tree[ii].distance = -1;  // manually set to disconnect, as SingleLinkage does not support it
+          parent[i] = parent[parent[i]];
+          i = parent[i];
         }
-        if (tree[ii].distance != -1)
+        return i;
+      };
+      for (GridType::const_grid_iterator cell = grid.grid_begin(); cell != grid.grid_end(); ++cell)
+      {
+        const GridType::CellIndex& index = cell->first;
+        for (Int64 d_rt = -1; d_rt <= 1; ++d_rt)
         {
-          ++node_count;
+          for (Int64 d_mz = -1; d_mz <= 1; ++d_mz)
+          {
+            GridType::const_grid_iterator neighbor = grid.grid_find(GridType::CellIndex(index[0] + d_rt, index[1] + d_mz));
+            if (neighbor == grid.grid_end())
+            {
+              continue;
+            }
+            for (GridType::const_cell_iterator it1 = cell->second.begin(); it1 != cell->second.end(); ++it1)
+            {
+              for (GridType::const_cell_iterator it2 = neighbor->second.begin(); it2 != neighbor->second.end(); ++it2)
+              {
+                // consider each pair once; distances are compared in single precision as in a DistanceMatrix<float>
+                if (it1->second >= it2->second ||
+                    !(float(1 - llc(data[it1->second], data[it2->second])) < 1.0f))
+                {
+                  continue;
+                }
+                Size root1 = findRoot(it1->second), root2 = findRoot(it2->second);
+                if (root1 < root2)
+                {
+                  parent[root2] = root1;
+                }
+                else
+                {
+                  parent[root1] = root2;
+                }
+              }
+            }
+          }
         }
       }
-      ca.cut(data_size - node_count, tree, clusters);
 
-      //std::cerr << "Treesize: " << (tree.size()+1) << "   #clusters: " << clusters.size() << std::endl;
-      //std::cerr << "tree:\n" << ca.newickTree(tree, true) << "\n";
-
-      // convert to blocks
+      // convert to blocks: the first spectrum of each cluster is the master spectrum
       MergeBlocks spectra_to_merge;
-
-      for (Size i_outer = 0; i_outer < clusters.size(); ++i_outer)
+      for (Size i = 0; i < data.size(); ++i)
       {
-        if (clusters[i_outer].size() <= 1)
+        Size root = findRoot(i);
+        if (root != i)
         {
-          continue;
-        }
-        // init block with first cluster element
-        Size cl_index0 = clusters[i_outer][0];
-        spectra_to_merge[index_mapping[cl_index0]] = std::vector<Size>();
-        // add all other elements
-        for (Size i_inner = 1; i_inner < clusters[i_outer].size(); ++i_inner)
-        {
-          Size cl_index = clusters[i_outer][i_inner];
-          spectra_to_merge[index_mapping[cl_index0]].push_back(index_mapping[cl_index]);
+          spectra_to_merge[index_mapping[root]].push_back(index_mapping[i]);
         }
       }
 
@@ -512,124 +542,159 @@ protected:
 
       p.setValue("is_relative_tolerance", mz_binning_unit == "Da" ? "false" : "true");
       sas.setParameters(p);
-      std::vector<std::pair<Size, Size> > alignment;
 
       Size count_peaks_aligned(0);
       Size count_peaks_overall(0);
 
-      // each BLOCK
+      // blocks are merged in parallel; the consensus spectra are added in block order
+      std::vector<typename MergeBlocks::const_iterator> blocks;
       for (auto it = spectra_to_merge.begin(); it != spectra_to_merge.end(); ++it)
       {
         ++cluster_sizes[it->second.size() + 1]; // for stats
-
-        typename MapType::SpectrumType consensus_spec = exp[it->first];
-        consensus_spec.setMSLevel(ms_level);
-
-        //consensus_spec.unify(exp[it->first]); // append meta info
         merged_indices.insert(it->first);
+        merged_indices.insert(it->second.begin(), it->second.end());
+        blocks.push_back(it);
+      }
+      std::vector<typename MapType::SpectrumType> consensus_spectra(blocks.size());
 
-        //typename MapType::SpectrumType all_peaks = exp[it->first];
-        double rt_average = consensus_spec.getRT();
-        double precursor_mz_average = 0.0;
-        Size precursor_count(0);
-        if (!consensus_spec.getPrecursors().empty())
-        {
-          precursor_mz_average = consensus_spec.getPrecursors()[0].getMZ();
-          ++precursor_count;
-        }
-
-        count_peaks_overall += consensus_spec.size();
+      Size errCount = 0;
+      std::exception_ptr error;
 
-        // block elements
-        for (auto sit = it->second.begin(); sit != it->second.end(); ++sit)
+      // each BLOCK
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) reduction(+: count_peaks_aligned, count_peaks_overall)
+#endif
+      for (SignedSize block_index = 0; block_index < (SignedSize)blocks.size(); ++block_index)
+      {
+        // parallel exception catching and re-throwing business
+        if (errCount) continue; // no need to merge further if already an error was encountered
+        try
         {
-          consensus_spec.unify(exp[*sit]); // append meta info
-          merged_indices.insert(*sit);
-
-          rt_average += exp[*sit].getRT();
-          if (ms_level >= 2 && exp[*sit].getPrecursors().size() > 0)
+          const typename MergeBlocks::const_iterator& it = blocks[block_index];
+          typename MapType::SpectrumType& consensus_spec = consensus_spectra[block_index];
+          consensus_spec = exp[it->first];
+          consensus_spec.setMSLevel(ms_level);
+          std::vector<std::pair<Size, Size> > alignment;
+
+          //consensus_spec.unify(exp[it->first]); // append meta info
+          //typename MapType::SpectrumType all_peaks = exp[it->first];
+          double rt_average = consensus_spec.getRT();
+          double precursor_mz_average = 0.0;
+          Size precursor_count(0);
+          if (!consensus_spec.getPrecursors().empty())
           {
-            precursor_mz_average += exp[*sit].getPrecursors()[0].getMZ();
+            precursor_mz_average = consensus_spec.getPrecursors()[0].getMZ();
             ++precursor_count;
           }
 
-          // merge data points
-          sas.getSpectrumAlignment(alignment, consensus_spec, exp[*sit]);
-          //std::cerr << "alignment of " << it->first << " with " << *sit << " yielded " << alignment.size() << " common peaks!\n";
-          count_peaks_aligned += alignment.size();
-          count_peaks_overall += exp[*sit].size();
+          count_peaks_overall += consensus_spec.size();
 
-          Size align_index(0);
-          Size spec_b_index(0);
-
-          // sanity check for number of peaks
-          Size spec_a = consensus_spec.size(), spec_b = exp[*sit].size(), align_size = alignment.size();
-          for (auto pit = exp[*sit].begin(); pit != exp[*sit].end(); ++pit)
+          // block elements
+          for (auto sit = it->second.begin(); sit != it->second.end(); ++sit)
           {
-            if (alignment.size() == 0 || alignment[align_index].second != spec_b_index)
-              // ... add unaligned peak
+            consensus_spec.unify(exp[*sit]); // append meta info
+
+            rt_average += exp[*sit].getRT();
+            if (ms_level >= 2 && exp[*sit].getPrecursors().size() > 0)
             {
-              consensus_spec.push_back(*pit);
+              precursor_mz_average += exp[*sit].getPrecursors()[0].getMZ();
+              ++precursor_count;
             }
-            // or add aligned peak height to ALL corresponding existing peaks
-            else
-            {
-              Size counter(0);
-              Size copy_of_align_index(align_index);
 
-              while (alignment.size() > 0 && 
-                     copy_of_align_index < alignment.size() && 
-                     alignment[copy_of_align_index].second == spec_b_index)
-              {
-                ++copy_of_align_index;
-                ++counter;
-              } // Count the number of peaks in a which correspond to a single b peak.
+            // merge data points
+            sas.getSpectrumAlignment(alignment, consensus_spec, exp[*sit]);
+            //std::cerr << "alignment of " << it->first << " with " << *sit << " yielded " << alignment.size() << " common peaks!\n";
+            count_peaks_aligned += alignment.size();
+            count_peaks_overall += exp[*sit].size();
+
+            Size align_index(0);
+            Size spec_b_index(0);
 
-              while (alignment.size() > 0 &&
-                     align_index < alignment.size() &&  
-                     alignment[align_index].second == spec_b_index)
+            // sanity check for number of peaks
+            Size spec_a = consensus_spec.size(), spec_b = exp[*sit].size(), align_size = alignment.size();
+            for (auto pit = exp[*sit].begin(); pit != exp[*sit].end(); ++pit)
+            {
+              if (alignment.size() == 0 || alignment[align_index].second != spec_b_index)
+                // ... add unaligned peak
+              {
+                consensus_spec.push_back(*pit);
+              }
+              // or add aligned peak height to ALL corresponding existing peaks
+              else
               {
-                consensus_spec[alignment[align_index].first].setIntensity(consensus_spec[alignment[align_index].first].getIntensity() +
-                    (pit->getIntensity() / (double)counter)); // add the intensity divided by the number of peaks
-                ++align_index; // this aligned peak was explained, wait for next aligned peak ...
-                if (align_index == alignment.size())
+                Size counter(0);
+                Size copy_of_align_index(align_index);
+
+                while (alignment.size() > 0 && 
+                       copy_of_align_index < alignment.size() && 
+                       alignment[copy_of_align_index].second == spec_b_index)
+                {
+                  ++copy_of_align_index;
+                  ++counter;
+                } // Count the number of peaks in a which correspond to a single b peak.
+
+                while (alignment.size() > 0 &&
+                       align_index < alignment.size() &&  
+                       alignment[align_index].second == spec_b_index)
                 {
-                  alignment.clear();  // end reached -> avoid going into this block again
+                  consensus_spec[alignment[align_index].first].setIntensity(consensus_spec[alignment[align_index].first].getIntensity() +
+                      (pit->getIntensity() / (double)counter)); // add the intensity divided by the number of peaks
+                  ++align_index; // this aligned peak was explained, wait for next aligned peak ...
+                  if (align_index == alignment.size())
+                  {
+                    alignment.clear();  // end reached -> avoid going into this block again
+                  }
                 }
+                align_size = align_size + 1 - counter; //Decrease align_size by number of
               }
-              align_size = align_size + 1 - counter; //Decrease align_size by number of
+              ++spec_b_index;
+            }
+            consensus_spec.sortByPosition(); // sort, otherwise next alignment will fail
+            if (spec_a + spec_b - align_size != consensus_spec.size())
+            {
+#ifdef _OPENMP
+#pragma omp critical (SpectraMerger_log)
+#endif
+              OPENMS_LOG_WARN << "wrong number of features after merge. Expected: " << spec_a + spec_b - align_size << " got: " << consensus_spec.size() << "\n";
             }
-            ++spec_b_index;
           }
-          consensus_spec.sortByPosition(); // sort, otherwise next alignment will fail
-          if (spec_a + spec_b - align_size != consensus_spec.size())
+          rt_average /= it->second.size() + 1;
+          consensus_spec.setRT(rt_average);
+
+          if (ms_level >= 2)
           {
-            OPENMS_LOG_WARN << "wrong number of features after merge. Expected: " << spec_a + spec_b - align_size << " got: " << consensus_spec.size() << "\n";
+            if (precursor_count)
+            {
+              precursor_mz_average /= precursor_count;
+            }
+            std::vector<Precursor> pcs = consensus_spec.getPrecursors();
+            //if (pcs.size()>1) OPENMS_LOG_WARN << "Removing excessive precursors - leaving only one per MS2 spectrum.\n";
+            pcs.resize(1);
+            pcs[0].setMZ(precursor_mz_average);
+            consensus_spec.setPrecursors(pcs);
           }
         }
-        rt_average /= it->second.size() + 1;
-        consensus_spec.setRT(rt_average);
-
-        if (ms_level >= 2)
+        catch (...)
         {
-          if (precursor_count)
+#ifdef _OPENMP
+#pragma omp critical (SpectraMerger_merge)
+#endif
           {
-            precursor_mz_average /= precursor_count;
+            if (!errCount) error = std::current_exception();
+            ++errCount;
           }
-          std::vector<Precursor> pcs = consensus_spec.getPrecursors();
-          //if (pcs.size()>1) OPENMS_LOG_WARN << "Removing excessive precursors - leaving only one per MS2 spectrum.\n";
-          pcs.resize(1);
-          pcs[0].setMZ(precursor_mz_average);
-          consensus_spec.setPrecursors(pcs);
         }
+      }
+      if (error)
+      {
+        std::rethrow_exception(error);
+      }
 
-        if (consensus_spec.empty())
-        {
-          continue;
-        }
-        else
+      for (Size block_index = 0; block_index < consensus_spectra.size(); ++block_index)
+      {
+        if (!consensus_spectra[block_index].empty())
         {
-          merged_spectra.addSpectrum(consensus_spec);
+          merged_spectra.addSpectrum(std::move(consensus_spectra[block_index]));
         }
       }
 
@@ -48,6 +48,8 @@
 #include <algorithm>
 #include <iterator>
 #include <cmath>
+#include <functional>
+#include <type_traits>
 #include <vector>
 
 #include <QByteArray>
@@ -151,22 +153,58 @@ public:
 
 private:
 
-    ///Internal class needed for type-punning
-    union Reinterpreter64_
-    {
-      double f;
-      UInt64 i;
-    };
+    /**
+      @name Low-level kernels
 
-    ///Internal class needed for type-punning
-    union Reinterpreter32_
-    {
-      float f;
-      UInt32 i;
-    };
+      Base64 coding and byte order conversion use SSE4.1 or AVX2 kernels if
+      the CPU supports them (determined once at runtime) and scalar code
+      otherwise. All of them operate on raw memory, so that data can be decoded
+      directly into the output vector without intermediate copies.
+    */
+    //@{
+    /**
+      @brief Decodes Base64 characters to bytes
+
+      Characters outside the Base64 alphabet (e.g. whitespace) are skipped,
+      decoding stops at the first padding character ('=').
+
+      @param in The Base64 characters
+      @param in_size Number of characters in @p in
+      @param out Output buffer, must hold at least 3 * (@p in_size / 4) bytes
+      @return The number of bytes written to @p out
+    */
+    static Size decodeRaw_(const char * in, Size in_size, Byte * out);
+
+    /// Encodes @p in_size bytes to Base64 (including padding), @p out must hold 4 * ceil(@p in_size / 3) characters
+    static void encodeRaw_(const Byte * in, Size in_size, char * out);
+
+    /// Reverses the byte order of @p count elements of @p element_size bytes (4 or 8) in place
+    static void swapByteOrder_(void * data, Size count, Size element_size);
+
+    /**
+      @brief Decompresses zlib-compressed data
+
+      @param in The compressed data
+      @param in_size Number of bytes in @p in
+      @param get_buffer Is called with the minimal number of bytes needed and has to return a buffer of at least that size which keeps previously written data
+      @return The number of decompressed bytes
+
+      @exception Exception::ConversionError is thrown if the data cannot be decompressed
+    */
+    static Size inflate_(const Byte * in, Size in_size, const std::function<Byte * (Size)> & get_buffer);
+
+    /// Compresses (optional) and encodes @p in_size bytes to the Base64 string @p out
+    static void encodeBytes_(const Byte * in, Size in_size, String & out, bool zlib_compression);
+    //@}
+
+    /// Decodes (and decompresses) a Base64 string directly into a vector of elements of the same size, converting the byte order if necessary
+    template <typename ToType>
+    static void decodeBytes_(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out, bool zlib_compression);
+
+    /// Decodes (and decompresses) a Base64 string of integers (of the same size as ToType) into a vector
+    template <typename ToType>
+    static void decodeIntegersBytes_(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out, bool zlib_compression);
 
-    static const char encoder_[];
-    static const char decoder_[];
     /// Decodes a Base64 string to a vector of floating point numbers
     template <typename ToType>
     static void decodeUncompressed_(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out);
@@ -213,124 +251,14 @@ private:
     if (in.empty())
       return;
 
-    //initialize
     const Size element_size = sizeof(FromType);
-    const Size input_bytes = element_size * in.size();
-    String compressed;
-    Byte * it;
-    Byte * end;
     //Change endianness if necessary
     if ((OPENMS_IS_BIG_ENDIAN && to_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && to_byte_order == Base64::BYTEORDER_BIGENDIAN))
     {
-      if (element_size == 4)
-      {
-        for (Size i = 0; i < in.size(); ++i)
-        {
-          Reinterpreter32_ tmp;
-          tmp.f = in[i];
-          tmp.i = endianize32(tmp.i);
-          in[i] = tmp.f;
-        }
-      }
-      else
-      {
-        for (Size i = 0; i < in.size(); ++i)
-        {
-          Reinterpreter64_ tmp;
-          tmp.f = static_cast<double>(in[i]);
-          tmp.i = endianize64(tmp.i);
-          in[i] = tmp.f;
-        }
-      }
-    }
-
-    //encode with compression
-    if (zlib_compression)
-    {
-      unsigned long sourceLen =   (unsigned long)in.size();
-      unsigned long compressed_length =       //compressBound((unsigned long)in.size());
-                                        sourceLen + (sourceLen >> 12) + (sourceLen >> 14) + 11; // taken from zlib's compress.c, as we cannot use compressBound*
-      //
-      // (*) compressBound is not defined in the QtCore lib, which forces the linker under windows to link in our zlib.
-      //     This leads to multiply defined symbols as compress() is then defined twice.
-
-      int zlib_error;
-      do
-      {
-        compressed.resize(compressed_length);
-        zlib_error = compress(reinterpret_cast<Bytef *>(&compressed[0]), &compressed_length, reinterpret_cast<Bytef *>(&in[0]), (unsigned long)input_bytes);
-
-        switch (zlib_error)
-        {
-        case Z_MEM_ERROR:
-          throw Exception::OutOfMemory(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, compressed_length);
-          break;
-
-        case Z_BUF_ERROR:
-          compressed_length *= 2;
-        }
-      }
-      while (zlib_error == Z_BUF_ERROR);
-
-      if (zlib_error != Z_OK)
-      {
-        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Compression error?");
-      }
-
-      String(compressed).swap(compressed);
-      it = reinterpret_cast<Byte *>(&compressed[0]);
-      end = it + compressed_length;
-      out.resize((Size)ceil(compressed_length / 3.) * 4);     //resize output array in order to have enough space for all characters
-    }
-    //encode without compression
-    else
-    {
-      out.resize((Size)ceil(input_bytes / 3.) * 4);     //resize output array in order to have enough space for all characters
-      it = reinterpret_cast<Byte *>(&in[0]);
-      end = it + input_bytes;
+      swapByteOrder_(&in[0], in.size(), element_size);
     }
 
-    Byte * to = reinterpret_cast<Byte *>(&out[0]);
-
-
-    Size written = 0;
-
-    while (it != end)
-    {
-      Int int_24bit = 0;
-      Int padding_count = 0;
-
-      // construct 24-bit integer from 3 bytes
-      for (Size i = 0; i < 3; i++)
-      {
-        if (it != end)
-        {
-          int_24bit |= *it++ << ((2 - i) * 8);
-        }
-        else
-        {
-          padding_count++;
-        }
-      }
-
-      // write out 4 characters
-      for (Int i = 3; i >= 0; i--)
-      {
-        to[i] = encoder_[int_24bit & 0x3F];
-        int_24bit >>= 6;
-      }
-
-      // fixup for padding
-      if (padding_count > 0)
-        to[3] = '=';
-      if (padding_count > 1)
-        to[2] = '=';
-
-      to += 4;
-      written += 4;
-    }
-
-    out.resize(written);         //no more space is needed
+    encodeBytes_(reinterpret_cast<const Byte *>(&in[0]), element_size * in.size(), out, zlib_compression);
   }
 
   template <typename ToType>
@@ -347,62 +275,54 @@ private:
   }
 
   template <typename ToType>
-  void Base64::decodeCompressed_(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out)
+  void Base64::decodeBytes_(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out, bool zlib_compression)
   {
-    out.clear();
-    if (in == "") return;
-
     const Size element_size = sizeof(ToType);
+    Size byte_count = 0;
 
-    String decompressed;
-
-    QByteArray qt_byte_array = QByteArray::fromRawData(in.c_str(), (int) in.size());
-    QByteArray bazip = QByteArray::fromBase64(qt_byte_array);
-    QByteArray czip;
-    czip.resize(4);
-    czip[0] = (bazip.size() & 0xff000000) >> 24;
-    czip[1] = (bazip.size() & 0x00ff0000) >> 16;
-    czip[2] = (bazip.size() & 0x0000ff00) >> 8;
-    czip[3] = (bazip.size() & 0x000000ff);
-    czip += bazip;
-    QByteArray base64_uncompressed = qUncompress(czip);
-
-    if (base64_uncompressed.isEmpty())
+    if (zlib_compression)
     {
-      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Decompression error?");
+      std::vector<Byte> compressed(3 * (in.size() / 4) + 3);
+      Size compressed_size = decodeRaw_(in.c_str(), in.size(), &compressed[0]);
+      // inflate directly into the output vector, growing it on demand
+      byte_count = inflate_(&compressed[0], compressed_size, [&out, element_size](Size min_bytes)
+        {
+          out.resize(min_bytes / element_size + 1);
+          return reinterpret_cast<Byte *>(&out[0]);
+        });
+      if (byte_count % element_size != 0)
+      {
+        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount?");
+      }
     }
-    decompressed.resize(base64_uncompressed.size());
-
-    std::copy(base64_uncompressed.begin(), base64_uncompressed.end(), decompressed.begin());
-
-    void* byte_buffer = reinterpret_cast<void *>(&decompressed[0]);
-    Size buffer_size = decompressed.size();
-
-    const ToType * float_buffer = reinterpret_cast<const ToType *>(byte_buffer);
-    if (buffer_size % element_size != 0)
+    else
     {
-      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount?");
+      // decode directly into the output vector (3 bytes per 4 characters at most)
+      out.resize(3 * (in.size() / 4) / element_size + 1);
+      Byte * bytes = reinterpret_cast<Byte *>(&out[0]);
+      byte_count = decodeRaw_(in.c_str(), in.size(), bytes);
+      // as for a full group of 4 characters, padding characters are decoded to zero bytes
+      const Size padded_count = (byte_count + 2) / 3 * 3;
+      std::fill(bytes + byte_count, bytes + padded_count, Byte(0));
+      byte_count = padded_count;
     }
-    
-    Size float_count = buffer_size / element_size;
-    
+    out.resize(byte_count / element_size);
+
     // change endianness if necessary
-    if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
+    if (!out.empty() &&
+        ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN)))
     {
-      if (element_size == 4) // 32 bit
-      {
-        UInt32 * p = reinterpret_cast<UInt32 *>(byte_buffer);
-        std::transform(p, p + float_count, p, endianize32);
-      }
-      else // 64 bit
-      {
-        UInt64 * p = reinterpret_cast<UInt64 *>(byte_buffer);
-        std::transform(p, p + float_count, p, endianize64);
-      }
+      swapByteOrder_(&out[0], out.size(), element_size);
     }
+  }
 
-    // copy values
-    out.assign(float_buffer, float_buffer + float_count);
+  template <typename ToType>
+  void Base64::decodeCompressed_(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out)
+  {
+    out.clear();
+    if (in == "") return;
+
+    decodeBytes_(in, from_byte_order, out, true);
   }
 
   template <typename ToType>
@@ -421,104 +341,7 @@ private:
       throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Malformed base64 input, length is not a multiple of 4.");
     }
 
-    Size src_size = in.size();
-    // last one or two '=' are skipped if contained
-    int padding = 0;
-    if (in[src_size - 1] == '=') padding++;
-    if (in[src_size - 2] == '=') padding++;
-
-    src_size -= padding;
-
-    UInt a;
-    UInt b;
-
-    UInt offset = 0;
-    int inc = 1;
-    UInt written = 0;
-
-    const Size element_size = sizeof(ToType);
-
-    // enough for either float or double
-    char element[8] = "\x00\x00\x00\x00\x00\x00\x00";
-
-    // Parse little endian data in big endian OpenMS (or other way round)
-    if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || 
-       (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
-    {
-      offset = (element_size - 1);              // other endian
-      inc = -1;
-    }
-    else
-    {
-      offset = 0;
-      inc = 1;
-    }
-
-    //reserve enough space in the output vector
-    out.reserve((UInt)(std::ceil((4.0 * src_size) / 3.0) + 6.0));
-
-    // sort all read bytes correctly into a char[4] (double) or
-    // char[8] (float) and push_back when necessary.
-    for (Size i = 0; i < src_size; i += 4)
-    {
-      // decode 4 Base64-Chars to 3 Byte
-      // -------------------------------
-
-      // decode the first two chars
-      a = decoder_[(int)in[i] - 43] - 62;
-      b = decoder_[(int)in[i + 1] - 43] - 62;
-      if (i + 1 >= src_size)
-      {
-        b = 0;
-      }
-      // write first byte (6 bits from a and 2 highest bits from b)
-      element[offset] = (unsigned char) ((a << 2) | (b >> 4));
-      written++;
-      offset = (offset + inc) % element_size;
-
-      if (written % element_size == 0)
-      {
-        ToType * to_type = reinterpret_cast<ToType *>(&element[0]);
-        out.push_back((*to_type));
-        strcpy(element, "");
-      }
-
-      // decode the third char
-      a = decoder_[(int)in[i + 2] - 43] - 62;
-      if (i + 2 >= src_size)
-      {
-        a = 0;
-      }
-      // write second byte (4 lowest bits from b and 4 highest bits from a)
-      element[offset] = (unsigned char) (((b & 15) << 4) | (a >> 2));
-      written++;
-      offset = (offset + inc) % element_size;
-
-      if (written % element_size == 0)
-      {
-        ToType * to_type = reinterpret_cast<ToType *>(&element[0]);
-        out.push_back((*to_type));
-        strcpy(element, "");
-      }
-
-      // decode the fourth char
-      b = decoder_[(int)in[i + 3] - 43] - 62;
-      if (i + 3 >= src_size)
-      {
-        b = 0;
-      }
-      // write third byte (2 lowest bits from a and 6 bits from b)
-      element[offset] = (unsigned char) (((a & 3) << 6) | b);
-      written++;
-      offset = (offset + inc) % element_size;
-
-      if (written % element_size == 0)
-      {
-        ToType * to_type = reinterpret_cast<ToType *>(&element[0]);
-        out.push_back((*to_type));
-        strcpy(element, "");
-      }
-    }
+    decodeBytes_(in, from_byte_order, out, false);
   }
 
   template <typename FromType>
@@ -528,104 +351,14 @@ private:
     if (in.empty())
       return;
 
-    //initialize
     const Size element_size = sizeof(FromType);
-    const Size input_bytes = element_size * in.size();
-    String compressed;
-    Byte * it;
-    Byte * end;
     //Change endianness if necessary
     if ((OPENMS_IS_BIG_ENDIAN && to_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && to_byte_order == Base64::BYTEORDER_BIGENDIAN))
     {
-      if (element_size == 4)
-      {
-        for (Size i = 0; i < in.size(); ++i)
-        {
-          UInt32 tmp = in[i];
-          tmp = endianize32(tmp);
-          in[i] = tmp;
-        }
-      }
-      else
-      {
-        for (Size i = 0; i < in.size(); ++i)
-        {
-          UInt64 tmp = in[i];
-          tmp = endianize64(tmp);
-          in[i] = tmp;
-        }
-      }
-    }
-
-    //encode with compression (use Qt because of zlib support)
-    if (zlib_compression)
-    {
-      unsigned long sourceLen =   (unsigned long)input_bytes;
-      unsigned long compressed_length =       //compressBound((unsigned long)in.size());
-                                        sourceLen + (sourceLen >> 12) + (sourceLen >> 14) + 11; // taken from zlib's compress.c, as we cannot use compressBound*
-
-      compressed.resize(compressed_length);
-      while (compress(reinterpret_cast<Bytef *>(&compressed[0]), &compressed_length, reinterpret_cast<Bytef *>(&in[0]), (unsigned long)input_bytes) != Z_OK)
-      {
-        compressed_length *= 2;
-        compressed.reserve(compressed_length);
-      }
-
-
-      String(compressed).swap(compressed);
-      it = reinterpret_cast<Byte *>(&compressed[0]);
-      end = it + compressed_length;
-      out.resize((Size)ceil(compressed_length / 3.) * 4);     //resize output array in order to have enough space for all characters
-    }
-    //encode without compression
-    else
-    {
-      out.resize((Size)ceil(input_bytes / 3.) * 4);     //resize output array in order to have enough space for all characters
-      it = reinterpret_cast<Byte *>(&in[0]);
-      end = it + input_bytes;
-    }
-
-    Byte * to = reinterpret_cast<Byte *>(&out[0]);
-
-
-    Size written = 0;
-
-    while (it != end)
-    {
-      Int int_24bit = 0;
-      Int padding_count = 0;
-
-      // construct 24-bit integer from 3 bytes
-      for (Size i = 0; i < 3; i++)
-      {
-        if (it != end)
-        {
-          int_24bit |= *it++ << ((2 - i) * 8);
-        }
-        else
-        {
-          padding_count++;
-        }
-      }
-
-      // write out 4 characters
-      for (Int i = 3; i >= 0; i--)
-      {
-        to[i] = encoder_[int_24bit & 0x3F];
-        int_24bit >>= 6;
-      }
-
-      // fixup for padding
-      if (padding_count > 0)
-        to[3] = '=';
-      if (padding_count > 1)
-        to[2] = '=';
-
-      to += 4;
-      written += 4;
+      swapByteOrder_(&in[0], in.size(), element_size);
     }
 
-    out.resize(written);         //no more space is needed
+    encodeBytes_(reinterpret_cast<const Byte *>(&in[0]), element_size * in.size(), out, zlib_compression);
   }
 
   template <typename ToType>
@@ -642,115 +375,37 @@ private:
   }
 
   template <typename ToType>
-  void Base64::decodeIntegersCompressed_(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out)
+  void Base64::decodeIntegersBytes_(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out, bool zlib_compression)
   {
-    out.clear();
-    if (in == "")
-      return;
+    // the data is stored as signed integers of the same size as ToType
+    typedef typename std::conditional<sizeof(ToType) == 4, Int32, Int64>::type IntType;
 
-    void * byte_buffer;
-    Size buffer_size;
-    const Size element_size = sizeof(ToType);
-
-    String decompressed;
-
-    QByteArray qt_byte_array = QByteArray::fromRawData(in.c_str(), (int) in.size());
-    QByteArray bazip = QByteArray::fromBase64(qt_byte_array);
-    QByteArray czip;
-    czip.resize(4);
-    czip[0] = (bazip.size() & 0xff000000) >> 24;
-    czip[1] = (bazip.size() & 0x00ff0000) >> 16;
-    czip[2] = (bazip.size() & 0x0000ff00) >> 8;
-    czip[3] = (bazip.size() & 0x000000ff);
-    czip += bazip;
-    QByteArray base64_uncompressed = qUncompress(czip);
-    if (base64_uncompressed.isEmpty())
+    if (std::is_integral<ToType>::value)
     {
-      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Decompression error?");
-    }
-    decompressed.resize(base64_uncompressed.size());
-
-    std::copy(base64_uncompressed.begin(), base64_uncompressed.end(), decompressed.begin());
-
-    byte_buffer = reinterpret_cast<void *>(&decompressed[0]);
-    buffer_size = decompressed.size();
-
-    //change endianness if necessary
-    if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
-    {
-      if (element_size == 4)
-      {
-        const Int32 * float_buffer = reinterpret_cast<const Int32 *>(byte_buffer);
-        if (buffer_size % element_size != 0)
-          throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount?");
-        Size float_count = buffer_size / element_size;
-        UInt32 * p = reinterpret_cast<UInt32 *>(byte_buffer);
-        std::transform(p, p + float_count, p, endianize32);
-
-        out.resize(float_count);
-        // do NOT use assign here, as it will give a lot of type conversion warnings on VS compiler
-        for (Size i = 0; i < float_count; ++i)
-        {
-          out[i] = (ToType) * float_buffer;
-          ++float_buffer;
-        }
-      }
-      else
-      {
-        const Int64 * float_buffer = reinterpret_cast<const Int64 *>(byte_buffer);
-
-        if (buffer_size % element_size != 0)
-          throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount?");
-
-        Size float_count = buffer_size / element_size;
-
-        UInt64 * p = reinterpret_cast<UInt64 *>(byte_buffer);
-        std::transform(p, p + float_count, p, endianize64);
-
-        out.resize(float_count);
-        // do NOT use assign here, as it will give a lot of type conversion warnings on VS compiler
-        for (Size i = 0; i < float_count; ++i)
-        {
-          out[i] = (ToType) * float_buffer;
-          ++float_buffer;
-        }
-      }
+      // same bit pattern, decode directly into the output vector
+      decodeBytes_(in, from_byte_order, out, zlib_compression);
     }
     else
     {
-      if (element_size == 4)
-      {
-        const Int * float_buffer = reinterpret_cast<const Int *>(byte_buffer);
-        if (buffer_size % element_size != 0)
-          throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount while decoding?");
-
-        Size float_count = buffer_size / element_size;
-        out.resize(float_count);
-        // do NOT use assign here, as it will give a lot of type conversion warnings on VS compiler
-        for (Size i = 0; i < float_count; ++i)
-        {
-          out[i] = (ToType) * float_buffer;
-          ++float_buffer;
-        }
-      }
-      else
+      std::vector<IntType> integers;
+      decodeBytes_(in, from_byte_order, integers, zlib_compression);
+      out.resize(integers.size());
+      // do NOT use assign here, as it will give a lot of type conversion warnings on VS compiler
+      for (Size i = 0; i < integers.size(); ++i)
       {
-        const Int64 * float_buffer = reinterpret_cast<const Int64 *>(byte_buffer);
-
-        if (buffer_size % element_size != 0)
-          throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount while decoding?");
-
-        Size float_count = buffer_size / element_size;
-        out.resize(float_count);
-        // do NOT use assign here, as it will give a lot of type conversion warnings on VS compiler
-        for (Size i = 0; i < float_count; ++i)
-        {
-          out[i] = (ToType) * float_buffer;
-          ++float_buffer;
-        }
+        out[i] = (ToType) integers[i];
       }
     }
+  }
 
+  template <typename ToType>
+  void Base64::decodeIntegersCompressed_(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out)
+  {
+    out.clear();
+    if (in == "")
+      return;
+
+    decodeIntegersBytes_(in, from_byte_order, out, true);
   }
 
   template <typename ToType>
@@ -765,133 +420,7 @@ private:
       return;
     }
 
-    Size src_size = in.size();
-    // last one or two '=' are skipped if contained
-    int padding = 0;
-    if (in[src_size - 1] == '=') padding++;
-    if (in[src_size - 2] == '=') padding++;
-
-    src_size -= padding;
-
-    UInt a;
-    UInt b;
-
-    UInt offset = 0;
-    int inc = 1;
-    UInt written = 0;
-
-    const Size element_size = sizeof(ToType);
-
-    // enough for either float or double
-    char element[8] = "\x00\x00\x00\x00\x00\x00\x00";
-
-    if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
-    {
-      offset = (element_size - 1);              // other endian
-      inc = -1;
-    }
-    else
-    {
-      offset = 0;
-      inc = 1;
-    }
-
-    //reserve enough space in the output vector
-    out.reserve((UInt)(std::ceil((4.0 * src_size) / 3.0) + 6.0));
-
-    // sort all read bytes correctly into a char[4] (double) or
-    // char[8] (float) and push_back when necessary.
-    for (Size i = 0; i < src_size; i += 4)
-    {
-
-      // decode 4 Base64-Chars to 3 Byte
-      // -------------------------------
-
-      // decode the first two chars
-      a = decoder_[(int)in[i] - 43] - 62;
-      b = decoder_[(int)in[i + 1] - 43] - 62;
-      if (i + 1 >= src_size)
-      {
-        b = 0;
-      }
-      // write first byte (6 bits from a and 2 highest bits from b)
-      element[offset] = (unsigned char) ((a << 2) | (b >> 4));
-      written++;
-      offset = (offset + inc) % element_size;
-
-      if (written % element_size == 0)
-      {
-        ToType float_value;
-        if (element_size == 4)
-        {
-          Int32 * value = reinterpret_cast<Int32 *>(&element[0]);
-          float_value = (ToType) * value;
-        }
-        else
-        {
-          Int64 * value = reinterpret_cast<Int64 *>(&element[0]);
-          float_value = (ToType) * value;
-        }
-        out.push_back(float_value);
-        strcpy(element, "");
-      }
-
-      // decode the third char
-      a = decoder_[(int)in[i + 2] - 43] - 62;
-      if (i + 2 >= src_size)
-      {
-        a = 0;
-      }
-      // write second byte (4 lowest bits from b and 4 highest bits from a)
-      element[offset] = (unsigned char) (((b & 15) << 4) | (a >> 2));
-      written++;
-      offset = (offset + inc) % element_size;
-
-      if (written % element_size == 0)
-      {
-        ToType float_value;
-        if (element_size == 4)
-        {
-          Int32 * value = reinterpret_cast<Int32 *>(&element[0]);
-          float_value = (ToType) * value;
-        }
-        else
-        {
-          Int64 * value = reinterpret_cast<Int64 *>(&element[0]);
-          float_value = (ToType) * value;
-        }
-        out.push_back(float_value);
-        strcpy(element, "");
-      }
-
-      // decode the fourth char
-      b = decoder_[(int)in[i + 3] - 43] - 62;
-      if (i + 3 >= src_size)
-      {
-        b = 0;
-      }
-      // write third byte (2 lowest bits from a and 6 bits from b)
-      element[offset] = (unsigned char) (((a & 3) << 6) | b);
-      written++;
-      offset = (offset + inc) % element_size;
-
-      if (written % element_size == 0)
-      {
-        ToType float_value;
-        if (element_size == 4)
-        {
-          Int32 * value = reinterpret_cast<Int32 *>(&element[0]);
-          float_value = (ToType) * value;
-        }
-        else
-        {
-          Int64 * value = reinterpret_cast<Int64 *>(&element[0]);
-          float_value = (ToType) * value;
-        }
-        out.push_back(float_value);
-        strcpy(element, "");
-      }
-    }
+    decodeIntegersBytes_(in, from_byte_order, out, false);
   }
 
 } //namespace OpenMS
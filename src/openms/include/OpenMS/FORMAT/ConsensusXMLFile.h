@@ -73,6 +73,9 @@ public:
     /**
     @brief Loads a consensus map from file and calls updateRanges
 
+    If PeakFileOptions::getFastParsing() is set, the consensus elements are
+    read by a non-validating pull parser in parallel (see loadFast_()).
+
     @exception Exception::FileNotFound is thrown if the file could not be opened
     @exception Exception::ParseError is thrown if an error occurs during parsing
     @exception Exception::MissingInformation is thrown if source files are missing/duplicated or map-IDs are referencing non-existing maps
@@ -105,6 +108,17 @@ protected:
     // Docu in base class
     void characters(const XMLCh* const chars, const XMLSize_t length) override;
 
+    /**
+      @brief Loads the file with the fast pull parser (see PeakFileOptions::setFastParsing())
+
+      The file is memory-mapped and the consensusElementList is parsed in
+      parallel blocks by Internal::XMLPullTokenizer, the rest of the document
+      is parsed by Xerces.
+
+      @return false if the file contains content that the pull parser does not support (nothing was loaded in this case)
+    */
+    bool loadFast_(const String& filename);
+
     /// Writes a peptide identification to a stream (for assigned/unassigned peptide identifications)
     void writePeptideIdentification_(const String& filename, std::ostream& os, const PeptideIdentification& id, const String& tag_name, UInt indentation_level);
 
@@ -0,0 +1,141 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest, Chris Bielow $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+
+#include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSChromatogram.h>
+
+#include <functional>
+#include <vector>
+
+namespace OpenMS
+{
+
+    /**
+      @brief Transforming consumer of MS data which processes batches of spectra/chromatograms in parallel
+
+      Like MSDataTransformingConsumer, but the spectra and chromatograms passed to it are collected
+      in batches. Once a batch is full, the lambda functions are applied to all its elements in parallel
+      and the results are passed on to the next consumer (see Constructor) in their original order.
+      This allows expensive per-spectrum operations (e.g. peak picking) to run on all cores while the data
+      is streamed from and to disc, with at most one batch held in memory.
+
+      Spectra and chromatograms are never reordered relative to each other: consuming a chromatogram
+      first processes all pending spectra and vice versa.
+
+      @note The lambda functions are called concurrently from multiple threads and must be thread-safe.
+      @note Consumed spectra and chromatograms are moved into the batch, i.e. they are left in an unspecified state.
+      @note Call flush() (or destroy this object) before the next consumer is closed to process the last batch.
+    */
+    class OPENMS_DLLAPI MSDataParallelTransformingConsumer :
+      public Interfaces::IMSDataConsumer
+    {
+
+    public:
+
+      /**
+        @brief Constructor
+
+        @param next_consumer Consumer which receives the transformed data (ownership is not transferred)
+        @param batch_size Number of spectra (or chromatograms) processed together. 0 selects a default based on the number of threads.
+      */
+      MSDataParallelTransformingConsumer(Interfaces::IMSDataConsumer* next_consumer, Size batch_size = 0);
+
+      /**
+        @brief Destructor
+
+        Flushes remaining data to the next consumer
+
+        @note It is essential to not delete the underlying next_consumer before
+        deleting this object, otherwise we risk a memory error
+      */
+      ~MSDataParallelTransformingConsumer() override;
+
+      /// passed on to the next consumer
+      void setExpectedSize(Size expectedSpectra, Size expectedChromatograms) override;
+
+      /// passed on to the next consumer
+      void setExperimentalSettings(const ExperimentalSettings& exp) override;
+
+      void consumeSpectrum(SpectrumType& s) override;
+
+      void consumeChromatogram(ChromatogramType& c) override;
+
+      /**
+        @brief Sets the (thread-safe) function to be called for every spectrum
+
+        Pass a nullptr if the spectrum should be left unchanged.
+      */
+      void setSpectraProcessingFunc(std::function<void (SpectrumType&)> f_spec);
+
+      /**
+        @brief Sets the (thread-safe) function to be called for every chromatogram
+
+        Pass a nullptr if the chromatogram should be left unchanged.
+      */
+      void setChromatogramProcessingFunc(std::function<void (ChromatogramType&)> f_chrom);
+
+      /**
+        @brief Processes all pending spectra and chromatograms and passes them on to the next consumer
+
+        If a lambda function throws, the first exception is rethrown after the batch was processed and
+        the data of the batch is discarded.
+      */
+      void flush();
+
+      /// Number of elements processed together
+      Size getBatchSize() const;
+
+    protected:
+
+      /// transform and pass on the pending spectra
+      void flushSpectra_();
+
+      /// transform and pass on the pending chromatograms
+      void flushChromatograms_();
+
+      Interfaces::IMSDataConsumer* next_consumer_;
+      Size batch_size_;
+      std::vector<SpectrumType> spectra_;
+      std::vector<ChromatogramType> chromatograms_;
+      std::function<void (SpectrumType&)> lambda_spec_;
+      std::function<void (ChromatogramType&)> lambda_chrom_;
+    };
+
+} //end namespace OpenMS
+
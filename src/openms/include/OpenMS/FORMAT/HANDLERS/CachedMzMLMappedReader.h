@@ -0,0 +1,244 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <OpenMS/OPENSWATHALGO/DATAACCESS/DataStructures.h>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace OpenMS
+{
+
+namespace Internal
+{
+
+  /**
+    @brief Read-only, memory-mapped access to a cached mzML file
+
+    Maps the binary part of a cached mzML file (the ".mzML.cached" file
+    written by CachedMzMLHandler::writeMemdump) into the address space of the
+    process and provides views on the stored spectra and chromatograms. No
+    data is read when opening the file apart from the record headers needed
+    to build the offset index; the operating system pages in data on demand
+    when a view is accessed. Thus, opening very large cache files is cheap.
+
+    All access functions are const and do not modify any state, the object
+    can therefore be shared between threads without locking (e.g. through a
+    boost::shared_ptr held by multiple SpectrumAccessOpenMSCachedMapped
+    instances).
+
+    @note The binary format stores doubles at arbitrary byte offsets, views
+    therefore expose the raw bytes and read values through memcpy instead of
+    handing out (potentially misaligned) double pointers.
+  */
+  class OPENMS_DLLAPI CachedMzMLMappedReader
+  {
+public:
+
+    /**
+      @brief A view on a single binary data array inside the mapped file
+
+      The view is only valid as long as the CachedMzMLMappedReader it was
+      obtained from is alive.
+    */
+    class OPENMS_DLLAPI DataArrayView
+    {
+public:
+      DataArrayView() :
+        data_(nullptr),
+        size_(0),
+        name_(nullptr),
+        name_size_(0)
+      {
+      }
+
+      DataArrayView(const char* data, Size size, const char* name, Size name_size) :
+        data_(data),
+        size_(size),
+        name_(name),
+        name_size_(name_size)
+      {
+      }
+
+      /// Number of values in the array
+      Size size() const
+      {
+        return size_;
+      }
+
+      /// Whether the array is empty
+      bool empty() const
+      {
+        return size_ == 0;
+      }
+
+      /// Raw (possibly misaligned) pointer to the first value in the mapped file
+      const char* data() const
+      {
+        return data_;
+      }
+
+      /// Value at position @p i (no range check)
+      double operator[](Size i) const
+      {
+        double value;
+        std::memcpy(&value, data_ + i * sizeof(double), sizeof(double));
+        return value;
+      }
+
+      /// Copies all values into @p out (which needs to hold at least size() values)
+      void copyTo(double* out) const
+      {
+        if (size_ > 0) std::memcpy(out, data_, size_ * sizeof(double));
+      }
+
+      /// Name of the array (empty for the two default arrays)
+      std::string getName() const
+      {
+        return std::string(name_, name_size_);
+      }
+
+private:
+      const char* data_;
+      Size size_;
+      const char* name_;
+      Size name_size_;
+    };
+
+    /**
+      @brief A view on a single spectrum or chromatogram
+
+      The first two arrays hold m/z (spectra) or RT (chromatograms) and
+      intensity, any further array holds an additional named data array.
+      MS level and retention time are only stored for spectra and are -1 for
+      chromatograms.
+    */
+    struct RecordView
+    {
+      int ms_level = -1;
+      double rt = -1.0;
+      std::vector<DataArrayView> arrays;
+    };
+
+    /**
+      @brief Maps the cached file and builds the index of all records
+
+      @param filename The binary cache file (ends in .mzML.cached)
+
+      @throws Exception::FileNotFound is thrown if the file does not exist
+      @throws Exception::ParseError is thrown if the file cannot be mapped or is not a valid cached mzML file
+    */
+    explicit CachedMzMLMappedReader(const String& filename);
+
+    /// Destructor (unmaps the file)
+    ~CachedMzMLMappedReader();
+
+    /// Number of spectra in the file
+    Size getNrSpectra() const;
+
+    /// Number of chromatograms in the file
+    Size getNrChromatograms() const;
+
+    /// Name of the mapped file
+    const String& getFilename() const;
+
+    /**
+      @brief Fills @p view with the data of spectrum @p id (no data is copied)
+
+      Passing the same @p view repeatedly avoids any allocation.
+
+      @throws Exception::ParseError is thrown if the record is corrupt
+    */
+    void getSpectrumView(Size id, RecordView& view) const;
+
+    /**
+      @brief Fills @p view with the data of chromatogram @p id (no data is copied)
+
+      @throws Exception::ParseError is thrown if the record is corrupt
+    */
+    void getChromatogramView(Size id, RecordView& view) const;
+
+    /// Copies spectrum @p id into the OpenSwath data structure
+    OpenSwath::SpectrumPtr getSpectrum(Size id) const;
+
+    /// Copies chromatogram @p id into the OpenSwath data structure
+    OpenSwath::ChromatogramPtr getChromatogram(Size id) const;
+
+private:
+
+    /// Not copyable, share via pointer instead
+    CachedMzMLMappedReader(const CachedMzMLMappedReader& rhs) = delete;
+    CachedMzMLMappedReader& operator=(const CachedMzMLMappedReader& rhs) = delete;
+
+    /**
+      @brief Parses the record starting at @p pos
+
+      @param pos Offset of the record in the file
+      @param is_spectrum Whether to expect the spectrum header (MS level and RT)
+      @param view Output view (may be nullptr to only determine the size of the record)
+
+      @return Offset directly after the record
+    */
+    Size parseRecord_(Size pos, bool is_spectrum, RecordView* view) const;
+
+    /// Copies a view into freshly allocated OpenSwath data arrays
+    static void copyArrays_(const RecordView& view, std::vector<OpenSwath::BinaryDataArrayPtr>& arrays);
+
+    String filename_;
+    boost::interprocess::file_mapping file_;
+    boost::interprocess::mapped_region region_;
+
+    /// Start of the mapped file
+    const char* begin_;
+
+    /// End of the data records (the trailing record counts are excluded)
+    Size records_end_;
+
+    std::vector<Size> spectra_index_;
+    std::vector<Size> chrom_index_;
+  };
+
+} // namespace Internal
+} // namespace OpenMS
+
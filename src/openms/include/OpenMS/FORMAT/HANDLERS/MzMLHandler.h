@@ -309,12 +309,33 @@ protected:
                         const Internal::MzMLValidator& validator);
 
 
+      /**
+          @brief Write out a list of elements (spectra or chromatograms) in order and record their offsets
+
+          Calls @p write_element (signature <tt>void(std::ostream&, Size)</tt>)
+          for each element and stores the offset of each element tag
+          together with its id in @p offsets (used for the indexedmzML
+          index).
+
+          If PeakFileOptions::getParallelWrite() is set, elements are encoded
+          in parallel into separate in-memory buffers, in batches of at most
+          PeakFileOptions::getMaxDataPoolSize() elements, and are then written
+          to @p os in their original order. The output is identical to the
+          serial path.
+      */
+      template <typename WriteFunctor>
+      void writeElementsOrdered_(std::ostream& os,
+                                 const std::vector<String>& ids,
+                                 std::vector<std::pair<std::string, Int64> >& offsets,
+                                 int& progress,
+                                 WriteFunctor write_element);
+
       /// Write out a single spectrum
       void writeSpectrum_(std::ostream& os,
                           const SpectrumType& spec,
                           Size spec_idx,
+                          const String& native_id,
                           const Internal::MzMLValidator& validator,
-                          bool renew_native_ids,
                           std::vector<std::vector< ConstDataProcessingPtr > >& dps);
 
       /// Write out a single chromatogram
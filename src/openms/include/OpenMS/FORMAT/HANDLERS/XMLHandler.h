@@ -76,6 +76,14 @@ namespace OpenMS
       // Converts from a narrow-character string to a wide-character string.
       inline XercesString fromNative_(const char* str) const
       {
+        // plain ASCII (tag and attribute names, numbers, ...) is widened
+        // directly, only other strings need the Xerces transcoder
+        const char* end = str;
+        while (*end != 0 && (unsigned char)*end < 128) ++end;
+        if (*end == 0)
+        {
+          return XercesString(str, end);
+        }
         XMLCh* ptr(xercesc::XMLString::transcode(str));
         XercesString result(ptr);
         xercesc::XMLString::release(&ptr);
@@ -91,6 +99,16 @@ namespace OpenMS
       // Converts from a wide-character string to a narrow-character string.
       inline String toNative_(const XMLCh* str) const
       {
+        // fast path for plain ASCII, which is all that the OpenMS formats
+        // contain apart from free text (see appendASCII())
+        const XMLCh* end = str;
+        while (*end != 0 && *end < 128) ++end;
+        if (*end == 0)
+        {
+          String result;
+          appendASCII(str, end - str, result);
+          return result;
+        }
         char* ptr(xercesc::XMLString::transcode(str));
         String result(ptr);
         xercesc::XMLString::release(&ptr);
@@ -459,7 +477,7 @@ protected:
       {
         const XMLCh * val = a.getValue(sm_.convert(name).c_str());
         if (val == nullptr) fatalError(LOAD, String("Required attribute '") + name + "' not present!");
-        return String(sm_.convert(val)).toDouble();
+        return sm_.convert(val).toDouble();
       }
 
       /// Converts an attribute to a DoubleList
@@ -541,7 +559,7 @@ protected:
         const XMLCh * val = a.getValue(sm_.convert(name).c_str());
         if (val != nullptr)
         {
-          value = String(sm_.convert(val)).toDouble();
+          value = sm_.convert(val).toDouble();
           return true;
         }
         return false;
@@ -0,0 +1,165 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+namespace Internal
+{
+
+  /**
+    @brief Minimal non-validating pull tokenizer for the bulk sections of the OpenMS XML formats
+
+    Walks over a character range (e.g. a memory-mapped file) and returns one
+    start or end tag per call to next(). Tag names and attribute values are
+    not copied or transcoded, they point into the input. Empty elements
+    (\<tag/\>) are reported as a start tag followed by an end tag, as a SAX
+    parser would do.
+
+    Only the subset of XML written by the OpenMS writers for their element
+    lists is accepted: elements, attributes, comments and whitespace between
+    tags. Anything else (character data, CDATA sections, processing
+    instructions, DOCTYPE, non-ASCII bytes, character references outside
+    ASCII) as well as malformed markup results in an Exception::ParseError.
+    Callers use this to fall back to the Xerces parser, so that the result
+    never differs from the validating code path.
+
+    The tokenizer holds no global state, several instances can run in
+    parallel on disjoint blocks of the same buffer.
+  */
+  class OPENMS_DLLAPI XMLPullTokenizer
+  {
+public:
+
+    /// Type of the current token
+    enum TokenType
+    {
+      START_TAG,   ///< opening tag (attributes are available)
+      END_TAG,     ///< closing tag (also reported for empty elements)
+      END_OF_INPUT ///< end of the range, all tags were closed
+    };
+
+    /// Constructor for the range [@p begin, @p end)
+    XMLPullTokenizer(const char* begin, const char* end);
+
+    /**
+      @brief Advances to the next start or end tag
+
+      @exception Exception::ParseError is thrown for unsupported or malformed markup and for unbalanced tags
+    */
+    TokenType next();
+
+    /// Returns the number of currently open elements (the current start tag counts as open)
+    Size depth() const;
+
+    /// Returns whether the name of the current tag is @p name
+    bool isTag(const char* name) const;
+
+    /// Returns the name of the current tag
+    String getTag() const;
+
+    /**
+      @brief Assigns the (entity decoded) value of the attribute @p name of the current start tag to @p value
+
+      @return if the attribute was present
+      @exception Exception::ParseError is thrown if the value contains unsupported entities
+    */
+    bool getAttribute(const char* name, String& value) const;
+
+    /**
+      @brief Parses the attribute @p name of the current start tag as a double
+
+      Numbers are parsed with boost::spirit, i.e. independent of the locale
+      and with the same semantics as String::toDouble().
+
+      @return if the attribute was present
+      @exception Exception::ParseError is thrown if the value is not a number
+    */
+    bool getAttribute(const char* name, double& value) const;
+
+    /**
+      @brief Parses the attribute @p name of the current start tag as an integer
+
+      @return if the attribute was present
+      @exception Exception::ParseError is thrown if the value is not an integer
+    */
+    bool getAttribute(const char* name, Int& value) const;
+
+protected:
+
+    /// A character range inside the input
+    struct Range_
+    {
+      const char* begin;
+      const char* end;
+    };
+
+    /// An attribute of the current start tag
+    struct Attribute_
+    {
+      Range_ name;
+      Range_ value;
+    };
+
+    /// Returns the value range of the attribute @p name or nullptr if absent
+    const Range_* findAttribute_(const char* name) const;
+
+    /// Throws an Exception::ParseError at the current position
+    void parseError_(const String& message) const;
+
+    /// Parses the attributes of a start tag, returns whether the tag is empty (\<tag/\>)
+    bool parseAttributes_();
+
+    /// Current position
+    const char* pos_;
+    /// End of the input
+    const char* end_;
+    /// Names of the open elements
+    std::vector<Range_> open_tags_;
+    /// Name of the current tag
+    Range_ tag_;
+    /// Attributes of the current start tag
+    std::vector<Attribute_> attributes_;
+    /// Whether the current start tag is an empty element, i.e. the next token is its end tag
+    bool pending_end_;
+  };
+
+} // namespace Internal
+} // namespace OpenMS
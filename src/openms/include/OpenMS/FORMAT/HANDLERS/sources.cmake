@@ -5,6 +5,7 @@ set(directory include/OpenMS/FORMAT/HANDLERS)
 set(sources_list_h
 AcqusHandler.h
 CachedMzMLHandler.h
+CachedMzMLMappedReader.h
 FidHandler.h
 IndexedMzMLDecoder.h
 IndexedMzMLHandler.h
@@ -25,6 +26,7 @@ ToolDescriptionHandler.h
 TraMLHandler.h
 UnimodXMLHandler.h
 XMLHandler.h
+XMLPullTokenizer.h
 XQuestResultXMLHandler.h
 )
 
@@ -101,6 +101,43 @@ namespace OpenMS
     // load MzTab file
     void load(const String& filename, MzTab& mz_tab);
 
+    /**
+      @brief Receives the content of an mzTab file row by row (see transform())
+
+      All methods do nothing by default, so only the sections of interest
+      need to be handled. Rows are passed as non-const references and may be
+      moved from.
+    */
+    class OPENMS_DLLAPI RowConsumer
+    {
+    public:
+      virtual ~RowConsumer();
+
+      /// Called with the complete meta data section before the first row of any other section (and again at the end of the file if meta data rows followed later)
+      virtual void consumeMetaData(const MzTabMetaData& meta_data);
+
+      virtual void consumeProteinRow(MzTabProteinSectionRow& row);
+      virtual void consumePeptideRow(MzTabPeptideSectionRow& row);
+      virtual void consumePSMRow(MzTabPSMSectionRow& row);
+      virtual void consumeSmallMoleculeRow(MzTabSmallMoleculeSectionRow& row);
+
+      /// Empty (or too short) lines, @p line_number is zero-based
+      virtual void consumeEmptyRow(Size line_number);
+      /// Comment (COM) lines, @p line_number is zero-based
+      virtual void consumeCommentRow(Size line_number, const String& line);
+    };
+
+    /**
+      @brief Reads an mzTab file row by row and passes each row to @p consumer
+
+      In contrast to load(), no MzTab object is built and the file is not
+      held in memory, so memory use does not depend on the number of rows.
+
+      @exception Exception::FileNotFound is thrown if the file could not be opened
+      @exception Exception::ParseError is thrown if a row could not be parsed
+    */
+    void transform(const String& filename, RowConsumer* consumer);
+
   protected:
     bool store_protein_reliability_;
     bool store_peptide_reliability_;
@@ -219,6 +219,10 @@ public:
     Size getMaxDataPoolSize() const;
     /// Set maximal size of the data pool
     void setMaxDataPoolSize(Size size);
+    /// [mzML only!] Whether to encode spectra and chromatograms in parallel when writing (in batches of the maximal data pool size)
+    bool getParallelWrite() const;
+    /// [mzML only!] Set whether to encode spectra and chromatograms in parallel when writing (in batches of the maximal data pool size)
+    void setParallelWrite(bool parallel_write);
     //@}
 
     /// [mzML only!] Whether to use the "selected ion m/z" value as the precursor m/z value (alternative: use the "isolation window target m/z" value)
@@ -227,6 +231,21 @@ public:
     /// [mzML only!] Set whether to use the "selected ion m/z" value as the precursor m/z value (alternative: use the "isolation window target m/z" value)
     void setPrecursorMZSelectedIon(bool choice);
 
+    /**
+        @brief [consensusXML only!] Whether to parse the bulk of the file with the fast pull parser
+
+        The consensus element list is read from a memory-mapped file by a
+        non-validating tokenizer (no transcoding, locale-independent number
+        parsing) in parallel blocks, the rest of the file is still parsed by
+        Xerces. Files with content the fast parser does not handle (e.g.
+        peptide identifications inside consensus elements) are parsed by
+        Xerces completely, i.e. the result is always the same.
+    */
+    bool getFastParsing() const;
+
+    /// [consensusXML only!] Set whether to parse the bulk of the file with the fast pull parser
+    void setFastParsing(bool fast_parsing);
+
     /// do these options skip spectra or chromatograms due to RT or MSLevel filters?
     bool hasFilters();
 
@@ -255,7 +274,9 @@ private:
     MSNumpressCoder::NumpressConfig np_config_int_;
     MSNumpressCoder::NumpressConfig np_config_fda_;
     Size maximal_data_pool_size_;
+    bool parallel_write_;
     bool precursor_mz_selected_ion_;
+    bool fast_parsing_;
   };
 
 } // namespace OpenMS
@@ -0,0 +1,358 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg$
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/KERNEL/Peak1D.h>
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace OpenMS
+{
+  class MSSpectrum;
+
+  /**
+    @brief A peak container storing m/z and intensity in separate contiguous arrays
+
+    MSSpectrum stores its peaks as an array of Peak1D, i.e. m/z and intensity
+    values are interleaved in memory. Algorithms that only look at one of the
+    two dimensions (e.g. binary search on m/z, intensity reductions) therefore
+    read twice the memory they need, and the values cannot be passed to
+    vectorized kernels or foreign code without a copy.
+
+    This class provides the same peak data in a structure-of-arrays (columnar)
+    layout: a std::vector<double> holding all m/z values and a
+    std::vector<float> holding all intensities. getMZData() and
+    getIntensityData() return raw pointers to the columns. Peaks can be
+    accessed and iterated like in MSSpectrum (operator[], begin()/end(),
+    MZBegin(), findNearest(), isSorted(), ...); dereferencing yields a light
+    proxy object offering the Peak1D accessors (getMZ(), getIntensity(),
+    getPosition(), and for mutable access setMZ() and setIntensity()).
+    Generic code templated on the spectrum type, like SpectrumAlignment,
+    thus works on both layouts.
+
+    Only the peaks are stored, meta data (RT, MS level, data arrays, ...)
+    remains with the MSSpectrum the data was taken from.
+
+    @ingroup Kernel
+  */
+  class OPENMS_DLLAPI ColumnarSpectrum
+  {
+public:
+
+    ///@name Type definitions
+    ///@{
+    typedef Peak1D PeakType;
+    typedef PeakType::CoordinateType CoordinateType;
+    typedef PeakType::IntensityType IntensityType;
+    typedef PeakType::PositionType PositionType;
+    ///@}
+
+    /// Read-only proxy for a single peak
+    class ConstPeakRef
+    {
+public:
+      ConstPeakRef(const CoordinateType* mz, const IntensityType* intensity) :
+        mz_(mz),
+        intensity_(intensity)
+      {
+      }
+
+      CoordinateType getMZ() const { return *mz_; }
+      CoordinateType getPos() const { return *mz_; }
+      PositionType getPosition() const { return PositionType(*mz_); }
+      IntensityType getIntensity() const { return *intensity_; }
+
+      /// Conversion to a stand-alone peak
+      operator PeakType() const { return PeakType(PositionType(*mz_), *intensity_); }
+
+protected:
+      const CoordinateType* mz_;
+      const IntensityType* intensity_;
+    };
+
+    /// Mutable proxy for a single peak
+    class PeakRef
+    {
+public:
+      PeakRef(CoordinateType* mz, IntensityType* intensity) :
+        mz_(mz),
+        intensity_(intensity)
+      {
+      }
+
+      /// Assigns the values of @p peak to the referenced peak
+      PeakRef& operator=(const PeakType& peak)
+      {
+        *mz_ = peak.getMZ();
+        *intensity_ = peak.getIntensity();
+        return *this;
+      }
+
+      CoordinateType getMZ() const { return *mz_; }
+      CoordinateType getPos() const { return *mz_; }
+      PositionType getPosition() const { return PositionType(*mz_); }
+      IntensityType getIntensity() const { return *intensity_; }
+      void setMZ(CoordinateType mz) { *mz_ = mz; }
+      void setPos(CoordinateType mz) { *mz_ = mz; }
+      void setIntensity(IntensityType intensity) { *intensity_ = intensity; }
+
+      /// Conversion to a read-only proxy
+      operator ConstPeakRef() const { return ConstPeakRef(mz_, intensity_); }
+
+      /// Conversion to a stand-alone peak
+      operator PeakType() const { return PeakType(PositionType(*mz_), *intensity_); }
+
+protected:
+      CoordinateType* mz_;
+      IntensityType* intensity_;
+    };
+
+    /**
+      @brief Random access iterator over the peaks
+
+      Dereferencing returns a proxy object by value (ConstPeakRef or PeakRef).
+    */
+    template <typename RefType, typename MZPtr, typename IntensityPtr>
+    class IteratorBase
+    {
+public:
+      typedef std::random_access_iterator_tag iterator_category;
+      typedef PeakType value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef RefType reference;
+
+      /// Helper making operator-> work on proxy objects
+      struct pointer
+      {
+        RefType ref;
+        const RefType* operator->() const { return &ref; }
+        RefType* operator->() { return &ref; }
+      };
+
+      IteratorBase() :
+        mz_(nullptr),
+        intensity_(nullptr)
+      {
+      }
+
+      IteratorBase(MZPtr mz, IntensityPtr intensity) :
+        mz_(mz),
+        intensity_(intensity)
+      {
+      }
+
+      /// Conversion from mutable to const iterator
+      template <typename R, typename M, typename I,
+                typename = typename std::enable_if<std::is_convertible<M, MZPtr>::value>::type>
+      IteratorBase(const IteratorBase<R, M, I>& rhs) :
+        mz_(rhs.mzPtr()),
+        intensity_(rhs.intensityPtr())
+      {
+      }
+
+      reference operator*() const { return reference(mz_, intensity_); }
+      pointer operator->() const { return pointer{reference(mz_, intensity_)}; }
+      reference operator[](difference_type n) const { return reference(mz_ + n, intensity_ + n); }
+
+      IteratorBase& operator++() { ++mz_; ++intensity_; return *this; }
+      IteratorBase operator++(int) { IteratorBase tmp(*this); ++(*this); return tmp; }
+      IteratorBase& operator--() { --mz_; --intensity_; return *this; }
+      IteratorBase operator--(int) { IteratorBase tmp(*this); --(*this); return tmp; }
+      IteratorBase& operator+=(difference_type n) { mz_ += n; intensity_ += n; return *this; }
+      IteratorBase& operator-=(difference_type n) { mz_ -= n; intensity_ -= n; return *this; }
+      IteratorBase operator+(difference_type n) const { return IteratorBase(mz_ + n, intensity_ + n); }
+      IteratorBase operator-(difference_type n) const { return IteratorBase(mz_ - n, intensity_ - n); }
+      difference_type operator-(const IteratorBase& rhs) const { return mz_ - rhs.mz_; }
+
+      bool operator==(const IteratorBase& rhs) const { return mz_ == rhs.mz_; }
+      bool operator!=(const IteratorBase& rhs) const { return mz_ != rhs.mz_; }
+      bool operator<(const IteratorBase& rhs) const { return mz_ < rhs.mz_; }
+      bool operator>(const IteratorBase& rhs) const { return mz_ > rhs.mz_; }
+      bool operator<=(const IteratorBase& rhs) const { return mz_ <= rhs.mz_; }
+      bool operator>=(const IteratorBase& rhs) const { return mz_ >= rhs.mz_; }
+
+      /// Pointer into the m/z column
+      MZPtr mzPtr() const { return mz_; }
+      /// Pointer into the intensity column
+      IntensityPtr intensityPtr() const { return intensity_; }
+
+protected:
+      MZPtr mz_;
+      IntensityPtr intensity_;
+    };
+
+    typedef IteratorBase<PeakRef, CoordinateType*, IntensityType*> Iterator;
+    typedef IteratorBase<ConstPeakRef, const CoordinateType*, const IntensityType*> ConstIterator;
+    typedef Iterator iterator;
+    typedef ConstIterator const_iterator;
+    typedef PeakType value_type;
+    typedef Size size_type;
+
+    ///@name Constructors and assignment
+    ///@{
+    /// Default constructor
+    ColumnarSpectrum() = default;
+
+    /// Constructor copying the peaks of @p spectrum
+    explicit ColumnarSpectrum(const MSSpectrum& spectrum);
+
+    /// Copy constructor
+    ColumnarSpectrum(const ColumnarSpectrum&) = default;
+
+    /// Move constructor
+    ColumnarSpectrum(ColumnarSpectrum&&) = default;
+
+    /// Assignment operator
+    ColumnarSpectrum& operator=(const ColumnarSpectrum&) = default;
+
+    /// Move assignment operator
+    ColumnarSpectrum& operator=(ColumnarSpectrum&&) = default;
+
+    /// Replaces the content with the peaks of @p spectrum
+    void assign(const MSSpectrum& spectrum);
+
+    /// Writes the peaks into @p spectrum, replacing its peaks (meta data of @p spectrum is kept)
+    void copyTo(MSSpectrum& spectrum) const;
+    ///@}
+
+    /// Equality operator (compares the peaks only)
+    bool operator==(const ColumnarSpectrum& rhs) const;
+
+    /// Inequality operator
+    bool operator!=(const ColumnarSpectrum& rhs) const
+    {
+      return !(operator==(rhs));
+    }
+
+    ///@name Container interface
+    ///@{
+    Size size() const { return mz_.size(); }
+    bool empty() const { return mz_.empty(); }
+    void clear() { mz_.clear(); intensity_.clear(); }
+    void reserve(Size n) { mz_.reserve(n); intensity_.reserve(n); }
+    void resize(Size n) { mz_.resize(n); intensity_.resize(n); }
+
+    void push_back(const PeakType& peak)
+    {
+      mz_.push_back(peak.getMZ());
+      intensity_.push_back(peak.getIntensity());
+    }
+
+    void emplace_back(CoordinateType mz, IntensityType intensity)
+    {
+      mz_.push_back(mz);
+      intensity_.push_back(intensity);
+    }
+
+    ConstPeakRef operator[](Size i) const { return ConstPeakRef(&mz_[i], &intensity_[i]); }
+    PeakRef operator[](Size i) { return PeakRef(&mz_[i], &intensity_[i]); }
+
+    Iterator begin() { return Iterator(mz_.data(), intensity_.data()); }
+    Iterator end() { return Iterator(mz_.data() + mz_.size(), intensity_.data() + intensity_.size()); }
+    ConstIterator begin() const { return cbegin(); }
+    ConstIterator end() const { return cend(); }
+    ConstIterator cbegin() const { return ConstIterator(mz_.data(), intensity_.data()); }
+    ConstIterator cend() const { return ConstIterator(mz_.data() + mz_.size(), intensity_.data() + intensity_.size()); }
+    ///@}
+
+    ///@name Raw column access
+    ///@{
+    /// Contiguous m/z values (size() elements)
+    const CoordinateType* getMZData() const { return mz_.data(); }
+    CoordinateType* getMZData() { return mz_.data(); }
+
+    /// Contiguous intensity values (size() elements)
+    const IntensityType* getIntensityData() const { return intensity_.data(); }
+    IntensityType* getIntensityData() { return intensity_.data(); }
+
+    /// The m/z column
+    const std::vector<CoordinateType>& getMZArray() const { return mz_; }
+
+    /// The intensity column
+    const std::vector<IntensityType>& getIntensityArray() const { return intensity_; }
+    ///@}
+
+    ///@name Sorting and searching (same semantics as in MSSpectrum)
+    ///@{
+    /// Stable sort of the peaks by ascending m/z
+    void sortByPosition();
+
+    /// Stable sort of the peaks by intensity (ascending, or descending if @p reverse is true)
+    void sortByIntensity(bool reverse = false);
+
+    /// Checks if all peaks are sorted with respect to ascending m/z
+    bool isSorted() const;
+
+    /**
+      @brief Binary search for the peak nearest to a specific m/z
+
+      @exception Exception::Precondition is thrown if the spectrum is empty
+    */
+    Size findNearest(CoordinateType mz) const;
+
+    /// Binary search for the peak nearest to @p mz within +/- @p tolerance, -1 if none
+    Int findNearest(CoordinateType mz, CoordinateType tolerance) const;
+
+    /// Binary search for peak range begin (first peak with m/z >= @p mz)
+    ConstIterator MZBegin(CoordinateType mz) const;
+
+    /// Binary search for peak range end (first peak with m/z > @p mz)
+    ConstIterator MZEnd(CoordinateType mz) const;
+
+    /// Binary search for peak range begin (first peak with m/z >= @p mz)
+    Iterator MZBegin(CoordinateType mz);
+
+    /// Binary search for peak range end (first peak with m/z > @p mz)
+    Iterator MZEnd(CoordinateType mz);
+    ///@}
+
+    /// Index of the peak with the highest intensity (the first one if not unique, 0 for an empty spectrum)
+    Size getBasePeakIndex() const;
+
+    /// Total ion count (sum of all peak intensities)
+    IntensityType getTIC() const;
+
+protected:
+    /// Applies the permutation @p order to both columns
+    void permute_(const std::vector<Size>& order);
+
+    std::vector<CoordinateType> mz_;
+    std::vector<IntensityType> intensity_;
+  };
+
+} // namespace OpenMS
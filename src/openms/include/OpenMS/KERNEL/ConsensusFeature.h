@@ -44,6 +44,8 @@
 
 #include <set>
 
+#include <boost/container/flat_set.hpp>
+
 namespace OpenMS
 {
   class FeatureMap;
@@ -72,7 +74,8 @@ namespace OpenMS
 public:
     ///Type definitions
     //@{
-    typedef std::set<FeatureHandle, FeatureHandle::IndexLess> HandleSetType;
+    /// Handles are kept in a sorted vector (one allocation per consensus feature instead of one per handle)
+    typedef boost::container::flat_set<FeatureHandle, FeatureHandle::IndexLess> HandleSetType;
     typedef HandleSetType::const_iterator const_iterator;
     typedef HandleSetType::iterator iterator;
     typedef HandleSetType::const_reverse_iterator const_reverse_iterator;
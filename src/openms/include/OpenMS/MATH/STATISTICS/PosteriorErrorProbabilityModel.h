@@ -61,6 +61,14 @@ namespace OpenMS
       One can output the fit as a gnuplot formula using getGumbelGnuplotFormula() and getGaussGnuplotFormula() after fitting.
       @note All parameters are stored in GaussFitResult. In the case of the Gumbel distribution x0 and sigma represent the local parameter alpha and the scale parameter beta, respectively.
 
+      For large sets of scores, the EM algorithm can be run on a histogram of the scores instead of on the individual
+      scores (parameter @em number_of_fit_bins). Each non-empty bin is represented by the mean of its scores, and the
+      spread of the scores within a bin enters the variance updates exactly, so only the variation of the posteriors
+      within a bin is neglected. The deviation of the fitted parameters from the exact fit is therefore of second
+      order in the bin width relative to the standard deviations of the components, i.e. O((h / sigma)^2) for bin
+      width h. With 1000 bins over a typical score range, the fitted means and standard deviations differ from the
+      exact fit by much less than 0.1%. Final probabilities are always computed for the individual scores.
+
       @todo test performance and make fitGumbelGauss available via parameters.
       @todo allow charge state based fitting
       @todo allow semi-supervised by using decoy annotations
@@ -252,6 +260,36 @@ public:
       void tryGnuplot(const String& gp_file);
 
 private:
+      /// Scores summarized into equally wide bins for the binned EM fit (see parameter @em number_of_fit_bins)
+      struct ScoreHistogram_
+      {
+        /// mean score of each non-empty bin
+        std::vector<double> means;
+        /// number of scores in each non-empty bin
+        std::vector<double> counts;
+        /// sum of the squared deviations of the scores from the bin mean
+        std::vector<double> squared_deviations;
+      };
+
+      /// summarizes @p x_scores into @p number_of_bins equally wide bins (empty bins are skipped)
+      static void binScores_(const std::vector<double>& x_scores, Size number_of_bins, ScoreHistogram_& histogram);
+
+      /// like computeLLAndIncorrectPosteriorsFromLogDensities, but with the log densities evaluated at the bin means of @p histogram (log likelihood is weighted by the bin counts)
+      double computeLLAndIncorrectPosteriorsFromLogDensities_(
+          const ScoreHistogram_& histogram,
+          const std::vector<double>& incorrect_log_density,
+          const std::vector<double>& correct_log_density,
+          std::vector<double>& incorrect_posterior) const;
+
+      /// like pos_neg_mean_weighted_posteriors, but for the bins of @p histogram
+      std::pair<double, double> pos_neg_mean_weighted_posteriors_(const ScoreHistogram_& histogram,
+                                                                 const std::vector<double>& incorrect_posteriors) const;
+
+      /// like pos_neg_sigma_weighted_posteriors, but for the bins of @p histogram (including the spread of the scores within each bin)
+      std::pair<double, double> pos_neg_sigma_weighted_posteriors_(const ScoreHistogram_& histogram,
+                                                                  const std::vector<double>& incorrect_posteriors,
+                                                                  const std::pair<double, double>& means) const;
+
       /// transform different score types to a range and score orientation that the model can handle (engine string is assumed in upper-case)
       void processOutliers_(std::vector<double>& x_scores, const String& outlier_handling) const;
 
@@ -34,6 +34,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <string>
 
@@ -124,6 +125,11 @@ public:
     /**
       Returns the integer index corresponding to a string. If the string is not
       registered, returns UInt(-1) (= UINT_MAX).
+
+      Indices of registered names never change, so each thread caches the
+      lookups it has done and repeated calls for the same name do not lock.
+      For tight loops, resolve the index once and use the index-based
+      accessors of MetaInfoInterface (e.g. getMetaValue(UInt)).
     */
     UInt getIndex(const String& name) const;
 
@@ -161,6 +167,8 @@ public:
     String getUnit(const String& name) const;
 
 private:
+    /// identifies the current state of this registry for the per-thread caches of getIndex() (read without locking)
+    std::atomic<UInt64> generation_;
     /// internal counter, that stores the next index to assign
     UInt next_index_;
     using MapString2IndexType = std::unordered_map<std::string, UInt>;
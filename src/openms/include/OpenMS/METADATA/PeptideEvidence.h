@@ -37,6 +37,8 @@
 #include <OpenMS/CONCEPT/Types.h>
 #include <OpenMS/DATASTRUCTURES/String.h>
 
+#include <memory>
+
 namespace OpenMS
 {
 
@@ -96,7 +98,15 @@ public:
     /// get the protein accession the peptide matches to. If not available the empty string is returned.
     const String& getProteinAccession() const;
 
-    /// set the protein accession the peptide matches to. If not available set to empty string.
+    /**
+      @brief set the protein accession the peptide matches to. If not available set to empty string.
+
+      Accessions are interned: all evidences with the same accession share a
+      single string, which is released together with the last evidence
+      referring to it. The memory used is bounded by the number of distinct
+      accessions (usually the size of the protein database), not by the number
+      of evidences.
+    */
     void setProteinAccession(const String& s);
 
     /// set the position of the last AA of the peptide in protein coordinates (starting at 0 for the N-terminus). If not available, set to UNKNOWN_POSITION. N-terminal positions must be marked with N_TERMINAL_AA
@@ -124,7 +134,8 @@ public:
     char getAAAfter() const;
 
 protected:
-    String accession_;
+    /// interned protein accession (see setProteinAccession()); a null pointer for the empty accession
+    std::shared_ptr<const String> accession_;
 
     Int start_;
 
@@ -35,6 +35,7 @@
 #pragma once
 
 #include <iosfwd>
+#include <memory>
 #include <vector>
 
 #include <OpenMS/CONCEPT/Types.h>
@@ -280,12 +281,19 @@ public:
     /// returns information on peptides (potentially) identified by this PSM
     const std::vector<PeptideEvidence>& getPeptideEvidences() const;
 
-    /// set information on peptides (potentially) identified by this PSM
+    /**
+      @brief set information on peptides (potentially) identified by this PSM
+
+      Evidence lists are interned: all hits with the same evidences share a
+      single list, which is released together with the last hit referring to
+      it. Setting the complete list at once is therefore preferable to adding
+      the evidences one by one.
+    */
     void setPeptideEvidences(const std::vector<PeptideEvidence>& peptide_evidences);
 
     void setPeptideEvidences(std::vector<PeptideEvidence>&& peptide_evidences);
 
-    /// adds information on a peptide that is (potentially) identified by this PSM
+    /// adds information on a peptide that is (potentially) identified by this PSM (copies the current list, see setPeptideEvidences())
     void addPeptideEvidence(const PeptideEvidence& peptide_evidence);
 
     /// returns the PSM score
@@ -335,8 +343,8 @@ protected:
     /// the charge of the peptide
     Int charge_;
 
-    /// information on the potential peptides observed through this PSM.
-    std::vector<PeptideEvidence> peptide_evidences_;
+    /// information on the potential peptides observed through this PSM (shared between hits, see setPeptideEvidences()); a null pointer for no evidences
+    std::shared_ptr<const std::vector<PeptideEvidence> > peptide_evidences_;
 
     /// annotations of fragments in the corresponding spectrum
     std::vector<PeptideHit::PeakAnnotation> fragment_annotations_;
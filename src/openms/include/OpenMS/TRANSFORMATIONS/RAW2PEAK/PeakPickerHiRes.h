@@ -46,6 +46,10 @@ namespace OpenMS
 {
   class MSChromatogram;
   class OnDiscMSExperiment;
+  namespace Interfaces
+  {
+    class IMSDataConsumer;
+  }
 
   /**
     @brief This class implements a fast peak-picking algorithm best suited for
@@ -131,7 +135,7 @@ public:
 
     /**
      * @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-     * method picks peaks for each scan in the map consecutively. The resulting
+     * method picks peaks for all scans in the map (in parallel). The resulting
      * picked peaks are written to the output map.
      *
      * @param input  input map in profile mode
@@ -142,7 +146,7 @@ public:
 
     /**
      * @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-     * method picks peaks for each scan in the map consecutively. The resulting
+     * method picks peaks for all scans in the map (in parallel). The resulting
      * picked peaks are written to the output map.
      *
      * @param input  input map in profile mode
@@ -159,13 +163,30 @@ public:
 
     /**
       @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-      method picks peaks for each scan in the map consecutively. The resulting
-      picked peaks are written to the output map.
+      method picks peaks for all scans in the map (in parallel, see the
+      consumer variant below). The resulting picked peaks are written to the output map.
 
       Currently we have to give up const-correctness but we know that everything on disc is constant
     */
     void pickExperiment(/* const */ OnDiscMSExperiment& input, PeakMap& output, const bool check_spectrum_type = true) const;
 
+    /**
+      @brief Applies the peak-picking algorithm to a map on disc and streams the picked data into a consumer.
+
+      Spectra are read from disc in batches, picked in parallel and passed on
+      to @p output in their original order (see MSDataParallelTransformingConsumer).
+      Only one batch is held in memory, so files larger than the main memory
+      can be centroided, e.g. by passing a PlainMSDataWritingConsumer. The
+      picked data is identical to the one of the PeakMap variant above.
+
+      @param input  input map in profile mode
+      @param output  consumer receiving the picked spectra and chromatograms
+      @param check_spectrum_type  if set, checks spectrum type and throws an exception if a centroided spectrum is passed
+
+      Currently we have to give up const-correctness but we know that everything on disc is constant
+    */
+    void pickExperiment(/* const */ OnDiscMSExperiment& input, Interfaces::IMSDataConsumer& output, const bool check_spectrum_type = true) const;
+
 protected:
 
     template <typename ContainerType>
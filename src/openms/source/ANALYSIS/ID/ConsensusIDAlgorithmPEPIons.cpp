@@ -61,8 +61,8 @@ namespace OpenMS
     mass_tolerance_ = param_.getValue("mass_tolerance");
     min_shared_ = param_.getValue("min_shared");
 
-    // new parameters may affect the similarity calculation, so clear cache:
-    similarities_.clear();
+    // new parameters may affect the similarity calculation, so reset cache:
+    resetSimilarityCache_();
   }
 
 
@@ -73,8 +73,8 @@ namespace OpenMS
     // order of sequences matters for cache look-up:
     if (seq2 < seq1) std::swap(seq1, seq2); // "operator>" not defined
     pair<AASequence, AASequence> seq_pair = make_pair(seq1, seq2);
-    SimilarityCache::iterator pos = similarities_.find(seq_pair);
-    if (pos != similarities_.end()) return pos->second; // score found in cache
+    double score_sim = 0.0;
+    if (getCachedSimilarity_(seq_pair, score_sim)) return score_sim; // score found in cache
 
     // compare b and y ion series of seq. 1 and seq. 2:
     vector<double> ions1(2 * seq1.size()), ions2(2 * seq2.size());
@@ -134,12 +134,11 @@ namespace OpenMS
       start = lower; // "*it1" is increasing, so lower bounds can't get lower
     }
 
-    double score_sim = 0.0;
     if (matches.size() >= min_shared_)
     {
       score_sim = matches.size() / float(min(ions1.size(), ions2.size()));
     }
-    similarities_[seq_pair] = score_sim; // cache the similarity score
+    setCachedSimilarity_(seq_pair, score_sim); // cache the similarity score
 
     return score_sim;
   }
@@ -35,16 +35,111 @@
 #include <OpenMS/ANALYSIS/ID/ConsensusIDAlgorithmSimilarity.h>
 #include <OpenMS/CONCEPT/LogStream.h>
 
+#include <functional>
+#include <mutex>
+
 using namespace std;
 
 namespace OpenMS
 {
-  ConsensusIDAlgorithmSimilarity::ConsensusIDAlgorithmSimilarity()
+  /**
+    @brief Thread-safe cache of sequence similarities
+
+    Instances applied in parallel look up and store similarities concurrently. A single lock for the whole cache
+    serializes them, so the pairs are distributed over shards by a hash of their residues, each with its own lock.
+  */
+  class ConsensusIDAlgorithmSimilarity::SimilarityCache
+  {
+  public:
+    /// Look up the similarity of a pair of sequences
+    bool find(const pair<AASequence, AASequence>& seq_pair, double& similarity)
+    {
+      Shard_& shard = getShard_(seq_pair);
+      lock_guard<mutex> lock(shard.access);
+      map<pair<AASequence, AASequence>, double>::const_iterator pos = shard.similarities.find(seq_pair);
+      if (pos == shard.similarities.end()) return false;
+      similarity = pos->second;
+      return true;
+    }
+
+    /// Store the similarity of a pair of sequences
+    void insert(const pair<AASequence, AASequence>& seq_pair, double similarity)
+    {
+      Shard_& shard = getShard_(seq_pair);
+      lock_guard<mutex> lock(shard.access);
+      shard.similarities[seq_pair] = similarity;
+    }
+
+  private:
+    struct Shard_
+    {
+      mutex access;
+      map<pair<AASequence, AASequence>, double> similarities;
+    };
+
+    static const Size nr_shards_ = 64;
+
+    /// Equal sequences consist of the same (unique) residue objects, so hashing their addresses is consistent with equality
+    static size_t hashSequence_(const AASequence& seq)
+    {
+      size_t h = seq.size();
+      for (Size i = 0; i < seq.size(); ++i)
+      {
+        h = h * 31 + hash<const void*>()(&seq[i]);
+      }
+      return h;
+    }
+
+    Shard_& getShard_(const pair<AASequence, AASequence>& seq_pair)
+    {
+      return shards_[(hashSequence_(seq_pair.first) * 31 + hashSequence_(seq_pair.second)) % nr_shards_];
+    }
+
+    Shard_ shards_[nr_shards_];
+  };
+
+
+  ConsensusIDAlgorithmSimilarity::ConsensusIDAlgorithmSimilarity() :
+    similarities_(new SimilarityCache())
   {
     setName("ConsensusIDAlgorithmSimilarity"); // DefaultParamHandler
   }
 
 
+  void ConsensusIDAlgorithmSimilarity::shareSimilarityCache(
+    const ConsensusIDAlgorithmSimilarity& other)
+  {
+    if ((getName() != other.getName()) || !(param_ == other.param_))
+    {
+      String msg = "Similarity caches can only be shared between instances of the same algorithm with the same parameters";
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                       msg);
+    }
+    similarities_ = other.similarities_;
+  }
+
+
+  bool ConsensusIDAlgorithmSimilarity::getCachedSimilarity_(
+    const pair<AASequence, AASequence>& seq_pair, double& similarity) const
+  {
+    return similarities_->find(seq_pair, similarity);
+  }
+
+
+  void ConsensusIDAlgorithmSimilarity::setCachedSimilarity_(
+    const pair<AASequence, AASequence>& seq_pair, double similarity)
+  {
+    similarities_->insert(seq_pair, similarity);
+  }
+
+
+  void ConsensusIDAlgorithmSimilarity::resetSimilarityCache_()
+  {
+    // don't clear the old cache, other instances may still use it:
+    similarities_.reset(new SimilarityCache());
+  }
+
+
   void ConsensusIDAlgorithmSimilarity::apply_(
     vector<PeptideIdentification>& ids,
     const map<String, String>& se_info,
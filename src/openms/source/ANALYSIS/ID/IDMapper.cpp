@@ -35,6 +35,9 @@
 #include <OpenMS/ANALYSIS/ID/IDMapper.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 
+#include <algorithm>
+#include <exception>
+
 using namespace std;
 
 namespace OpenMS
@@ -244,37 +247,60 @@ namespace OpenMS
     // keep track of assigned/unassigned precursors
     std::map<Size, Size> assigned_precursors;
 
-    // store which peptides fit which feature (and avoid double entries)
-    // consensusMap -> {peptide_index}
-    vector<set<size_t>> mapping(map.size());
-
-    DoubleList mz_values;
-    double rt_pep;
-    IntList charges;
-
     // for statistics
     Size id_matches_none(0), id_matches_single(0), id_matches_multiple(0);
 
-    // iterate over the peptide IDs
-    for (Size i = 0; i < ids.size(); ++i)
+    // m/z-sorted positions of the consensus features (or of their sub-features):
+    // each ID only needs to be compared to the positions in its m/z tolerance window
+    vector<IndexedPosition_> positions;
+    for (Size cm_index = 0; cm_index < map.size(); ++cm_index)
     {
-      if (ids[i].getHits().empty()) continue;
-
-      getIDDetails_(ids[i], rt_pep, mz_values, charges);
+      if (!measure_from_subelements)
+      {
+        positions.push_back({map[cm_index].getMZ(), map[cm_index].getRT(), map[cm_index].getCharge(), cm_index, 0});
+      }
+      else
+      {
+        Size handle_index = 0;
+        for (ConsensusFeature::HandleSetType::const_iterator it_handle = map[cm_index].getFeatures().begin();
+             it_handle != map[cm_index].getFeatures().end();
+             ++it_handle, ++handle_index)
+        {
+          positions.push_back({it_handle->getMZ(), it_handle->getRT(), it_handle->getCharge(), cm_index, handle_index});
+        }
+      }
+    }
+    std::sort(positions.begin(), positions.end(), [](const IndexedPosition_& a, const IndexedPosition_& b) { return a.mz < b.mz; });
+
+    // for each ID: matching consensus features (in ascending order) and, when
+    // measuring from subelements, the first matching sub-feature of each
+    vector<vector<pair<Size, Size> > > id_matches(ids.size());
+
+    Size errCount = 0;
+    std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)ids.size(); ++i)
+    {
+      // parallel exception catching and re-throwing business
+      if (errCount) continue;
+      try
+      {
+        if (ids[i].getHits().empty()) continue;
 
-      bool id_mapped(false);
+        DoubleList mz_values;
+        double rt_pep;
+        IntList charges;
+        getIDDetails_(ids[i], rt_pep, mz_values, charges);
 
-      // iterate over the features
-      for (Size cm_index = 0; cm_index < map.size(); ++cm_index)
-      {
-        // if set to TRUE, we leave the i_mz-loop as we added the whole ID with all hits
-        bool was_added = false; // was current pep-m/z matched?!
+        // consensus feature -> (first matching m/z value, first matching sub-feature for that value)
+        std::map<Size, pair<Size, Size> > first_match;
+        vector<const IndexedPosition_*> matches;
 
         // iterate over m/z values of pepIds
         for (Size i_mz = 0; i_mz < mz_values.size(); ++i_mz)
         {
-          double mz_pep = mz_values[i_mz];
-
           // charge states to use for checking:
           IntList current_charges;
           if (!ignore_charge_)
@@ -292,59 +318,67 @@ namespace OpenMS
             current_charges.push_back(0); // "not specified" always matches
           }
 
-          //check if we compare distance from centroid or subelements
-          if (!measure_from_subelements)
+          findMatches_(positions, rt_pep, mz_values[i_mz], current_charges, matches);
+          for (const IndexedPosition_* match : matches)
           {
-            if (isMatch_(rt_pep - map[cm_index].getRT(), mz_pep, map[cm_index].getMZ()) && (ignore_charge_ || ListUtils::contains(current_charges, map[cm_index].getCharge())))
+            std::pair<std::map<Size, pair<Size, Size> >::iterator, bool> ins =
+              first_match.insert(make_pair(match->cm_index, make_pair(i_mz, match->handle_index)));
+            if (!ins.second && ins.first->second.first == i_mz)
             {
-              id_mapped = true;
-              was_added = true;
-              map[cm_index].getPeptideIdentifications().push_back(ids[i]);
-              ++assigned_ids[i];
+              ins.first->second.second = std::min(ins.first->second.second, match->handle_index);
             }
           }
-          else
-          {
-            for (ConsensusFeature::HandleSetType::const_iterator it_handle = map[cm_index].getFeatures().begin();
-                 it_handle != map[cm_index].getFeatures().end();
-                 ++it_handle)
-            {
-              if (isMatch_(rt_pep - it_handle->getRT(), mz_pep, it_handle->getMZ())  && (ignore_charge_ || ListUtils::contains(current_charges, it_handle->getCharge())))
-              {
-                id_mapped = true;
-                was_added = true;
-                if (mapping[cm_index].count(i) == 0)
-                {
-                  // Store the map index of the peptide feature in the id the feature was mapped to.
-                  PeptideIdentification id_pep = ids[i];
-                  if (annotate_ids_with_subelements)
-                  {
-                    id_pep.setMetaValue("map_index", it_handle->getMapIndex());
-                  }
-
-                  map[cm_index].getPeptideIdentifications().push_back(id_pep);
-                  ++assigned_ids[i];
-                  mapping[cm_index].insert(i);
-                }
-                break; // we added this peptide already.. no need to check other handles
-              }
-            }
-            // continue to here
-          }
-
-          if (was_added) break;
-
-        } // m/z values to check
+        }
 
-        // break to here
+        for (std::map<Size, pair<Size, Size> >::const_iterator it = first_match.begin(); it != first_match.end(); ++it)
+        {
+          id_matches[i].push_back(make_pair(it->first, it->second.second));
+        }
+      }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical (IDMapper_annotate)
+#endif
+        {
+          if (!errCount) error = std::current_exception();
+          ++errCount;
+        }
+      }
+    }
+    if (error)
+    {
+      std::rethrow_exception(error);
+    }
 
-      } // features
+    // assign the IDs in their original order
+    for (Size i = 0; i < ids.size(); ++i)
+    {
+      if (ids[i].getHits().empty()) continue;
 
       // the id has not been mapped to any consensus feature
-      if (!id_mapped)
+      if (id_matches[i].empty())
       {
         map.getUnassignedPeptideIdentifications().push_back(ids[i]);
         ++id_matches_none;
+        continue;
+      }
+
+      for (const pair<Size, Size>& match : id_matches[i])
+      {
+        ConsensusFeature& cf = map[match.first];
+        if (measure_from_subelements && annotate_ids_with_subelements)
+        {
+          // Store the map index of the peptide feature in the id the feature was mapped to.
+          PeptideIdentification id_pep = ids[i];
+          id_pep.setMetaValue("map_index", (cf.getFeatures().begin() + match.second)->getMapIndex());
+          cf.getPeptideIdentifications().push_back(id_pep);
+        }
+        else
+        {
+          cf.getPeptideIdentifications().push_back(ids[i]);
+        }
+        ++assigned_ids[i];
       }
     } // Identifications
 
@@ -426,50 +460,37 @@ namespace OpenMS
         }
         precursor_empty_id.setIdentifier(empty_protein_id.getIdentifier());
 
-        // iterate over the consensus features
-        for (Size cm_index = 0; cm_index < map.size(); ++cm_index)
+        // charge states to use for checking:
+        IntList current_charges;
+        if (!ignore_charge_)
         {
-          // charge states to use for checking:
-          IntList current_charges;
-          if (!ignore_charge_)
-          {
-            current_charges.push_back(z_p);
-            current_charges.push_back(0); // "not specified" always matches
-          }
+          current_charges.push_back(z_p);
+          current_charges.push_back(0); // "not specified" always matches
+        }
 
-          // check if we compare distance from centroid or subelements
-          if (!measure_from_subelements) // measure from centroid
+        // matching consensus features (or sub-features) in the order of the map
+        vector<const IndexedPosition_*> matches;
+        findMatches_(positions, rt_value, mz_p, current_charges, matches);
+        std::sort(matches.begin(), matches.end(), [](const IndexedPosition_* a, const IndexedPosition_* b)
           {
-            if (isMatch_(rt_value - map[cm_index].getRT(), mz_p, map[cm_index].getMZ()) && (ignore_charge_ || ListUtils::contains(current_charges, map[cm_index].getCharge())))
-            {
-              map[cm_index].getPeptideIdentifications().push_back(precursor_empty_id);
-              ++assigned_precursors[spectrum_index];
-              precursor_mapped = true;
-            }
-          }
-          else // measure from subelements
+            return std::make_pair(a->cm_index, a->handle_index) < std::make_pair(b->cm_index, b->handle_index);
+          });
+
+        for (const IndexedPosition_* match : matches)
+        {
+          ConsensusFeature& cf = map[match->cm_index];
+          if (measure_from_subelements && annotate_ids_with_subelements)
           {
-            for (ConsensusFeature::HandleSetType::const_iterator it_handle = map[cm_index].getFeatures().begin();
-                 it_handle != map[cm_index].getFeatures().end();
-                 ++it_handle)
-            {
-              if (isMatch_(rt_value - it_handle->getRT(), mz_p, it_handle->getMZ())  && (ignore_charge_ || ListUtils::contains(current_charges, it_handle->getCharge())))
-              {
-                if (annotate_ids_with_subelements)
-                {
-                  // store the map index the precursor was mapped to
-                  Size map_index = it_handle->getMapIndex();
-
-                  // we use no undesrscore here to be compatible with linkers
-                  precursor_empty_id.setMetaValue("map_index", map_index);
-                }
-                map[cm_index].getPeptideIdentifications().push_back(precursor_empty_id);
-                ++assigned_precursors[spectrum_index];
-                precursor_mapped = true;
-              }
-            }
+            // store the map index the precursor was mapped to
+            Size map_index = (cf.getFeatures().begin() + match->handle_index)->getMapIndex();
+
+            // we use no undesrscore here to be compatible with linkers
+            precursor_empty_id.setMetaValue("map_index", map_index);
           }
-        } // m/z values to check
+          cf.getPeptideIdentifications().push_back(precursor_empty_id);
+          ++assigned_precursors[spectrum_index];
+          precursor_mapped = true;
+        }
       }
       if (!precursor_mapped) ++spectrum_matches_none;
     }
@@ -854,6 +875,23 @@ namespace OpenMS
     throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "IDMapper::getAbsoluteTolerance_(): illegal internal state of measure_!", String(measure_));
   }
 
+  void IDMapper::findMatches_(const vector<IndexedPosition_>& positions, const double rt, const double mz,
+                              const IntList& charges, vector<const IndexedPosition_*>& matches) const
+  {
+    matches.clear();
+    // slightly widened m/z window, isMatch_() has the final say
+    double mz_tol = fabs(getAbsoluteMZTolerance_(mz)) * (1.0 + 1e-9);
+    vector<IndexedPosition_>::const_iterator it = std::lower_bound(positions.begin(), positions.end(), mz - mz_tol,
+      [](const IndexedPosition_& p, double value) { return p.mz < value; });
+    for (; it != positions.end() && it->mz <= mz + mz_tol; ++it)
+    {
+      if (isMatch_(rt - it->rt, mz, it->mz) && (ignore_charge_ || ListUtils::contains(charges, it->charge)))
+      {
+        matches.push_back(&(*it));
+      }
+    }
+  }
+
   bool IDMapper::isMatch_(const double rt_distance, const double mz_theoretical, const double mz_observed) const
   {
     if (measure_ == MEASURE_PPM)
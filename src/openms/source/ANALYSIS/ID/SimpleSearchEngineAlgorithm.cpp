@@ -60,6 +60,7 @@
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/FORMAT/FASTAFile.h>
 
+#include <OpenMS/KERNEL/ColumnarSpectrum.h>
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/KERNEL/Peak1D.h>
@@ -73,6 +74,9 @@
 
 #include <map>
 #include <algorithm>
+#include <functional>
+#include <limits>
+#include <tuple>
 
 #ifdef _OPENMP
   #include <omp.h>
@@ -146,6 +150,14 @@ namespace OpenMS
     defaults_.setValue("report:top_hits", 1, "Maximum number of top scoring hits per spectrum that are reported.");
     defaults_.setSectionDescription("report", "Reporting Options");
 
+    defaults_.setValue("fragment_index:enabled", "false", "Score spectra via an index of theoretical fragment m/z values instead of scoring every candidate against all spectra with matching precursor mass. The index is built once per protein batch and each spectrum is scored by walking its peaks through it.");
+    defaults_.setValidStrings("fragment_index:enabled", {"true","false"} );
+    defaults_.setValue("fragment_index:min_shared_peaks", 1, "Minimum number of experimental peaks matching indexed fragments of a candidate before it is scored. 1 reports the same hits as the search without index and only skips candidates without any matching peak, which pays off mostly for wide precursor windows. Larger values prune far more candidates but may drop correct hits with few matching fragments.");
+    defaults_.setMinInt("fragment_index:min_shared_peaks", 1);
+    defaults_.setValue("fragment_index:protein_batch_size", 2000, "Number of proteins whose candidate peptides are collected (and indexed, if enabled) at once before all spectra are scored against them. Limits the memory used for the theoretical spectra (also if the index is disabled).");
+    defaults_.setMinInt("fragment_index:protein_batch_size", 1);
+    defaults_.setSectionDescription("fragment_index", "Fragment Ion Index Options");
+
     defaultsToParam_();
   }
 
@@ -180,8 +192,147 @@ namespace OpenMS
 
     decoys_ = param_.getValue("decoys") == "true";
     annotate_psm_ = param_.getValue("annotate:PSM");
+
+    fragment_index_enabled_ = param_.getValue("fragment_index:enabled") == "true";
+    fragment_index_min_shared_peaks_ = param_.getValue("fragment_index:min_shared_peaks");
+    fragment_index_protein_batch_size_ = param_.getValue("fragment_index:protein_batch_size");
   }
 
+  /**
+    @brief Fragment ion index over a batch of candidate peptides
+
+    Candidates are sorted by mass and grouped into blocks of consecutive masses. Per block, the m/z values of all
+    fragments are stored sorted by m/z together with the candidate they belong to, so the candidates sharing
+    peaks with a spectrum are found by a binary search per peak in the blocks covering its precursor mass window.
+    The full theoretical spectra are kept (ordered by candidate) for exact scoring.
+  */
+  struct SimpleSearchEngineAlgorithm::FragmentIndex_
+  {
+    struct Candidate
+    {
+      double mass;
+      StringView sequence;
+      SignedSize peptide_mod_index;
+      Size fragment_begin; ///< first fragment in fragment_mz, fragment_intensity and fragment_ion_type
+      Size fragment_end; ///< one past the last fragment
+    };
+
+    /// number of (mass sorted) candidates sharing one m/z sorted fragment list
+    Size block_size = 1024;
+
+    /// candidates, sorted by mass after build()
+    std::vector<Candidate> candidates;
+
+    /// theoretical spectra of all candidates (sorted by m/z per candidate)
+    std::vector<double> fragment_mz;
+    std::vector<float> fragment_intensity;
+    std::vector<char> fragment_ion_type; ///< see HyperScore::getIonType()
+
+    /// per block: fragment m/z values sorted by m/z and the candidate they belong to
+    std::vector<float> index_mz;
+    std::vector<UInt32> index_candidate;
+    std::vector<Size> block_begin; ///< offset of each block in index_mz and index_candidate (plus end offset)
+
+    void addCandidate(double mass, const StringView& sequence, SignedSize peptide_mod_index, const PeakSpectrum& theo_spectrum)
+    {
+      Candidate c;
+      c.mass = mass;
+      c.sequence = sequence;
+      c.peptide_mod_index = peptide_mod_index;
+      c.fragment_begin = fragment_mz.size();
+      const PeakSpectrum::StringDataArray* ion_names = theo_spectrum.getStringDataArrays().empty() ? nullptr : &theo_spectrum.getStringDataArrays()[0];
+      for (Size i = 0; i != theo_spectrum.size(); ++i)
+      {
+        fragment_mz.push_back(theo_spectrum[i].getMZ());
+        fragment_intensity.push_back(theo_spectrum[i].getIntensity());
+        fragment_ion_type.push_back(ion_names != nullptr ? HyperScore::getIonType((*ion_names)[i]) : 0);
+      }
+      c.fragment_end = fragment_mz.size();
+      candidates.push_back(c);
+    }
+
+    /// append the candidates of another (not yet built) index
+    void append(const FragmentIndex_& other)
+    {
+      const Size offset = fragment_mz.size();
+      for (Candidate c : other.candidates)
+      {
+        c.fragment_begin += offset;
+        c.fragment_end += offset;
+        candidates.push_back(c);
+      }
+      fragment_mz.insert(fragment_mz.end(), other.fragment_mz.begin(), other.fragment_mz.end());
+      fragment_intensity.insert(fragment_intensity.end(), other.fragment_intensity.begin(), other.fragment_intensity.end());
+      fragment_ion_type.insert(fragment_ion_type.end(), other.fragment_ion_type.begin(), other.fragment_ion_type.end());
+    }
+
+    /// sort candidates by mass and (if @p with_fragment_index) create the per block fragment lists
+    void build(bool with_fragment_index)
+    {
+      if (candidates.size() > (Size)std::numeric_limits<UInt32>::max())
+      {
+        throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, candidates.size());
+      }
+
+      // deterministic order, independent of the order candidates were added in
+      std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b)
+        {
+          if (a.mass != b.mass) return a.mass < b.mass;
+          if (a.peptide_mod_index != b.peptide_mod_index) return a.peptide_mod_index < b.peptide_mod_index;
+          return a.sequence < b.sequence;
+        });
+
+      // store fragments in candidate order
+      std::vector<double> mz;
+      std::vector<float> intensity;
+      std::vector<char> ion_type;
+      mz.reserve(fragment_mz.size());
+      intensity.reserve(fragment_mz.size());
+      ion_type.reserve(fragment_mz.size());
+      for (Candidate& c : candidates)
+      {
+        const Size begin = mz.size();
+        mz.insert(mz.end(), fragment_mz.begin() + c.fragment_begin, fragment_mz.begin() + c.fragment_end);
+        intensity.insert(intensity.end(), fragment_intensity.begin() + c.fragment_begin, fragment_intensity.begin() + c.fragment_end);
+        ion_type.insert(ion_type.end(), fragment_ion_type.begin() + c.fragment_begin, fragment_ion_type.begin() + c.fragment_end);
+        c.fragment_end = mz.size();
+        c.fragment_begin = begin;
+      }
+      fragment_mz.swap(mz);
+      fragment_intensity.swap(intensity);
+      fragment_ion_type.swap(ion_type);
+
+      index_mz.clear();
+      index_candidate.clear();
+      block_begin.clear();
+      if (!with_fragment_index) { return; }
+
+      index_mz.reserve(fragment_mz.size());
+      index_candidate.reserve(fragment_mz.size());
+      block_begin.assign(1, 0);
+      std::vector<std::pair<float, UInt32> > block;
+      for (Size first = 0; first < candidates.size(); first += block_size)
+      {
+        const Size last = (std::min)(first + block_size, candidates.size());
+        block.clear();
+        for (Size c = first; c != last; ++c)
+        {
+          for (Size f = candidates[c].fragment_begin; f != candidates[c].fragment_end; ++f)
+          {
+            block.emplace_back((float)fragment_mz[f], (UInt32)c);
+          }
+        }
+        std::sort(block.begin(), block.end());
+        for (const auto& b : block)
+        {
+          index_mz.push_back(b.first);
+          index_candidate.push_back(b.second);
+        }
+        block_begin.push_back(index_mz.size());
+      }
+    }
+  };
+
   // static
   void SimpleSearchEngineAlgorithm::preprocessSpectra_(PeakMap& exp, double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm)
   {
@@ -375,6 +526,125 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
     protein_ids[0].setSearchParameters(std::move(search_parameters));
   }
 
+  void SimpleSearchEngineAlgorithm::scoreFragmentIndex_(const FragmentIndex_& index,
+    const vector<ColumnarSpectrum>& spectra,
+    const vector<vector<double> >& precursor_masses,
+    bool precursor_mass_tolerance_unit_ppm,
+    bool fragment_mass_tolerance_unit_ppm,
+    vector<vector<AnnotatedHit_> >& annotated_hits) const
+  {
+    if (index.candidates.empty()) { return; }
+
+    typedef FragmentIndex_::Candidate Candidate;
+    const double half_precursor_tolerance = 0.5 * precursor_mass_tolerance_ * (precursor_mass_tolerance_unit_ppm ? 1e-6 : 1.0);
+    const double fragment_tolerance = fragment_mass_tolerance_ * (fragment_mass_tolerance_unit_ppm ? 1e-6 : 1.0);
+
+    // each spectrum is processed by exactly one thread, so hits can be collected without locking
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 10)
+#endif
+    for (SignedSize scan_index = 0; scan_index < (SignedSize)spectra.size(); ++scan_index)
+    {
+      const vector<double>& masses = precursor_masses[scan_index];
+      if (masses.empty()) { continue; }
+
+      // range of candidates that may match one of the precursor masses (conservatively widened, the exact test follows)
+      const double min_precursor_mass = *std::min_element(masses.begin(), masses.end());
+      const double max_precursor_mass = *std::max_element(masses.begin(), masses.end());
+      double min_mass, max_mass;
+      if (precursor_mass_tolerance_unit_ppm)
+      {
+        min_mass = min_precursor_mass / (1.0 + half_precursor_tolerance) - 1e-6;
+        max_mass = half_precursor_tolerance < 1.0 ? max_precursor_mass / (1.0 - half_precursor_tolerance) + 1e-6 : std::numeric_limits<double>::max();
+      }
+      else
+      {
+        min_mass = min_precursor_mass - half_precursor_tolerance - 1e-6;
+        max_mass = max_precursor_mass + half_precursor_tolerance + 1e-6;
+      }
+      const Size first = std::lower_bound(index.candidates.begin(), index.candidates.end(), min_mass,
+        [](const Candidate& c, double m) { return c.mass < m; }) - index.candidates.begin();
+      const Size last = std::upper_bound(index.candidates.begin(), index.candidates.end(), max_mass,
+        [](double m, const Candidate& c) { return m < c.mass; }) - index.candidates.begin();
+      if (first >= last) { continue; }
+
+      // number of precursor masses each candidate matches, using the same test as the search without index
+      // (every match yields a hit, e.g. if the spectrum is matched with and without isotope correction)
+      vector<UInt> multiplicity(last - first, 0);
+      bool any_match = false;
+      for (Size c = first; c != last; ++c)
+      {
+        const double mass = index.candidates[c].mass;
+        const double tolerance = precursor_mass_tolerance_unit_ppm ? 0.5 * mass * precursor_mass_tolerance_ * 1e-6 : 0.5 * precursor_mass_tolerance_;
+        for (double precursor_mass : masses)
+        {
+          if (precursor_mass >= mass - tolerance && precursor_mass <= mass + tolerance) { ++multiplicity[c - first]; }
+        }
+        any_match = any_match || multiplicity[c - first] != 0;
+      }
+      if (!any_match) { continue; }
+
+      // count experimental peaks matching indexed fragments of each candidate (if the index was built)
+      const ColumnarSpectrum& exp_spectrum = spectra[scan_index];
+      const double* exp_mz = exp_spectrum.getMZData();
+      const bool use_fragment_index = !index.block_begin.empty();
+      vector<UInt> shared_peaks(use_fragment_index ? last - first : 0, 0);
+      const Size first_block = first / index.block_size;
+      const Size last_block = (last - 1) / index.block_size;
+      for (Size p = 0; use_fragment_index && p != exp_spectrum.size(); ++p)
+      {
+        // window wide enough to contain every fragment HyperScore could match to this peak (plus float precision of the index)
+        const double mz = exp_mz[p];
+        const double window = (fragment_mass_tolerance_unit_ppm ? mz * fragment_tolerance / (1.0 - fragment_tolerance) : fragment_tolerance) * (1.0 + 1e-5)
+          + mz * 1e-6 + 1e-9;
+        const float window_begin = (float)(mz - window);
+        const float window_end = (float)(mz + window);
+        for (Size b = first_block; b <= last_block; ++b)
+        {
+          const Size block_end = index.block_begin[b + 1];
+          Size f = std::lower_bound(index.index_mz.begin() + index.block_begin[b], index.index_mz.begin() + block_end, window_begin) - index.index_mz.begin();
+          for (; f != block_end && index.index_mz[f] <= window_end; ++f)
+          {
+            const Size c = index.index_candidate[f];
+            if (c >= first && c < last) { ++shared_peaks[c - first]; }
+          }
+        }
+      }
+
+      // score preselected candidates
+      vector<AnnotatedHit_>& hits = annotated_hits[scan_index];
+      for (Size c = first; c != last; ++c)
+      {
+        if (multiplicity[c - first] == 0) { continue; }
+        if (use_fragment_index && shared_peaks[c - first] < fragment_index_min_shared_peaks_) { continue; }
+
+        const Candidate& candidate = index.candidates[c];
+        const double score = HyperScore::compute(fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm, exp_spectrum,
+          index.fragment_mz.data() + candidate.fragment_begin, index.fragment_intensity.data() + candidate.fragment_begin,
+          index.fragment_ion_type.data() + candidate.fragment_begin, candidate.fragment_end - candidate.fragment_begin);
+
+        if (score == 0) { continue; } // no hit?
+
+        AnnotatedHit_ ah;
+        ah.sequence = candidate.sequence;
+        ah.peptide_mod_index = candidate.peptide_mod_index;
+        ah.score = score;
+
+        for (UInt m = 0; m != multiplicity[c - first]; ++m)
+        {
+          hits.push_back(ah);
+
+          // prevent vector from growing indefinitly (memory) but don't shrink the vector every time
+          if (hits.size() >= 2 * report_top_hits_)
+          {
+            std::partial_sort(hits.begin(), hits.begin() + report_top_hits_, hits.end(), AnnotatedHit_::hasBetterScore);
+            hits.resize(report_top_hits_);
+          }
+        }
+      }
+    }
+  }
+
   SimpleSearchEngineAlgorithm::ExitCodes SimpleSearchEngineAlgorithm::search(const String& in_mzML, const String& in_db, vector<ProteinIdentification>& protein_ids, vector<PeptideIdentification>& peptide_ids) const
   {
     boost::regex peptide_motif_regex(peptide_motif_);
@@ -456,16 +726,16 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
     param.setValue("add_metainfo", "true");
     spectrum_generator.setParameters(param);
 
+    // columnar copies of the preprocessed spectra: every spectrum is scored against many candidates,
+    // so matching on contiguous m/z and intensity arrays pays off
+    vector<ColumnarSpectrum> spectra_columns;
+    spectra_columns.reserve(spectra.size());
+    for (const PeakSpectrum& s : spectra) { spectra_columns.emplace_back(s); }
+
     // preallocate storage for PSMs
     vector<vector<AnnotatedHit_> > annotated_hits(spectra.size(), vector<AnnotatedHit_>());
     for (auto & a : annotated_hits) { a.reserve(2 * report_top_hits_); }
 
-#ifdef _OPENMP
-    // we want to do locking at the spectrum level so we get good parallelisation 
-    vector<omp_lock_t> annotated_hits_lock(annotated_hits.size());
-    for (size_t i = 0; i != annotated_hits_lock.size(); i++) { omp_init_lock(&(annotated_hits_lock[i])); }
-#endif
-
     startProgress(0, 1, "Load database from FASTA file...");
     vector<FASTAFile::FASTAEntry> fasta_db;
     FASTAFile::load(in_db, fasta_db);
@@ -498,14 +768,21 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
     }
     startProgress(0, fasta_db.size(), "Scoring peptide models against spectra...");
 
-    // lookup for processed peptides. must be defined outside of omp section and synchronized
-    set<StringView> processed_petides;
+    // lookup for processed peptides. must be defined outside of omp section and synchronized.
+    // Sharded by the hash of the peptide sequence so threads rarely wait for the same lock.
+    const Size processed_peptides_shards = 256;
+    vector<set<StringView> > processed_peptides(processed_peptides_shards);
+#ifdef _OPENMP
+    vector<omp_lock_t> processed_peptides_lock(processed_peptides_shards);
+    for (omp_lock_t& l : processed_peptides_lock) { omp_init_lock(&l); }
+#endif
 
     Size count_proteins(0), count_peptides(0);
 
-#pragma omp parallel for schedule(static) default(none) shared(annotated_hits, spectrum_generator, multimap_mass_2_scan_index, fixed_modifications, variable_modifications, fasta_db, digestor, processed_petides, count_proteins, count_peptides, precursor_mass_tolerance_unit_ppm, fragment_mass_tolerance_unit_ppm, peptide_motif_regex, spectra, annotated_hits_lock)
-      for (SignedSize fasta_index = 0; fasta_index < (SignedSize)fasta_db.size(); ++fasta_index)
-      {
+    // digest a protein and generate all modified variants of its (not yet processed) peptides
+    auto digestProtein = [&](SignedSize fasta_index, vector<pair<StringView, vector<AASequence> > >& modified_peptides)
+    {
+      modified_peptides.clear();
 
       #pragma omp atomic
       ++count_proteins;
@@ -526,19 +803,15 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
         // if a peptide motif is provided skip all peptides without match
         if (!peptide_motif_.empty() && !boost::regex_match(current_peptide, peptide_motif_regex)) { continue; }          
       
-        bool already_processed = false;
-        #pragma omp critical (processed_peptides_access)
-        {
-          // peptide (and all modified variants) already processed so skip it
-          if (processed_petides.find(c) != processed_petides.end())
-          {
-            already_processed = true;
-          }
-          else
-          {
-            processed_petides.insert(c);
-          }
-        }
+        // peptide (and all modified variants) already processed so skip it
+        const Size shard = std::hash<std::string>()(current_peptide) % processed_peptides_shards;
+#ifdef _OPENMP
+        omp_set_lock(&(processed_peptides_lock[shard]));
+#endif
+        bool already_processed = !processed_peptides[shard].insert(c).second;
+#ifdef _OPENMP
+        omp_unset_lock(&(processed_peptides_lock[shard]));
+#endif
 
         // skip peptides that have already been processed
         if (already_processed) { continue; }
@@ -546,88 +819,98 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
         #pragma omp atomic
         ++count_peptides;
 
-        vector<AASequence> all_modified_peptides;
-
-        // this critial section is because ResidueDB is not thread safe and new residues are created based on the PTMs
-        #pragma omp critical (residuedb_access)
-        {
-          AASequence aas = AASequence::fromString(current_peptide);
-          ModifiedPeptideGenerator::applyFixedModifications(fixed_modifications, aas);
-          ModifiedPeptideGenerator::applyVariableModifications(variable_modifications, aas, modifications_max_variable_mods_per_peptide_, all_modified_peptides);
-        }
-
-        for (SignedSize mod_pep_idx = 0; mod_pep_idx < (SignedSize)all_modified_peptides.size(); ++mod_pep_idx)
-        {
-          const AASequence& candidate = all_modified_peptides[mod_pep_idx];
-          double current_peptide_mass = candidate.getMonoWeight();
+        modified_peptides.emplace_back(c, vector<AASequence>());
+        vector<AASequence>& all_modified_peptides = modified_peptides.back().second;
 
-          // determine MS2 precursors that match to the current peptide mass
-          multimap<double, Size>::const_iterator low_it;
-          multimap<double, Size>::const_iterator up_it;
+        // no synchronization needed: unmodified sequences only use the (read only) one letter code lookup of ResidueDB
+        // and all modified residues have been created in ResidueDB before (see ModifiedPeptideGenerator::getModifications)
+        AASequence aas = AASequence::fromString(current_peptide);
+        ModifiedPeptideGenerator::applyFixedModifications(fixed_modifications, aas);
+        ModifiedPeptideGenerator::applyVariableModifications(variable_modifications, aas, modifications_max_variable_mods_per_peptide_, all_modified_peptides);
+      }
+    };
 
-          if (precursor_mass_tolerance_unit_ppm) // ppm
-          {
-            low_it = multimap_mass_2_scan_index.lower_bound(current_peptide_mass - 0.5 * current_peptide_mass * precursor_mass_tolerance_ * 1e-6);
-            up_it = multimap_mass_2_scan_index.upper_bound(current_peptide_mass + 0.5 * current_peptide_mass * precursor_mass_tolerance_ * 1e-6);
-          }
-          else // Dalton
-          {
-            low_it = multimap_mass_2_scan_index.lower_bound(current_peptide_mass - 0.5 * precursor_mass_tolerance_);
-            up_it = multimap_mass_2_scan_index.upper_bound(current_peptide_mass + 0.5 * precursor_mass_tolerance_);
-          }
+    // determine MS2 precursors that match to a peptide mass
+    typedef multimap<double, Size>::const_iterator PrecursorIterator;
+    auto matchingPrecursors = [&](double current_peptide_mass) -> pair<PrecursorIterator, PrecursorIterator>
+    {
+      if (precursor_mass_tolerance_unit_ppm) // ppm
+      {
+        return make_pair(multimap_mass_2_scan_index.lower_bound(current_peptide_mass - 0.5 * current_peptide_mass * precursor_mass_tolerance_ * 1e-6),
+                         multimap_mass_2_scan_index.upper_bound(current_peptide_mass + 0.5 * current_peptide_mass * precursor_mass_tolerance_ * 1e-6));
+      }
+      else // Dalton
+      {
+        return make_pair(multimap_mass_2_scan_index.lower_bound(current_peptide_mass - 0.5 * precursor_mass_tolerance_),
+                         multimap_mass_2_scan_index.upper_bound(current_peptide_mass + 0.5 * precursor_mass_tolerance_));
+      }
+    };
 
-          // no matching precursor in data
-          if (low_it == up_it) { continue; }
+    // precursor masses each spectrum is matched with
+    vector<vector<double> > precursor_masses(spectra.size());
+    for (const auto& m : multimap_mass_2_scan_index) { precursor_masses[m.second].push_back(m.first); }
 
-          // create theoretical spectrum
-          PeakSpectrum theo_spectrum;
+    // collect the candidates of a batch of proteins (and index their fragments if enabled), then score
+    // all spectra against them. Each spectrum is scored by one thread, so hits are stored without locking.
+    for (Size batch_begin = 0; batch_begin < fasta_db.size(); batch_begin += fragment_index_protein_batch_size_)
+    {
+      const SignedSize batch_end = (SignedSize)(std::min)(batch_begin + fragment_index_protein_batch_size_, fasta_db.size());
+      FragmentIndex_ index;
 
-          // add peaks for b and y ions with charge 1
-          spectrum_generator.getSpectrum(theo_spectrum, candidate, 1, 1);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+      {
+        FragmentIndex_ thread_index;
+        vector<pair<StringView, vector<AASequence> > > modified_peptides;
 
-          // sort by mz
-          theo_spectrum.sortByPosition();
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+        for (SignedSize fasta_index = (SignedSize)batch_begin; fasta_index < batch_end; ++fasta_index)
+        {
+          digestProtein(fasta_index, modified_peptides);
 
-          for (; low_it != up_it; ++low_it)
+          for (auto const & mp : modified_peptides)
           {
-            const Size& scan_index = low_it->second;
-            const PeakSpectrum& exp_spectrum = spectra[scan_index];
-            // const int& charge = exp_spectrum.getPrecursors()[0].getCharge();
-            const double& score = HyperScore::compute(fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm, exp_spectrum, theo_spectrum);
-
-            if (score == 0) { continue; } // no hit?
-
-            // add peptide hit
-            AnnotatedHit_ ah;
-            ah.sequence = c;
-            ah.peptide_mod_index = mod_pep_idx;
-            ah.score = score;
-
-#ifdef _OPENMP
-            omp_set_lock(&(annotated_hits_lock[scan_index]));
+            for (SignedSize mod_pep_idx = 0; mod_pep_idx < (SignedSize)mp.second.size(); ++mod_pep_idx)
             {
-#endif
-              annotated_hits[scan_index].push_back(ah);
-
-              // prevent vector from growing indefinitly (memory) but don't shrink the vector every time
-              if (annotated_hits[scan_index].size() >= 2 * report_top_hits_)
-              {
-                std::partial_sort(annotated_hits[scan_index].begin(), annotated_hits[scan_index].begin() + report_top_hits_, annotated_hits[scan_index].end(), AnnotatedHit_::hasBetterScore);
-                annotated_hits[scan_index].resize(report_top_hits_); 
-              }
-#ifdef _OPENMP
+              const AASequence& candidate = mp.second[mod_pep_idx];
+              double current_peptide_mass = candidate.getMonoWeight();
+
+              // no matching precursor in data
+              auto precursor_range = matchingPrecursors(current_peptide_mass);
+              if (precursor_range.first == precursor_range.second) { continue; }
+
+              // create theoretical spectrum with b and y ions of charge 1, sorted by m/z
+              PeakSpectrum theo_spectrum;
+              spectrum_generator.getSpectrum(theo_spectrum, candidate, 1, 1);
+              theo_spectrum.sortByPosition();
+              thread_index.addCandidate(current_peptide_mass, mp.first, mod_pep_idx, theo_spectrum);
             }
-            omp_unset_lock(&(annotated_hits_lock[scan_index]));
-#endif
           }
         }
+
+#ifdef _OPENMP
+#pragma omp critical (fragment_index_access)
+#endif
+        index.append(thread_index);
       }
+
+      index.build(fragment_index_enabled_);
+      scoreFragmentIndex_(index, spectra_columns, precursor_masses, precursor_mass_tolerance_unit_ppm, fragment_mass_tolerance_unit_ppm, annotated_hits);
     }
     endProgress();
 
     OPENMS_LOG_INFO << "Proteins: " << count_proteins << endl;
     OPENMS_LOG_INFO << "Peptides: " << count_peptides << endl;
-    OPENMS_LOG_INFO << "Processed peptides: " << processed_petides.size() << endl;
+    Size count_processed_peptides(0);
+    for (const set<StringView>& p : processed_peptides) { count_processed_peptides += p.size(); }
+    OPENMS_LOG_INFO << "Processed peptides: " << count_processed_peptides << endl;
+
+#ifdef _OPENMP
+    for (omp_lock_t& l : processed_peptides_lock) { omp_destroy_lock(&l); }
+#endif
 
     startProgress(0, 1, "Post-processing PSMs...");
     SimpleSearchEngineAlgorithm::postProcessHits_(spectra, 
@@ -684,11 +967,6 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
       }
     } 
 
-#ifdef _OPENMP
-    // free locks
-    for (size_t i = 0; i != annotated_hits_lock.size(); i++) { omp_destroy_lock(&(annotated_hits_lock[i])); }
-#endif
-
     return ExitCodes::EXECUTION_OK;
   }
 
@@ -38,6 +38,12 @@
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
 
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 
 namespace OpenMS
@@ -184,6 +190,36 @@ namespace OpenMS
     // add last partition (a bit more since we use "smaller than" below)
     partition_boundaries.push_back(massrange.back() + 1.0);
 
+    const Size nr_partitions = partition_boundaries.size() - 1;
+
+    // collect the features of partition j from all input maps
+    auto extractPartition = [&](Size j, std::vector<MapType>& tmp_input_maps)
+    {
+      double partition_start = partition_boundaries[j];
+      double partition_end = partition_boundaries[j+1];
+
+      tmp_input_maps.assign(input_maps.size(), MapType());
+      for (size_t k = 0; k < input_maps.size(); k++)
+      {
+        // iterate over all features in the current input map and append
+        // matching features (within the current partition) to the temporary
+        // map
+        for (size_t m = 0; m < input_maps[k].size(); m++)
+        {
+          if (input_maps[k][m].getMZ() >= partition_start &&
+              input_maps[k][m].getMZ() < partition_end)
+          {
+            tmp_input_maps[k].push_back(input_maps[k][m]);
+          }
+        }
+        tmp_input_maps[k].updateRanges();
+      }
+    };
+
+    // Partitions are processed in parallel. Results are collected per
+    // partition and merged in partition order, so the output does not
+    // depend on the number of threads.
+
     // ------------ compute RT transformation models ------------
 
     MapAlignmentAlgorithmKD aligner(input_maps.size(), param_);
@@ -191,33 +227,47 @@ namespace OpenMS
     if (align)
     {
       Size progress = 0;
-      startProgress(0, partition_boundaries.size(), "computing RT transformations");
-      for (size_t j = 0; j < partition_boundaries.size()-1; j++)
+      startProgress(0, nr_partitions, "computing RT transformations");
+      vector<vector<TransformationModel::DataPoints> > partition_fit_data(nr_partitions);
+      Size errCount = 0;
+      std::exception_ptr error;
+#pragma omp parallel for schedule(dynamic, 1)
+      for (SignedSize j = 0; j < (SignedSize)nr_partitions; j++)
       {
-        double partition_start = partition_boundaries[j];
-        double partition_end = partition_boundaries[j+1];
+        // parallel exception catching and re-throwing business
+        if (errCount) continue;
+        try
+        {
+          std::vector<MapType> tmp_input_maps;
+          extractPartition(j, tmp_input_maps);
 
-        std::vector<MapType> tmp_input_maps(input_maps.size());
-        for (size_t k = 0; k < input_maps.size(); k++)
+          // set up kd-tree
+          KDTreeFeatureMaps kd_data(tmp_input_maps, param_);
+          aligner.computeRTFitData(kd_data, partition_fit_data[j]);
+        }
+        catch (...)
         {
-          // iterate over all features in the current input map and append
-          // matching features (within the current partition) to the temporary
-          // map
-          for (size_t m = 0; m < input_maps[k].size(); m++)
+#pragma omp critical (FeatureGroupingAlgorithmKD_group)
           {
-            if (input_maps[k][m].getMZ() >= partition_start &&
-                input_maps[k][m].getMZ() < partition_end)
-            {
-              tmp_input_maps[k].push_back(input_maps[k][m]);
-            }
+            if (!errCount) error = std::current_exception();
+            ++errCount;
           }
-          tmp_input_maps[k].updateRanges();
         }
 
-        // set up kd-tree
-        KDTreeFeatureMaps kd_data(tmp_input_maps, param_);
-        aligner.addRTFitData(kd_data);
-        setProgress(progress++);
+#pragma omp atomic
+        ++progress;
+        IF_MASTERTHREAD
+        {
+          setProgress(progress);
+        }
+      }
+      if (error)
+      {
+        std::rethrow_exception(error);
+      }
+      for (Size j = 0; j < nr_partitions; j++)
+      {
+        aligner.addRTFitData(partition_fit_data[j]);
       }
 
       // fit LOWESS on RT fit data collected across all partitions
@@ -236,41 +286,60 @@ namespace OpenMS
 
     // ------------ run alignment + feature linking on individual partitions ------------
     Size progress = 0;
-    startProgress(0, partition_boundaries.size(), "linking features");
-    for (size_t j = 0; j < partition_boundaries.size()-1; j++)
+    startProgress(0, nr_partitions, "linking features");
+    vector<ConsensusMap> partition_results(nr_partitions);
+    Size errCount = 0;
+    std::exception_ptr error;
+#pragma omp parallel for schedule(dynamic, 1)
+    for (SignedSize j = 0; j < (SignedSize)nr_partitions; j++)
     {
-      double partition_start = partition_boundaries[j];
-      double partition_end = partition_boundaries[j+1];
+      // parallel exception catching and re-throwing business
+      if (errCount) continue;
+      try
+      {
+        std::vector<MapType> tmp_input_maps;
+        extractPartition(j, tmp_input_maps);
 
-      std::vector<MapType> tmp_input_maps(input_maps.size());
-      for (size_t k = 0; k < input_maps.size(); k++)
+        // set up kd-tree
+        KDTreeFeatureMaps kd_data(tmp_input_maps, param_);
+
+        // alignment
+        if (align)
+        {
+          aligner.transform(kd_data);
+        }
+
+        // link features (with a thread-local copy of the distance functor)
+        FeatureDistance feature_distance(feature_distance_);
+        runClustering_(kd_data, feature_distance, partition_results[j]);
+      }
+      catch (...)
       {
-        // iterate over all features in the current input map and append
-        // matching features (within the current partition) to the temporary
-        // map
-        for (size_t m = 0; m < input_maps[k].size(); m++)
+#pragma omp critical (FeatureGroupingAlgorithmKD_group)
         {
-          if (input_maps[k][m].getMZ() >= partition_start &&
-              input_maps[k][m].getMZ() < partition_end)
-          {
-            tmp_input_maps[k].push_back(input_maps[k][m]);
-          }
+          if (!errCount) error = std::current_exception();
+          ++errCount;
         }
-        tmp_input_maps[k].updateRanges();
       }
 
-      // set up kd-tree
-      KDTreeFeatureMaps kd_data(tmp_input_maps, param_);
-
-      // alignment
-      if (align)
+#pragma omp atomic
+      ++progress;
+      IF_MASTERTHREAD
       {
-        aligner.transform(kd_data);
+        setProgress(progress);
       }
-
-      // link features
-      runClustering_(kd_data, out);
-      setProgress(progress++);
+    }
+    if (error)
+    {
+      std::rethrow_exception(error);
+    }
+    for (Size j = 0; j < nr_partitions; j++)
+    {
+      for (ConsensusFeature& feature : partition_results[j])
+      {
+        out.push_back(std::move(feature));
+      }
+      partition_results[j].clear(false);
     }
     endProgress();
 
@@ -289,7 +358,7 @@ namespace OpenMS
     group_(maps, out);
   }
 
-  void FeatureGroupingAlgorithmKD::runClustering_(const KDTreeFeatureMaps& kd_data, ConsensusMap& out)
+  void FeatureGroupingAlgorithmKD::runClustering_(const KDTreeFeatureMaps& kd_data, FeatureDistance& feature_distance, ConsensusMap& out) const
   {
     Size n = kd_data.size();
 
@@ -302,7 +371,7 @@ namespace OpenMS
     set<ClusterProxyKD> potential_clusters;
     vector<ClusterProxyKD> cluster_for_idx(n);
     vector<Int> assigned(n, false);
-    updateClusterProxies_(potential_clusters, cluster_for_idx, update_these, assigned, kd_data);
+    updateClusterProxies_(potential_clusters, cluster_for_idx, update_these, assigned, kd_data, feature_distance);
 
     // pass 2: construct consensus features until all points assigned.
     while (!potential_clusters.empty())
@@ -312,7 +381,7 @@ namespace OpenMS
 
       // compile the actual list of sub feature indices for cluster with center i
       vector<Size> cf_indices;
-      computeBestClusterForCenter_(i, cf_indices, assigned, kd_data);
+      computeBestClusterForCenter_(i, cf_indices, assigned, kd_data, feature_distance);
 
       // add consensus feature
       addConsensusFeature_(cf_indices, kd_data, out);
@@ -340,7 +409,7 @@ namespace OpenMS
       }
 
       // now that the points are marked assigned, update the neighborhoods of their neighbors
-      updateClusterProxies_(potential_clusters, cluster_for_idx, update_these, assigned, kd_data);
+      updateClusterProxies_(potential_clusters, cluster_for_idx, update_these, assigned, kd_data, feature_distance);
     }
   }
 
@@ -350,14 +419,15 @@ namespace OpenMS
                                                          vector<ClusterProxyKD>& cluster_for_idx,
                                                          const set<Size>& update_these,
                                                          const vector<Int>& assigned,
-                                                         const KDTreeFeatureMaps& kd_data)
+                                                         const KDTreeFeatureMaps& kd_data,
+                                                         FeatureDistance& feature_distance) const
   {
     for (set<Size>::const_iterator it = update_these.begin(); it != update_these.end(); ++it)
     {
       Size i = *it;
       const ClusterProxyKD& old_proxy = cluster_for_idx[i];
       vector<Size> unused;
-      ClusterProxyKD new_proxy = computeBestClusterForCenter_(i, unused, assigned, kd_data);
+      ClusterProxyKD new_proxy = computeBestClusterForCenter_(i, unused, assigned, kd_data, feature_distance);
 
       // only need to update if size and/or average distance have changed
       if (new_proxy != old_proxy)
@@ -369,7 +439,7 @@ namespace OpenMS
     }
   }
 
-  ClusterProxyKD FeatureGroupingAlgorithmKD::computeBestClusterForCenter_(Size i, vector<Size>& cf_indices, const vector<Int>& assigned, const KDTreeFeatureMaps& kd_data) const
+  ClusterProxyKD FeatureGroupingAlgorithmKD::computeBestClusterForCenter_(Size i, vector<Size>& cf_indices, const vector<Int>& assigned, const KDTreeFeatureMaps& kd_data, FeatureDistance& feature_distance) const
   {
     //Parameters how to use charge/adduct information
     String merge_charge(param_.getValue("link:charge_merging").toString());
@@ -471,8 +541,7 @@ namespace OpenMS
       Size best_index = numeric_limits<Size>::max();
       for (vector<Size>::const_iterator c_it = candidates.begin(); c_it != candidates.end(); ++c_it)
       {
-        double dist = const_cast<FeatureDistance&>(feature_distance_)(*(kd_data.feature(*c_it)),
-                                                                      *(kd_data.feature(i))).second;
+        double dist = feature_distance(*(kd_data.feature(*c_it)), *(kd_data.feature(i))).second;
 
         if (dist < min_dist)
         {
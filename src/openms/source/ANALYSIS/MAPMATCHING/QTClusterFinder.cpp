@@ -37,6 +37,12 @@
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/KERNEL/FeatureHandle.h>
 
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 // #define DEBUG_QTCLUSTERFINDER
 
 using std::list;
@@ -152,35 +158,79 @@ namespace OpenMS
       // add last partition (a bit more since we use "smaller than" below)
       partition_boundaries.push_back(massrange.back() + 1.0);
 
+      // partitions are clustered in parallel: clustering keeps its state in
+      // member variables, so each partition gets its own finder; the results
+      // are merged in partition order afterwards
+      const Size nr_partitions = partition_boundaries.size() - 1;
+      std::vector<ConsensusMap> partition_results(nr_partitions);
+
       ProgressLogger logger;
       Size progress = 0;
       logger.setLogType(ProgressLogger::CMD);
-      logger.startProgress(0, partition_boundaries.size(), "Linking features");
-      for (size_t j = 0; j < partition_boundaries.size()-1; j++)
-      {
-        double partition_start = partition_boundaries[j];
-        double partition_end = partition_boundaries[j+1];
+      logger.startProgress(0, nr_partitions, "Linking features");
 
-        std::vector<MapType> tmp_input_maps(input_maps.size());
-        for (size_t k = 0; k < input_maps.size(); k++)
+      size_t errCount = 0;
+      std::exception_ptr error;
+#pragma omp parallel for schedule(dynamic, 1)
+      for (SignedSize j = 0; j < (SignedSize)nr_partitions; j++)
+      {
+        // parallel exception catching and re-throwing business
+        if (errCount) continue; // no need to link further if already an error was encountered
+        try
         {
-          // iterate over all features in the current input map and append
-          // matching features (within the current partition) to the temporary
-          // map
-          for (size_t m = 0; m < input_maps[k].size(); m++)
+          double partition_start = partition_boundaries[j];
+          double partition_end = partition_boundaries[j+1];
+
+          std::vector<MapType> tmp_input_maps(input_maps.size());
+          for (size_t k = 0; k < input_maps.size(); k++)
           {
-            if (input_maps[k][m].getMZ() >= partition_start && 
-                input_maps[k][m].getMZ() < partition_end)
+            // iterate over all features in the current input map and append
+            // matching features (within the current partition) to the temporary
+            // map
+            for (size_t m = 0; m < input_maps[k].size(); m++)
             {
-              tmp_input_maps[k].push_back(input_maps[k][m]);
+              if (input_maps[k][m].getMZ() >= partition_start && 
+                  input_maps[k][m].getMZ() < partition_end)
+              {
+                tmp_input_maps[k].push_back(input_maps[k][m]);
+              }
             }
+            tmp_input_maps[k].updateRanges();
+          }
+
+          // run algo on current partition
+          QTClusterFinder partition_finder;
+          partition_finder.setParameters(param_);
+          partition_finder.run_internal_(tmp_input_maps, partition_results[j], false);
+        }
+        catch (...)
+        {
+#pragma omp critical (QTClusterFinder_run)
+          {
+            if (!errCount) error = std::current_exception();
+            ++errCount;
           }
-          tmp_input_maps[k].updateRanges();
         }
 
-        // run algo on current partition
-        run_internal_(tmp_input_maps, result_map, false);
-        logger.setProgress(progress++);
+#pragma omp atomic
+        ++progress;
+        IF_MASTERTHREAD
+        {
+          logger.setProgress(progress);
+        }
+      }
+      if (errCount != 0)
+      {
+        std::rethrow_exception(error);
+      }
+
+      for (Size j = 0; j < nr_partitions; j++)
+      {
+        for (ConsensusFeature& feature : partition_results[j])
+        {
+          result_map.push_back(std::move(feature));
+        }
+        partition_results[j].clear(false);
       }
 
       logger.endProgress();
@@ -37,11 +37,146 @@
 #include <OpenMS/DATASTRUCTURES/String.h>
 
 #include <OpenMS/CONCEPT/Exception.h>
-#include <iostream>
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace OpenMS
 {
 
+  /**
+    @brief Index of extraction coordinates by their RT windows
+
+    Coordinates without RT restriction (rt_end - rt_start <= 0) are extracted
+    from every spectrum. The RT range spanned by all other coordinates is
+    divided into bins (of about the median window width) and each coordinate
+    is registered in every bin its window overlaps, so that a query only tests
+    the coordinates of a single bin. Windows wider than a few bins are kept in
+    a separate list that is tested on every query instead, so the memory used
+    by the bins stays linear in the number of coordinates. All lists are in
+    coordinate (i.e. m/z) order.
+  */
+  class ChromatogramExtractorAlgorithm::RTIndex_
+  {
+public:
+    explicit RTIndex_(const std::vector<ExtractionCoordinates>& coordinates) :
+      coordinates_(coordinates),
+      rt_min_(std::numeric_limits<double>::max()),
+      rt_max_(-std::numeric_limits<double>::max()),
+      bin_width_(1.0)
+    {
+      std::vector<double> widths;
+      for (Size k = 0; k < coordinates.size(); ++k)
+      {
+        const double width = coordinates[k].rt_end - coordinates[k].rt_start;
+        if (width > 0)
+        {
+          widths.push_back(width);
+          rt_min_ = (std::min)(rt_min_, coordinates[k].rt_start);
+          rt_max_ = (std::max)(rt_max_, coordinates[k].rt_end);
+        }
+        else
+        {
+          unrestricted_.push_back(k);
+        }
+      }
+      if (widths.empty())
+      {
+        return;
+      }
+
+      std::nth_element(widths.begin(), widths.begin() + widths.size() / 2, widths.end());
+      bin_width_ = widths[widths.size() / 2];
+      // no more bins than restricted coordinates
+      double nr_bins = std::floor((rt_max_ - rt_min_) / bin_width_) + 1;
+      if (nr_bins > widths.size())
+      {
+        nr_bins = widths.size();
+        bin_width_ = (rt_max_ - rt_min_) / nr_bins;
+      }
+      bins_.resize((Size)nr_bins);
+
+      for (Size k = 0; k < coordinates.size(); ++k)
+      {
+        if (coordinates[k].rt_end - coordinates[k].rt_start > 0)
+        {
+          const Size first = bin_(coordinates[k].rt_start);
+          const Size last = bin_(coordinates[k].rt_end);
+          if (last - first >= max_bins_per_window_)
+          {
+            wide_.push_back(k);
+            continue;
+          }
+          for (Size b = first; b <= last; ++b)
+          {
+            bins_[b].push_back(k);
+          }
+        }
+      }
+    }
+
+    /// Returns the (sorted) indices of all coordinates to extract at retention time @p rt; @p buffer is used as storage if necessary
+    const std::vector<Size>& query(double rt, std::vector<Size>& buffer) const
+    {
+      if (bins_.empty() || rt < rt_min_ || rt > rt_max_)
+      {
+        return unrestricted_;
+      }
+
+      // merge the coordinates of the bin and the wide coordinates whose window contains rt with the unrestricted ones
+      buffer.clear();
+      appendContaining_(bins_[bin_(rt)], rt, buffer);
+      const Size nr_bin_matches = buffer.size();
+      appendContaining_(wide_, rt, buffer);
+      std::inplace_merge(buffer.begin(), buffer.begin() + nr_bin_matches, buffer.end());
+      const Size nr_matches = buffer.size();
+      buffer.insert(buffer.end(), unrestricted_.begin(), unrestricted_.end());
+      std::inplace_merge(buffer.begin(), buffer.begin() + nr_matches, buffer.end());
+      return buffer;
+    }
+
+private:
+    /// Windows covering more bins than this are not binned but tested on every query
+    static const Size max_bins_per_window_ = 4;
+
+    /// Appends the coordinates of @p candidates whose RT window contains @p rt to @p buffer
+    void appendContaining_(const std::vector<Size>& candidates, double rt, std::vector<Size>& buffer) const
+    {
+      for (std::vector<Size>::const_iterator it = candidates.begin(); it != candidates.end(); ++it)
+      {
+        if (rt >= coordinates_[*it].rt_start && rt <= coordinates_[*it].rt_end)
+        {
+          buffer.push_back(*it);
+        }
+      }
+    }
+
+    /// Bin of retention time @p rt (monotonic in @p rt)
+    Size bin_(double rt) const
+    {
+      const double pos = (rt - rt_min_) / bin_width_;
+      if (pos <= 0)
+      {
+        return 0;
+      }
+      return pos >= bins_.size() ? bins_.size() - 1 : (Size)pos;
+    }
+
+    const std::vector<ExtractionCoordinates>& coordinates_;
+    double rt_min_;
+    double rt_max_;
+    double bin_width_;
+    std::vector<Size> unrestricted_;
+    std::vector<Size> wide_;
+    std::vector<std::vector<Size> > bins_;
+  };
+
   void ChromatogramExtractorAlgorithm::extract_value_tophat(
       const std::vector<double>::const_iterator& mz_start,
             std::vector<double>::const_iterator& mz_it,
@@ -296,30 +431,78 @@ namespace OpenMS
         "Input to extractChromatogram needs to be sorted by m/z");
     }
 
-    //go through all spectra
-    startProgress(0, input_size, "Extracting chromatograms");
+    const bool has_im = (im_extraction_window > 0.0);
+    const RTIndex_ rt_index(extraction_coordinates);
+
+    // retention times of all spectra and (an upper bound for) the number of
+    // data points of each chromatogram, to allocate the output only once
+    std::vector<double> spectrum_rt(input_size);
+    std::vector<Size> nr_values(input_size);
+    std::vector<Size> chrom_size(extraction_coordinates.size(), 0);
+    std::vector<Size> active_buffer;
+    for (Size scan_idx = 0; scan_idx < input_size; ++scan_idx)
+    {
+      spectrum_rt[scan_idx] = input->getSpectrumMetaById(scan_idx).RT;
+      const std::vector<Size>& active = rt_index.query(spectrum_rt[scan_idx], active_buffer);
+      nr_values[scan_idx] = active.size();
+      for (std::vector<Size>::const_iterator it = active.begin(); it != active.end(); ++it)
+      {
+        ++chrom_size[*it];
+      }
+    }
+    std::vector<std::vector<double>* > time_data(output.size()), intensity_data(output.size());
+    for (Size k = 0; k < output.size(); ++k)
+    {
+      time_data[k] = &output[k]->getTimeArray()->data;
+      intensity_data[k] = &output[k]->getIntensityArray()->data;
+      time_data[k]->reserve(time_data[k]->size() + chrom_size[k]);
+      intensity_data[k]->reserve(intensity_data[k]->size() + chrom_size[k]);
+    }
+
+    // Spectra are extracted in parallel in chunks of limited size (in number
+    // of extracted values). After each chunk, the values are appended to the
+    // chromatograms in scan order (in parallel over blocks of chromatograms).
+    const Size max_chunk_values = 1 << 21;
+    std::vector<Size> chunk_starts(1, 0);
+    Size chunk_values = 0, max_chunk_size = 0;
     for (Size scan_idx = 0; scan_idx < input_size; ++scan_idx)
     {
-      setProgress(scan_idx);
+      if (chunk_values > 0 && chunk_values + nr_values[scan_idx] > max_chunk_values)
+      {
+        max_chunk_size = (std::max)(max_chunk_size, scan_idx - chunk_starts.back());
+        chunk_starts.push_back(scan_idx);
+        chunk_values = 0;
+      }
+      chunk_values += nr_values[scan_idx];
+    }
+    max_chunk_size = (std::max)(max_chunk_size, input_size - chunk_starts.back());
+    chunk_starts.push_back(input_size);
 
-      OpenSwath::SpectrumPtr sptr = input->getSpectrumById(scan_idx);
-      OpenSwath::SpectrumMeta s_meta = input->getSpectrumMetaById(scan_idx);
+    std::vector<std::vector<Size> > chunk_active(max_chunk_size);
+    std::vector<std::vector<double> > chunk_intensities(max_chunk_size);
+    std::vector<char> chunk_extracted(max_chunk_size);
+
+    // Extracts all active coordinates from one spectrum, returns false if the spectrum is empty
+    auto extractSpectrum = [&](OpenSwath::ISpectrumAccess& spectrum_access, Size scan_idx,
+                               std::vector<Size>& active, std::vector<double>& intensities) -> bool
+    {
+      active.clear();
+      intensities.clear();
+      OpenSwath::SpectrumPtr sptr = spectrum_access.getSpectrumById(scan_idx);
 
       OpenSwath::BinaryDataArrayPtr mz_arr = sptr->getMZArray();
       OpenSwath::BinaryDataArrayPtr int_arr = sptr->getIntensityArray();
+      if (mz_arr->data.empty())
+      {
+        return false;
+      }
       std::vector<double>::const_iterator mz_start = mz_arr->data.begin();
       std::vector<double>::const_iterator mz_end = mz_arr->data.end();
       std::vector<double>::const_iterator mz_it = mz_arr->data.begin();
       std::vector<double>::const_iterator int_it = int_arr->data.begin();
       std::vector<double>::const_iterator im_it;
 
-      if (sptr->getMZArray()->data.size() == 0)
-      {
-        continue;
-      }
-
       // Look for ion mobility array
-      bool has_im = (im_extraction_window > 0.0);
       if (has_im)
       {
         OpenSwath::BinaryDataArrayPtr im_arr = sptr->getDriftTimeArray();
@@ -334,47 +517,134 @@ namespace OpenMS
         }
       }
 
-      // go through all transitions / chromatograms which are sorted by
-      // ProductMZ. We can use this to step through the spectrum and at the
-      // same time step through the transitions. We increase the peak counter
-      // until we hit the next transition and then extract the signal.
-      for (Size k = 0; k < extraction_coordinates.size(); ++k)
+      // go through all transitions / chromatograms active at this RT which
+      // are sorted by ProductMZ. We can use this to step through the
+      // spectrum and at the same time step through the transitions. We
+      // increase the peak counter until we hit the next transition and then
+      // extract the signal.
+      active = rt_index.query(spectrum_rt[scan_idx], active);
+      if (!active.empty() && used_filter == 2)
+      {
+        throw Exception::NotImplemented(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+      }
+      intensities.resize(active.size());
+      for (Size i = 0; i < active.size(); ++i)
       {
-        double integrated_intensity = 0;
-        double current_rt = s_meta.RT;
-        if (extraction_coordinates[k].rt_end - extraction_coordinates[k].rt_start > 0 &&
-             (current_rt < extraction_coordinates[k].rt_start ||
-              current_rt > extraction_coordinates[k].rt_end) )
+        const ExtractionCoordinates& coord = extraction_coordinates[active[i]];
+        if (coord.ion_mobility >= 0.0 && has_im)
         {
-          continue;
+          extract_value_tophat(mz_start, mz_it, mz_end, int_it, im_it,
+                               coord.mz, coord.ion_mobility,
+                               intensities[i], mz_extraction_window, im_extraction_window, ppm);
         }
-
-        const bool use_im = (extraction_coordinates[k].ion_mobility >= 0.0 && has_im);
-        if (!use_im && used_filter == 1)
+        else
         {
           extract_value_tophat(mz_start, mz_it, mz_end, int_it,
-                               extraction_coordinates[k].mz, integrated_intensity, mz_extraction_window, ppm);
+                               coord.mz, intensities[i], mz_extraction_window, ppm);
         }
-        else if (use_im && used_filter == 1)
+      }
+      return true;
+    };
+
+    startProgress(0, input_size, "Extracting chromatograms");
+    Size progress = 0;
+    Size errCount = 0;
+    std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      // spectrum access is not thread-safe, every thread uses its own copy
+      OpenSwath::SpectrumAccessPtr thread_input;
+      try
+      {
+        thread_input = input->lightClone();
+      }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical (ChromatogramExtractorAlgorithm_extract)
+#endif
+        {
+          if (!errCount) error = std::current_exception();
+          ++errCount;
+        }
+      }
+#ifdef _OPENMP
+      const SignedSize nr_blocks = omp_get_num_threads();
+#else
+      const SignedSize nr_blocks = 1;
+#endif
+
+      for (Size chunk = 0; chunk + 1 < chunk_starts.size(); ++chunk)
+      {
+        const SignedSize chunk_start = chunk_starts[chunk];
+        const SignedSize chunk_end = chunk_starts[chunk + 1];
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1)
+#endif
+        for (SignedSize scan_idx = chunk_start; scan_idx < chunk_end; ++scan_idx)
         {
-          if (extraction_coordinates[k].ion_mobility < 0)
+          // parallel exception catching and re-throwing business
+          if (errCount) continue; // no need to extract further if already an error was encountered
+          try
           {
-            std::cerr << "WARNING : Drift time of ion is negative!" << std::endl;
+            chunk_extracted[scan_idx - chunk_start] = extractSpectrum(*thread_input, scan_idx,
+                                                                      chunk_active[scan_idx - chunk_start],
+                                                                      chunk_intensities[scan_idx - chunk_start]);
+          }
+          catch (...)
+          {
+#ifdef _OPENMP
+#pragma omp critical (ChromatogramExtractorAlgorithm_extract)
+#endif
+            {
+              if (!errCount) error = std::current_exception();
+              ++errCount;
+            }
+          }
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+          ++progress;
+          IF_MASTERTHREAD
+          {
+            setProgress(progress);
           }
-          extract_value_tophat(mz_start, mz_it, mz_end, int_it, im_it,
-                               extraction_coordinates[k].mz, extraction_coordinates[k].ion_mobility,
-                               integrated_intensity, mz_extraction_window, im_extraction_window, ppm);
         }
-        else if (used_filter == 2)
+
+        // append the chunk in scan order, every thread handles a block of chromatograms
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+        for (SignedSize block = 0; block < nr_blocks; ++block)
         {
-          throw Exception::NotImplemented(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+          const Size k_begin = extraction_coordinates.size() * block / nr_blocks;
+          const Size k_end = extraction_coordinates.size() * (block + 1) / nr_blocks;
+          for (SignedSize scan_idx = chunk_start; scan_idx < chunk_end && !errCount; ++scan_idx)
+          {
+            if (!chunk_extracted[scan_idx - chunk_start])
+            {
+              continue;
+            }
+            const double current_rt = spectrum_rt[scan_idx];
+            const std::vector<Size>& active = chunk_active[scan_idx - chunk_start];
+            const std::vector<double>& intensities = chunk_intensities[scan_idx - chunk_start];
+            for (Size i = std::lower_bound(active.begin(), active.end(), k_begin) - active.begin();
+                 i < active.size() && active[i] < k_end; ++i)
+            {
+              time_data[active[i]]->push_back(current_rt);
+              intensity_data[active[i]]->push_back(intensities[i]);
+            }
+          }
         }
-
-        output[k]->getTimeArray()->data.push_back(current_rt);
-        output[k]->getIntensityArray()->data.push_back(integrated_intensity);
       }
     }
     endProgress();
+    if (error)
+    {
+      std::rethrow_exception(error);
+    }
   }
 
   int ChromatogramExtractorAlgorithm::getFilterNr_(const String& filter)
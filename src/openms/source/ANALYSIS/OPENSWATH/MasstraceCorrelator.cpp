@@ -183,7 +183,7 @@ namespace OpenMS
 
       // get the points into a vector of pairs (RT, intensity)
       MasstracePointsType f1_points; 
-      for (ConsensusFeature::HandleSetType::iterator it = f1_features->begin(); it != f1_features->end(); ++it)
+      for (ConsensusFeature::HandleSetType::const_iterator it = f1_features->begin(); it != f1_features->end(); ++it)
       {
         f1_points.push_back(std::make_pair(it->getRT(), it->getIntensity())); 
       }
@@ -192,7 +192,7 @@ namespace OpenMS
 
       // find maximum intensity and store it 
       double max_int = 0, max_mz =0;
-      for (ConsensusFeature::HandleSetType::iterator it = f1_features->begin(); it != f1_features->end(); ++it)
+      for (ConsensusFeature::HandleSetType::const_iterator it = f1_features->begin(); it != f1_features->end(); ++it)
       {
         if (it->getIntensity() > max_int)
         {
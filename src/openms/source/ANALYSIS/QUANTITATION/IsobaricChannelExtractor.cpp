@@ -43,6 +43,8 @@
 #include <OpenMS/KERNEL/ConsensusMap.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 
+#include <exception>
+
 // #define ISOBARIC_CHANNEL_EXTRACTOR_DEBUG
 // #undef ISOBARIC_CHANNEL_EXTRACTOR_DEBUG
 
@@ -54,6 +56,9 @@ namespace OpenMS
   // Also used for TMT_11PLEX
   double TMT_10AND11PLEX_CHANNEL_TOLERANCE = 0.003;
 
+  // Search window around each expected reporter ion m/z used for the calibration stats.
+  const double QC_DIST_MZ = 0.5; // fixed! Do not change!
+
   /// small quality control class, holding temporary data for reporting
   struct ChannelQC
   {
@@ -120,7 +125,8 @@ namespace OpenMS
     remove_low_intensity_quantifications_(false),
     min_precursor_purity_(0.0),
     max_precursor_isotope_deviation_(10),
-    interpolate_precursor_purity_(false)
+    interpolate_precursor_purity_(false),
+    block_size_(10000)
   {
     setDefaultParams_();
   }
@@ -136,7 +142,8 @@ namespace OpenMS
     remove_low_intensity_quantifications_(other.remove_low_intensity_quantifications_),
     min_precursor_purity_(other.min_precursor_purity_),
     max_precursor_isotope_deviation_(other.max_precursor_isotope_deviation_),
-    interpolate_precursor_purity_(other.interpolate_precursor_purity_)
+    interpolate_precursor_purity_(other.interpolate_precursor_purity_),
+    block_size_(other.block_size_)
   {
   }
 
@@ -156,6 +163,7 @@ namespace OpenMS
     min_precursor_purity_ = rhs.min_precursor_purity_;
     max_precursor_isotope_deviation_ = rhs.max_precursor_isotope_deviation_;
     interpolate_precursor_purity_ = rhs.interpolate_precursor_purity_;
+    block_size_ = rhs.block_size_;
 
     return *this;
   }
@@ -451,6 +459,130 @@ namespace OpenMS
     }
   }
 
+  /// reporter ion signal of a single channel in a quantification spectrum
+  struct ChannelSignal
+  {
+    Peak2D::IntensityType intensity; ///< intensity assigned to the channel (0 if below thresholds)
+    bool found; ///< a non-zero peak was found within QC_DIST_MZ of the expected position
+    double mz_delta; ///< m/z distance between expected and closest observed peak (if found)
+    bool not_unique; ///< more than one peak within the reporter mass shift
+  };
+
+  /// a selected quantification spectrum and the results of processQuantSpectrum_()
+  struct IsobaricChannelExtractor::QuantSpectrum_
+  {
+    QuantSpectrum_(const PeakMap::ConstIterator& spectrum, const PuritySate_& purity_state);
+
+    /// the MS2/MS3 spectrum to quantify
+    PeakMap::ConstIterator spectrum;
+    /// precursor state at the time the spectrum was selected
+    PuritySate_ purity_state;
+
+    /// precursor purity (-1 if no precursor scan is available)
+    double precursor_purity;
+    /// the MS2 spectrum holding the precursor information
+    PeakMap::ConstIterator ms2_spectrum;
+    /// non-empty if the spectrum lacks required precursor information
+    String error;
+    /// one entry per channel of the quantitation method
+    std::vector<ChannelSignal> channels;
+  };
+
+  IsobaricChannelExtractor::QuantSpectrum_::QuantSpectrum_(const PeakMap::ConstIterator& spectrum, const PuritySate_& purity_state) :
+    spectrum(spectrum),
+    purity_state(purity_state),
+    precursor_purity(-1.0),
+    ms2_spectrum(purity_state.baseExperiment.end())
+  {
+  }
+
+  void IsobaricChannelExtractor::processQuantSpectrum_(QuantSpectrum_& qs, const PeakMap& ms_exp_data) const
+  {
+    const PeakMap::ConstIterator& it = qs.spectrum;
+
+    // check precursor purity if we have a valid precursor ..
+    if (qs.purity_state.precursorScan != ms_exp_data.end())
+    {
+      qs.precursor_purity = computePrecursorPurity_(it, qs.purity_state);
+      // spectrum will be skipped (and reported) by the caller
+      if (qs.precursor_purity < min_precursor_purity_) return;
+    }
+
+    if (it->getMSLevel() == 3)
+    {
+      // we cannot save just the last MS2 but need to compare to the precursor info stored in the (potential MS3 spectrum)
+      qs.ms2_spectrum = ms_exp_data.getPrecursorSpectrum(it);
+
+      if (qs.ms2_spectrum == ms_exp_data.end())
+      { // this only happens if an MS3 spec does not have a preceding MS2
+        qs.error = String("No MS2 precursor information given for MS3 scan native ID ") + it->getNativeID() + " with RT " + String(it->getRT());
+        return;
+      }
+    }
+    else
+    {
+      qs.ms2_spectrum = it;
+    }
+
+    // check if MS1 precursor info is available
+    if (qs.ms2_spectrum->getPrecursors().empty())
+    {
+      qs.error = String("No precursor information given for scan native ID ") + it->getNativeID() + " with RT " + String(it->getRT());
+      return;
+    }
+
+    qs.channels.resize(quant_method_->getChannelInformation().size());
+    std::vector<ChannelSignal>::iterator signal = qs.channels.begin();
+    for (IsobaricQuantitationMethod::IsobaricChannelList::const_iterator cl_it = quant_method_->getChannelInformation().begin();
+          cl_it != quant_method_->getChannelInformation().end();
+          ++cl_it, ++signal)
+    {
+      signal->intensity = 0;
+      signal->found = false;
+      signal->mz_delta = 0;
+      signal->not_unique = false;
+
+      // as every evaluation requires time, we cache the MZEnd iterator
+      const PeakMap::SpectrumType::ConstIterator mz_end = it->MZEnd(cl_it->center + QC_DIST_MZ);
+
+      // search for the non-zero signal closest to theoretical position
+      // & check for closest signal within reasonable distance (0.5 Da) -- might find neighbouring TMT channel, but that should not confuse anyone
+      int peak_count(0); // count peaks in user window -- should be only one, otherwise Window is too large
+      PeakMap::SpectrumType::ConstIterator idx_nearest(mz_end);
+      for (PeakMap::SpectrumType::ConstIterator mz_it = it->MZBegin(cl_it->center - QC_DIST_MZ);
+            mz_it != mz_end;
+            ++mz_it)
+      {
+        if (mz_it->getIntensity() == 0) continue; // ignore 0-intensity shoulder peaks -- could be detrimental when de-calibrated
+        double dist_mz = fabs(mz_it->getMZ() - cl_it->center);
+        if (dist_mz < reporter_mass_shift_) ++peak_count;
+        if (idx_nearest == mz_end // first peak
+            || ((dist_mz < fabs(idx_nearest->getMZ() - cl_it->center)))) // closer to best candidate
+        {
+          idx_nearest = mz_it;
+        }
+      }
+      if (idx_nearest != mz_end)
+      {
+        double mz_delta = cl_it->center - idx_nearest->getMZ();
+        signal->found = true;
+        signal->mz_delta = mz_delta;
+        signal->not_unique = peak_count > 1;
+        // pass user threshold
+        if (std::fabs(mz_delta) < reporter_mass_shift_)
+        {
+          signal->intensity = idx_nearest->getIntensity();
+        }
+      }
+
+      // discard contribution of this channel as it is below the required intensity threshold
+      if (signal->intensity < min_reporter_intensity_)
+      {
+        signal->intensity = 0;
+      }
+    }
+  }
+
   void IsobaricChannelExtractor::extractChannels(const PeakMap& ms_exp_data, ConsensusMap& consensus_map)
   {
     if (ms_exp_data.empty())
@@ -515,178 +647,173 @@ namespace OpenMS
 
     typedef std::map<String, ChannelQC > ChannelQCSet;
     ChannelQCSet channel_mz_delta;
-    const double qc_dist_mz = 0.5; // fixed! Do not change!
 
     Size number_of_channels = quant_method_->getNumberOfChannels();
 
-    PeakMap::ConstIterator it_last_MS2 = ms_exp_data.end(); // remember last MS2 spec, to get precursor in MS1 (also if quant is in MS3)
+    // Spectra are selected sequentially (this needs the running precursor
+    // state), then purity and reporter signals of a block of them are computed
+    // in parallel and the consensus features are assembled again in the order
+    // of the experiment.
+    std::vector<QuantSpectrum_> block;
 
-    for (PeakMap::ConstIterator it = ms_exp_data.begin(); it != ms_exp_data.end(); ++it)
+    auto processBlock = [&]()
     {
-      // remember the last MS1 spectra as we assume it to be the precursor spectrum
-      if (it->getMSLevel() ==  1)
-      {
-        // remember potential precursor and continue
-        pState.precursorScan = it;
-        // reset last MS2 -- we expect to see a new one soon and the old one should not be used for the following MS3 (if any)
-        it_last_MS2 = ms_exp_data.end();
-        continue;
-      }
-
-      if (it->getMSLevel() != quant_ms_level) continue;
-      if ((*it).empty()) continue; // skip empty spectra
-      if (!(selected_activation_.empty() || isValidActivation(*it))) continue;
-
-      // find following ms1 scan (needed for purity computation)
-      if (!pState.followUpValid(it->getRT()))
-      {
-        // advance iterator
-        pState.advanceFollowUp(it->getRT());
-      }
-
-      // check precursor constraints
-      if (!isValidPrecursor_(it->getPrecursors()[0]))
-      {
-        OPENMS_LOG_DEBUG << "Skip spectrum " << it->getNativeID() << ": Precursor doesn't fulfill all constraints." << std::endl;
-        continue;
-      }
-
-      // check precursor purity if we have a valid precursor ..
-      double precursor_purity = -1.0;
-      if (pState.precursorScan != ms_exp_data.end())
+      Size errCount = 0;
+      std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)block.size(); ++i)
       {
-        precursor_purity = computePrecursorPurity_(it, pState);
-        // check if purity is high enough
-        if (precursor_purity < min_precursor_purity_)
+        // parallel exception catching and re-throwing business
+        if (errCount) continue;
+        try
         {
-          OPENMS_LOG_DEBUG << "Skip spectrum " << it->getNativeID() << ": Precursor purity is below the threshold. [purity = " << precursor_purity << "]" << std::endl;
-          continue;
+          processQuantSpectrum_(block[i], ms_exp_data);
         }
-      }
-      else
-      {
-        OPENMS_LOG_INFO << "No precursor available for spectrum: " << it->getNativeID() << std::endl;
-      }
-
-      if (it->getMSLevel() == 3)
-      {
-        // we cannot save just the last MS2 but need to compare to the precursor info stored in the (potential MS3 spectrum)
-        it_last_MS2 = ms_exp_data.getPrecursorSpectrum(it);
-
-        if (it_last_MS2 == ms_exp_data.end())
-        { // this only happens if an MS3 spec does not have a preceding MS2
-          throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No MS2 precursor information given for MS3 scan native ID ") + it->getNativeID() + " with RT " + String(it->getRT()));
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (IsobaricChannelExtractor_extractChannels)
+#endif
+          {
+            if (!errCount) error = std::current_exception();
+            ++errCount;
+          }
         }
       }
-      else
+      if (error)
       {
-        it_last_MS2 = it;
+        std::rethrow_exception(error);
       }
 
-      // check if MS1 precursor info is available
-      if (it_last_MS2->getPrecursors().empty())
+      for (const QuantSpectrum_& qs : block)
       {
-        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No precursor information given for scan native ID ") + it->getNativeID() + " with RT " + String(it->getRT()));
-      }
+        const PeakMap::ConstIterator& it = qs.spectrum;
 
-      // store RT of MS2 scan and MZ of MS1 precursor ion as centroid of ConsensusFeature
-      ConsensusFeature cf;
-      cf.setUniqueId();
-      cf.setRT(it_last_MS2->getRT());
-      cf.setMZ(it_last_MS2->getPrecursors()[0].getMZ());
-
-      Peak2D channel_value;
-      channel_value.setRT(it->getRT());
-      // for each each channel
-      UInt64 map_index = 0;
-      Peak2D::IntensityType overall_intensity = 0;
-
-      for (IsobaricQuantitationMethod::IsobaricChannelList::const_iterator cl_it = quant_method_->getChannelInformation().begin();
-            cl_it != quant_method_->getChannelInformation().end();
-            ++cl_it)
-      {
-        // set mz-position of channel
-        channel_value.setMZ(cl_it->center);
-        // reset intensity
-        channel_value.setIntensity(0);
-
-        // as every evaluation requires time, we cache the MZEnd iterator
-        const PeakMap::SpectrumType::ConstIterator mz_end = it->MZEnd(cl_it->center + qc_dist_mz);
-
-        // search for the non-zero signal closest to theoretical position
-        // & check for closest signal within reasonable distance (0.5 Da) -- might find neighbouring TMT channel, but that should not confuse anyone
-        int peak_count(0); // count peaks in user window -- should be only one, otherwise Window is too large
-        PeakMap::SpectrumType::ConstIterator idx_nearest(mz_end);
-        for (PeakMap::SpectrumType::ConstIterator mz_it = it->MZBegin(cl_it->center - qc_dist_mz);
-              mz_it != mz_end;
-              ++mz_it)
+        // check precursor purity if we have a valid precursor ..
+        if (qs.purity_state.precursorScan != ms_exp_data.end())
         {
-          if (mz_it->getIntensity() == 0) continue; // ignore 0-intensity shoulder peaks -- could be detrimental when de-calibrated
-          double dist_mz = fabs(mz_it->getMZ() - cl_it->center);
-          if (dist_mz < reporter_mass_shift_) ++peak_count;
-          if (idx_nearest == mz_end // first peak
-              || ((dist_mz < fabs(idx_nearest->getMZ() - cl_it->center)))) // closer to best candidate
+          // check if purity is high enough
+          if (qs.precursor_purity < min_precursor_purity_)
           {
-            idx_nearest = mz_it;
+            OPENMS_LOG_DEBUG << "Skip spectrum " << it->getNativeID() << ": Precursor purity is below the threshold. [purity = " << qs.precursor_purity << "]" << std::endl;
+            continue;
           }
         }
-        if (idx_nearest != mz_end)
+        else
+        {
+          OPENMS_LOG_INFO << "No precursor available for spectrum: " << it->getNativeID() << std::endl;
+        }
+
+        if (!qs.error.empty())
+        {
+          throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, qs.error);
+        }
+
+        // store RT of MS2 scan and MZ of MS1 precursor ion as centroid of ConsensusFeature
+        ConsensusFeature cf;
+        cf.setUniqueId();
+        cf.setRT(qs.ms2_spectrum->getRT());
+        cf.setMZ(qs.ms2_spectrum->getPrecursors()[0].getMZ());
+
+        Peak2D channel_value;
+        channel_value.setRT(it->getRT());
+        // for each each channel
+        UInt64 map_index = 0;
+        Peak2D::IntensityType overall_intensity = 0;
+
+        IsobaricQuantitationMethod::IsobaricChannelList::const_iterator cl_it = quant_method_->getChannelInformation().begin();
+        for (const ChannelSignal& signal : qs.channels)
         {
-          double mz_delta = cl_it->center - idx_nearest->getMZ();
-          // stats: we don't care what shift the user specified
-          channel_mz_delta[cl_it->name].mz_deltas.push_back(mz_delta);
-          if (peak_count > 1) ++channel_mz_delta[cl_it->name].signal_not_unique;
-          // pass user threshold
-          if (std::fabs(mz_delta) < reporter_mass_shift_)
+          // set mz-position of channel
+          channel_value.setMZ(cl_it->center);
+          channel_value.setIntensity(signal.intensity);
+
+          if (signal.found)
           {
-            channel_value.setIntensity(idx_nearest->getIntensity());
+            // stats: we don't care what shift the user specified
+            channel_mz_delta[cl_it->name].mz_deltas.push_back(signal.mz_delta);
+            if (signal.not_unique) ++channel_mz_delta[cl_it->name].signal_not_unique;
           }
+
+          overall_intensity += channel_value.getIntensity();
+          // add channel to ConsensusFeature
+          cf.insert(map_index, channel_value, element_index);
+          ++map_index;
+          ++cl_it;
+        } // ! channel_iterator
+
+        // check if we keep this feature or if it contains low-intensity quantifications
+        if (remove_low_intensity_quantifications_ && hasLowIntensityReporter_(cf))
+        {
+          continue;
         }
 
-        // discard contribution of this channel as it is below the required intensity threshold
-        if (channel_value.getIntensity() < min_reporter_intensity_)
+        // check featureHandles are not empty
+        if (overall_intensity <= 0)
         {
-          channel_value.setIntensity(0);
+          cf.setMetaValue("all_empty", String("true"));
         }
+        // add purity information if we could compute it
+        if (qs.precursor_purity > 0.0)
+        {
+          cf.setMetaValue("precursor_purity", qs.precursor_purity);
+        }
+
+        // embed the id of the scan from which the quantitative information was extracted
+        cf.setMetaValue("scan_id", it->getNativeID());
+        // ...as well as additional meta information
+        cf.setMetaValue("precursor_intensity", it->getPrecursors()[0].getIntensity());
+
+        cf.setCharge(it->getPrecursors()[0].getCharge());
+        cf.setIntensity(overall_intensity);
+        consensus_map.push_back(cf);
 
-        overall_intensity += channel_value.getIntensity();
-        // add channel to ConsensusFeature
-        cf.insert(map_index, channel_value, element_index);
-        ++map_index;
-      } // ! channel_iterator
+        // the tandem-scan in the order they appear in the experiment
+        ++element_index;
+      }
+      block.clear();
+    };
 
-      // check if we keep this feature or if it contains low-intensity quantifications
-      if (remove_low_intensity_quantifications_ && hasLowIntensityReporter_(cf))
+    for (PeakMap::ConstIterator it = ms_exp_data.begin(); it != ms_exp_data.end(); ++it)
+    {
+      // remember the last MS1 spectra as we assume it to be the precursor spectrum
+      if (it->getMSLevel() ==  1)
       {
+        // remember potential precursor and continue
+        pState.precursorScan = it;
         continue;
       }
 
-      // check featureHandles are not empty
-      if (overall_intensity <= 0)
+      if (it->getMSLevel() != quant_ms_level) continue;
+      if ((*it).empty()) continue; // skip empty spectra
+      if (!(selected_activation_.empty() || isValidActivation(*it))) continue;
+
+      // find following ms1 scan (needed for purity computation)
+      if (!pState.followUpValid(it->getRT()))
       {
-        cf.setMetaValue("all_empty", String("true"));
+        // advance iterator
+        pState.advanceFollowUp(it->getRT());
       }
-      // add purity information if we could compute it
-      if (precursor_purity > 0.0)
+
+      // check precursor constraints
+      if (!isValidPrecursor_(it->getPrecursors()[0]))
       {
-        cf.setMetaValue("precursor_purity", precursor_purity);
+        OPENMS_LOG_DEBUG << "Skip spectrum " << it->getNativeID() << ": Precursor doesn't fulfill all constraints." << std::endl;
+        continue;
       }
 
-      // embed the id of the scan from which the quantitative information was extracted
-      cf.setMetaValue("scan_id", it->getNativeID());
-      // ...as well as additional meta information
-      cf.setMetaValue("precursor_intensity", it->getPrecursors()[0].getIntensity());
-
-      cf.setCharge(it->getPrecursors()[0].getCharge());
-      cf.setIntensity(overall_intensity);
-      consensus_map.push_back(cf);
-
-      // the tandem-scan in the order they appear in the experiment
-      ++element_index;
+      block.emplace_back(it, pState);
+      if (block.size() == block_size_)
+      {
+        processBlock();
+      }
     } // ! Experiment iterator
+    processBlock();
 
     // print stats about m/z calibration / presence of signal
-    OPENMS_LOG_INFO << "Calibration stats: Median distance of observed reporter ions m/z to expected position (up to " << qc_dist_mz << " Th):\n";
+    OPENMS_LOG_INFO << "Calibration stats: Median distance of observed reporter ions m/z to expected position (up to " << QC_DIST_MZ << " Th):\n";
     bool impurities_found(false);
     for (IsobaricQuantitationMethod::IsobaricChannelList::const_iterator cl_it = quant_method_->getChannelInformation().begin();
       cl_it != quant_method_->getChannelInformation().end();
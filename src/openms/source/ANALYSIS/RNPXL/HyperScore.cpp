@@ -36,11 +36,58 @@
 
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/DATASTRUCTURES/MatchedIterator.h>
+#include <OpenMS/MATH/MISC/MathFunctions.h>
+
+#include <cmath>
+#include <limits>
 
 using std::vector;
 
 namespace OpenMS
 {
+  namespace
+  {
+    /**
+      @brief Peak matching of HyperScore on a columnar experimental spectrum
+
+      Same matching as MatchedIterator<PeakSpectrum, PpmTrait/DaTrait>: for each theoretical peak, walk forward in the
+      experimental spectrum to the closest peak (ties prefer the smaller m/z) and accept it if within tolerance.
+      Calls @p on_match(theo_index, exp_index) for each accepted pair.
+    */
+    template <typename TheoMZ, typename OnMatch>
+    void matchColumnar(const ColumnarSpectrum& exp_spectrum, Size theo_size, const TheoMZ& theo_mz_at,
+                       float tolerance, bool tolerance_unit_ppm, const OnMatch& on_match)
+    {
+      const double* exp_mz = exp_spectrum.getMZData();
+      const Size exp_size = exp_spectrum.size();
+      Size t = 0;
+      for (Size r = 0; r < theo_size; ++r)
+      {
+        const double theo_mz = theo_mz_at(r);
+        const double max_dist = tolerance_unit_ppm ? Math::ppmToMass(tolerance, (float)theo_mz) : tolerance;
+
+        float diff = std::numeric_limits<float>::max();
+        do
+        {
+          const float d = std::fabs(theo_mz - exp_mz[t]);
+          if (diff > d) // getting better
+          {
+            diff = d;
+          }
+          else // getting worse (overshot)
+          {
+            --t;
+            break;
+          }
+          ++t;
+        } while (t != exp_size);
+
+        if (t == exp_size) --t; // reset to last valid entry
+        if (diff <= max_dist) on_match(r, t);
+      }
+    }
+  }
+
   inline double HyperScore::logfactorial_(const int x, int base)
   {
     double z(0);
@@ -82,16 +129,7 @@ namespace OpenMS
       for (; it != it.end(); ++it)
       {
         dot_product += (*it).getIntensity() * it.ref().getIntensity(); /* * mass_error */;
-        // fragment annotations in XL-MS data are more complex and do not start with the ion type, but the ion type always follows after a $
-        auto i = it.refIdx();
-        if ((*ion_names)[i][0] == 'y' || (*ion_names)[i].hasSubstring("$y"))
-        {
-          ++y_ion_count;
-        }
-        else if ((*ion_names)[i][0] == 'b' || (*ion_names)[i].hasSubstring("$b"))
-        {
-          ++b_ion_count;
-        }
+        countIon_(getIonType((*ion_names)[it.refIdx()]), y_ion_count, b_ion_count);
       }
     }
     else
@@ -100,20 +138,96 @@ namespace OpenMS
       for (; it != it.end(); ++it)
       {
         dot_product += (*it).getIntensity() * it.ref().getIntensity(); /* * mass_error */;
-        // fragment annotations in XL-MS data are more complex and do not start with the ion type, but the ion type always follows after a $
-        auto i = it.refIdx();
-        if ((*ion_names)[i][0] == 'y' || (*ion_names)[i].hasSubstring("$y"))
-        {
-          ++y_ion_count;
-        }
-        else if ((*ion_names)[i][0] == 'b' || (*ion_names)[i].hasSubstring("$b"))
-        {
-          ++b_ion_count;
-        }
+        countIon_(getIonType((*ion_names)[it.refIdx()]), y_ion_count, b_ion_count);
       }
 
     }
 
+    return score_(dot_product, y_ion_count, b_ion_count);
+  }
+
+  double HyperScore::compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const ColumnarSpectrum& exp_spectrum, const PeakSpectrum& theo_spectrum)
+  {
+    if (exp_spectrum.size() < 1 || theo_spectrum.size() < 1)
+    {
+      std::cout << "Warning: HyperScore: One of the given spectra is empty." << std::endl;
+      return 0.0;
+    }
+
+    // TODO this assumes only one StringDataArray is present and it is the right one
+    if (theo_spectrum.getStringDataArrays().empty())
+    {
+      std::cout << "Error: HyperScore: Theoretical spectrum without StringDataArray (\"IonNames\" annotation) provided." << std::endl;
+      return 0.0;
+    }
+    const PeakSpectrum::StringDataArray& ion_names = theo_spectrum.getStringDataArrays()[0];
+
+    const float* exp_intensity = exp_spectrum.getIntensityData();
+    int y_ion_count = 0;
+    int b_ion_count = 0;
+    double dot_product = 0.0;
+    matchColumnar(exp_spectrum, theo_spectrum.size(), [&theo_spectrum](Size r) { return theo_spectrum[r].getMZ(); },
+      fragment_mass_tolerance, fragment_mass_tolerance_unit_ppm,
+      [&](Size r, Size t)
+      {
+        dot_product += exp_intensity[t] * theo_spectrum[r].getIntensity();
+        countIon_(getIonType(ion_names[r]), y_ion_count, b_ion_count);
+      });
+
+    return score_(dot_product, y_ion_count, b_ion_count);
+  }
+
+  double HyperScore::compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const ColumnarSpectrum& exp_spectrum,
+    const double* theo_mz, const float* theo_intensity, const char* theo_ion_types, Size theo_size)
+  {
+    if (exp_spectrum.size() < 1 || theo_size < 1)
+    {
+      return 0.0;
+    }
+
+    const float* exp_intensity = exp_spectrum.getIntensityData();
+    int y_ion_count = 0;
+    int b_ion_count = 0;
+    double dot_product = 0.0;
+    matchColumnar(exp_spectrum, theo_size, [theo_mz](Size r) { return theo_mz[r]; },
+      fragment_mass_tolerance, fragment_mass_tolerance_unit_ppm,
+      [&](Size r, Size t)
+      {
+        dot_product += exp_intensity[t] * theo_intensity[r];
+        countIon_(theo_ion_types[r], y_ion_count, b_ion_count);
+      });
+
+    return score_(dot_product, y_ion_count, b_ion_count);
+  }
+
+  char HyperScore::getIonType(const String& ion_name)
+  {
+    // fragment annotations in XL-MS data are more complex and do not start with the ion type, but the ion type always follows after a $
+    if (ion_name[0] == 'y' || ion_name.hasSubstring("$y"))
+    {
+      return 'y';
+    }
+    else if (ion_name[0] == 'b' || ion_name.hasSubstring("$b"))
+    {
+      return 'b';
+    }
+    return 0;
+  }
+
+  inline void HyperScore::countIon_(char ion_type, int& y_ion_count, int& b_ion_count)
+  {
+    if (ion_type == 'y')
+    {
+      ++y_ion_count;
+    }
+    else if (ion_type == 'b')
+    {
+      ++b_ion_count;
+    }
+  }
+
+  inline double HyperScore::score_(double dot_product, int y_ion_count, int b_ion_count)
+  {
     // inefficient: calculates logs repeatedly
     //const double yFact = logfactorial_(y_ion_count);
     //const double bFact = logfactorial_(b_ion_count);
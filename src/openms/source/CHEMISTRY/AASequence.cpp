@@ -43,6 +43,7 @@
 #include <OpenMS/CONCEPT/PrecisionWrapper.h>
 
 #include <cmath>
+#include <unordered_map>
 
 using namespace std;
 
@@ -465,6 +466,117 @@ namespace OpenMS
     }
   }
 
+  namespace
+  {
+    /// returns the formula that has to be added to the internal residues to get the residue type @p type
+    const EmpiricalFormula& getInternalToFormula(Residue::ResidueType type)
+    {
+      static const EmpiricalFormula internal;
+      switch (type)
+      {
+        case Residue::Full:
+          return Residue::getInternalToFull();
+
+        case Residue::Internal:
+          return internal;
+
+        case Residue::NTerminal:
+          return Residue::getInternalToNTerm();
+
+        case Residue::CTerminal:
+          return Residue::getInternalToCTerm();
+
+        case Residue::AIon:
+          return Residue::getInternalToAIon();
+
+        case Residue::BIon:
+          return Residue::getInternalToBIon();
+
+        case Residue::CIon:
+          return Residue::getInternalToCIon();
+
+        case Residue::XIon:
+          return Residue::getInternalToXIon();
+
+        case Residue::YIon:
+          return Residue::getInternalToYIon();
+
+        case Residue::ZIon:
+          return Residue::getInternalToZIon();
+
+        default:
+          OPENMS_LOG_ERROR << "AASequence: unknown ResidueType" << std::endl;
+      }
+      return internal;
+    }
+
+    /// returns the mono isotopic weight of getInternalToFormula() (computing it on every call is comparatively expensive)
+    double getInternalToMonoWeight(Residue::ResidueType type)
+    {
+      static const double internal_to_full = Residue::getInternalToFull().getMonoWeight();
+      static const double internal_to_nterm = Residue::getInternalToNTerm().getMonoWeight();
+      static const double internal_to_cterm = Residue::getInternalToCTerm().getMonoWeight();
+      static const double internal_to_aion = Residue::getInternalToAIon().getMonoWeight();
+      static const double internal_to_bion = Residue::getInternalToBIon().getMonoWeight();
+      static const double internal_to_cion = Residue::getInternalToCIon().getMonoWeight();
+      static const double internal_to_xion = Residue::getInternalToXIon().getMonoWeight();
+      static const double internal_to_yion = Residue::getInternalToYIon().getMonoWeight();
+      static const double internal_to_zion = Residue::getInternalToZIon().getMonoWeight();
+      switch (type)
+      {
+        case Residue::Full:
+          return internal_to_full;
+
+        case Residue::Internal:
+          return 0.0;
+
+        case Residue::NTerminal:
+          return internal_to_nterm;
+
+        case Residue::CTerminal:
+          return internal_to_cterm;
+
+        case Residue::AIon:
+          return internal_to_aion;
+
+        case Residue::BIon:
+          return internal_to_bion;
+
+        case Residue::CIon:
+          return internal_to_cion;
+
+        case Residue::XIon:
+          return internal_to_xion;
+
+        case Residue::YIon:
+          return internal_to_yion;
+
+        case Residue::ZIon:
+          return internal_to_zion;
+
+        default:
+          OPENMS_LOG_ERROR << "AASequence: unknown ResidueType" << std::endl;
+      }
+      return 0.0;
+    }
+
+    /// returns whether the N-terminal modification contributes to the residue type @p type
+    bool hasNTerminus(Residue::ResidueType type)
+    {
+      return type == Residue::Full || type == Residue::AIon ||
+             type == Residue::BIon || type == Residue::CIon ||
+             type == Residue::NTerminal;
+    }
+
+    /// returns whether the C-terminal modification contributes to the residue type @p type
+    bool hasCTerminus(Residue::ResidueType type)
+    {
+      return type == Residue::Full || type == Residue::XIon ||
+             type == Residue::YIon || type == Residue::ZIon ||
+             type == Residue::CTerminal;
+    }
+  }
+
   double AASequence::getAverageWeight(Residue::ResidueType type, Int charge) const
   {
     // check whether tags are present
@@ -519,50 +631,75 @@ namespace OpenMS
       }
 
       // add the missing formula part
-      switch (type)
-      {
-        case Residue::Full:
-          return mono_weight + Residue::getInternalToFull().getMonoWeight();
-
-        case Residue::Internal:
-          return mono_weight;
-
-        case Residue::NTerminal:
-          return mono_weight + Residue::getInternalToNTerm().getMonoWeight();
-
-        case Residue::CTerminal:
-          return mono_weight + Residue::getInternalToCTerm().getMonoWeight();
-
-        case Residue::AIon:
-          return mono_weight + Residue::getInternalToAIon().getMonoWeight();
-
-        case Residue::BIon:
-          return mono_weight + Residue::getInternalToBIon().getMonoWeight();
-
-        case Residue::CIon:
-          return mono_weight + Residue::getInternalToCIon().getMonoWeight();
+      return mono_weight + getInternalToMonoWeight(type);
+    }
+    else
+    {
+      OPENMS_LOG_ERROR << "AASequence::getMonoWeight: Mass for ResidueType " << type << " not defined for sequences of length 0." << std::endl;
+      return 0.0;
+    }
+}
 
-        case Residue::XIon:
-          return mono_weight + Residue::getInternalToXIon().getMonoWeight();
+  std::vector<double> AASequence::getPrefixMonoWeights(Residue::ResidueType type, Int charge) const
+  {
+    std::vector<double> weights;
+    weights.reserve(peptide_.size());
 
-        case Residue::YIon:
-          return mono_weight + Residue::getInternalToYIon().getMonoWeight();
+    // same summation order as in getMonoWeight(), so that the weights are identical
+    double mono_weight(Constants::PROTON_MASS_U * charge);
+    if (n_term_mod_ != nullptr && hasNTerminus(type))
+    {
+      mono_weight += n_term_mod_->getDiffMonoMass();
+    }
+    const double internal_to_type = getInternalToMonoWeight(type);
+    static auto const rx = ResidueDB::getInstance()->getResidue("X");
+    for (auto const& e : peptide_)
+    {
+      if (e == rx) throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Cannot get weight of sequence with unknown AA 'X' with unknown mass.", toString());
+      mono_weight += e->getMonoWeight(Residue::Internal);
+      weights.push_back(mono_weight + internal_to_type);
+    }
 
-        case Residue::ZIon:
-          return mono_weight + Residue::getInternalToZIon().getMonoWeight();
+    // the full sequence includes the C-terminal modification (which is added before the residues)
+    if (c_term_mod_ != nullptr && hasCTerminus(type) && !weights.empty())
+    {
+      weights.back() = getMonoWeight(type, charge);
+    }
+    return weights;
+  }
 
-        default:
-          OPENMS_LOG_ERROR << "AASequence::getMonoWeight: unknown ResidueType" << std::endl;
-      }
+  std::vector<double> AASequence::getPrefixAverageWeights(Residue::ResidueType type, Int charge) const
+  {
+    std::vector<double> weights;
+    weights.reserve(peptide_.size());
 
-      return mono_weight;
+    EmpiricalFormula ef;
+    ef.setCharge(charge);
+    if (n_term_mod_ != nullptr && hasNTerminus(type))
+    {
+      ef += n_term_mod_->getDiffFormula();
     }
-    else
+    ef += getInternalToFormula(type);
+    double tag_offset(0);
+    static auto const rx = ResidueDB::getInstance()->getResidue("X");
+    for (Size i = 0; i < peptide_.size(); ++i)
     {
-      OPENMS_LOG_ERROR << "AASequence::getMonoWeight: Mass for ResidueType " << type << " not defined for sequences of length 0." << std::endl;
-      return 0.0;
+      const Residue* e = peptide_[i];
+      if (e == rx) throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Cannot get weight of sequence with unknown AA 'X' with unknown mass.", toString());
+      if (e->getOneLetterCode() == "")
+      {
+        tag_offset += e->getAverageWeight(Residue::Internal);
+      }
+      ef += e->getFormula(Residue::Internal);
+      // the full sequence includes the C-terminal modification
+      if (i + 1 == peptide_.size() && c_term_mod_ != nullptr && hasCTerminus(type))
+      {
+        ef += c_term_mod_->getDiffFormula();
+      }
+      weights.push_back(tag_offset + ef.getAverageWeight());
     }
-}
+    return weights;
+  }
 
 
 
@@ -1490,18 +1627,108 @@ namespace OpenMS
     return c_term_mod_ != nullptr;
   }
 
+  namespace
+  {
+    /// per-thread cache of parsed, modified sequences (see AASequence::fromString())
+    struct ParseCache
+    {
+      /// generation of ModificationsDB the cached sequences were parsed with
+      Size generation = 0;
+      /// parsed sequences, separately for permissive (index 1) and strict parsing
+      std::unordered_map<std::string, AASequence> sequences[2];
+      /// lookups and hits since the hit rate was checked last
+      Size lookups = 0;
+      Size hits = 0;
+      /// number of remaining calls that parse without looking up the cache
+      Size bypass = 0;
+    };
+
+    /// maximum number of cached sequences per thread and parsing mode
+    const Size PARSE_CACHE_SIZE = 10000;
+    /// number of lookups after which the hit rate of the cache is checked
+    const Size PARSE_CACHE_CHECK_INTERVAL = 5000;
+    /// number of calls that bypass the cache after a low hit rate
+    const Size PARSE_CACHE_BYPASS = 64 * PARSE_CACHE_CHECK_INTERVAL;
+  }
+
   AASequence AASequence::fromString(const String& s, bool permissive)
   {
     AASequence aas;
+
+    // unmodified sequences are parsed faster than they can be looked up
+    if (s.find_first_of("([") == std::string::npos)
+    {
+      parseString_(s, aas, permissive);
+      return aas;
+    }
+
+    // Resolving modifications is expensive and the same modified peptides
+    // occur many times (e.g. in identification files). Parse results only
+    // depend on the modifications known at the time, so the cache is
+    // invalidated whenever ModificationsDB changes (checked without locking
+    // the database).
+    static thread_local ParseCache cache;
+    if (cache.bypass > 0)
+    {
+      --cache.bypass;
+      parseString_(s, aas, permissive);
+      return aas;
+    }
+
+    static ModificationsDB* mod_db = ModificationsDB::getInstance();
+    std::unordered_map<std::string, AASequence>& sequences = cache.sequences[permissive];
+
+    // A lookup costs about as much as parsing a sequence with few
+    // modifications, so the cache only pays off if many sequences repeat.
+    // If the hit rate is low (e.g. for far more distinct sequences than fit
+    // into the cache), the cache is switched off for a while and then tried
+    // again with no entries, which also drops entries that stopped being
+    // used. While the cache fills up, hits are rare even if sequences repeat,
+    // so only an almost zero hit rate counts as low.
+    if (cache.lookups == PARSE_CACHE_CHECK_INTERVAL)
+    {
+      const Size min_hits = sequences.size() < PARSE_CACHE_SIZE ? cache.lookups / 20 : cache.lookups / 3;
+      if (cache.hits < min_hits)
+      {
+        cache.bypass = PARSE_CACHE_BYPASS;
+        cache.sequences[0].clear();
+        cache.sequences[1].clear();
+      }
+      cache.lookups = 0;
+      cache.hits = 0;
+    }
+
+    const Size generation = mod_db->getGeneration();
+    if (generation == cache.generation)
+    {
+      ++cache.lookups;
+      std::unordered_map<std::string, AASequence>::const_iterator it = sequences.find(s);
+      if (it != sequences.end())
+      {
+        ++cache.hits;
+        return it->second;
+      }
+    }
+
     parseString_(s, aas, permissive);
+
+    // don't cache if the modifications changed while parsing (parsing may
+    // itself add unknown modifications), the result may already be outdated
+    if (mod_db->getGeneration() != generation) return aas;
+
+    if (generation != cache.generation)
+    {
+      cache.sequences[0].clear();
+      cache.sequences[1].clear();
+      cache.generation = generation;
+    }
+    if (sequences.size() < PARSE_CACHE_SIZE) sequences.emplace(s, aas);
     return aas;
   }
 
   AASequence AASequence::fromString(const char* s, bool permissive)
   {
-    AASequence aas;
-    parseString_(String(s), aas, permissive);
-    return aas;
+    return fromString(String(s), permissive);
   }
 
 }
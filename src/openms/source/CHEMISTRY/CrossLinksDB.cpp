@@ -356,6 +356,7 @@ namespace OpenMS
         }
       }
     }
+    ++generation_;
   }
 
   void CrossLinksDB::getAllSearchModifications(vector<String>& modifications) const
@@ -95,7 +95,8 @@ namespace OpenMS
     return db_;
   }
 
-  ModificationsDB::ModificationsDB(OpenMS::String unimod_file, OpenMS::String psimod_file, OpenMS::String xlmod_file)
+  ModificationsDB::ModificationsDB(OpenMS::String unimod_file, OpenMS::String psimod_file, OpenMS::String xlmod_file) :
+    generation_(0)
   {
     if (!unimod_file.empty())
     {
@@ -138,6 +139,11 @@ namespace OpenMS
     return s;
   }
 
+  Size ModificationsDB::getGeneration() const
+  {
+    return generation_.load();
+  }
+
   const ResidueModification* ModificationsDB::searchModificationsFast(const String& mod_name_,
                                                                       bool& multiple_matches,
                                                                       const String& residue,
@@ -398,6 +404,7 @@ namespace OpenMS
         // e.g. UniMod:312
         modification_names_[m->getUniModAccession()].insert(m);
         mods_.push_back(m);
+        ++generation_;
       }
     }
   }
@@ -417,6 +424,7 @@ namespace OpenMS
       modification_names_[new_mod->getFullName()].insert(new_mod);
       modification_names_[new_mod->getUniModAccession()].insert(new_mod);
       mods_.push_back(new_mod); // we probably want that
+      ++generation_;
     }
   }
 
@@ -719,6 +727,7 @@ namespace OpenMS
           }
         }
       }
+      ++generation_;
     }
   }
 
@@ -36,7 +36,11 @@
 
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 
-#include <boost/dynamic_bitset.hpp>
+#include <algorithm>
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
 
 namespace OpenMS
 {
@@ -164,11 +168,11 @@ namespace OpenMS
       last_weights_sum = weights_sum;
     }
 
-    void computeWeightedSDEstimate(std::list<PeakType> tmp, const double& mean_t, double& sd_t, const double& /* lower_sd_bound */)
+    void computeWeightedSDEstimate(const std::vector<PeakType>& tmp, const double& mean_t, double& sd_t, const double& /* lower_sd_bound */)
     {
       double denom(0.0), weights_sum(0.0);
 
-      for (std::list<PeakType>::const_iterator l_it = tmp.begin(); l_it != tmp.end(); ++l_it)
+      for (std::vector<PeakType>::const_iterator l_it = tmp.begin(); l_it != tmp.end(); ++l_it)
       {
         denom += l_it->getIntensity() * (l_it->getMZ() - mean_t) * (l_it->getMZ() - mean_t);
         weights_sum += l_it->getIntensity();
@@ -186,6 +190,51 @@ namespace OpenMS
       return;
     }
 
+    struct MassTraceDetection::Apex_
+    {
+      double intensity;
+      Size scan; ///< index of the spectrum (in PeakData_)
+      Size peak; ///< index of the peak in the flat peak arrays
+    };
+
+    struct MassTraceDetection::PeakData_
+    {
+      std::vector<double> rt; ///< RT of each spectrum
+      std::vector<Size> offsets; ///< first peak of each spectrum (plus end of the last one)
+      std::vector<double> mz;
+      std::vector<float> intensity;
+      std::vector<float> fwhm; ///< FWHM_ppm meta values (empty if not present)
+
+      Size scanCount() const
+      {
+        return rt.size();
+      }
+
+      bool scanEmpty(Size scan) const
+      {
+        return offsets[scan] == offsets[scan + 1];
+      }
+
+      /// flat index of the peak in @p scan nearest to @p query_mz (same semantics as MSSpectrum::findNearest())
+      Size findNearest(Size scan, double query_mz) const
+      {
+        std::vector<double>::const_iterator first = mz.begin() + offsets[scan];
+        std::vector<double>::const_iterator last = mz.begin() + offsets[scan + 1];
+        std::vector<double>::const_iterator it = std::lower_bound(first, last, query_mz);
+        if (it == first) return offsets[scan];
+        if (it == last) return offsets[scan + 1] - 1;
+        Size idx = it - mz.begin();
+        return (std::fabs(*it - query_mz) < std::fabs(*(it - 1) - query_mz)) ? idx : idx - 1;
+      }
+    };
+
+    struct MassTraceDetection::TraceCandidate_
+    {
+      Size rank; ///< position of the apex in the intensity order
+      bool accepted;
+      std::vector<Size> gathered_idx; ///< flat indices of the collected peaks
+      MassTrace trace;
+    };
 
     void MassTraceDetection::run(const PeakMap& input_exp, std::vector<MassTrace>& found_masstraces, const Size max_traces)
     {
@@ -193,16 +242,13 @@ namespace OpenMS
       found_masstraces.clear();
 
       // gather all peaks that are potential chromatographic peak apices
-      //   - use work_exp for actual work (remove peaks below noise threshold)
+      //   - store peaks above the noise threshold in flat arrays
       //   - store potential apices in chrom_apices
-      PeakMap work_exp;
-      MapIdxSortedByInt chrom_apices;
-
-      Size total_peak_count(0);
-      std::vector<Size> spec_offsets;
-      spec_offsets.push_back(0);
+      PeakData_ peaks;
+      std::vector<Apex_> chrom_apices;
+      peaks.offsets.push_back(0);
 
-      Size spectra_count(0);
+      Size fwhm_meta_count(0);
 
       // *********************************************************** //
       //  Step 1: Detecting potential chromatographic apices
@@ -212,7 +258,19 @@ namespace OpenMS
         // check if this is a MS1 survey scan
         if (it->getMSLevel() != 1) continue;
 
-        std::vector<Size> indices_passing;
+        // check presence of FWHM meta data
+        const MSSpectrum::FloatDataArray* fwhm_array = nullptr;
+        if (!it->getFloatDataArrays().empty() &&
+            it->getFloatDataArrays()[0].getName() == "FWHM_ppm")
+        {
+          if (it->getFloatDataArrays()[0].size() != it->size())
+          { // float data should always have the same size as the corresponding array
+            throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, it->size());
+          }
+          fwhm_array = &it->getFloatDataArrays()[0];
+          ++fwhm_meta_count;
+        }
+
         for (Size peak_idx = 0; peak_idx < it->size(); ++peak_idx)
         {
           double tmp_peak_int((*it)[peak_idx].getIntensity());
@@ -223,328 +281,470 @@ namespace OpenMS
             // --> add this peak as possible chromatographic apex
             if (tmp_peak_int > chrom_peak_snr_ * noise_threshold_int_)
             {
-              chrom_apices.insert(std::make_pair(tmp_peak_int, std::make_pair(spectra_count, indices_passing.size())));
+              Apex_ apex = {tmp_peak_int, peaks.rt.size(), peaks.mz.size()};
+              chrom_apices.push_back(apex);
             }
-            indices_passing.push_back(peak_idx);
-            ++total_peak_count;
+            peaks.mz.push_back((*it)[peak_idx].getMZ());
+            peaks.intensity.push_back((*it)[peak_idx].getIntensity());
+            if (fwhm_array != nullptr) peaks.fwhm.push_back((*fwhm_array)[peak_idx]);
           }
         }
-        PeakMap::SpectrumType tmp_spec(*it);
-        tmp_spec.select(indices_passing);
-        work_exp.addSpectrum(tmp_spec);
-        spec_offsets.push_back(spec_offsets.back() + tmp_spec.size());
-        ++spectra_count;
+        peaks.rt.push_back(it->getRT());
+        peaks.offsets.push_back(peaks.mz.size());
       }
 
+      const Size spectra_count(peaks.scanCount());
       if (spectra_count < 3)
       {
         throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
                                       "Input map consists of too few MS1 spectra (less than 3!). Aborting...", String(spectra_count));
       }
 
-      // discard last spectrum's offset
-      spec_offsets.pop_back();
+      if (fwhm_meta_count > 0 && fwhm_meta_count != spectra_count)
+      {
+        throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                      String("FWHM meta arrays are expected to be missing or present for all MS spectra [") + fwhm_meta_count + "/" + spectra_count + "].");
+      }
+
+      // order apices by decreasing intensity; among equally intense apices, the
+      // one found last comes first (this is the order of a reversed multimap)
+      std::sort(chrom_apices.begin(), chrom_apices.end(),
+                [](const Apex_& a, const Apex_& b)
+                {
+                  return a.intensity > b.intensity || (a.intensity == b.intensity && a.peak > b.peak);
+                });
 
       // *********************************************************************
       // Step 2: start extending mass traces beginning with the apex peak (go
       // through all peaks in order of decreasing intensity)
       // *********************************************************************
-      run_(chrom_apices, total_peak_count, work_exp, spec_offsets, found_masstraces, max_traces);
+      run_(chrom_apices, peaks, found_masstraces, max_traces);
 
       return;
     } // end of MassTraceDetection::run
 
-    void MassTraceDetection::run_(const MapIdxSortedByInt& chrom_apices,
-                                  const Size total_peak_count,
-                                  const PeakMap& work_exp,
-                                  const std::vector<Size>& spec_offsets,
-                                  std::vector<MassTrace>& found_masstraces,
-                                  const Size max_traces)
+    bool MassTraceDetection::extendTrace_(const PeakData_& peaks,
+                                          const Apex_& apex,
+                                          const std::vector<char>& peak_visited,
+                                          double mz_lo,
+                                          double mz_hi,
+                                          TraceCandidate_& candidate)
     {
-      boost::dynamic_bitset<> peak_visited(total_peak_count);
-      Size trace_number(1);
+      candidate.accepted = false;
+      candidate.gathered_idx.clear();
 
-      // check presence of FWHM meta data
-      int fwhm_meta_idx(-1);
-      Size fwhm_meta_count(0);
-      for (Size i = 0; i < work_exp.size(); ++i)
-      {
-        if (work_exp[i].getFloatDataArrays().size() > 0 &&
-            work_exp[i].getFloatDataArrays()[0].getName() == "FWHM_ppm")
-        {
-          if (work_exp[i].getFloatDataArrays()[0].size() != work_exp[i].size())
-          { // float data should always have the same size as the corresponding array
-            throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, work_exp[i].size());
-          }
-          fwhm_meta_idx = 0;
-          ++fwhm_meta_count;
-        }
-      }
-      if (fwhm_meta_count > 0 && fwhm_meta_count != work_exp.size())
-      {
-        throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-                                      String("FWHM meta arrays are expected to be missing or present for all MS spectra [") + fwhm_meta_count + "/" + work_exp.size() + "].");
-      }
+      const Size scan_count(peaks.scanCount());
+      const bool use_fwhm(!peaks.fwhm.empty());
+      const bool outlier_criterion(trace_termination_criterion_ == "outlier");
+      const bool sample_rate_criterion(trace_termination_criterion_ == "sample_rate");
 
+      Peak2D apex_peak;
+      apex_peak.setRT(peaks.rt[apex.scan]);
+      apex_peak.setMZ(peaks.mz[apex.peak]);
+      apex_peak.setIntensity(peaks.intensity[apex.peak]);
 
-      this->startProgress(0, total_peak_count, "mass trace detection");
-      Size peaks_detected(0);
+      Size trace_up_idx(apex.scan);
+      Size trace_down_idx(apex.scan);
 
-      for (MapIdxSortedByInt::const_reverse_iterator m_it = chrom_apices.rbegin(); m_it != chrom_apices.rend(); ++m_it)
-      {
-        Size apex_scan_idx(m_it->second.first);
-        Size apex_peak_idx(m_it->second.second);
+      // peaks found below and above the apex (in order of collection)
+      std::vector<PeakType> trace_down, trace_up;
+      std::vector<double> fwhms_mz; // peak-FWHM meta values of collected peaks
 
-        if (peak_visited[spec_offsets[apex_scan_idx] + apex_peak_idx])
-        {
-          continue;
-        }
+      // Initialization for the iterative version of weighted m/z mean calculation
+      double centroid_mz(apex_peak.getMZ());
+      double prev_counter(apex_peak.getIntensity() * apex_peak.getMZ());
+      double prev_denom(apex_peak.getIntensity());
 
-        Peak2D apex_peak;
-        apex_peak.setRT(work_exp[apex_scan_idx].getRT());
-        apex_peak.setMZ(work_exp[apex_scan_idx][apex_peak_idx].getMZ());
-        apex_peak.setIntensity(work_exp[apex_scan_idx][apex_peak_idx].getIntensity());
+      updateIterativeWeightedMeanMZ(apex_peak.getMZ(), apex_peak.getIntensity(), centroid_mz, prev_counter, prev_denom);
 
-        Size trace_up_idx(apex_scan_idx);
-        Size trace_down_idx(apex_scan_idx);
+      std::vector<Size>& gathered_idx = candidate.gathered_idx;
+      gathered_idx.push_back(apex.peak);
+      if (use_fwhm)
+      {
+        fwhms_mz.push_back(peaks.fwhm[apex.peak]);
+      }
 
-        std::list<PeakType> current_trace;
-        current_trace.push_back(apex_peak);
-        std::vector<double> fwhms_mz; // peak-FWHM meta values of collected peaks
+      Size up_hitting_peak(0), down_hitting_peak(0);
+      Size up_scan_counter(0), down_scan_counter(0);
+
+      bool toggle_up = true, toggle_down = true;
+
+      Size conseq_missed_peak_up(0), conseq_missed_peak_down(0);
+      Size max_consecutive_missing(trace_termination_outliers_);
 
-        // Initialization for the iterative version of weighted m/z mean calculation
-        double centroid_mz(apex_peak.getMZ());
-        double prev_counter(apex_peak.getIntensity() * apex_peak.getMZ());
-        double prev_denom(apex_peak.getIntensity());
+      double current_sample_rate(1.0);
+      Size min_scans_to_consider(5);
 
-        updateIterativeWeightedMeanMZ(apex_peak.getMZ(), apex_peak.getIntensity(), centroid_mz, prev_counter, prev_denom);
+      double ftl_sd((centroid_mz / 1e6) * mass_error_ppm_);
+      double intensity_so_far(apex_peak.getIntensity());
 
-        std::vector<std::pair<Size, Size> > gathered_idx;
-        gathered_idx.push_back(std::make_pair(apex_scan_idx, apex_peak_idx));
-        if (fwhm_meta_idx != -1)
+      while (((trace_down_idx > 0) && toggle_down) ||
+             ((trace_up_idx < scan_count - 1) && toggle_up)
+              )
+      {
+        // *********************************************************** //
+        // Step 2.1 MOVE DOWN in RT dim
+        // *********************************************************** //
+        if ((trace_down_idx > 0) && toggle_down)
         {
-          fwhms_mz.push_back(work_exp[apex_scan_idx].getFloatDataArrays()[fwhm_meta_idx][apex_peak_idx]);
-        }
+          const Size scan_down(trace_down_idx - 1);
+          if (!peaks.scanEmpty(scan_down))
+          {
+            double right_bound = centroid_mz + 3 * ftl_sd;
+            double left_bound = centroid_mz - 3 * ftl_sd;
 
-        Size up_hitting_peak(0), down_hitting_peak(0);
-        Size up_scan_counter(0), down_scan_counter(0);
+            // the search window leaves the m/z range we may access
+            if (left_bound < mz_lo || right_bound >= mz_hi) return false;
 
-        bool toggle_up = true, toggle_down = true;
+            Size next_down_peak_idx = peaks.findNearest(scan_down, centroid_mz);
+            double next_down_peak_mz = peaks.mz[next_down_peak_idx];
+            double next_down_peak_int = peaks.intensity[next_down_peak_idx];
 
-        Size conseq_missed_peak_up(0), conseq_missed_peak_down(0);
-        Size max_consecutive_missing(trace_termination_outliers_);
+            if ((next_down_peak_mz <= right_bound) &&
+                (next_down_peak_mz >= left_bound) &&
+                !peak_visited[next_down_peak_idx]
+                    )
+            {
+              Peak2D next_peak;
+              next_peak.setRT(peaks.rt[scan_down]);
+              next_peak.setMZ(next_down_peak_mz);
+              next_peak.setIntensity(next_down_peak_int);
+
+              trace_down.push_back(next_peak);
+              // FWHM average
+              if (use_fwhm)
+              {
+                fwhms_mz.push_back(peaks.fwhm[next_down_peak_idx]);
+              }
+              // Update the m/z mean of the current trace as we added a new peak
+              updateIterativeWeightedMeanMZ(next_down_peak_mz, next_down_peak_int, centroid_mz, prev_counter, prev_denom);
+              gathered_idx.push_back(next_down_peak_idx);
 
-        double current_sample_rate(1.0);
-        // Size min_scans_to_consider(std::floor((min_sample_rate_ /2)*10));
-        Size min_scans_to_consider(5);
+              // Update the m/z variance dynamically
+              if (reestimate_mt_sd_)
+              {
+                updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
+              }
 
-        // double outlier_ratio(0.3);
+              ++down_hitting_peak;
+              conseq_missed_peak_down = 0;
+            }
+            else
+            {
+              ++conseq_missed_peak_down;
+            }
 
-        // double ftl_mean(centroid_mz);
-        double ftl_sd((centroid_mz / 1e6) * mass_error_ppm_);
-        double intensity_so_far(apex_peak.getIntensity());
+          }
+          --trace_down_idx;
+          ++down_scan_counter;
 
-        while (((trace_down_idx > 0) && toggle_down) ||
-               ((trace_up_idx < work_exp.size() - 1) && toggle_up)
-                )
-        {
-          // *********************************************************** //
-          // Step 2.1 MOVE DOWN in RT dim
-          // *********************************************************** //
-          if ((trace_down_idx > 0) && toggle_down)
+          // trace termination criterion: max allowed number of
+          // consecutive outliers reached OR cancel extension if
+          // sampling_rate falls below min_sample_rate_
+          if (outlier_criterion)
+          {
+            if (conseq_missed_peak_down > max_consecutive_missing)
+            {
+              toggle_down = false;
+            }
+          }
+          else if (sample_rate_criterion)
           {
-            const MSSpectrum& spec_trace_down = work_exp[trace_down_idx - 1];
-            if (!spec_trace_down.empty())
+            current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) /
+                                  (double)(down_scan_counter + up_scan_counter + 1);
+            if (down_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
             {
-              Size next_down_peak_idx = spec_trace_down.findNearest(centroid_mz);
-              double next_down_peak_mz = spec_trace_down[next_down_peak_idx].getMZ();
-              double next_down_peak_int = spec_trace_down[next_down_peak_idx].getIntensity();
+              toggle_down = false;
+            }
+          }
+        }
 
-              double right_bound = centroid_mz + 3 * ftl_sd;
-              double left_bound = centroid_mz - 3 * ftl_sd;
+        // *********************************************************** //
+        // Step 2.2 MOVE UP in RT dim
+        // *********************************************************** //
+        if ((trace_up_idx < scan_count - 1) && toggle_up)
+        {
+          const Size scan_up(trace_up_idx + 1);
+          if (!peaks.scanEmpty(scan_up))
+          {
+            double right_bound = centroid_mz + 3 * ftl_sd;
+            double left_bound = centroid_mz - 3 * ftl_sd;
+
+            // the search window leaves the m/z range we may access
+            if (left_bound < mz_lo || right_bound >= mz_hi) return false;
 
-              if ((next_down_peak_mz <= right_bound) &&
-                  (next_down_peak_mz >= left_bound) &&
-                  !peak_visited[spec_offsets[trace_down_idx - 1] + next_down_peak_idx]
-                      )
+            Size next_up_peak_idx = peaks.findNearest(scan_up, centroid_mz);
+            double next_up_peak_mz = peaks.mz[next_up_peak_idx];
+            double next_up_peak_int = peaks.intensity[next_up_peak_idx];
+
+            if ((next_up_peak_mz <= right_bound) &&
+                (next_up_peak_mz >= left_bound) &&
+                !peak_visited[next_up_peak_idx])
+            {
+              Peak2D next_peak;
+              next_peak.setRT(peaks.rt[scan_up]);
+              next_peak.setMZ(next_up_peak_mz);
+              next_peak.setIntensity(next_up_peak_int);
+
+              trace_up.push_back(next_peak);
+              if (use_fwhm)
               {
-                Peak2D next_peak;
-                next_peak.setRT(spec_trace_down.getRT());
-                next_peak.setMZ(next_down_peak_mz);
-                next_peak.setIntensity(next_down_peak_int);
-
-                current_trace.push_front(next_peak);
-                // FWHM average
-                if (fwhm_meta_idx != -1)
-                {
-                  fwhms_mz.push_back(spec_trace_down.getFloatDataArrays()[fwhm_meta_idx][next_down_peak_idx]);
-                }
-                // Update the m/z mean of the current trace as we added a new peak
-                updateIterativeWeightedMeanMZ(next_down_peak_mz, next_down_peak_int, centroid_mz, prev_counter, prev_denom);
-                gathered_idx.push_back(std::make_pair(trace_down_idx - 1, next_down_peak_idx));
-
-                // Update the m/z variance dynamically
-                if (reestimate_mt_sd_)           //  && (down_hitting_peak+1 > min_flank_scans))
-                {
-                  // if (ftl_t > min_fwhm_scans)
-                  {
-                    updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
-                  }
-                }
-
-                ++down_hitting_peak;
-                conseq_missed_peak_down = 0;
+                fwhms_mz.push_back(peaks.fwhm[next_up_peak_idx]);
               }
-              else
+              // Update the m/z mean of the current trace as we added a new peak
+              updateIterativeWeightedMeanMZ(next_up_peak_mz, next_up_peak_int, centroid_mz, prev_counter, prev_denom);
+              gathered_idx.push_back(next_up_peak_idx);
+
+              // Update the m/z variance dynamically
+              if (reestimate_mt_sd_)
               {
-                ++conseq_missed_peak_down;
+                updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
               }
 
+              ++up_hitting_peak;
+              conseq_missed_peak_up = 0;
+
+            }
+            else
+            {
+              ++conseq_missed_peak_up;
             }
-            --trace_down_idx;
-            ++down_scan_counter;
 
-            // trace termination criterion: max allowed number of
-            // consecutive outliers reached OR cancel extension if
-            // sampling_rate falls below min_sample_rate_
-            if (trace_termination_criterion_ == "outlier")
+          }
+
+          ++trace_up_idx;
+          ++up_scan_counter;
+
+          if (outlier_criterion)
+          {
+            if (conseq_missed_peak_up > max_consecutive_missing)
             {
-              if (conseq_missed_peak_down > max_consecutive_missing)
-              {
-                toggle_down = false;
-              }
+              toggle_up = false;
             }
-            else if (trace_termination_criterion_ == "sample_rate")
+          }
+          else if (sample_rate_criterion)
+          {
+            current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) / (double)(down_scan_counter + up_scan_counter + 1);
+
+            if (up_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
             {
-              current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) /
-                                    (double)(down_scan_counter + up_scan_counter + 1);
-              if (down_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
-              {
-                // std::cout << "stopping down..." << std::endl;
-                toggle_down = false;
-              }
+              toggle_up = false;
             }
           }
+        }
+
+      }
+
+      double num_scans(down_scan_counter + up_scan_counter + 1 - conseq_missed_peak_down - conseq_missed_peak_up);
+
+      const Size trace_size(trace_down.size() + trace_up.size() + 1);
+      double mt_quality((double)trace_size / (double)num_scans);
+      const PeakType& first_peak = trace_down.empty() ? apex_peak : trace_down.back();
+      const PeakType& last_peak = trace_up.empty() ? apex_peak : trace_up.back();
+      double rt_range(std::fabs(last_peak.getRT() - first_peak.getRT()));
+
+      // *********************************************************** //
+      // Step 2.3 check if minimum length and quality of mass trace criteria are met
+      // *********************************************************** //
+      bool max_trace_criteria = (max_trace_length_ < 0.0 || rt_range < max_trace_length_);
+      if (rt_range >= min_trace_length_ && max_trace_criteria && mt_quality >= min_sample_rate_)
+      {
+        // collected peaks in RT order
+        std::vector<PeakType> current_trace;
+        current_trace.reserve(trace_size);
+        current_trace.insert(current_trace.end(), trace_down.rbegin(), trace_down.rend());
+        current_trace.push_back(apex_peak);
+        current_trace.insert(current_trace.end(), trace_up.begin(), trace_up.end());
+
+        // create new MassTrace object and store collected peaks from current_trace
+        MassTrace new_trace(current_trace);
+        new_trace.updateWeightedMeanRT();
+        new_trace.updateWeightedMeanMZ();
+        if (!fwhms_mz.empty()) new_trace.fwhm_mz_avg = Math::median(fwhms_mz.begin(), fwhms_mz.end());
+        new_trace.setQuantMethod(quant_method_);
+        //new_trace.setCentroidSD(ftl_sd);
+        new_trace.updateWeightedMZsd();
+
+        candidate.trace = new_trace;
+        candidate.accepted = true;
+      }
+      return true;
+    }
+
+    void MassTraceDetection::run_(const std::vector<Apex_>& chrom_apices,
+                                  const PeakData_& peaks,
+                                  std::vector<MassTrace>& found_masstraces,
+                                  const Size max_traces)
+    {
+      const Size total_peak_count(peaks.mz.size());
+      const Size apex_count(chrom_apices.size());
+
+      // one byte per peak, so that threads can mark peaks of their own m/z range concurrently
+      std::vector<char> peak_visited(total_peak_count, 0);
 
-          // *********************************************************** //
-          // Step 2.2 MOVE UP in RT dim
-          // *********************************************************** //
-          if ((trace_up_idx < work_exp.size() - 1) && toggle_up)
+      // *********************************************************************
+      // Partition the m/z axis into slabs of roughly equal numbers of apices.
+      // Each slab extends its apices (in intensity order) independently. A
+      // trace only reads and marks peaks within its m/z search window, so
+      // traces whose window stays inside their slab cannot influence another
+      // slab. Extension of a trace leaving its slab is aborted; all work of
+      // lower intensity than this trace is discarded and the trace is
+      // extended sequentially before the slabs continue. This yields exactly
+      // the traces of a sequential pass over all apices.
+      // *********************************************************************
+      const double inf(std::numeric_limits<double>::infinity());
+      std::vector<double> slab_bounds(1, -inf);
+      Size thread_count(1);
+#ifdef _OPENMP
+      thread_count = omp_get_max_threads();
+#endif
+      const Size min_apices_per_slab(1000);
+      Size slab_count((std::min)(4 * thread_count, apex_count / min_apices_per_slab));
+      if (thread_count > 1 && slab_count > 1)
+      {
+        std::vector<double> apex_mz;
+        apex_mz.reserve(apex_count);
+        for (Size i = 0; i < apex_count; ++i) apex_mz.push_back(peaks.mz[chrom_apices[i].peak]);
+        std::sort(apex_mz.begin(), apex_mz.end());
+
+        // place each boundary into the largest m/z gap near the quantile, to keep crossing traces rare
+        const Size window(apex_count / (4 * slab_count));
+        for (Size k = 1; k < slab_count; ++k)
+        {
+          const Size quantile(k * apex_count / slab_count);
+          Size best(quantile - 1);
+          for (Size j = quantile - window; j < quantile + window; ++j)
           {
-            const MSSpectrum& spec_trace_up = work_exp[trace_up_idx + 1];
-            if (!spec_trace_up.empty())
-            {
-              Size next_up_peak_idx = spec_trace_up.findNearest(centroid_mz);
-              double next_up_peak_mz = spec_trace_up[next_up_peak_idx].getMZ();
-              double next_up_peak_int = spec_trace_up[next_up_peak_idx].getIntensity();
+            if (apex_mz[j + 1] - apex_mz[j] > apex_mz[best + 1] - apex_mz[best]) best = j;
+          }
+          const double bound((apex_mz[best] + apex_mz[best + 1]) / 2);
+          if (bound > slab_bounds.back()) slab_bounds.push_back(bound);
+        }
+      }
+      slab_bounds.push_back(inf);
+      slab_count = slab_bounds.size() - 1;
 
-              double right_bound = centroid_mz + 3 * ftl_sd;
-              double left_bound = centroid_mz - 3 * ftl_sd;
+      // apex ranks (positions in intensity order) per slab
+      std::vector<std::vector<Size> > slab_apices(slab_count);
+      for (Size rank = 0; rank < apex_count; ++rank)
+      {
+        const double mz(peaks.mz[chrom_apices[rank].peak]);
+        Size slab = std::upper_bound(slab_bounds.begin() + 1, slab_bounds.end() - 1, mz) - (slab_bounds.begin() + 1);
+        slab_apices[slab].push_back(rank);
+      }
 
-              if ((next_up_peak_mz <= right_bound) &&
-                  (next_up_peak_mz >= left_bound) &&
-                  !peak_visited[spec_offsets[trace_up_idx + 1] + next_up_peak_idx])
-              {
-                Peak2D next_peak;
-                next_peak.setRT(spec_trace_up.getRT());
-                next_peak.setMZ(next_up_peak_mz);
-                next_peak.setIntensity(next_up_peak_int);
+      this->startProgress(0, total_peak_count, "mass trace detection");
+      Size peaks_detected(0);
 
-                current_trace.push_back(next_peak);
-                if (fwhm_meta_idx != -1)
-                {
-                  fwhms_mz.push_back(spec_trace_up.getFloatDataArrays()[fwhm_meta_idx][next_up_peak_idx]);
-                }
-                // Update the m/z mean of the current trace as we added a new peak
-                updateIterativeWeightedMeanMZ(next_up_peak_mz, next_up_peak_int, centroid_mz, prev_counter, prev_denom);
-                gathered_idx.push_back(std::make_pair(trace_up_idx + 1, next_up_peak_idx));
-
-                // Update the m/z variance dynamically
-                if (reestimate_mt_sd_)           //  && (up_hitting_peak+1 > min_flank_scans))
-                {
-                  // if (ftl_t > min_fwhm_scans)
-                  {
-                    updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
-                  }
-                }
+      std::vector<TraceCandidate_> accepted; // final traces (unordered)
+      std::vector<std::vector<TraceCandidate_> > slab_traces(slab_count); // traces of the current round
+      std::vector<Size> slab_cursor(slab_count, 0); // first apex of each slab not processed yet
+      std::vector<Size> slab_abort(slab_count);
 
-                ++up_hitting_peak;
-                conseq_missed_peak_up = 0;
+      // size of a round (in ranks); adapted to the frequency of crossing traces
+      const Size min_round_size(64 * slab_count);
+      Size round_size(slab_count == 1 ? apex_count : min_round_size);
+      Size next_rank(0); // all apices of lower rank are final
 
-              }
-              else
-              {
-                ++conseq_missed_peak_up;
-              }
+      while (next_rank < apex_count)
+      {
+        const Size horizon((std::min)(next_rank + round_size, apex_count));
 
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (SignedSize s = 0; s < (SignedSize)slab_count; ++s)
+        {
+          std::vector<TraceCandidate_>& traces = slab_traces[s];
+          traces.clear();
+          slab_abort[s] = horizon;
+          TraceCandidate_ candidate;
+          for (Size i = slab_cursor[s]; i < slab_apices[s].size() && slab_apices[s][i] < horizon; ++i)
+          {
+            const Apex_& apex = chrom_apices[slab_apices[s][i]];
+            if (peak_visited[apex.peak]) continue;
+
+            if (!extendTrace_(peaks, apex, peak_visited, slab_bounds[s], slab_bounds[s + 1], candidate))
+            {
+              slab_abort[s] = slab_apices[s][i];
+              break;
             }
+            if (!candidate.accepted) continue;
 
-            ++trace_up_idx;
-            ++up_scan_counter;
+            // mark all peaks as visited
+            for (Size j = 0; j < candidate.gathered_idx.size(); ++j)
+            {
+              peak_visited[candidate.gathered_idx[j]] = 1;
+            }
+            candidate.rank = slab_apices[s][i];
+            traces.push_back(std::move(candidate));
+          }
+        }
 
-            if (trace_termination_criterion_ == "outlier")
+        // traces of lower rank than the first crossing trace are final, the others are undone
+        const Size first_abort(*std::min_element(slab_abort.begin(), slab_abort.end()));
+        for (Size s = 0; s < slab_count; ++s)
+        {
+          for (std::vector<TraceCandidate_>::iterator t_it = slab_traces[s].begin(); t_it != slab_traces[s].end(); ++t_it)
+          {
+            if (t_it->rank < first_abort)
             {
-              if (conseq_missed_peak_up > max_consecutive_missing)
-              {
-                toggle_up = false;
-              }
+              peaks_detected += t_it->trace.getSize();
+              accepted.push_back(std::move(*t_it));
             }
-            else if (trace_termination_criterion_ == "sample_rate")
+            else
             {
-              current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) / (double)(down_scan_counter + up_scan_counter + 1);
-
-              if (up_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
+              for (Size j = 0; j < t_it->gathered_idx.size(); ++j)
               {
-                // std::cout << "stopping up" << std::endl;
-                toggle_up = false;
+                peak_visited[t_it->gathered_idx[j]] = 0;
               }
             }
-
-
           }
-
         }
 
-        // std::cout << "current sr: " << current_sample_rate << std::endl;
-        double num_scans(down_scan_counter + up_scan_counter + 1 - conseq_missed_peak_down - conseq_missed_peak_up);
-
-        double mt_quality((double)current_trace.size() / (double)num_scans);
-        // std::cout << "mt quality: " << mt_quality << std::endl;
-        double rt_range(std::fabs(current_trace.rbegin()->getRT() - current_trace.begin()->getRT()));
-
-        // *********************************************************** //
-        // Step 2.3 check if minimum length and quality of mass trace criteria are met
-        // *********************************************************** //
-        bool max_trace_criteria = (max_trace_length_ < 0.0 || rt_range < max_trace_length_);
-        if (rt_range >= min_trace_length_ && max_trace_criteria && mt_quality >= min_sample_rate_)
+        if (first_abort < horizon)
         {
-          // std::cout << "T" << trace_number << "\t" << mt_quality << std::endl;
-
-          // mark all peaks as visited
-          for (Size i = 0; i < gathered_idx.size(); ++i)
+          // extend the crossing trace without m/z restriction
+          const Apex_& apex = chrom_apices[first_abort];
+          TraceCandidate_ candidate;
+          if (!peak_visited[apex.peak] && extendTrace_(peaks, apex, peak_visited, -inf, inf, candidate) && candidate.accepted)
           {
-            peak_visited[spec_offsets[gathered_idx[i].first] +  gathered_idx[i].second] = true;
+            for (Size j = 0; j < candidate.gathered_idx.size(); ++j)
+            {
+              peak_visited[candidate.gathered_idx[j]] = 1;
+            }
+            candidate.rank = first_abort;
+            peaks_detected += candidate.trace.getSize();
+            accepted.push_back(std::move(candidate));
           }
+          next_rank = first_abort + 1;
+          round_size = (std::max)(round_size / 2, min_round_size);
+        }
+        else
+        {
+          next_rank = horizon;
+          round_size *= 2;
+        }
+
+        for (Size s = 0; s < slab_count; ++s)
+        {
+          while (slab_cursor[s] < slab_apices[s].size() && slab_apices[s][slab_cursor[s]] < next_rank) ++slab_cursor[s];
+        }
 
-          // create new MassTrace object and store collected peaks from list current_trace
-          MassTrace new_trace(current_trace);
-          new_trace.updateWeightedMeanRT();
-          new_trace.updateWeightedMeanMZ();
-          if (!fwhms_mz.empty()) new_trace.fwhm_mz_avg = Math::median(fwhms_mz.begin(), fwhms_mz.end());
-          new_trace.setQuantMethod(quant_method_);
-          //new_trace.setCentroidSD(ftl_sd);
-          new_trace.updateWeightedMZsd();
-          new_trace.setLabel("T" + String(trace_number));
-          ++trace_number;
+        this->setProgress(peaks_detected);
 
-          found_masstraces.push_back(new_trace);
+        // check if we already reached the (optional) maximum number of traces
+        if (max_traces > 0 && accepted.size() >= max_traces) break;
+      }
 
-          peaks_detected += new_trace.getSize();
-          this->setProgress(peaks_detected);
+      // report traces in order of decreasing apex intensity
+      std::sort(accepted.begin(), accepted.end(),
+                [](const TraceCandidate_& a, const TraceCandidate_& b) { return a.rank < b.rank; });
+      if (max_traces > 0 && accepted.size() > max_traces) accepted.resize(max_traces);
 
-          // check if we already reached the (optional) maximum number of traces
-          if (max_traces > 0 && found_masstraces.size() == max_traces) break;
-        }
+      found_masstraces.reserve(accepted.size());
+      for (Size i = 0; i < accepted.size(); ++i)
+      {
+        found_masstraces.push_back(accepted[i].trace);
+        found_masstraces.back().setLabel("T" + String(i + 1));
       }
 
       this->endProgress();
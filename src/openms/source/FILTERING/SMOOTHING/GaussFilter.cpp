@@ -34,6 +34,12 @@
 
 #include <OpenMS/FILTERING/SMOOTHING/GaussFilter.h>
 
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
@@ -60,4 +66,66 @@ namespace OpenMS
             (double)param_.getValue("ppm_tolerance"), param_.getValue("use_ppm_tolerance").toBool());
   }
 
+  void GaussFilter::filterExperiment(PeakMap & map)
+  {
+    const SignedSize n_spectra = (SignedSize)map.size();
+    const SignedSize n_total = n_spectra + (SignedSize)map.getChromatograms().size();
+    Size progress = 0;
+    startProgress(0, n_total, "smoothing data");
+
+    Size errCount = 0;
+    std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      // with "use_ppm_tolerance" the kernel is re-initialized for every data
+      // point, so each thread needs its own copy of the filter
+      GaussFilter local_filter(*this);
+      local_filter.setLogType(ProgressLogger::NONE);
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 10)
+#endif
+      for (SignedSize i = 0; i < n_total; ++i)
+      {
+        // parallel exception catching and re-throwing business
+        if (errCount) continue; // no need to process further if error was raised
+
+        try
+        {
+          if (i < n_spectra)
+          {
+            local_filter.filter(map[i]);
+          }
+          else
+          {
+            local_filter.filter(map.getChromatogram(i - n_spectra));
+          }
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (GaussFilter_filterExperiment)
+#endif
+          {
+            if (!errCount) error = std::current_exception();
+            ++errCount;
+          }
+        }
+
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        ++progress;
+        IF_MASTERTHREAD
+        {
+          setProgress(progress);
+        }
+      }
+    }
+    endProgress();
+    if (error) std::rethrow_exception(error);
+  }
+
 }
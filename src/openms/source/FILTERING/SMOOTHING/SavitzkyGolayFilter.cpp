@@ -38,6 +38,12 @@
 #include <Eigen/Core>
 #include <Eigen/SVD>
 
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
   SavitzkyGolayFilter::SavitzkyGolayFilter() :
@@ -105,4 +111,57 @@ namespace OpenMS
       }
     }
   }
+
+  void SavitzkyGolayFilter::filterExperiment(PeakMap & map)
+  {
+    const SignedSize n_spectra = (SignedSize)map.size();
+    const SignedSize n_total = n_spectra + (SignedSize)map.getChromatograms().size();
+    Size progress = 0;
+    startProgress(0, n_total, "smoothing data");
+
+    // spectra and chromatograms are independent and the filter only reads its coefficients
+    Size errCount = 0;
+    std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 10)
+#endif
+    for (SignedSize i = 0; i < n_total; ++i)
+    {
+      // parallel exception catching and re-throwing business
+      if (errCount) continue; // no need to process further if error was raised
+
+      try
+      {
+        if (i < n_spectra)
+        {
+          filter(map[i]);
+        }
+        else
+        {
+          filter(map.getChromatogram(i - n_spectra));
+        }
+      }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical (SavitzkyGolayFilter_filterExperiment)
+#endif
+        {
+          if (!errCount) error = std::current_exception();
+          ++errCount;
+        }
+      }
+
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+      ++progress;
+      IF_MASTERTHREAD
+      {
+        setProgress(progress);
+      }
+    }
+    endProgress();
+    if (error) std::rethrow_exception(error);
+  }
 }
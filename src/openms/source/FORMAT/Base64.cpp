@@ -37,6 +37,21 @@
 #include <QtCore/QList>
 #include <QtCore/QString>
 
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define OPENMS_BASE64_SIMD
+#define OPENMS_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define OPENMS_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(OPENMS_COMPILER_MSVC) && defined(_M_X64)
+#define OPENMS_BASE64_SIMD
+#define OPENMS_TARGET_SSE41
+#define OPENMS_TARGET_AVX2
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
 using namespace std;
 
 namespace OpenMS
@@ -44,85 +59,355 @@ namespace OpenMS
 
   /*
 
-   Background in the following two encoding / decoding mapping arrays.
-
-   While encoding we have to map a binary value to its character value using
-   the base 64 mapping:
+   Background on the decoding table: while encoding we map a 6 bit value to
+   its character using the Base64 alphabet
 
     binary  ->    char = val
 
-       0    ->     A   = 65  
-                   ...     
-      25    ->     Z   = 90  
-      26    ->     a   = 97  
-                   ...     
-      51    ->     z   = 122 
-      52    ->     0   = 48  
-                   ...     
-      61    ->     9   = 57  
-      62    ->     +   = 43  
-      63    ->     /   = 47  
-      
-   
-   While decoding we have to map a character to its base 64 target using the
-   base 64 mapping:
-
-    char = val      ->      target 
-   
-     A   = 65       ->        0
-     ...     
-     Z   = 90       ->       25
-     a   = 97       ->       26
-     ...     
-     z   = 122      ->       51
-     0   = 48       ->       52
-     ...     
-     9   = 57       ->       61
-     +   = 43       ->       62
-     /   = 47       ->       63
-
-
-  this can be done by first subtracting 43 from each value
-  and then looking up a value in a table as found in the code,
-  e.g. lookup[char - 43] - 62
-
-  The following string can be produced by this Python snippet:
-
-offset = 62
-s = ""
-s += chr(62 + offset)
-s += '$' * 3
-s += "".join([ chr(52 + i + offset) for i in range(10) ])
-s += '$' * 7
-s += "".join([ chr(i + offset) for i in range(26) ])
-s += '$' * 6
-s += "".join([ chr(26 + i + offset) for i in range(26) ])
-print s
-
-"|$$$rstuvwxyz{$$$$$$$>?@ABCDEFGHIJKLMNOPQRSTUVW$$$$$$XYZ[\]^_`abcdefghijklmnopq"
-
-  however, this is basically just convenience to produce printable characters.
-  We could also go for a direct mapping:
-
-s = '$' * 42
-s += hex(62)
-s += '$' * 3
-s += "".join([ hex(52 + i) for i in range(10) ])
-s += '$' * 7
-s += "".join([ hex(i) for i in range(26) ])
-s += '$' * 6
-s += "".join([ hex(26 + i) for i in range(26) ])
-print s
-
-"$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$0x3e$$$0x340x350x360x370x380x390x3a0x3b0x3c0x3d$$$$$$$0x00x10x20x30x40x50x60x70x80x90xa0xb0xc0xd0xe0xf0x100x110x120x130x140x150x160x170x180x19$$$$$$0x1a0x1b0x1c0x1d0x1e0x1f0x200x210x220x230x240x250x260x270x280x290x2a0x2b0x2c0x2d0x2e0x2f0x300x310x320x33"
-
-  which would allow lookup[char] without any adding or subtraction step (but
-  needs a 42 byte extra memory in the local cache).
+       0    ->     A   = 65
+                   ...
+      25    ->     Z   = 90
+      26    ->     a   = 97
+                   ...
+      51    ->     z   = 122
+      52    ->     0   = 48
+                   ...
+      61    ->     9   = 57
+      62    ->     +   = 43
+      63    ->     /   = 47
+
+   and while decoding we look up the 6 bit value of each character in a 256
+   entry table (0xFF for characters outside of the alphabet). The SIMD kernels
+   translate characters with range comparisons instead of a table lookup.
 
   */
 
-  const char Base64::encoder_[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-  const char Base64::decoder_[] = "|$$$}rstuvwxyz{$$$$$$$>?@ABCDEFGHIJKLMNOPQRSTUVW$$$$$$XYZ[\\]^_`abcdefghijklmnopq";
+  namespace
+  {
+    /// Maps a character to its 6-bit value or to 0xFF for characters outside the base64 alphabet
+    struct Base64DecodeTable_
+    {
+      unsigned char value[256];
+
+      Base64DecodeTable_()
+      {
+        const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::fill(value, value + 256, 0xFF);
+        for (unsigned char i = 0; i < 64; ++i)
+        {
+          value[(unsigned char)alphabet[i]] = i;
+        }
+      }
+    };
+
+    const Base64DecodeTable_& decodeTable_()
+    {
+      static const Base64DecodeTable_ table;
+      return table;
+    }
+
+    const char encode_table_[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    /// Scalar decoding, skips characters outside the alphabet (e.g. whitespace) and stops at the first '='
+    Size decodeScalar_(const unsigned char* in, Size in_size, Byte* out)
+    {
+      const unsigned char* decode_table = decodeTable_().value;
+      Size i = 0;
+      Size written = 0;
+      // fast path: four valid characters at a time
+      for (; i + 4 <= in_size; i += 4)
+      {
+        const UInt32 a = decode_table[in[i]];
+        const UInt32 b = decode_table[in[i + 1]];
+        const UInt32 c = decode_table[in[i + 2]];
+        const UInt32 d = decode_table[in[i + 3]];
+        if ((a | b | c | d) > 63) break;
+        const UInt32 int_24bit = (a << 18) | (b << 12) | (c << 6) | d;
+        out[written++] = (Byte)(int_24bit >> 16);
+        out[written++] = (Byte)(int_24bit >> 8);
+        out[written++] = (Byte)int_24bit;
+      }
+      // slow path: padding, whitespace or invalid characters
+      UInt32 bit_buffer = 0;
+      int bit_count = 0;
+      for (; i < in_size; ++i)
+      {
+        const UInt32 v = decode_table[in[i]];
+        if (v > 63)
+        {
+          if (in[i] == '=') break;
+          continue;
+        }
+        bit_buffer = (bit_buffer << 6) | v;
+        bit_count += 6;
+        if (bit_count >= 8)
+        {
+          bit_count -= 8;
+          out[written++] = (Byte)(bit_buffer >> bit_count);
+        }
+      }
+      return written;
+    }
+
+    /// Scalar encoding, writes 4 * ceil(in_size / 3) characters including padding
+    void encodeScalar_(const Byte* in, Size in_size, char* out)
+    {
+      Size i = 0;
+      for (; i + 3 <= in_size; i += 3)
+      {
+        const UInt32 int_24bit = (UInt32(in[i]) << 16) | (UInt32(in[i + 1]) << 8) | UInt32(in[i + 2]);
+        *out++ = encode_table_[(int_24bit >> 18) & 0x3F];
+        *out++ = encode_table_[(int_24bit >> 12) & 0x3F];
+        *out++ = encode_table_[(int_24bit >> 6) & 0x3F];
+        *out++ = encode_table_[int_24bit & 0x3F];
+      }
+      if (i < in_size)
+      {
+        const bool two_left = (i + 2 == in_size);
+        const UInt32 int_24bit = (UInt32(in[i]) << 16) | (two_left ? UInt32(in[i + 1]) << 8 : 0);
+        *out++ = encode_table_[(int_24bit >> 18) & 0x3F];
+        *out++ = encode_table_[(int_24bit >> 12) & 0x3F];
+        *out++ = two_left ? encode_table_[(int_24bit >> 6) & 0x3F] : '=';
+        *out++ = '=';
+      }
+    }
+
+    template <typename UIntType>
+    void swapByteOrderScalar_(UIntType* data, Size count);
+
+    template <>
+    void swapByteOrderScalar_<UInt32>(UInt32* data, Size count)
+    {
+      std::transform(data, data + count, data, endianize32);
+    }
+
+    template <>
+    void swapByteOrderScalar_<UInt64>(UInt64* data, Size count)
+    {
+      std::transform(data, data + count, data, endianize64);
+    }
+
+#ifdef OPENMS_BASE64_SIMD
+    /*
+      SIMD kernels (see W. Mula and D. Lemire, "Faster Base64 Encoding and
+      Decoding Using AVX2 Instructions", ACM TWEB 2018). Decoding uses plain
+      range checks to translate characters; a block containing any character
+      outside the alphabet (padding, whitespace) is left to the scalar code.
+    */
+
+    OPENMS_TARGET_SSE41 inline __m128i translateToValues128_(const __m128i chars, bool& valid)
+    {
+      const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(chars, _mm_set1_epi8('Z' + 1)));
+      const __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(chars, _mm_set1_epi8('z' + 1)));
+      const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+      const __m128i plus = _mm_cmpeq_epi8(chars, _mm_set1_epi8('+'));
+      const __m128i slash = _mm_cmpeq_epi8(chars, _mm_set1_epi8('/'));
+      const __m128i all = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(plus, slash)));
+      valid = (_mm_movemask_epi8(all) == 0xFFFF);
+
+      __m128i shift = _mm_and_si128(upper, _mm_set1_epi8(-65));
+      shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(-71)));
+      shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(4)));
+      shift = _mm_or_si128(shift, _mm_and_si128(plus, _mm_set1_epi8(19)));
+      shift = _mm_or_si128(shift, _mm_and_si128(slash, _mm_set1_epi8(16)));
+      return _mm_add_epi8(chars, shift);
+    }
+
+    /// Packs 16 6-bit values (one per byte) into 12 bytes (in the low 12 bytes of the result)
+    OPENMS_TARGET_SSE41 inline __m128i packValues128_(const __m128i values)
+    {
+      const __m128i merged_ab_cd = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+      const __m128i merged = _mm_madd_epi16(merged_ab_cd, _mm_set1_epi32(0x00011000));
+      return _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    }
+
+    /// Splits 12 input bytes (in the low 12 bytes) into 16 6-bit values
+    OPENMS_TARGET_SSE41 inline __m128i unpackBytes128_(const __m128i bytes)
+    {
+      const __m128i shuffled = _mm_shuffle_epi8(bytes, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+      const __m128i t0 = _mm_and_si128(shuffled, _mm_set1_epi32(0x0fc0fc00));
+      const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+      const __m128i t2 = _mm_and_si128(shuffled, _mm_set1_epi32(0x003f03f0));
+      const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+      return _mm_or_si128(t1, t3);
+    }
+
+    OPENMS_TARGET_SSE41 inline __m128i translateToChars128_(const __m128i values)
+    {
+      __m128i shift = _mm_set1_epi8(65);
+      shift = _mm_add_epi8(shift, _mm_and_si128(_mm_cmpgt_epi8(values, _mm_set1_epi8(25)), _mm_set1_epi8(6)));
+      shift = _mm_add_epi8(shift, _mm_and_si128(_mm_cmpgt_epi8(values, _mm_set1_epi8(51)), _mm_set1_epi8(-75)));
+      shift = _mm_add_epi8(shift, _mm_and_si128(_mm_cmpeq_epi8(values, _mm_set1_epi8(62)), _mm_set1_epi8(-15)));
+      shift = _mm_add_epi8(shift, _mm_and_si128(_mm_cmpeq_epi8(values, _mm_set1_epi8(63)), _mm_set1_epi8(-12)));
+      return _mm_add_epi8(values, shift);
+    }
+
+    OPENMS_TARGET_SSE41 Size decodeSSE41_(const unsigned char* in, Size in_size, Byte* out, Size& consumed)
+    {
+      Size i = 0;
+      Size written = 0;
+      for (; i + 16 <= in_size; i += 16)
+      {
+        bool valid;
+        const __m128i values = translateToValues128_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), valid);
+        if (!valid) break;
+        alignas(16) Byte block[16];
+        _mm_store_si128(reinterpret_cast<__m128i*>(block), packValues128_(values));
+        std::memcpy(out + written, block, 12);
+        written += 12;
+      }
+      consumed = i;
+      return written;
+    }
+
+    OPENMS_TARGET_SSE41 Size encodeSSE41_(const Byte* in, Size in_size, char* out)
+    {
+      Size i = 0;
+      // 16 bytes are loaded but only 12 are encoded per iteration
+      for (; i + 16 <= in_size; i += 12)
+      {
+        const __m128i values = unpackBytes128_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), translateToChars128_(values));
+        out += 16;
+      }
+      return i;
+    }
+
+    OPENMS_TARGET_SSE41 void swapByteOrderSSE41_(Byte* data, Size count, Size element_size)
+    {
+      const __m128i mask = (element_size == 4) ?
+        _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12) :
+        _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+      const Size bytes = count * element_size;
+      Size i = 0;
+      for (; i + 16 <= bytes; i += 16)
+      {
+        __m128i* p = reinterpret_cast<__m128i*>(data + i);
+        _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), mask));
+      }
+      if (element_size == 4) swapByteOrderScalar_(reinterpret_cast<UInt32*>(data + i), (bytes - i) / 4);
+      else swapByteOrderScalar_(reinterpret_cast<UInt64*>(data + i), (bytes - i) / 8);
+    }
+
+    OPENMS_TARGET_AVX2 Size decodeAVX2_(const unsigned char* in, Size in_size, Byte* out, Size& consumed)
+    {
+      const __m256i upper_min = _mm256_set1_epi8('A' - 1), upper_max = _mm256_set1_epi8('Z' + 1);
+      const __m256i lower_min = _mm256_set1_epi8('a' - 1), lower_max = _mm256_set1_epi8('z' + 1);
+      const __m256i digit_min = _mm256_set1_epi8('0' - 1), digit_max = _mm256_set1_epi8('9' + 1);
+      const __m256i shuffle = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                               2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+      Size i = 0;
+      Size written = 0;
+      for (; i + 32 <= in_size; i += 32)
+      {
+        const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(chars, upper_min), _mm256_cmpgt_epi8(upper_max, chars));
+        const __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi8(chars, lower_min), _mm256_cmpgt_epi8(lower_max, chars));
+        const __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(chars, digit_min), _mm256_cmpgt_epi8(digit_max, chars));
+        const __m256i plus = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('+'));
+        const __m256i slash = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('/'));
+        const __m256i all = _mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(digit, _mm256_or_si256(plus, slash)));
+        if (_mm256_movemask_epi8(all) != -1) break;
+
+        __m256i shift = _mm256_and_si256(upper, _mm256_set1_epi8(-65));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(lower, _mm256_set1_epi8(-71)));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(digit, _mm256_set1_epi8(4)));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(plus, _mm256_set1_epi8(19)));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(slash, _mm256_set1_epi8(16)));
+        const __m256i values = _mm256_add_epi8(chars, shift);
+
+        const __m256i merged_ab_cd = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        const __m256i merged = _mm256_madd_epi16(merged_ab_cd, _mm256_set1_epi32(0x00011000));
+        alignas(32) Byte block[32];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(block), _mm256_shuffle_epi8(merged, shuffle));
+        std::memcpy(out + written, block, 12);
+        std::memcpy(out + written + 12, block + 16, 12);
+        written += 24;
+      }
+      consumed = i;
+      return written;
+    }
+
+    OPENMS_TARGET_AVX2 Size encodeAVX2_(const Byte* in, Size in_size, char* out)
+    {
+      const __m256i unpack_shuffle = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                                      1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+      Size i = 0;
+      // two 16 byte loads at offsets 0 and 12, 24 bytes are encoded per iteration
+      for (; i + 28 <= in_size; i += 24)
+      {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 12));
+        const __m256i bytes = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        const __m256i shuffled = _mm256_shuffle_epi8(bytes, unpack_shuffle);
+        const __m256i t0 = _mm256_and_si256(shuffled, _mm256_set1_epi32(0x0fc0fc00));
+        const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(shuffled, _mm256_set1_epi32(0x003f03f0));
+        const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const __m256i values = _mm256_or_si256(t1, t3);
+
+        __m256i shift = _mm256_set1_epi8(65);
+        shift = _mm256_add_epi8(shift, _mm256_and_si256(_mm256_cmpgt_epi8(values, _mm256_set1_epi8(25)), _mm256_set1_epi8(6)));
+        shift = _mm256_add_epi8(shift, _mm256_and_si256(_mm256_cmpgt_epi8(values, _mm256_set1_epi8(51)), _mm256_set1_epi8(-75)));
+        shift = _mm256_add_epi8(shift, _mm256_and_si256(_mm256_cmpeq_epi8(values, _mm256_set1_epi8(62)), _mm256_set1_epi8(-15)));
+        shift = _mm256_add_epi8(shift, _mm256_and_si256(_mm256_cmpeq_epi8(values, _mm256_set1_epi8(63)), _mm256_set1_epi8(-12)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_add_epi8(values, shift));
+        out += 32;
+      }
+      return i;
+    }
+
+    OPENMS_TARGET_AVX2 void swapByteOrderAVX2_(Byte* data, Size count, Size element_size)
+    {
+      const __m256i mask = (element_size == 4) ?
+        _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12) :
+        _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+      const Size bytes = count * element_size;
+      Size i = 0;
+      for (; i + 32 <= bytes; i += 32)
+      {
+        __m256i* p = reinterpret_cast<__m256i*>(data + i);
+        _mm256_storeu_si256(p, _mm256_shuffle_epi8(_mm256_loadu_si256(p), mask));
+      }
+      if (element_size == 4) swapByteOrderScalar_(reinterpret_cast<UInt32*>(data + i), (bytes - i) / 4);
+      else swapByteOrderScalar_(reinterpret_cast<UInt64*>(data + i), (bytes - i) / 8);
+    }
+
+    /// Instruction set used by the kernels, determined once at runtime
+    enum SimdLevel_ { SIMD_NONE, SIMD_SSE41, SIMD_AVX2 };
+
+    SimdLevel_ detectSimdLevel_()
+    {
+#if defined(OPENMS_COMPILER_MSVC)
+      int info[4];
+      __cpuid(info, 0);
+      const int max_leaf = info[0];
+      __cpuid(info, 1);
+      const bool sse41 = (info[2] & (1 << 19)) != 0;
+      const bool os_avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+      bool avx2 = false;
+      if (max_leaf >= 7 && os_avx)
+      {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+      }
+#else
+      __builtin_cpu_init();
+      const bool sse41 = __builtin_cpu_supports("sse4.1");
+      const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+      if (avx2) return SIMD_AVX2;
+      if (sse41) return SIMD_SSE41;
+      return SIMD_NONE;
+    }
+
+    SimdLevel_ simdLevel_()
+    {
+      static const SimdLevel_ level = detectSimdLevel_();
+      return level;
+    }
+#endif
+  }
 
   void Base64::encodeStrings(const std::vector<String>& in, String& out, bool zlib_compression, bool append_null_byte)
   {
@@ -131,26 +416,150 @@ print s
       return;
 
     std::string str;
-    std::string compressed;
-    Byte* it;
-    Byte* end;
     for (Size i = 0; i < in.size(); ++i)
     {
       str = str.append(in[i]);
       if (append_null_byte) str.push_back('\0');
     }
 
+    encodeBytes_(reinterpret_cast<const Byte*>(str.data()), str.size(), out, zlib_compression);
+  }
+
+  Size Base64::decodeRaw_(const char* in, Size in_size, Byte* out)
+  {
+    const unsigned char* chars = reinterpret_cast<const unsigned char*>(in);
+    Size consumed = 0;
+    Size written = 0;
+#ifdef OPENMS_BASE64_SIMD
+    switch (simdLevel_())
+    {
+    case SIMD_AVX2:
+      written = decodeAVX2_(chars, in_size, out, consumed);
+      break;
+
+    case SIMD_SSE41:
+      written = decodeSSE41_(chars, in_size, out, consumed);
+      break;
+
+    default:
+      break;
+    }
+#endif
+    // remainder, padding and blocks with characters outside the alphabet
+    return written + decodeScalar_(chars + consumed, in_size - consumed, out + written);
+  }
+
+  void Base64::encodeRaw_(const Byte* in, Size in_size, char* out)
+  {
+    Size consumed = 0;
+#ifdef OPENMS_BASE64_SIMD
+    switch (simdLevel_())
+    {
+    case SIMD_AVX2:
+      consumed = encodeAVX2_(in, in_size, out);
+      break;
+
+    case SIMD_SSE41:
+      consumed = encodeSSE41_(in, in_size, out);
+      break;
+
+    default:
+      break;
+    }
+#endif
+    // the kernels always consume a multiple of 3 bytes
+    encodeScalar_(in + consumed, in_size - consumed, out + consumed / 3 * 4);
+  }
+
+  void Base64::swapByteOrder_(void* data, Size count, Size element_size)
+  {
+#ifdef OPENMS_BASE64_SIMD
+    switch (simdLevel_())
+    {
+    case SIMD_AVX2:
+      swapByteOrderAVX2_(reinterpret_cast<Byte*>(data), count, element_size);
+      return;
+
+    case SIMD_SSE41:
+      swapByteOrderSSE41_(reinterpret_cast<Byte*>(data), count, element_size);
+      return;
+
+    default:
+      break;
+    }
+#endif
+    if (element_size == 4)
+    {
+      swapByteOrderScalar_(reinterpret_cast<UInt32*>(data), count);
+    }
+    else
+    {
+      swapByteOrderScalar_(reinterpret_cast<UInt64*>(data), count);
+    }
+  }
+
+  Size Base64::inflate_(const Byte* in, Size in_size, const std::function<Byte*(Size)>& get_buffer)
+  {
+    z_stream stream;
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    stream.next_in = const_cast<Bytef*>(in);
+    stream.avail_in = (uInt)in_size;
+    if (inflateInit(&stream) != Z_OK)
+    {
+      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Decompression error?");
+    }
+
+    // binary data arrays usually compress by a factor of 2-4
+    Size capacity = (std::max)(Size(4 * in_size), Size(64));
+    Byte* buffer = get_buffer(capacity);
+    Size written = 0;
+    int zlib_error = Z_OK;
+    while (true)
+    {
+      stream.next_out = buffer + written;
+      stream.avail_out = (uInt)(capacity - written);
+      zlib_error = inflate(&stream, Z_NO_FLUSH);
+      written = capacity - stream.avail_out;
+
+      if (zlib_error == Z_STREAM_END) break;
+      if (zlib_error != Z_OK && zlib_error != Z_BUF_ERROR) break;
+      if (stream.avail_out != 0)
+      {
+        // no progress possible although there is space left -> truncated input
+        zlib_error = Z_DATA_ERROR;
+        break;
+      }
+      capacity *= 2;
+      buffer = get_buffer(capacity);
+    }
+    inflateEnd(&stream);
+
+    if (zlib_error != Z_STREAM_END)
+    {
+      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Decompression error?");
+    }
+    return written;
+  }
+
+  void Base64::encodeBytes_(const Byte* in, Size in_size, String& out, bool zlib_compression)
+  {
+    std::string compressed;
     if (zlib_compression)
     {
-      unsigned long sourceLen =   (unsigned long)str.size();
-      unsigned long compressed_length = //compressBound((unsigned long)str.size());
+      unsigned long sourceLen =   (unsigned long)in_size;
+      unsigned long compressed_length = //compressBound((unsigned long)in_size);
                                         sourceLen + (sourceLen >> 12) + (sourceLen >> 14) + 11; // taken from zlib's compress.c, as we cannot use compressBound*
+      //
+      // (*) compressBound is not defined in the QtCore lib, which forces the linker under windows to link in our zlib.
+      //     This leads to multiply defined symbols as compress() is then defined twice.
 
       int zlib_error;
       do
       {
         compressed.resize(compressed_length);
-        zlib_error = compress(reinterpret_cast<Bytef*>(&compressed[0]), &compressed_length, reinterpret_cast<Bytef*>(&str[0]), (unsigned long) str.size());
+        zlib_error = compress(reinterpret_cast<Bytef*>(&compressed[0]), &compressed_length, reinterpret_cast<const Bytef*>(in), (unsigned long)in_size);
 
         switch (zlib_error)
         {
@@ -167,57 +576,16 @@ print s
         throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Compression error?");
       }
 
-      it = reinterpret_cast<Byte*>(&compressed[0]);
-      end = it + compressed_length;
-      // TODO check integer overflow
-      out.resize((Size)ceil(compressed_length / 3.) * 4); //resize output array in order to have enough space for all characters
-    }
-    else
-    {
-      // TODO check integer overflow
-      out.resize((Size)ceil(str.size() / 3.) * 4); //resize output array in order to have enough space for all characters
-      it = reinterpret_cast<Byte*>(&str[0]);
-      end = it + str.size();
+      in = reinterpret_cast<const Byte*>(compressed.data());
+      in_size = compressed_length;
     }
-    Byte* to = reinterpret_cast<Byte*>(&out[0]);
-    Size written = 0;
 
-    while (it != end)
+    // TODO check integer overflow
+    out.resize((in_size + 2) / 3 * 4); // 4 characters for every (started) 3 bytes
+    if (in_size > 0)
     {
-      Int int_24bit = 0;
-      Int padding_count = 0;
-
-      // construct 24-bit integer from 3 bytes
-      for (Size i = 0; i < 3; i++)
-      {
-        if (it != end)
-        {
-          int_24bit |= *it++ << ((2 - i) * 8);
-        }
-        else
-        {
-          padding_count++;
-        }
-      }
-
-      // write out 4 characters
-      for (Int i = 3; i >= 0; i--)
-      {
-        to[i] = encoder_[int_24bit & 0x3F];
-        int_24bit >>= 6;
-      }
-
-      // fixup for padding
-      if (padding_count > 0)
-        to[3] = '=';
-      if (padding_count > 1)
-        to[2] = '=';
-
-      to += 4;
-      written += 4;
+      encodeRaw_(in, in_size, &out[0]);
     }
-
-    out.resize(written); //no more space is needed
   }
 
   void Base64::decodeStrings(const String& in, std::vector<String>& out, bool zlib_compression)
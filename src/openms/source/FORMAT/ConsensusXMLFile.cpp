@@ -38,12 +38,218 @@
 #include <OpenMS/SYSTEM/File.h>
 #include <OpenMS/METADATA/DataProcessing.h>
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
+#include <OpenMS/FORMAT/HANDLERS/XMLPullTokenizer.h>
+
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
 #include <fstream>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 
 namespace OpenMS
 {
+  namespace
+  {
+    /// User parameters of one consensus element, they are set in document order after parsing (see ConsensusXMLFile::loadFast_)
+    typedef std::vector<std::pair<String, DataValue> > UserParams_;
+
+    /**
+      @brief Parses the consensus elements in [@p begin, @p end) with the pull tokenizer
+
+      Mirrors ConsensusXMLFile::startElement() and endElement() for the
+      content written by ConsensusXMLFile::store() (centroid, grouped elements
+      and user parameters). Everything else (e.g. PeptideIdentification
+      elements or elements without a centroid, which inherit the centroid of
+      the previous element in the Xerces code path) results in an
+      Exception::ParseError so that the caller can fall back to Xerces.
+    */
+    void parseConsensusElements_(const char* begin, const char* end, const PeakFileOptions& options,
+                                 std::vector<ConsensusFeature>& features, std::vector<UserParams_>& user_params)
+    {
+      Internal::XMLPullTokenizer tokenizer(begin, end);
+      ConsensusFeature feature;
+      UserParams_ params;
+      DPosition<2> pos;
+      double it(0.0);
+      bool has_centroid(false), in_grouped_list(false);
+      String tmp;
+      UniqueIdInterface tmp_unique_id_interface;
+
+      for (Internal::XMLPullTokenizer::TokenType token = tokenizer.next(); token != Internal::XMLPullTokenizer::END_OF_INPUT; token = tokenizer.next())
+      {
+        const Size depth = tokenizer.depth();
+        if (token == Internal::XMLPullTokenizer::END_TAG)
+        {
+          if (depth == 0) // end of consensusElement
+          {
+            if ((!options.hasRTRange() || options.getRTRange().encloses(feature.getRT())) &&
+                (!options.hasMZRange() || options.getMZRange().encloses(feature.getMZ())) &&
+                (!options.hasIntensityRange() || options.getIntensityRange().encloses(feature.getIntensity())))
+            {
+              features.push_back(std::move(feature));
+              user_params.push_back(std::move(params));
+            }
+          }
+          continue;
+        }
+
+        if (depth == 1)
+        {
+          if (!tokenizer.isTag("consensusElement"))
+          {
+            throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, tokenizer.getTag(), "Unexpected element in consensusElementList");
+          }
+          feature = ConsensusFeature();
+          params.clear();
+          has_centroid = false;
+          double quality = 0.0;
+          if (tokenizer.getAttribute("quality", quality))
+          {
+            feature.setQuality(quality);
+          }
+          Int charge = 0;
+          if (tokenizer.getAttribute("charge", charge))
+          {
+            feature.setCharge(charge);
+          }
+          if (!tokenizer.getAttribute("id", tmp))
+          {
+            throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "consensusElement", "Required attribute 'id' not present");
+          }
+          feature.setUniqueId(tmp);
+        }
+        else if (depth == 2 && tokenizer.isTag("centroid"))
+        {
+          if (!tokenizer.getAttribute("rt", pos[Peak2D::RT]) || !tokenizer.getAttribute("mz", pos[Peak2D::MZ]) || !tokenizer.getAttribute("it", it))
+          {
+            throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "centroid", "Incomplete centroid");
+          }
+          has_centroid = true;
+          in_grouped_list = false;
+        }
+        else if (depth == 2 && tokenizer.isTag("groupedElementList"))
+        {
+          in_grouped_list = true;
+        }
+        else if (depth == 3 && in_grouped_list && has_centroid && tokenizer.isTag("element"))
+        {
+          if (!tokenizer.getAttribute("map", tmp))
+          {
+            throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "element", "Required attribute 'map' not present");
+          }
+          if (tmp != "")
+          {
+            tmp_unique_id_interface.setUniqueId(tmp);
+            UInt64 map_index = tmp_unique_id_interface.getUniqueId();
+            if (!tokenizer.getAttribute("id", tmp))
+            {
+              throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "element", "Required attribute 'id' not present");
+            }
+            if (tmp != "")
+            {
+              tmp_unique_id_interface.setUniqueId(tmp);
+              FeatureHandle handle;
+              handle.setMapIndex(map_index);
+              handle.setUniqueId(tmp_unique_id_interface.getUniqueId());
+
+              DPosition<2> element_pos;
+              double intensity = 0.0;
+              if (!tokenizer.getAttribute("rt", element_pos[0]) || !tokenizer.getAttribute("mz", element_pos[1]) || !tokenizer.getAttribute("it", intensity))
+              {
+                throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "element", "Incomplete element");
+              }
+              handle.setPosition(element_pos);
+              handle.setIntensity(intensity);
+
+              Int charge = 0;
+              if (tokenizer.getAttribute("charge", charge))
+              {
+                handle.setCharge(charge);
+              }
+              feature.insert(handle);
+            }
+          }
+          feature.getPosition() = pos;
+          feature.setIntensity(it);
+        }
+        else if (depth == 2 && (tokenizer.isTag("UserParam") || tokenizer.isTag("userParam")))
+        {
+          in_grouped_list = false;
+          String name, type;
+          if (!tokenizer.getAttribute("name", name) || !tokenizer.getAttribute("type", type))
+          {
+            throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "UserParam", "Required attribute not present");
+          }
+          if (type == "int")
+          {
+            Int value = 0;
+            if (!tokenizer.getAttribute("value", value))
+            {
+              throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, name, "Required attribute 'value' not present");
+            }
+            params.emplace_back(name, value);
+          }
+          else if (type == "float")
+          {
+            double value = 0.0;
+            if (!tokenizer.getAttribute("value", value))
+            {
+              throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, name, "Required attribute 'value' not present");
+            }
+            params.emplace_back(name, value);
+          }
+          else
+          {
+            if (!tokenizer.getAttribute("value", tmp))
+            {
+              throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, name, "Required attribute 'value' not present");
+            }
+            if (type == "string")
+            {
+              params.emplace_back(name, tmp);
+            }
+            else if (tmp.hasPrefix('[') && tmp.hasSuffix(']'))
+            {
+              if (type == "intList")
+              {
+                params.emplace_back(name, ListUtils::create<Int>(tmp.substr(1, tmp.size() - 2)));
+              }
+              else if (type == "floatList")
+              {
+                params.emplace_back(name, ListUtils::create<double>(tmp.substr(1, tmp.size() - 2)));
+              }
+              else if (type == "stringList")
+              {
+                params.emplace_back(name, ListUtils::create<String>(tmp.substr(1, tmp.size() - 2)));
+              }
+              else
+              {
+                throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, type, "Invalid UserParam type");
+              }
+            }
+            else
+            {
+              throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, tmp, "List argument is not a string representation of a list");
+            }
+          }
+        }
+        else
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, tokenizer.getTag(), "Element not supported by the fast consensusXML parser");
+        }
+      }
+    }
+  }
+
   ConsensusXMLFile::ConsensusXMLFile() :
     XMLHandler("", "1.7"),
     XMLFile("/SCHEMAS/ConsensusXML_1_7.xsd", "1.7"),
@@ -916,7 +1122,10 @@ namespace OpenMS
     consensus_map_->setLoadedFileType(file_);
     consensus_map_->setLoadedFilePath(file_);
 
-    parse_(filename, this);
+    if (!options_.getFastParsing() || !loadFast_(filename))
+    {
+      parse_(filename, this);
+    }
 
     if (!map.isMapConsistent(&OpenMS_Log_warn)) // a warning is printed to LOG_WARN during isMapConsistent()
     {
@@ -944,6 +1153,143 @@ namespace OpenMS
     map.updateRanges();
   }
 
+  bool
+  ConsensusXMLFile::loadFast_(const String& filename)
+  {
+    boost::interprocess::file_mapping file;
+    boost::interprocess::mapped_region region;
+    try
+    {
+      boost::interprocess::file_mapping(filename.c_str(), boost::interprocess::read_only).swap(file);
+      boost::interprocess::mapped_region(file, boost::interprocess::read_only).swap(region);
+    }
+    catch (boost::interprocess::interprocess_exception&)
+    {
+      return false; // e.g. missing or empty file, Xerces reports the error
+    }
+    const char* begin = static_cast<const char*>(region.get_address());
+    const char* end = begin + region.get_size();
+
+    // The pull parser only accepts ASCII inside the element list, so any
+    // ASCII-compatible encoding (UTF-8, ISO-8859-1, ...) is read without
+    // transcoding. Compressed files and UTF-16 do not start with '<'.
+    const char* start = begin;
+    if (end - start >= 3 && std::memcmp(start, "\xEF\xBB\xBF", 3) == 0)
+    {
+      start += 3;
+    }
+    if (start == end || *start != '<')
+    {
+      return false;
+    }
+
+    static const char list_tag[] = "<consensusElementList";
+    static const char list_end_tag[] = "</consensusElementList";
+    static const char element_tag[] = "<consensusElement";
+    const Size element_tag_length = sizeof(element_tag) - 1;
+
+    const char* body_begin = std::search(start, end, list_tag, list_tag + sizeof(list_tag) - 1);
+    body_begin = std::find(body_begin, end, '>');
+    if (body_begin == end || *(body_begin - 1) == '/')
+    {
+      return false; // no or empty list, nothing to gain
+    }
+    ++body_begin;
+    const char* body_end = std::find_end(body_begin, end, list_end_tag, list_end_tag + sizeof(list_end_tag) - 1);
+    if (body_end == end)
+    {
+      return false;
+    }
+
+    // split the list into blocks of consensus elements
+    Size thread_count(1);
+#ifdef _OPENMP
+    thread_count = omp_get_max_threads();
+#endif
+    const Size min_block_size(1 << 16);
+    const Size block_count = std::max(Size(1), std::min(4 * thread_count, Size(body_end - body_begin) / min_block_size));
+    std::vector<const char*> bounds(1, body_begin);
+    for (Size i = 1; i < block_count; ++i)
+    {
+      const char* pos = std::max(bounds.back(), body_begin + i * (body_end - body_begin) / block_count);
+      while (true)
+      {
+        pos = std::search(pos, body_end, element_tag, element_tag + element_tag_length);
+        if (pos == body_end || body_end - pos == (SignedSize)element_tag_length) break;
+        const char c = pos[element_tag_length];
+        if (c == ' ' || c == '>' || c == '/' || c == '\t' || c == '\n' || c == '\r') break;
+        ++pos;
+      }
+      if (pos == body_end) break;
+      if (pos != bounds.back()) bounds.push_back(pos);
+    }
+    bounds.push_back(body_end);
+
+    const SignedSize blocks = bounds.size() - 1;
+    std::vector<std::vector<ConsensusFeature> > features(blocks);
+    std::vector<std::vector<UserParams_> > user_params(blocks);
+    Size errCount = 0;
+    std::exception_ptr error;
+#pragma omp parallel for schedule(dynamic, 1)
+    for (SignedSize i = 0; i < blocks; ++i)
+    {
+      // parallel exception catching and re-throwing business
+      if (errCount) continue;
+      try
+      {
+        parseConsensusElements_(bounds[i], bounds[i + 1], options_, features[i], user_params[i]);
+      }
+      catch (...)
+      {
+#pragma omp critical (ConsensusXMLFile_loadFast)
+        {
+          if (!errCount) error = std::current_exception();
+          ++errCount;
+        }
+      }
+    }
+    if (error)
+    {
+      try
+      {
+        std::rethrow_exception(error);
+      }
+      catch (Exception::BaseException&)
+      {
+        return false; // content not handled by the pull parser, Xerces reproduces errors
+      }
+    }
+
+    // header, maps, identifications and data processing are parsed by Xerces
+    // (the element list is cut out), then the elements are appended in order
+    std::string rest;
+    rest.reserve((body_begin - begin) + (end - body_end));
+    rest.append(begin, body_begin);
+    rest.append(body_end, end);
+    parseBuffer_(rest, this);
+
+    Size size = 0;
+    for (SignedSize i = 0; i < blocks; ++i)
+    {
+      size += features[i].size();
+    }
+    consensus_map_->reserve(consensus_map_->size() + size);
+    for (SignedSize i = 0; i < blocks; ++i)
+    {
+      for (Size j = 0; j < features[i].size(); ++j)
+      {
+        // set the user parameters here, so that new meta value names are
+        // registered in document order (as in the Xerces code path)
+        for (const std::pair<String, DataValue>& param : user_params[i][j])
+        {
+          features[i][j].setMetaValue(param.first, param.second);
+        }
+        consensus_map_->push_back(std::move(features[i][j]));
+      }
+    }
+    return true;
+  }
+
   void
   ConsensusXMLFile::writePeptideIdentification_(const String& filename, std::ostream& os, const PeptideIdentification& id, const String& tag_name,
                                                 UInt indentation_level)
@@ -0,0 +1,177 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest, Chris Bielow $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataParallelTransformingConsumer.h>
+
+#include <OpenMS/CONCEPT/LogStream.h>
+
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace OpenMS
+{
+  namespace
+  {
+    /// apply @p f to all elements of @p data in parallel, rethrowing the first exception (if any)
+    template <typename ContainerType>
+    void transformParallel(std::vector<ContainerType>& data, const std::function<void (ContainerType&)>& f)
+    {
+      if (!f) return;
+
+      size_t errCount = 0;
+      std::exception_ptr error;
+#pragma omp parallel for schedule(dynamic)
+      for (SignedSize i = 0; i < (SignedSize)data.size(); ++i)
+      {
+        // parallel exception catching and re-throwing business
+        if (!errCount) // no need to process further if already an error was encountered
+        {
+          try
+          {
+            f(data[i]);
+          }
+          catch (...)
+          {
+#pragma omp critical (MSDataParallelTransformingConsumer_error)
+            {
+              if (!errCount) error = std::current_exception();
+              ++errCount;
+            }
+          }
+        }
+      }
+      if (errCount != 0)
+      {
+        data.clear();
+        std::rethrow_exception(error);
+      }
+    }
+  }
+
+  MSDataParallelTransformingConsumer::MSDataParallelTransformingConsumer(Interfaces::IMSDataConsumer* next_consumer, Size batch_size) :
+    next_consumer_(next_consumer),
+    batch_size_(batch_size),
+    lambda_spec_(nullptr),
+    lambda_chrom_(nullptr)
+  {
+    if (batch_size_ == 0)
+    {
+      // a few elements per thread balances the load without holding much data in memory
+#ifdef _OPENMP
+      batch_size_ = 4 * omp_get_max_threads();
+#else
+      batch_size_ = 1;
+#endif
+    }
+    spectra_.reserve(batch_size_);
+  }
+
+  MSDataParallelTransformingConsumer::~MSDataParallelTransformingConsumer()
+  {
+    // must not throw from a destructor: call flush() explicitly to get notified about errors
+    try
+    {
+      flush();
+    }
+    catch (std::exception& e)
+    {
+      OPENMS_LOG_ERROR << "Error while processing the last batch of MS data: " << e.what() << std::endl;
+    }
+  }
+
+  void MSDataParallelTransformingConsumer::setExpectedSize(Size expectedSpectra, Size expectedChromatograms)
+  {
+    next_consumer_->setExpectedSize(expectedSpectra, expectedChromatograms);
+  }
+
+  void MSDataParallelTransformingConsumer::setExperimentalSettings(const ExperimentalSettings& exp)
+  {
+    next_consumer_->setExperimentalSettings(exp);
+  }
+
+  void MSDataParallelTransformingConsumer::consumeSpectrum(SpectrumType& s)
+  {
+    flushChromatograms_(); // keep the order of spectra and chromatograms
+    spectra_.push_back(std::move(s));
+    if (spectra_.size() >= batch_size_) flushSpectra_();
+  }
+
+  void MSDataParallelTransformingConsumer::consumeChromatogram(ChromatogramType& c)
+  {
+    flushSpectra_(); // keep the order of spectra and chromatograms
+    chromatograms_.push_back(std::move(c));
+    if (chromatograms_.size() >= batch_size_) flushChromatograms_();
+  }
+
+  void MSDataParallelTransformingConsumer::setSpectraProcessingFunc(std::function<void (SpectrumType&)> f_spec)
+  {
+    lambda_spec_ = f_spec;
+  }
+
+  void MSDataParallelTransformingConsumer::setChromatogramProcessingFunc(std::function<void (ChromatogramType&)> f_chrom)
+  {
+    lambda_chrom_ = f_chrom;
+  }
+
+  void MSDataParallelTransformingConsumer::flush()
+  {
+    flushSpectra_();
+    flushChromatograms_();
+  }
+
+  Size MSDataParallelTransformingConsumer::getBatchSize() const
+  {
+    return batch_size_;
+  }
+
+  void MSDataParallelTransformingConsumer::flushSpectra_()
+  {
+    if (spectra_.empty()) return;
+    transformParallel(spectra_, lambda_spec_);
+    for (SpectrumType& s : spectra_) next_consumer_->consumeSpectrum(s);
+    spectra_.clear();
+  }
+
+  void MSDataParallelTransformingConsumer::flushChromatograms_()
+  {
+    if (chromatograms_.empty()) return;
+    transformParallel(chromatograms_, lambda_chrom_);
+    for (ChromatogramType& c : chromatograms_) next_consumer_->consumeChromatogram(c);
+    chromatograms_.clear();
+  }
+
+} // namespace OpenMS
@@ -111,11 +111,13 @@ namespace OpenMS
       ofs_ << "\t\t<spectrumList count=\"" << spectra_expected_ << "\" defaultDataProcessingRef=\"dp_sp_0\">\n";
       writing_spectra_ = true;
     }
-    bool renew_native_ids = false;
+    // IMPORTANT make sure the offset corresponds to the start of the <spectrum tag
+    Int64 offset = ofs_.tellp();
+    spectra_offsets_.push_back(std::make_pair(scpy.getNativeID(), offset + 3));
     // TODO writeSpectrum assumes that dps_ has at least one value -> assert
     // this here ...
     Internal::MzMLHandler::writeSpectrum_(ofs_, scpy,
-            spectra_written_++, *validator_, renew_native_ids, dps_);
+            spectra_written_++, scpy.getNativeID(), *validator_, dps_);
   }
 
    void MSDataWritingConsumer::consumeChromatogram(ChromatogramType & c)
@@ -156,6 +158,9 @@ namespace OpenMS
       ofs_ << "\t\t<chromatogramList count=\"" << chromatograms_expected_ << "\" defaultDataProcessingRef=\"dp_sp_0\">\n";
       writing_chromatograms_ = true;
     }
+    // IMPORTANT make sure the offset corresponds to the start of the <chromatogram tag
+    Int64 offset = ofs_.tellp();
+    chromatograms_offsets_.push_back(std::make_pair(ccpy.getNativeID(), offset + 3));
     Internal::MzMLHandler::writeChromatogram_(ofs_, ccpy,
             chromatograms_written_++, *validator_);
   }
@@ -0,0 +1,259 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/FORMAT/HANDLERS/CachedMzMLMappedReader.h>
+
+#include <OpenMS/FORMAT/HANDLERS/CachedMzMLHandler.h>
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/CONCEPT/Macros.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <boost/interprocess/exceptions.hpp>
+
+namespace OpenMS
+{
+namespace Internal
+{
+
+  namespace
+  {
+    /// Reads a plain field at @p pos and advances @p pos, throws if the field extends past @p end
+    template <typename T>
+    T readField_(const char* begin, Size& pos, Size end, const String& filename)
+    {
+      if (end < pos || end - pos < sizeof(T))
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Unexpected end of file while reading record at position " + String(pos) + ".", filename);
+      }
+      T value;
+      std::memcpy(&value, begin + pos, sizeof(T));
+      pos += sizeof(T);
+      return value;
+    }
+
+    /// Skips @p count elements of @p element_size bytes, throws if they extend past @p end
+    void skip_(Size& pos, Size count, Size element_size, Size end, const String& filename)
+    {
+      if (end < pos || count > (end - pos) / element_size)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Data array extends past the end of file at position " + String(pos) + ".", filename);
+      }
+      pos += count * element_size;
+    }
+  }
+
+  CachedMzMLMappedReader::CachedMzMLMappedReader(const String& filename) :
+    filename_(filename),
+    begin_(nullptr),
+    records_end_(0)
+  {
+    if (!File::exists(filename_))
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename_);
+    }
+
+    try
+    {
+      boost::interprocess::file_mapping(filename_.c_str(), boost::interprocess::read_only).swap(file_);
+      boost::interprocess::mapped_region(file_, boost::interprocess::read_only).swap(region_);
+    }
+    catch (boost::interprocess::interprocess_exception& e)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        String("Could not map file into memory: ") + e.what(), filename_);
+    }
+
+    begin_ = static_cast<const char*>(region_.get_address());
+    const Size file_size = region_.get_size();
+    const Size trailer_size = 2 * sizeof(Size);
+    if (file_size < sizeof(int) + trailer_size)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "File is too small to be a cached mzML file. Aborting!", filename_);
+    }
+
+    Size pos = 0;
+    int file_identifier = readField_<int>(begin_, pos, file_size, filename_);
+    if (file_identifier != CACHED_MZML_FILE_IDENTIFIER)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "File might not be a cached mzML file (wrong file magic number). Aborting!", filename_);
+    }
+
+    records_end_ = file_size - trailer_size;
+    Size trailer_pos = records_end_;
+    const Size exp_size = readField_<Size>(begin_, trailer_pos, file_size, filename_);
+    const Size chrom_size = readField_<Size>(begin_, trailer_pos, file_size, filename_);
+
+    // every record needs at least its two size fields, reject corrupt counts
+    // before reserving memory for the index
+    const Size max_records = (records_end_ - pos) / (2 * sizeof(Size));
+    if (exp_size > max_records || chrom_size > max_records - exp_size)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Invalid number of spectra or chromatograms in file trailer. Aborting!", filename_);
+    }
+
+    // Walk the record headers only (the data arrays are skipped and never
+    // touched, so they are not paged in)
+    spectra_index_.reserve(exp_size);
+    for (Size i = 0; i < exp_size; ++i)
+    {
+      spectra_index_.push_back(pos);
+      pos = parseRecord_(pos, true, nullptr);
+    }
+    chrom_index_.reserve(chrom_size);
+    for (Size i = 0; i < chrom_size; ++i)
+    {
+      chrom_index_.push_back(pos);
+      pos = parseRecord_(pos, false, nullptr);
+    }
+
+    if (pos != records_end_)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Records do not end at the file trailer, the file is corrupt. Aborting!", filename_);
+    }
+  }
+
+  CachedMzMLMappedReader::~CachedMzMLMappedReader()
+  {
+  }
+
+  Size CachedMzMLMappedReader::getNrSpectra() const
+  {
+    return spectra_index_.size();
+  }
+
+  Size CachedMzMLMappedReader::getNrChromatograms() const
+  {
+    return chrom_index_.size();
+  }
+
+  const String& CachedMzMLMappedReader::getFilename() const
+  {
+    return filename_;
+  }
+
+  Size CachedMzMLMappedReader::parseRecord_(Size pos, bool is_spectrum, RecordView* view) const
+  {
+    const Size data_size = readField_<Size>(begin_, pos, records_end_, filename_);
+    const Size nr_float_arrays = readField_<Size>(begin_, pos, records_end_, filename_);
+    int ms_level = -1;
+    double rt = -1.0;
+    if (is_spectrum)
+    {
+      ms_level = readField_<int>(begin_, pos, records_end_, filename_);
+      rt = readField_<double>(begin_, pos, records_end_, filename_);
+    }
+
+    if (view != nullptr)
+    {
+      view->ms_level = ms_level;
+      view->rt = rt;
+      view->arrays.clear();
+    }
+
+    // m/z (or RT) and intensity
+    for (Size k = 0; k < 2; ++k)
+    {
+      const char* data = begin_ + pos;
+      skip_(pos, data_size, sizeof(double), records_end_, filename_);
+      if (view != nullptr) view->arrays.emplace_back(data, data_size, nullptr, 0);
+    }
+
+    // additional named arrays
+    for (Size k = 0; k < nr_float_arrays; ++k)
+    {
+      const Size len = readField_<Size>(begin_, pos, records_end_, filename_);
+      const Size len_name = readField_<Size>(begin_, pos, records_end_, filename_);
+      const char* name = begin_ + pos;
+      skip_(pos, len_name, sizeof(char), records_end_, filename_);
+      const char* data = begin_ + pos;
+      skip_(pos, len, sizeof(double), records_end_, filename_);
+      if (view != nullptr) view->arrays.emplace_back(data, len, name, len_name);
+    }
+    return pos;
+  }
+
+  void CachedMzMLMappedReader::getSpectrumView(Size id, RecordView& view) const
+  {
+    OPENMS_PRECONDITION(id < getNrSpectra(), "Id cannot be larger than number of spectra");
+    parseRecord_(spectra_index_[id], true, &view);
+  }
+
+  void CachedMzMLMappedReader::getChromatogramView(Size id, RecordView& view) const
+  {
+    OPENMS_PRECONDITION(id < getNrChromatograms(), "Id cannot be larger than number of chromatograms");
+    parseRecord_(chrom_index_[id], false, &view);
+  }
+
+  void CachedMzMLMappedReader::copyArrays_(const RecordView& view, std::vector<OpenSwath::BinaryDataArrayPtr>& arrays)
+  {
+    arrays.clear();
+    arrays.reserve(view.arrays.size());
+    for (const DataArrayView& a : view.arrays)
+    {
+      OpenSwath::BinaryDataArrayPtr bda(new OpenSwath::BinaryDataArray);
+      bda->data.resize(a.size());
+      a.copyTo(bda->data.data());
+      bda->description = a.getName();
+      arrays.push_back(bda);
+    }
+  }
+
+  OpenSwath::SpectrumPtr CachedMzMLMappedReader::getSpectrum(Size id) const
+  {
+    RecordView view;
+    getSpectrumView(id, view);
+    OpenSwath::SpectrumPtr sptr(new OpenSwath::Spectrum);
+    copyArrays_(view, sptr->getDataArrays());
+    return sptr;
+  }
+
+  OpenSwath::ChromatogramPtr CachedMzMLMappedReader::getChromatogram(Size id) const
+  {
+    RecordView view;
+    getChromatogramView(id, view);
+    OpenSwath::ChromatogramPtr cptr(new OpenSwath::Chromatogram);
+    copyArrays_(view, cptr->getDataArrays());
+    return cptr;
+  }
+
+} // namespace Internal
+} // namespace OpenMS
+
@@ -44,6 +44,9 @@
 #include <OpenMS/INTERFACES/IMSDataConsumer.h>
 #include <OpenMS/SYSTEM/File.h>
 
+#include <exception>
+#include <sstream>
+
 namespace OpenMS
 {
   namespace Internal
@@ -3382,10 +3385,21 @@ namespace OpenMS
       // validateCV_() is called very often for the same path-term-combinations, so we save lots of repetitive computations
       // By caching these combinations we save about 99% of the runtime of validateCV_()
 
-      const auto it = cached_terms_.find(std::make_pair(path, c.id));
-      if (it != cached_terms_.end())
+      // The cache is shared between threads when writing in parallel (see writeElementsOrdered_)
+      bool is_cached = false;
+      bool cached_value = false;
+#pragma omp critical (MzMLHandler_cached_terms)
       {
-        return it->second;
+        const auto it = cached_terms_.find(std::make_pair(path, c.id));
+        if (it != cached_terms_.end())
+        {
+          is_cached = true;
+          cached_value = it->second;
+        }
+      }
+      if (is_cached)
+      {
+        return cached_value;
       }
 
       SemanticValidator::CVTerm sc;
@@ -3395,6 +3409,7 @@ namespace OpenMS
       sc.has_unit_name = false;
 
       bool isValid = validator.SemanticValidator::locateTerm(path, sc);
+#pragma omp critical (MzMLHandler_cached_terms)
       cached_terms_[std::make_pair(path, c.id)] = isValid;
       return isValid;
     }
@@ -3982,13 +3997,19 @@ namespace OpenMS
           warning(STORE, String("Invalid native IDs detected. Using spectrum identifier nativeID format (spectrum=xsd:nonNegativeInteger) for all spectra."));
         }
 
-        // write actual data
+        std::vector<String> native_ids;
+        native_ids.reserve(exp.size());
         for (Size s_idx = 0; s_idx < exp.size(); ++s_idx)
         {
-          logger_.setProgress(progress++);
-          const SpectrumType& spec = exp[s_idx];
-          writeSpectrum_(os, spec, s_idx, validator, renew_native_ids, dps);
+          native_ids.push_back(renew_native_ids ? String("spectrum=") + s_idx : exp[s_idx].getNativeID());
         }
+
+        // write actual data
+        writeElementsOrdered_(os, native_ids, spectra_offsets_, progress,
+          [&](std::ostream& out, Size s_idx)
+          {
+            writeSpectrum_(out, exp[s_idx], s_idx, native_ids[s_idx], validator, dps);
+          });
         os << "\t\t</spectrumList>\n";
       }
 
@@ -4002,12 +4023,19 @@ namespace OpenMS
         // meta information needs to be stored here but the actual data is
         // stored somewhere else).
         os << "\t\t<chromatogramList count=\"" << exp.getChromatograms().size() << "\" defaultDataProcessingRef=\"dp_sp_0\">\n";
+        std::vector<String> native_ids;
+        native_ids.reserve(exp.getChromatograms().size());
         for (Size c_idx = 0; c_idx != exp.getChromatograms().size(); ++c_idx)
         {
-          logger_.setProgress(progress++);
-          const ChromatogramType& chromatogram = exp.getChromatograms()[c_idx];
-          writeChromatogram_(os, chromatogram, c_idx, validator);
+          // TODO native id with chromatogram=?? prefix?
+          native_ids.push_back(exp.getChromatograms()[c_idx].getNativeID());
         }
+
+        writeElementsOrdered_(os, native_ids, chromatograms_offsets_, progress,
+          [&](std::ostream& out, Size c_idx)
+          {
+            writeChromatogram_(out, exp.getChromatograms()[c_idx], c_idx, validator);
+          });
         os << "\t\t</chromatogramList>" << "\n";
       }
 
@@ -4015,6 +4043,80 @@ namespace OpenMS
       logger_.endProgress();
     }
 
+    template <typename WriteFunctor>
+    void MzMLHandler::writeElementsOrdered_(std::ostream& os,
+                                            const std::vector<String>& ids,
+                                            std::vector<std::pair<std::string, Int64> >& offsets,
+                                            int& progress,
+                                            WriteFunctor write_element)
+    {
+      if (!options_.getParallelWrite())
+      {
+        for (Size i = 0; i < ids.size(); ++i)
+        {
+          logger_.setProgress(progress++);
+          // IMPORTANT make sure the offset corresponds to the start of the element tag (after three tabs)
+          Int64 offset = os.tellp();
+          offsets.push_back(make_pair(ids[i], offset + 3));
+          write_element(os, i);
+        }
+        return;
+      }
+
+      // Encode a bounded batch of elements in parallel into separate buffers
+      // (base64, zlib and numpress encoding are the expensive parts), then
+      // write the buffers in order. Only one batch is held in memory at a time.
+      const Size batch_size = (std::max)(Size(1), options_.getMaxDataPoolSize());
+      std::vector<std::string> buffers;
+      for (Size batch_start = 0; batch_start < ids.size(); batch_start += batch_size)
+      {
+        const Size batch_end = (std::min)(batch_start + batch_size, ids.size());
+        buffers.assign(batch_end - batch_start, std::string());
+
+        size_t errCount = 0;
+        std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (SignedSize i = (SignedSize)batch_start; i < (SignedSize)batch_end; ++i)
+        {
+          // parallel exception catching and re-throwing business
+          if (!errCount) // no need to encode further if already an error was encountered
+          {
+            try
+            {
+              std::ostringstream buffer;
+              buffer.copyfmt(os); // same precision and flags as the output stream
+              write_element(buffer, (Size)i);
+              buffers[i - batch_start] = buffer.str();
+            }
+            catch (...)
+            {
+#pragma omp critical (MzMLHandler_writeElementsOrdered)
+              {
+                if (!errCount) error = std::current_exception();
+                ++errCount;
+              }
+            }
+          }
+        }
+        if (errCount != 0)
+        {
+          std::rethrow_exception(error);
+        }
+
+        for (Size i = batch_start; i < batch_end; ++i)
+        {
+          logger_.setProgress(progress++);
+          // IMPORTANT make sure the offset corresponds to the start of the element tag (after three tabs)
+          Int64 offset = os.tellp();
+          offsets.push_back(make_pair(ids[i], offset + 3));
+          os << buffers[i - batch_start];
+          std::string().swap(buffers[i - batch_start]); // release memory early
+        }
+      }
+    }
+
     void MzMLHandler::writeHeader_(std::ostream& os,
                                    const MapType& exp,
                                    std::vector<std::vector< ConstDataProcessingPtr > >& dps,
@@ -4951,21 +5053,11 @@ namespace OpenMS
     void MzMLHandler::writeSpectrum_(std::ostream& os,
                                      const SpectrumType& spec,
                                      Size s,
+                                     const String& native_id,
                                      const Internal::MzMLValidator& validator,
-                                     bool renew_native_ids,
                                      std::vector<std::vector< ConstDataProcessingPtr > >& dps)
     {
-      //native id
-      String native_id = spec.getNativeID();
-      if (renew_native_ids)
-      {
-        native_id = String("spectrum=") + s;
-      }
-
-      Int64 offset = os.tellp();
-      spectra_offsets_.push_back(make_pair(native_id, offset + 3));
-
-      // IMPORTANT make sure the offset (above) corresponds to the start of the <spectrum tag
+      // IMPORTANT the offset (see writeElementsOrdered_) has to correspond to the start of the <spectrum tag
       os << "\t\t\t<spectrum id=\"" << writeXMLEscape(native_id) << "\" index=\"" << s << "\" defaultArrayLength=\"" << spec.size() << "\"";
       if (spec.getSourceFile() != SourceFile())
       {
@@ -5530,11 +5622,7 @@ namespace OpenMS
                                          Size c,
                                          const Internal::MzMLValidator& validator)
     {
-      Int64 offset = os.tellp();
-      chromatograms_offsets_.push_back(make_pair(chromatogram.getNativeID(), offset + 3));
-
-      // TODO native id with chromatogram=?? prefix?
-      // IMPORTANT make sure the offset (above) corresponds to the start of the <chromatogram tag
+      // IMPORTANT the offset (see writeElementsOrdered_) has to correspond to the start of the <chromatogram tag
       os << "\t\t\t<chromatogram id=\"" << writeXMLEscape(chromatogram.getNativeID()) << "\" index=\"" << c << "\" defaultArrayLength=\"" << chromatogram.size() << "\">" << "\n";
 
       // write cvParams (chromatogram type)
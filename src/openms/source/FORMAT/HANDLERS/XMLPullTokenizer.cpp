@@ -0,0 +1,398 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/HANDLERS/XMLPullTokenizer.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/DATASTRUCTURES/StringUtils.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace OpenMS
+{
+namespace Internal
+{
+
+  namespace
+  {
+    inline bool isSpace_(char c)
+    {
+      return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    /// Characters that terminate a tag or attribute name
+    inline bool isNameEnd_(char c)
+    {
+      return isSpace_(c) || c == '>' || c == '/' || c == '=';
+    }
+
+    inline bool equals_(const char* begin, const char* end, const char* name)
+    {
+      const Size length = end - begin;
+      return std::strlen(name) == length && std::memcmp(begin, name, length) == 0;
+    }
+  }
+
+  XMLPullTokenizer::XMLPullTokenizer(const char* begin, const char* end) :
+    pos_(begin),
+    end_(end),
+    open_tags_(),
+    tag_(),
+    attributes_(),
+    pending_end_(false)
+  {
+    tag_.begin = begin;
+    tag_.end = begin;
+  }
+
+  XMLPullTokenizer::TokenType XMLPullTokenizer::next()
+  {
+    attributes_.clear();
+    if (pending_end_)
+    {
+      pending_end_ = false;
+      tag_ = open_tags_.back();
+      open_tags_.pop_back();
+      return END_TAG;
+    }
+
+    while (true)
+    {
+      while (pos_ != end_ && isSpace_(*pos_)) ++pos_;
+      if (pos_ == end_)
+      {
+        if (!open_tags_.empty())
+        {
+          parseError_("Unexpected end of input inside element '" + String(open_tags_.back().begin, open_tags_.back().end) + "'");
+        }
+        return END_OF_INPUT;
+      }
+      if (*pos_ != '<')
+      {
+        parseError_("Unsupported character data");
+      }
+      ++pos_;
+      if (pos_ == end_)
+      {
+        parseError_("Unexpected end of input");
+      }
+
+      if (*pos_ == '!')
+      {
+        // comments are skipped, all other declarations are not supported
+        static const char comment_start[] = "!--";
+        static const char comment_end[] = "-->";
+        if (end_ - pos_ < 3 || std::memcmp(pos_, comment_start, 3) != 0)
+        {
+          parseError_("Unsupported markup declaration");
+        }
+        const char* close = std::search(pos_ + 3, end_, comment_end, comment_end + 3);
+        if (close == end_)
+        {
+          parseError_("Unterminated comment");
+        }
+        pos_ = close + 3;
+        continue;
+      }
+      if (*pos_ == '?')
+      {
+        parseError_("Unsupported processing instruction");
+      }
+
+      bool closing = (*pos_ == '/');
+      if (closing) ++pos_;
+
+      tag_.begin = pos_;
+      while (pos_ != end_ && !isNameEnd_(*pos_))
+      {
+        if (static_cast<unsigned char>(*pos_) >= 128 || *pos_ == '<')
+        {
+          parseError_("Unsupported character in tag name");
+        }
+        ++pos_;
+      }
+      tag_.end = pos_;
+      if (tag_.begin == tag_.end)
+      {
+        parseError_("Missing tag name");
+      }
+
+      if (closing)
+      {
+        while (pos_ != end_ && isSpace_(*pos_)) ++pos_;
+        if (pos_ == end_ || *pos_ != '>')
+        {
+          parseError_("Malformed end tag '" + getTag() + "'");
+        }
+        ++pos_;
+        if (open_tags_.empty() ||
+            open_tags_.back().end - open_tags_.back().begin != tag_.end - tag_.begin ||
+            std::memcmp(open_tags_.back().begin, tag_.begin, tag_.end - tag_.begin) != 0)
+        {
+          parseError_("Unexpected end tag '" + getTag() + "'");
+        }
+        open_tags_.pop_back();
+        return END_TAG;
+      }
+
+      pending_end_ = parseAttributes_();
+      open_tags_.push_back(tag_);
+      return START_TAG;
+    }
+  }
+
+  Size XMLPullTokenizer::depth() const
+  {
+    return open_tags_.size();
+  }
+
+  bool XMLPullTokenizer::isTag(const char* name) const
+  {
+    return equals_(tag_.begin, tag_.end, name);
+  }
+
+  String XMLPullTokenizer::getTag() const
+  {
+    return String(tag_.begin, tag_.end);
+  }
+
+  bool XMLPullTokenizer::getAttribute(const char* name, String& value) const
+  {
+    const Range_* range = findAttribute_(name);
+    if (range == nullptr)
+    {
+      return false;
+    }
+
+    value.clear();
+    value.reserve(range->end - range->begin);
+    for (const char* it = range->begin; it != range->end; ++it)
+    {
+      if (*it == '&')
+      {
+        const char* semicolon = std::find(it, range->end, ';');
+        if (semicolon == range->end)
+        {
+          parseError_("Unterminated entity reference in attribute '" + String(name) + "'");
+        }
+        if (equals_(it + 1, semicolon, "lt")) value += '<';
+        else if (equals_(it + 1, semicolon, "gt")) value += '>';
+        else if (equals_(it + 1, semicolon, "amp")) value += '&';
+        else if (equals_(it + 1, semicolon, "quot")) value += '"';
+        else if (equals_(it + 1, semicolon, "apos")) value += '\'';
+        else if (semicolon - it > 2 && it[1] == '#')
+        {
+          // character references, only ASCII is passed through without transcoding
+          const bool hex = (it[2] == 'x');
+          unsigned code = 0;
+          for (const char* digit = it + (hex ? 3 : 2); digit != semicolon; ++digit)
+          {
+            unsigned d;
+            if (*digit >= '0' && *digit <= '9') d = *digit - '0';
+            else if (hex && *digit >= 'a' && *digit <= 'f') d = *digit - 'a' + 10;
+            else if (hex && *digit >= 'A' && *digit <= 'F') d = *digit - 'A' + 10;
+            else d = 128;
+            code = code * (hex ? 16 : 10) + d;
+            if (d == 128 || code >= 128)
+            {
+              parseError_("Unsupported character reference in attribute '" + String(name) + "'");
+            }
+          }
+          if (code == 0)
+          {
+            parseError_("Invalid character reference in attribute '" + String(name) + "'");
+          }
+          value += static_cast<char>(code);
+        }
+        else
+        {
+          parseError_("Unsupported entity reference in attribute '" + String(name) + "'");
+        }
+        it = semicolon;
+      }
+      else if (*it == '\r')
+      {
+        // attribute value normalization: line breaks and tabs become spaces, "\r\n" counts once
+        if (it + 1 != range->end && it[1] == '\n') ++it;
+        value += ' ';
+      }
+      else if (*it == '\n' || *it == '\t')
+      {
+        value += ' ';
+      }
+      else
+      {
+        value += *it;
+      }
+    }
+    return true;
+  }
+
+  bool XMLPullTokenizer::getAttribute(const char* name, double& value) const
+  {
+    const Range_* range = findAttribute_(name);
+    if (range == nullptr)
+    {
+      return false;
+    }
+    const char* it = range->begin;
+    if (StringUtils::extractDouble(it, range->end, value) && it == range->end)
+    {
+      return true;
+    }
+    // surrounding whitespace or entities: same semantics as the Xerces code path
+    String tmp;
+    getAttribute(name, tmp);
+    try
+    {
+      value = tmp.toDouble();
+    }
+    catch (Exception::ConversionError&)
+    {
+      parseError_("Attribute '" + String(name) + "' is not a number: '" + tmp + "'");
+    }
+    return true;
+  }
+
+  bool XMLPullTokenizer::getAttribute(const char* name, Int& value) const
+  {
+    const Range_* range = findAttribute_(name);
+    if (range == nullptr)
+    {
+      return false;
+    }
+    const char* it = range->begin;
+    if (boost::spirit::qi::parse(it, range->end, boost::spirit::qi::int_, value) && it == range->end)
+    {
+      return true;
+    }
+    String tmp;
+    getAttribute(name, tmp);
+    try
+    {
+      value = tmp.toInt();
+    }
+    catch (Exception::ConversionError&)
+    {
+      parseError_("Attribute '" + String(name) + "' is not an integer: '" + tmp + "'");
+    }
+    return true;
+  }
+
+  const XMLPullTokenizer::Range_* XMLPullTokenizer::findAttribute_(const char* name) const
+  {
+    for (const Attribute_& attribute : attributes_)
+    {
+      if (equals_(attribute.name.begin, attribute.name.end, name))
+      {
+        return &attribute.value;
+      }
+    }
+    return nullptr;
+  }
+
+  void XMLPullTokenizer::parseError_(const String& message) const
+  {
+    throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(std::min(pos_, end_), std::min(pos_ + 40, end_)), message);
+  }
+
+  bool XMLPullTokenizer::parseAttributes_()
+  {
+    while (true)
+    {
+      while (pos_ != end_ && isSpace_(*pos_)) ++pos_;
+      if (pos_ == end_)
+      {
+        parseError_("Unexpected end of input in tag '" + getTag() + "'");
+      }
+      if (*pos_ == '>')
+      {
+        ++pos_;
+        return false;
+      }
+      if (*pos_ == '/')
+      {
+        ++pos_;
+        if (pos_ == end_ || *pos_ != '>')
+        {
+          parseError_("Malformed empty element tag '" + getTag() + "'");
+        }
+        ++pos_;
+        return true;
+      }
+
+      Attribute_ attribute;
+      attribute.name.begin = pos_;
+      while (pos_ != end_ && !isNameEnd_(*pos_))
+      {
+        if (static_cast<unsigned char>(*pos_) >= 128 || *pos_ == '<' || *pos_ == '"' || *pos_ == '\'')
+        {
+          parseError_("Unsupported character in attribute name");
+        }
+        ++pos_;
+      }
+      attribute.name.end = pos_;
+      while (pos_ != end_ && isSpace_(*pos_)) ++pos_;
+      if (attribute.name.begin == attribute.name.end || pos_ == end_ || *pos_ != '=')
+      {
+        parseError_("Malformed attribute in tag '" + getTag() + "'");
+      }
+      ++pos_;
+      while (pos_ != end_ && isSpace_(*pos_)) ++pos_;
+      if (pos_ == end_ || (*pos_ != '"' && *pos_ != '\''))
+      {
+        parseError_("Unquoted attribute value in tag '" + getTag() + "'");
+      }
+      const char quote = *pos_++;
+      attribute.value.begin = pos_;
+      while (pos_ != end_ && *pos_ != quote)
+      {
+        if (static_cast<unsigned char>(*pos_) >= 128 || *pos_ == '<')
+        {
+          parseError_("Unsupported character in attribute value");
+        }
+        ++pos_;
+      }
+      if (pos_ == end_)
+      {
+        parseError_("Unterminated attribute value in tag '" + getTag() + "'");
+      }
+      attribute.value.end = pos_++;
+      attributes_.push_back(attribute);
+    }
+  }
+
+} // namespace Internal
+} // namespace OpenMS
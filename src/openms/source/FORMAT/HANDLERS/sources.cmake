@@ -5,6 +5,7 @@ set(directory source/FORMAT/HANDLERS)
 set(sources_list
   AcqusHandler.cpp
   CachedMzMLHandler.cpp
+  CachedMzMLMappedReader.cpp
   FidHandler.cpp
   IndexedMzMLDecoder.cpp
   IndexedMzMLHandler.cpp
@@ -25,6 +26,7 @@ set(sources_list
   TraMLHandler.cpp
   UnimodXMLHandler.cpp
   XMLHandler.cpp
+  XMLPullTokenizer.cpp
   XQuestResultXMLHandler.cpp
 )
 
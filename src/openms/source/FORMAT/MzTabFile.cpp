@@ -39,6 +39,8 @@
 
 #include <boost/regex.hpp>
 
+#include <fstream>
+
 using namespace std;
 
 // TODO fix all the shadowed "String s"
@@ -102,17 +104,116 @@ namespace OpenMS
   return pair;
   }
 
+  namespace
+  {
+    /// Collects all rows of an mzTab file in an MzTab object (see MzTabFile::load())
+    class MzTabCollectingConsumer :
+      public MzTabFile::RowConsumer
+    {
+    public:
+      void consumeMetaData(const MzTabMetaData& meta_data) override
+      {
+        meta_data_ = meta_data;
+      }
+
+      void consumeProteinRow(MzTabProteinSectionRow& row) override
+      {
+        protein_rows_.push_back(std::move(row));
+      }
+
+      void consumePeptideRow(MzTabPeptideSectionRow& row) override
+      {
+        peptide_rows_.push_back(std::move(row));
+      }
+
+      void consumePSMRow(MzTabPSMSectionRow& row) override
+      {
+        psm_rows_.push_back(std::move(row));
+      }
+
+      void consumeSmallMoleculeRow(MzTabSmallMoleculeSectionRow& row) override
+      {
+        small_molecule_rows_.push_back(std::move(row));
+      }
+
+      void consumeEmptyRow(Size line_number) override
+      {
+        empty_rows_.push_back(line_number);
+      }
+
+      void consumeCommentRow(Size line_number, const String& line) override
+      {
+        comment_rows_[line_number] = line;
+      }
+
+      MzTabMetaData meta_data_;
+      MzTabProteinSectionRows protein_rows_;
+      MzTabPeptideSectionRows peptide_rows_;
+      MzTabPSMSectionRows psm_rows_;
+      MzTabSmallMoleculeSectionRows small_molecule_rows_;
+      vector<Size> empty_rows_;
+      map<Size, String> comment_rows_;
+    };
+  }
+
+  MzTabFile::RowConsumer::~RowConsumer()
+  {
+  }
+
+  void MzTabFile::RowConsumer::consumeMetaData(const MzTabMetaData& /* meta_data */)
+  {
+  }
+
+  void MzTabFile::RowConsumer::consumeProteinRow(MzTabProteinSectionRow& /* row */)
+  {
+  }
+
+  void MzTabFile::RowConsumer::consumePeptideRow(MzTabPeptideSectionRow& /* row */)
+  {
+  }
+
+  void MzTabFile::RowConsumer::consumePSMRow(MzTabPSMSectionRow& /* row */)
+  {
+  }
+
+  void MzTabFile::RowConsumer::consumeSmallMoleculeRow(MzTabSmallMoleculeSectionRow& /* row */)
+  {
+  }
+
+  void MzTabFile::RowConsumer::consumeEmptyRow(Size /* line_number */)
+  {
+  }
+
+  void MzTabFile::RowConsumer::consumeCommentRow(Size /* line_number */, const String& /* line */)
+  {
+  }
+
   void MzTabFile::load(const String& filename, MzTab& mz_tab)
   {
-  TextFile tf(filename, true);
+    MzTabCollectingConsumer consumer;
+    transform(filename, &consumer);
+
+    mz_tab.setMetaData(consumer.meta_data_);
+    mz_tab.setProteinSectionRows(consumer.protein_rows_);
+    mz_tab.setPeptideSectionRows(consumer.peptide_rows_);
+    mz_tab.setPSMSectionRows(consumer.psm_rows_);
+    mz_tab.setSmallMoleculeSectionRows(consumer.small_molecule_rows_);
+    mz_tab.setEmptyRows(consumer.empty_rows_);
+    mz_tab.setCommentRows(consumer.comment_rows_);
+  }
+
+  void MzTabFile::transform(const String& filename, RowConsumer* consumer)
+  {
+  // read line by line, so memory use does not depend on the number of rows
+  ifstream is(filename.c_str(), ios_base::in | ios_base::binary);
+  if (!is)
+  {
+    throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+  }
 
   MzTabMetaData mz_tab_metadata;
-  MzTabProteinSectionRows mz_tab_protein_section_data;
-  MzTabPeptideSectionRows mz_tab_peptide_section_data;
-  MzTabPSMSectionRows mz_tab_psm_section_data;
-  MzTabSmallMoleculeSectionRows mz_tab_small_molecule_section_data;
-  map<Size, String> comment_rows;
-  vector<Size> empty_rows;
+  bool meta_data_reported = false; // passed to the consumer before the first non-MTD row
+  bool meta_data_changed = false; // MTD rows after that (not allowed by the standard, but tolerated)
 
   map<String, Size> protein_custom_opt_columns;  // map column name to original column index
   map<String, Size> peptide_custom_opt_columns;
@@ -228,15 +329,15 @@ namespace OpenMS
   Size count_smallmolecule_search_engine_score = 0;
 
   Size line_number = 0;
-  for (TextFile::ConstIterator sit = tf.begin(); sit != tf.end(); ++sit, ++line_number)
+  String line;
+  for (; TextFile::getLine(is, line); ++line_number)
   {
-    //  std::cout << *sit << std::endl;
-    String s = *sit;
+    String s = line.trim();
 
     // skip empty lines or lines that are too short
     if (s.trim().size() < 3)
     {
-      empty_rows.push_back(line_number); // preserve empty lines to map comments to correct position
+      consumer->consumeEmptyRow(line_number); // preserve empty lines to map comments to correct position
       continue;
     }
 
@@ -245,7 +346,7 @@ namespace OpenMS
     // discard comments
     if (section == "COM")
     {
-      comment_rows[line_number] = s;
+      consumer->consumeCommentRow(line_number, s);
       continue;
     }
 
@@ -257,10 +358,17 @@ namespace OpenMS
       throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "Error parsing MzTab line: " + String(s) + ". Did you forget to use tabulator as separator?");
     }
 
+    if (section != "MTD" && !meta_data_reported)
+    {
+      consumer->consumeMetaData(mz_tab_metadata);
+      meta_data_reported = true;
+    }
+
     // parse metadata section
     if (section == "MTD")
     {
       sections_present.insert("MTD");
+      meta_data_changed = meta_data_reported;
       StringList meta_key_fields; // the "-" separated fields of the metavalue key
       cells[1].split("-", meta_key_fields);
       String meta_key = meta_key_fields[0];
@@ -1021,7 +1129,7 @@ namespace OpenMS
         row.opt_.push_back(e);
       }
 
-      mz_tab_protein_section_data.push_back(row);
+      consumer->consumeProteinRow(row);
       continue;
     }
 
@@ -1198,7 +1306,7 @@ namespace OpenMS
         row.opt_.push_back(e);
       }
 
-      mz_tab_peptide_section_data.push_back(row);
+      consumer->consumePeptideRow(row);
       continue;
     }
 
@@ -1345,7 +1453,7 @@ namespace OpenMS
         row.opt_.push_back(e);
       }
 
-      mz_tab_psm_section_data.push_back(row);
+      consumer->consumePSMRow(row);
       continue;
     }
 
@@ -1543,7 +1651,7 @@ namespace OpenMS
         row.opt_.push_back(e);
       }
 
-      mz_tab_small_molecule_section_data.push_back(row);
+      consumer->consumeSmallMoleculeRow(row);
       continue;
     }
   }
@@ -1551,13 +1659,10 @@ namespace OpenMS
   // TODO: check mandatoryness
   //hasMandatoryMetaDataKeys_(mandatory_meta_values, sections_present, mz_tab_metadata);
 
-  mz_tab.setMetaData(mz_tab_metadata);
-  mz_tab.setProteinSectionRows(mz_tab_protein_section_data);
-  mz_tab.setPeptideSectionRows(mz_tab_peptide_section_data);
-  mz_tab.setPSMSectionRows(mz_tab_psm_section_data);
-  mz_tab.setSmallMoleculeSectionRows(mz_tab_small_molecule_section_data);
-  mz_tab.setEmptyRows(empty_rows);
-  mz_tab.setCommentRows(comment_rows);
+  if (!meta_data_reported || meta_data_changed)
+  {
+    consumer->consumeMetaData(mz_tab_metadata);
+  }
   }
 
   void MzTabFile::generateMzTabMetaDataSection_(const MzTabMetaData& md, StringList& sl) const
@@ -63,7 +63,9 @@ namespace OpenMS
     np_config_int_(),
     np_config_fda_(),
     maximal_data_pool_size_(100),
-    precursor_mz_selected_ion_(true)
+    parallel_write_(false),
+    precursor_mz_selected_ion_(true),
+    fast_parsing_(false)
   {
   }
 
@@ -92,7 +94,9 @@ namespace OpenMS
     np_config_int_(options.np_config_int_),
     np_config_fda_(options.np_config_fda_),
     maximal_data_pool_size_(options.maximal_data_pool_size_),
-    precursor_mz_selected_ion_(options.precursor_mz_selected_ion_)
+    parallel_write_(options.parallel_write_),
+    precursor_mz_selected_ion_(options.precursor_mz_selected_ion_),
+    fast_parsing_(options.fast_parsing_)
   {
   }
 
@@ -352,6 +356,16 @@ namespace OpenMS
     maximal_data_pool_size_ = size;
   }
 
+  bool PeakFileOptions::getParallelWrite() const
+  {
+    return parallel_write_;
+  }
+
+  void PeakFileOptions::setParallelWrite(bool parallel_write)
+  {
+    parallel_write_ = parallel_write;
+  }
+
   bool PeakFileOptions::getPrecursorMZSelectedIon() const
   {
     return precursor_mz_selected_ion_;
@@ -362,6 +376,16 @@ namespace OpenMS
     precursor_mz_selected_ion_ = choice;
   }
 
+  bool PeakFileOptions::getFastParsing() const
+  {
+    return fast_parsing_;
+  }
+
+  void PeakFileOptions::setFastParsing(bool fast_parsing)
+  {
+    fast_parsing_ = fast_parsing;
+  }
+
   bool PeakFileOptions::hasFilters()
   {
     return (has_rt_range_ || hasMSLevels());
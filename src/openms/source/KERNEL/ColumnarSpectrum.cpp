@@ -0,0 +1,195 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg$
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/KERNEL/ColumnarSpectrum.h>
+
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+
+namespace OpenMS
+{
+
+  ColumnarSpectrum::ColumnarSpectrum(const MSSpectrum& spectrum)
+  {
+    assign(spectrum);
+  }
+
+  void ColumnarSpectrum::assign(const MSSpectrum& spectrum)
+  {
+    const Size n = spectrum.size();
+    mz_.resize(n);
+    intensity_.resize(n);
+    for (Size i = 0; i < n; ++i)
+    {
+      mz_[i] = spectrum[i].getMZ();
+      intensity_[i] = spectrum[i].getIntensity();
+    }
+  }
+
+  void ColumnarSpectrum::copyTo(MSSpectrum& spectrum) const
+  {
+    spectrum.clear(false);
+    spectrum.resize(mz_.size());
+    for (Size i = 0; i < mz_.size(); ++i)
+    {
+      spectrum[i].setMZ(mz_[i]);
+      spectrum[i].setIntensity(intensity_[i]);
+    }
+  }
+
+  bool ColumnarSpectrum::operator==(const ColumnarSpectrum& rhs) const
+  {
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wfloat-equal"
+    return mz_ == rhs.mz_ && intensity_ == rhs.intensity_;
+#pragma clang diagnostic pop
+  }
+
+  void ColumnarSpectrum::permute_(const std::vector<Size>& order)
+  {
+    std::vector<CoordinateType> mz(order.size());
+    std::vector<IntensityType> intensity(order.size());
+    for (Size i = 0; i < order.size(); ++i)
+    {
+      mz[i] = mz_[order[i]];
+      intensity[i] = intensity_[order[i]];
+    }
+    mz_.swap(mz);
+    intensity_.swap(intensity);
+  }
+
+  void ColumnarSpectrum::sortByPosition()
+  {
+    if (isSorted()) return;
+
+    std::vector<Size> order(mz_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](Size a, Size b) { return mz_[a] < mz_[b]; });
+    permute_(order);
+  }
+
+  void ColumnarSpectrum::sortByIntensity(bool reverse)
+  {
+    if (reverse && std::is_sorted(intensity_.begin(), intensity_.end(), std::greater<IntensityType>())) return;
+    else if (!reverse && std::is_sorted(intensity_.begin(), intensity_.end())) return;
+
+    std::vector<Size> order(intensity_.size());
+    std::iota(order.begin(), order.end(), 0);
+    if (reverse)
+    {
+      std::stable_sort(order.begin(), order.end(), [this](Size a, Size b) { return intensity_[a] > intensity_[b]; });
+    }
+    else
+    {
+      std::stable_sort(order.begin(), order.end(), [this](Size a, Size b) { return intensity_[a] < intensity_[b]; });
+    }
+    permute_(order);
+  }
+
+  bool ColumnarSpectrum::isSorted() const
+  {
+    return std::is_sorted(mz_.begin(), mz_.end());
+  }
+
+  Size ColumnarSpectrum::findNearest(CoordinateType mz) const
+  {
+    // no peak => no search
+    if (mz_.empty()) throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "There must be at least one peak to determine the nearest peak!");
+
+    // search for position for inserting
+    const Size i = std::lower_bound(mz_.begin(), mz_.end(), mz) - mz_.begin();
+    // border cases
+    if (i == 0) return 0;
+    if (i == mz_.size()) return mz_.size() - 1;
+
+    // the peak before or the current peak are closest
+    if (std::fabs(mz_[i] - mz) < std::fabs(mz_[i - 1] - mz))
+    {
+      return i;
+    }
+    else
+    {
+      return i - 1;
+    }
+  }
+
+  Int ColumnarSpectrum::findNearest(CoordinateType mz, CoordinateType tolerance) const
+  {
+    if (mz_.empty()) return -1;
+    const Size i = findNearest(mz);
+    const double found_mz = mz_[i];
+    if (found_mz >= mz - tolerance && found_mz <= mz + tolerance)
+    {
+      return static_cast<Int>(i);
+    }
+    return -1;
+  }
+
+  ColumnarSpectrum::ConstIterator ColumnarSpectrum::MZBegin(CoordinateType mz) const
+  {
+    return cbegin() + (std::lower_bound(mz_.begin(), mz_.end(), mz) - mz_.begin());
+  }
+
+  ColumnarSpectrum::ConstIterator ColumnarSpectrum::MZEnd(CoordinateType mz) const
+  {
+    return cbegin() + (std::upper_bound(mz_.begin(), mz_.end(), mz) - mz_.begin());
+  }
+
+  ColumnarSpectrum::Iterator ColumnarSpectrum::MZBegin(CoordinateType mz)
+  {
+    return begin() + (std::lower_bound(mz_.begin(), mz_.end(), mz) - mz_.begin());
+  }
+
+  ColumnarSpectrum::Iterator ColumnarSpectrum::MZEnd(CoordinateType mz)
+  {
+    return begin() + (std::upper_bound(mz_.begin(), mz_.end(), mz) - mz_.begin());
+  }
+
+  Size ColumnarSpectrum::getBasePeakIndex() const
+  {
+    if (intensity_.empty()) return 0;
+    return std::max_element(intensity_.begin(), intensity_.end()) - intensity_.begin();
+  }
+
+  ColumnarSpectrum::IntensityType ColumnarSpectrum::getTIC() const
+  {
+    return std::accumulate(intensity_.begin(), intensity_.end(), IntensityType(0));
+  }
+
+} // namespace OpenMS
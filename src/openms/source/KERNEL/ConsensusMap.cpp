@@ -287,7 +287,7 @@ namespace OpenMS
 
       // update map indices
       ConsensusFeature::HandleSetType new_handles;
-      // std::set only provides const iterators, so we copy
+      // the sort key of a handle must not be modified in place, so we copy
       for (auto handle : cf) // OMS_CODING_TEST_EXCLUDE
       {
         //since we only add a constant to the map_index, the set order will not change.
@@ -27,6 +27,7 @@ StandardTypes.cpp
 ChromatogramPeak.cpp
 MSChromatogram.cpp
 ChromatogramTools.cpp
+ColumnarSpectrum.cpp
 SpectrumHelper.cpp
 )
 
@@ -48,6 +48,7 @@
 #include <QDir>
 
 #include <algorithm>
+#include <numeric>
 
 
 
@@ -70,6 +71,9 @@ namespace OpenMS
       defaults_.setValue("max_nr_iterations", 1000, "Bounds the number of iterations for the EM algorithm when convergence is slow.", ListUtils::create<String>("advanced"));
       defaults_.setValidStrings("incorrectly_assigned", ListUtils::create<String>("Gumbel,Gauss"));
       defaults_.setValue("neg_log_delta",6, "The negative logarithm of the convergence threshold for the likelihood increase.");
+      defaults_.setValue("number_of_fit_bins", 0, "If larger than 0 and there are more scores than bins, the EM algorithm is run on a histogram with this many equally wide bins instead of on the individual scores. "
+                                                  "Recommended for very large sets of scores (e.g. 1000 bins for millions of PSMs). The fitted parameters deviate from the exact fit by O((bin width / standard deviation)^2).", ListUtils::create<String>("advanced"));
+      defaults_.setMinInt("number_of_fit_bins", 0);
       defaults_.setValue("outlier_handling","ignore_iqr_outliers", "What to do with outliers:\n"
                                                                    "- ignore_iqr_outliers: ignore outliers outside of 3*IQR from Q1/Q3 for fitting\n"
                                                                    "- set_iqr_to_closest_valid: set IQR-based outliers to the last valid value for fitting\n"
@@ -333,23 +337,41 @@ namespace OpenMS
       int delta = param_.getValue("neg_log_delta");
       int itns = 0;
 
+      // for large data sets, optionally run the EM algorithm on a histogram of the scores
+      const Size number_of_fit_bins = (Int)param_.getValue("number_of_fit_bins");
+      const bool binned = (number_of_fit_bins > 0) && (x_scores.size() > number_of_fit_bins);
+      ScoreHistogram_ histogram;
+      if (binned)
+      {
+        binScores_(x_scores, number_of_fit_bins, histogram);
+      }
+      const vector<double>& fit_scores = binned ? histogram.means : x_scores;
+
       vector<double> incorrect_log_density, correct_log_density;
-      fillLogDensities(x_scores, incorrect_log_density, correct_log_density);
+      fillLogDensities(fit_scores, incorrect_log_density, correct_log_density);
       vector<double> incorrect_posteriors;
-      double maxlike = computeLLAndIncorrectPosteriorsFromLogDensities(incorrect_log_density, correct_log_density, incorrect_posteriors);
-      double sumIncorrectPosteriors = Math::sum(incorrect_posteriors.begin(),incorrect_posteriors.end());
+      double maxlike = binned ?
+        computeLLAndIncorrectPosteriorsFromLogDensities_(histogram, incorrect_log_density, correct_log_density, incorrect_posteriors) :
+        computeLLAndIncorrectPosteriorsFromLogDensities(incorrect_log_density, correct_log_density, incorrect_posteriors);
+      double sumIncorrectPosteriors = binned ?
+        std::inner_product(histogram.counts.begin(), histogram.counts.end(), incorrect_posteriors.begin(), 0.0) :
+        Math::sum(incorrect_posteriors.begin(),incorrect_posteriors.end());
       double sumCorrectPosteriors = x_scores.size() - sumIncorrectPosteriors;
 
       do
       {
         //-------------------------------------------------------------
         // E-STEP
-        std::pair<double,double> newMeans = pos_neg_mean_weighted_posteriors(x_scores, incorrect_posteriors);
+        std::pair<double,double> newMeans = binned ?
+          pos_neg_mean_weighted_posteriors_(histogram, incorrect_posteriors) :
+          pos_neg_mean_weighted_posteriors(x_scores, incorrect_posteriors);
         newMeans.first /= sumCorrectPosteriors;
         newMeans.second /= sumIncorrectPosteriors;
 
         //new standard deviation
-        std::pair<double,double> newSigmas = pos_neg_sigma_weighted_posteriors(x_scores, incorrect_posteriors, newMeans);
+        std::pair<double,double> newSigmas = binned ?
+          pos_neg_sigma_weighted_posteriors_(histogram, incorrect_posteriors, newMeans) :
+          pos_neg_sigma_weighted_posteriors(x_scores, incorrect_posteriors, newMeans);
         newSigmas.first = sqrt(newSigmas.first/sumCorrectPosteriors);
         newSigmas.second = sqrt(newSigmas.second/sumIncorrectPosteriors);
 
@@ -371,9 +393,13 @@ namespace OpenMS
 
 
         // compute new prior probabilities negative peptides
-        fillLogDensities(x_scores, incorrect_log_density, correct_log_density);
-        double new_maxlike = computeLLAndIncorrectPosteriorsFromLogDensities(incorrect_log_density, correct_log_density, incorrect_posteriors);
-        sumIncorrectPosteriors = Math::sum(incorrect_posteriors.begin(),incorrect_posteriors.end());
+        fillLogDensities(fit_scores, incorrect_log_density, correct_log_density);
+        double new_maxlike = binned ?
+          computeLLAndIncorrectPosteriorsFromLogDensities_(histogram, incorrect_log_density, correct_log_density, incorrect_posteriors) :
+          computeLLAndIncorrectPosteriorsFromLogDensities(incorrect_log_density, correct_log_density, incorrect_posteriors);
+        sumIncorrectPosteriors = binned ?
+          std::inner_product(histogram.counts.begin(), histogram.counts.end(), incorrect_posteriors.begin(), 0.0) :
+          Math::sum(incorrect_posteriors.begin(),incorrect_posteriors.end());
         sumCorrectPosteriors = x_scores.size() - sumIncorrectPosteriors;
         negative_prior_ = sumIncorrectPosteriors / x_scores.size();
 
@@ -498,15 +524,24 @@ namespace OpenMS
         incorrect_density.resize(x_scores.size());
         correct_density.resize(x_scores.size());
       }
-      auto incorrect(incorrect_density.begin());
-      auto correct(correct_density.begin());
-      for (double const & score : x_scores)
+      // same as GaussFitResult::log_eval_no_normalize, but with the normalization terms computed only once
+      // TODO: incorrect is currently filled with gauss as fitting gumble is not supported
+      const double halflogtwopi = 0.5 * log(2.0 * Constants::PI);
+      const double incorrect_x0 = incorrectly_assigned_fit_param_.x0;
+      const double incorrect_sigma = incorrectly_assigned_fit_param_.sigma;
+      const double incorrect_log_norm = -log(incorrect_sigma) - halflogtwopi;
+      const double correct_x0 = correctly_assigned_fit_param_.x0;
+      const double correct_sigma = correctly_assigned_fit_param_.sigma;
+      const double correct_log_norm = -log(correct_sigma) - halflogtwopi;
+
+      const double* score = x_scores.data();
+      double* incorrect = incorrect_density.data();
+      double* correct = correct_density.data();
+      const Size n = x_scores.size();
+      for (Size i = 0; i < n; ++i)
       {
-        // TODO: incorrect is currently filled with gauss as fitting gumble is not supported
-        *incorrect = incorrectly_assigned_fit_param_.log_eval_no_normalize(score);
-        *correct = correctly_assigned_fit_param_.log_eval_no_normalize(score);
-        ++incorrect;
-        ++correct;
+        incorrect[i] = incorrect_log_norm - 0.5 * pow((score[i] - incorrect_x0) / incorrect_sigma, 2.0);
+        correct[i] = correct_log_norm - 0.5 * pow((score[i] - correct_x0) / correct_sigma, 2.0);
       }
     }
 
@@ -585,6 +620,106 @@ namespace OpenMS
       return {pos_sigma, neg_sigma};
     }
 
+    void PosteriorErrorProbabilityModel::binScores_(const vector<double>& x_scores, Size number_of_bins, ScoreHistogram_& histogram)
+    {
+      histogram.means.clear();
+      histogram.counts.clear();
+      histogram.squared_deviations.clear();
+      if (x_scores.empty() || number_of_bins == 0) return;
+
+      const auto min_max = std::minmax_element(x_scores.begin(), x_scores.end());
+      const double min_score = *min_max.first;
+      const double bin_width = (*min_max.second - min_score) / number_of_bins;
+      auto binIndex = [&](double x)
+      {
+        if (bin_width <= 0.0) return Size(0);
+        return std::min(number_of_bins - 1, Size((x - min_score) / bin_width));
+      };
+
+      // two passes (mean first, then squared deviations) for numerical stability
+      vector<double> sums(number_of_bins, 0.0), counts(number_of_bins, 0.0), squared_deviations(number_of_bins, 0.0);
+      for (double x : x_scores)
+      {
+        Size bin = binIndex(x);
+        sums[bin] += x;
+        counts[bin] += 1.0;
+      }
+      for (Size bin = 0; bin < number_of_bins; ++bin)
+      {
+        if (counts[bin] > 0.0) sums[bin] /= counts[bin];
+      }
+      for (double x : x_scores)
+      {
+        Size bin = binIndex(x);
+        squared_deviations[bin] += (x - sums[bin]) * (x - sums[bin]);
+      }
+
+      for (Size bin = 0; bin < number_of_bins; ++bin)
+      {
+        if (counts[bin] == 0.0) continue;
+        histogram.means.push_back(sums[bin]);
+        histogram.counts.push_back(counts[bin]);
+        histogram.squared_deviations.push_back(squared_deviations[bin]);
+      }
+    }
+
+    double PosteriorErrorProbabilityModel::computeLLAndIncorrectPosteriorsFromLogDensities_(
+        const ScoreHistogram_& histogram,
+        const vector<double>& incorrect_log_density, const vector<double>& correct_log_density,
+        vector<double>& incorrect_posterior) const
+    {
+      double loglikelihood = 0.0;
+      double log_prior_pos = log(1. - negative_prior_);
+      double log_prior_neg = log(negative_prior_);
+      incorrect_posterior.resize(incorrect_log_density.size());
+
+      for (Size bin = 0; bin < histogram.counts.size(); ++bin)
+      {
+        double log_resp_correct = log_prior_pos + correct_log_density[bin];
+        double log_resp_incorrect = log_prior_neg + incorrect_log_density[bin];
+        double max_log_resp = std::max(log_resp_correct, log_resp_incorrect);
+        double resp_correct = exp(log_resp_correct - max_log_resp);
+        double resp_incorrect = exp(log_resp_incorrect - max_log_resp);
+        double sum = resp_correct + resp_incorrect;
+        incorrect_posterior[bin] = resp_incorrect / sum;
+        loglikelihood += histogram.counts[bin] * (max_log_resp + log(sum));
+      }
+      return loglikelihood;
+    }
+
+    std::pair<double,double> PosteriorErrorProbabilityModel::pos_neg_mean_weighted_posteriors_(
+        const ScoreHistogram_& histogram,
+        const vector<double>& incorrect_posteriors) const
+    {
+      double pos_x0(0);
+      double neg_x0(0);
+      for (Size bin = 0; bin < histogram.counts.size(); ++bin)
+      {
+        double weighted_sum = histogram.counts[bin] * histogram.means[bin];
+        pos_x0 += (1. - incorrect_posteriors[bin]) * weighted_sum;
+        neg_x0 += incorrect_posteriors[bin] * weighted_sum;
+      }
+      return {pos_x0, neg_x0};
+    }
+
+    std::pair<double,double> PosteriorErrorProbabilityModel::pos_neg_sigma_weighted_posteriors_(
+        const ScoreHistogram_& histogram,
+        const vector<double>& incorrect_posteriors,
+        const std::pair<double,double>& pos_neg_mean) const
+    {
+      double pos_sigma(0);
+      double neg_sigma(0);
+      for (Size bin = 0; bin < histogram.counts.size(); ++bin)
+      {
+        // sum over the bin of (x - mean)^2 = count * (bin_mean - mean)^2 + sum of (x - bin_mean)^2
+        double pos_diff = histogram.means[bin] - pos_neg_mean.first;
+        double neg_diff = histogram.means[bin] - pos_neg_mean.second;
+        pos_sigma += (1. - incorrect_posteriors[bin]) * (histogram.counts[bin] * pos_diff * pos_diff + histogram.squared_deviations[bin]);
+        neg_sigma += incorrect_posteriors[bin] * (histogram.counts[bin] * neg_diff * neg_diff + histogram.squared_deviations[bin]);
+      }
+      return {pos_sigma, neg_sigma};
+    }
+
     double PosteriorErrorProbabilityModel::computeProbability(double score) const
     {
       // apply the same transformation that was applied before fitting
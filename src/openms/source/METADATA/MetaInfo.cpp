@@ -77,7 +77,11 @@ namespace OpenMS
 
   void MetaInfo::setValue(const String& name, const DataValue& value)
   {
-    UInt index = registry_.registerName(name); // no-op if name is already registered
+    UInt index = registry_.getIndex(name); // lock-free for known names
+    if (index == UInt(-1))
+    {
+      index = registry_.registerName(name);
+    }
     setValue(index, value);
   }
 
@@ -36,12 +36,28 @@
 
 #include <OpenMS/METADATA/MetaInfoRegistry.h>
 
+#include <atomic>
+
 using namespace std;
 
 namespace OpenMS
 {
 
+  namespace
+  {
+    /// source of MetaInfoRegistry::generation_ (unique over all registries and assignments)
+    std::atomic<UInt64> registry_generation(0);
+
+    /// per-thread cache of successful MetaInfoRegistry::getIndex() lookups
+    struct IndexCache
+    {
+      UInt64 generation = 0;
+      std::unordered_map<std::string, UInt> name_to_index;
+    };
+  }
+
   MetaInfoRegistry::MetaInfoRegistry() :
+    generation_(++registry_generation),
     next_index_(1024), 
     name_to_index_(), 
     index_to_name_(), 
@@ -114,7 +130,8 @@ namespace OpenMS
     index_to_unit_[13] = "";
   }
 
-  MetaInfoRegistry::MetaInfoRegistry(const MetaInfoRegistry& rhs)
+  MetaInfoRegistry::MetaInfoRegistry(const MetaInfoRegistry& rhs) :
+    generation_(++registry_generation)
   {
     *this = rhs;
   }
@@ -129,6 +146,8 @@ namespace OpenMS
 
 #pragma omp critical (MetaInfoRegistry)
     {
+      // indices may change, invalidate cached lookups
+      generation_.store(++registry_generation, std::memory_order_relaxed);
       next_index_ = rhs.next_index_;
       name_to_index_ = rhs.name_to_index_;
       index_to_name_ = rhs.index_to_name_;
@@ -230,6 +249,22 @@ namespace OpenMS
 
   UInt MetaInfoRegistry::getIndex(const String& name) const
   {
+    // names are never unregistered and keep their index, so hits can be served
+    // from a per-thread cache without locking (misses are not cached)
+    static thread_local IndexCache cache;
+    // a stale entry added while operator= runs is dropped with the next call
+    const UInt64 generation = generation_.load(std::memory_order_relaxed);
+    if (cache.generation != generation)
+    {
+      cache.name_to_index.clear();
+      cache.generation = generation;
+    }
+    MapString2IndexType::const_iterator cached = cache.name_to_index.find(name);
+    if (cached != cache.name_to_index.end())
+    {
+      return cached->second;
+    }
+
     UInt rv = UInt(-1);
 #pragma omp critical (MetaInfoRegistry)
     {
@@ -239,6 +274,10 @@ namespace OpenMS
         rv = it->second;
       }
     }
+    if (rv != UInt(-1))
+    {
+      cache.name_to_index.emplace(name, rv);
+    }
     return rv;
   }
 
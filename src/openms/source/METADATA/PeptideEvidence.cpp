@@ -36,8 +36,85 @@
 
 #include <OpenMS/CHEMISTRY/AASequence.h>
 
+#include <functional>
+#include <unordered_map>
+
 namespace OpenMS
 {
+  namespace
+  {
+    /// Hash and equality of the pointed-to accessions (to look up pooled accessions by any string)
+    struct AccessionHash
+    {
+      size_t operator()(const String* s) const { return std::hash<std::string>()(*s); }
+    };
+
+    struct AccessionEqual
+    {
+      bool operator()(const String* a, const String* b) const { return *a == *b; }
+    };
+
+    /// Pool of the accessions in use, keyed by the pooled strings themselves
+    typedef std::unordered_map<const String*, std::weak_ptr<const String>, AccessionHash, AccessionEqual> AccessionPool;
+
+    /// Returns the pool (never destroyed, as evidences in static objects may release their accessions after it)
+    AccessionPool& accessionPool()
+    {
+      static AccessionPool* const pool = new AccessionPool();
+      return *pool;
+    }
+
+    /// Removes an accession from the pool when the last evidence referring to it is gone
+    struct AccessionDeleter
+    {
+      void operator()(const String* s) const
+      {
+#pragma omp critical (PeptideEvidence_accessions)
+        {
+          AccessionPool& pool = accessionPool();
+          AccessionPool::iterator it = pool.find(s);
+          // the entry may already have been replaced by a new copy of the same accession
+          if (it != pool.end() && it->first == s) pool.erase(it);
+        }
+        delete s;
+      }
+    };
+
+    /**
+      @brief Returns the shared copy of accession @p s (a null pointer for the empty accession)
+
+      Protein accessions are repeated across many peptide hits (e.g. millions of
+      PSMs referring to some thousand proteins). Storing each of them once saves
+      memory and makes copying and comparing evidences cheap.
+
+      The pool only holds weak references: an accession is removed as soon as
+      no evidence refers to it any more, so its size is bounded by the distinct
+      accessions of the evidences currently alive.
+    */
+    std::shared_ptr<const String> internAccession(const String& s)
+    {
+      std::shared_ptr<const String> interned;
+      if (s.empty()) return interned;
+
+      // no shared_ptr may be released inside the critical section (its deleter locks the pool)
+#pragma omp critical (PeptideEvidence_accessions)
+      {
+        AccessionPool& pool = accessionPool();
+        AccessionPool::iterator it = pool.find(&s);
+        if (it != pool.end())
+        {
+          interned = it->second.lock();
+          if (!interned) pool.erase(it); // expired, its deleter is waiting for the lock
+        }
+        if (!interned)
+        {
+          interned = std::shared_ptr<const String>(new String(s), AccessionDeleter());
+          pool.emplace(interned.get(), interned);
+        }
+      }
+      return interned;
+    }
+  }
 
   const int PeptideEvidence::UNKNOWN_POSITION = -1;
   const int PeptideEvidence::N_TERMINAL_POSITION = 0;
@@ -55,7 +132,7 @@ namespace OpenMS
   }
 
   PeptideEvidence::PeptideEvidence(const String& accession, Int start, Int end, char aa_before, char aa_after) :
-      accession_(accession),
+      accession_(internAccession(accession)),
       start_(start),
       end_(end),
       aa_before_(aa_before),
@@ -65,7 +142,7 @@ namespace OpenMS
 
   bool PeptideEvidence::operator==(const PeptideEvidence& rhs) const
   {
-    return accession_ == rhs.accession_ &&
+    return accession_ == rhs.accession_ && // interned: same accession <=> same pointer
            start_ == rhs.start_ &&
            end_ == rhs.end_ &&
            aa_before_ == rhs.aa_before_ &&
@@ -74,7 +151,7 @@ namespace OpenMS
 
   bool PeptideEvidence::operator<(const PeptideEvidence& rhs) const
   {
-    if (accession_ != rhs.accession_) return accession_ < rhs.accession_;
+    if (accession_ != rhs.accession_) return getProteinAccession() < rhs.getProteinAccession();
     if (start_ != rhs.start_) return start_ < rhs.start_;
     if (end_ != rhs.end_) return end_ < rhs.end_;
     if (aa_before_ != rhs.aa_before_) return aa_before_ < rhs.aa_before_;
@@ -98,12 +175,13 @@ namespace OpenMS
 
   void PeptideEvidence::setProteinAccession(const String& s)
   {
-    accession_ = s;
+    accession_ = internAccession(s);
   }
 
   const String& PeptideEvidence::getProteinAccession() const
   {
-    return accession_;
+    static const String* const empty = new String();
+    return accession_ ? *accession_ : *empty;
   }
 
   void PeptideEvidence::setStart(const Int a)
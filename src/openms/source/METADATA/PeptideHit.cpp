@@ -34,11 +34,105 @@
 
 #include <OpenMS/METADATA/PeptideHit.h>
 #include <ostream>
+#include <unordered_map>
 
 using namespace std;
 
 namespace OpenMS
 {
+  namespace
+  {
+    typedef vector<PeptideEvidence> Evidences;
+
+    /// Hash and equality of the pointed-to evidence lists (accessions are interned, so their addresses can be hashed)
+    struct EvidencesHash
+    {
+      size_t operator()(const Evidences* e) const
+      {
+        size_t h = e->size();
+        for (const PeptideEvidence& ev : *e)
+        {
+          size_t v[] = { hash<const void*>()(&ev.getProteinAccession()), hash<Int>()(ev.getStart()), hash<Int>()(ev.getEnd()),
+                         hash<char>()(ev.getAABefore()), hash<char>()(ev.getAAAfter()) };
+          for (size_t x : v) h ^= x + 0x9e3779b9 + (h << 6) + (h >> 2);
+        }
+        return h;
+      }
+    };
+
+    struct EvidencesEqual
+    {
+      bool operator()(const Evidences* a, const Evidences* b) const { return *a == *b; }
+    };
+
+    /// Pool of the evidence lists in use, keyed by the pooled lists themselves
+    typedef unordered_map<const Evidences*, weak_ptr<const Evidences>, EvidencesHash, EvidencesEqual> EvidencesPool;
+
+    /// Returns the pool (never destroyed, as hits in static objects may release their evidences after it)
+    EvidencesPool& evidencesPool()
+    {
+      static EvidencesPool* const pool = new EvidencesPool();
+      return *pool;
+    }
+
+    /// An evidence list of the pool, removes itself from the pool when the last hit referring to it is gone
+    struct PooledEvidences
+    {
+      explicit PooledEvidences(Evidences&& e) :
+        evidences(std::move(e))
+      {
+      }
+
+      ~PooledEvidences()
+      {
+#pragma omp critical (PeptideHit_evidences)
+        {
+          EvidencesPool& pool = evidencesPool();
+          EvidencesPool::iterator it = pool.find(&evidences);
+          // the entry may already have been replaced by a new copy of the same list
+          if (it != pool.end() && it->first == &evidences) pool.erase(it);
+        }
+      } // the evidences (and their accessions) are released after leaving the critical section
+
+      Evidences evidences;
+    };
+
+    /**
+      @brief Returns the shared copy of the evidence list @p evidences (a null pointer for an empty list)
+
+      Hits of the same peptide (e.g. PSMs of different spectra, or of several
+      runs) usually carry identical evidences. Storing each distinct list once
+      keeps the memory of large identification results proportional to the
+      number of distinct peptides instead of the number of hits. Like the
+      accessions of PeptideEvidence, lists are only weakly referenced by the
+      pool and released with the last hit referring to them.
+    */
+    shared_ptr<const Evidences> internEvidences(Evidences&& evidences)
+    {
+      shared_ptr<const Evidences> interned;
+      if (evidences.empty()) return interned;
+
+      // no shared_ptr may be released inside the critical section (the pooled list would lock the pool)
+#pragma omp critical (PeptideHit_evidences)
+      {
+        EvidencesPool& pool = evidencesPool();
+        EvidencesPool::iterator it = pool.find(&evidences);
+        if (it != pool.end())
+        {
+          interned = it->second.lock();
+          if (!interned) pool.erase(it); // expired, its destructor is waiting for the lock
+        }
+        if (!interned)
+        {
+          shared_ptr<PooledEvidences> pooled = make_shared<PooledEvidences>(std::move(evidences));
+          interned = shared_ptr<const Evidences>(pooled, &pooled->evidences); // (pooled is still referenced by interned)
+          pool.emplace(interned.get(), interned);
+        }
+      }
+      return interned;
+    }
+  }
+
   // default constructor
   PeptideHit::PeptideHit() :
     MetaInfoInterface(),
@@ -181,7 +275,7 @@ namespace OpenMS
            && ar_equal
            && rank_ == rhs.rank_
            && charge_ == rhs.charge_
-           && peptide_evidences_ == rhs.peptide_evidences_
+           && (peptide_evidences_ == rhs.peptide_evidences_ || getPeptideEvidences() == rhs.getPeptideEvidences())
            && fragment_annotations_ == rhs.fragment_annotations_;
   }
 
@@ -230,22 +324,30 @@ namespace OpenMS
 
   const std::vector<PeptideEvidence>& PeptideHit::getPeptideEvidences() const
   {
-    return peptide_evidences_;
+    static const std::vector<PeptideEvidence> empty;
+    if (!peptide_evidences_)
+    {
+      return empty;
+    }
+    return *peptide_evidences_;
   }
 
   void PeptideHit::setPeptideEvidences(const std::vector<PeptideEvidence>& peptide_evidences)
   {
-    peptide_evidences_ = peptide_evidences;
+    peptide_evidences_ = internEvidences(std::vector<PeptideEvidence>(peptide_evidences));
   }
 
   void PeptideHit::setPeptideEvidences(std::vector<PeptideEvidence>&& peptide_evidences)
   {
-    peptide_evidences_ = std::move(peptide_evidences);
+    peptide_evidences_ = internEvidences(std::move(peptide_evidences));
   }
 
   void PeptideHit::addPeptideEvidence(const PeptideEvidence& peptide_evidence)
   {
-    peptide_evidences_.push_back(peptide_evidence);
+    // the current list may be shared with other hits, replace it by the extended one
+    std::vector<PeptideEvidence> peptide_evidences(getPeptideEvidences());
+    peptide_evidences.push_back(peptide_evidence);
+    setPeptideEvidences(std::move(peptide_evidences));
   }
 
   // sets the score of the peptide hit
@@ -289,7 +391,7 @@ namespace OpenMS
   std::set<String> PeptideHit::extractProteinAccessionsSet() const
   {
     set<String> accessions;
-    for (const auto& ev : peptide_evidences_)
+    for (const auto& ev : getPeptideEvidences())
     {
       // don't return empty accessions
       if (!ev.getProteinAccession().empty())
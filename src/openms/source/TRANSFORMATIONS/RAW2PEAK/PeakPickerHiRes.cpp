@@ -36,11 +36,19 @@
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
 
 #include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedian.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataParallelTransformingConsumer.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataTransformingConsumer.h>
 #include <OpenMS/KERNEL/OnDiscMSExperiment.h>
 #include <OpenMS/KERNEL/MSChromatogram.h>
 #include <OpenMS/MATH/MISC/SplineBisection.h>
 #include <OpenMS/MATH/MISC/CubicSpline2d.h>
 
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 using namespace std;
 
@@ -138,8 +146,9 @@ namespace OpenMS
       check_spacings = false;
     }
 
-    // signal-to-noise estimation
+    // signal-to-noise estimation (without progress logging, since spectra are picked in parallel)
     SignalToNoiseEstimatorMedian< ContainerType > snt;
+    snt.setLogType(ProgressLogger::NONE);
     snt.setParameters(param_.copy("SignalToNoise:", true));
 
     if (signal_to_noise_ > 0.0)
@@ -426,14 +435,19 @@ namespace OpenMS
     Size progress = 0;
     startProgress(0, input.size() + input.getChromatograms().size(), "picking peaks");
 
-    // MSLevel -> stats
-    map<int, SpectraPickInfo> pick_info;
+    // spectra are picked in parallel; boundaries and statistics are collected per spectrum and assembled in order afterwards
+    std::vector<std::vector<PeakBoundary> > boundaries_per_spectrum(input.size());
+    std::vector<char> was_picked(input.size(), false);
 
-    if (input.getNrSpectra() > 0)
+    size_t errCount = 0;
+    std::exception_ptr error;
+#pragma omp parallel for schedule(dynamic)
+    for (SignedSize scan_idx = 0; scan_idx < (SignedSize)input.size(); ++scan_idx)
     {
-      for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+      // parallel exception catching and re-throwing business
+      if (errCount) continue; // no need to pick further if already an error was encountered
+      try
       {
-        bool was_picked{false};
         // auto mode
         if (ms_levels_.empty()) 
         {
@@ -444,10 +458,8 @@ namespace OpenMS
           }
           else
           {
-            std::vector<PeakBoundary> boundaries_s; // peak boundaries of a single spectrum
-            pick(input[scan_idx], output[scan_idx], boundaries_s);
-            was_picked = true;
-            boundaries_spec.push_back(std::move(boundaries_s));
+            pick(input[scan_idx], output[scan_idx], boundaries_per_spectrum[scan_idx]);
+            was_picked[scan_idx] = true;
           }
         }
         // manual mode
@@ -457,32 +469,84 @@ namespace OpenMS
         }
         else
         {
-          std::vector<PeakBoundary> boundaries_s; // peak boundaries of a single spectrum
           SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType(true); // uses meta-info and inspects data if needed
           if (spectrum_type == SpectrumSettings::CENTROID && check_spectrum_type)
           {
             throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
           }
 
-          pick(input[scan_idx], output[scan_idx], boundaries_s);
-          was_picked = true;
-          boundaries_spec.push_back(std::move(boundaries_s));
+          pick(input[scan_idx], output[scan_idx], boundaries_per_spectrum[scan_idx]);
+          was_picked[scan_idx] = true;
+        }
+      }
+      catch (...)
+      {
+#pragma omp critical (PeakPickerHiRes_pickExperiment)
+        {
+          if (!errCount) error = std::current_exception();
+          ++errCount;
         }
-        pick_info[input[scan_idx].getMSLevel()].picked += was_picked;
-        ++pick_info[input[scan_idx].getMSLevel()].total;
-        setProgress(++progress);
       }
+
+#pragma omp atomic
+      ++progress;
+      IF_MASTERTHREAD
+      {
+        setProgress(progress);
+      }
+    }
+    if (errCount != 0)
+    {
+      std::rethrow_exception(error);
     }
 
+    // MSLevel -> stats
+    map<int, SpectraPickInfo> pick_info;
+    for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+    {
+      if (was_picked[scan_idx])
+      {
+        boundaries_spec.push_back(std::move(boundaries_per_spectrum[scan_idx]));
+      }
+      pick_info[input[scan_idx].getMSLevel()].picked += was_picked[scan_idx];
+      ++pick_info[input[scan_idx].getMSLevel()].total;
+    }
 
-    for (Size i = 0; i < input.getChromatograms().size(); ++i)
+    std::vector<MSChromatogram> chromatograms(input.getChromatograms().size());
+    std::vector<std::vector<PeakBoundary> > boundaries_per_chromatogram(input.getChromatograms().size());
+#pragma omp parallel for schedule(dynamic)
+    for (SignedSize i = 0; i < (SignedSize)input.getChromatograms().size(); ++i)
     {
-      MSChromatogram chromatogram;
-      std::vector<PeakBoundary> boundaries_c; // peak boundaries of a single chromatogram
-      pick(input.getChromatograms()[i], chromatogram, boundaries_c);
-      output.addChromatogram(chromatogram);
-      boundaries_chrom.push_back(boundaries_c);
-      setProgress(++progress);
+      // parallel exception catching and re-throwing business
+      if (errCount) continue;
+      try
+      {
+        pick(input.getChromatograms()[i], chromatograms[i], boundaries_per_chromatogram[i]);
+      }
+      catch (...)
+      {
+#pragma omp critical (PeakPickerHiRes_pickExperiment)
+        {
+          if (!errCount) error = std::current_exception();
+          ++errCount;
+        }
+      }
+
+#pragma omp atomic
+      ++progress;
+      IF_MASTERTHREAD
+      {
+        setProgress(progress);
+      }
+    }
+    if (errCount != 0)
+    {
+      std::rethrow_exception(error);
+    }
+    for (Size i = 0; i < chromatograms.size(); ++i)
+    {
+      output.addChromatogram(std::move(chromatograms[i]));
+      boundaries_chrom.push_back(std::move(boundaries_per_chromatogram[i]));
     }
     endProgress();
 
@@ -499,69 +563,74 @@ namespace OpenMS
   {
     // make sure that output is clear
     output.clear(true);
+    output.reserveSpaceSpectra(input.getNrSpectra());
+    output.reserveSpaceChromatograms(input.getNrChromatograms());
 
-    // copy experimental settings
-    static_cast<ExperimentalSettings &>(output) = *input.getExperimentalSettings();
+    // collect the picked data (in order) in the output map
+    MSDataTransformingConsumer storing_consumer;
+    storing_consumer.setExperimentalSettingsFunc([&output](const ExperimentalSettings& settings)
+    {
+      static_cast<ExperimentalSettings &>(output) = settings;
+    });
+    storing_consumer.setSpectraProcessingFunc([&output](MSSpectrum& s) { output.addSpectrum(std::move(s)); });
+    storing_consumer.setChromatogramProcessingFunc([&output](MSChromatogram& c) { output.addChromatogram(std::move(c)); });
 
-    Size progress = 0;
-    startProgress(0, input.size() + input.getNrChromatograms(), "picking peaks");
+    pickExperiment(input, storing_consumer, check_spectrum_type);
+  }
 
-    // resize output with respect to input
-    output.resize(input.size());
+  void PeakPickerHiRes::pickExperiment(/* const */ OnDiscMSExperiment& input, Interfaces::IMSDataConsumer& output, const bool check_spectrum_type) const
+  {
+    output.setExpectedSize(input.getNrSpectra(), input.getNrChromatograms());
+    output.setExperimentalSettings(*input.getExperimentalSettings());
 
-    if (input.getNrSpectra() > 0)
+    // reading (and decoding) from disc is serial, picking runs in parallel on batches of spectra
+    MSDataParallelTransformingConsumer picking_consumer(&output);
+    picking_consumer.setSpectraProcessingFunc([this, check_spectrum_type](MSSpectrum& s)
     {
-      for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+      if (ms_levels_.empty()) //auto mode
       {
-        if (ms_levels_.empty()) //auto mode
-        {
-          MSSpectrum s = input[scan_idx];
-          s.sortByPosition();
-
-          // determine type of spectral data (profile or centroided)
-          SpectrumSettings::SpectrumType spectrumType = s.getType();
-          if (spectrumType == SpectrumSettings::CENTROID)
-          {
-            output[scan_idx] = input[scan_idx];
-          }
-          else
-          {
-            pick(s, output[scan_idx]);
-          }
-        }
-        else if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel())) // manual mode
-        {
-          output[scan_idx] = input[scan_idx];
-        }
-        else
-        {
-          MSSpectrum s = input[scan_idx];
-          s.sortByPosition();
+        // determine type of spectral data (profile or centroided)
+        if (s.getType() == SpectrumSettings::CENTROID) return; // copied unchanged
+      }
+      else if (!ListUtils::contains(ms_levels_, s.getMSLevel())) // manual mode
+      {
+        return; // copied unchanged
+      }
+      else if (s.getType() == SpectrumSettings::CENTROID && check_spectrum_type)
+      {
+        throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
+      }
 
-          // determine type of spectral data (profile or centroided)
-          SpectrumSettings::SpectrumType spectrum_type = s.getType();
+      s.sortByPosition();
+      MSSpectrum picked;
+      pick(s, picked);
+      s = std::move(picked);
+    });
+    picking_consumer.setChromatogramProcessingFunc([this](MSChromatogram& c)
+    {
+      MSChromatogram picked;
+      pick(c, picked);
+      c = std::move(picked);
+    });
 
-          if (spectrum_type == SpectrumSettings::CENTROID && check_spectrum_type)
-          {
-            throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
-          }
+    Size progress = 0;
+    startProgress(0, input.size() + input.getNrChromatograms(), "picking peaks");
 
-          pick(s, output[scan_idx]);
-        }
-        setProgress(++progress);
-      }
+    for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+    {
+      MSSpectrum s = input.getSpectrum(scan_idx);
+      picking_consumer.consumeSpectrum(s);
+      setProgress(++progress);
     }
 
     for (Size i = 0; i < input.getNrChromatograms(); ++i)
     {
-      MSChromatogram chromatogram;
-      pick(input.getChromatogram(i), chromatogram);
-      output.addChromatogram(chromatogram);
+      MSChromatogram c = input.getChromatogram(i);
+      picking_consumer.consumeChromatogram(c);
       setProgress(++progress);
     }
+    picking_consumer.flush();
     endProgress();
-
-    return;
   }
 
   void PeakPickerHiRes::updateMembers_()
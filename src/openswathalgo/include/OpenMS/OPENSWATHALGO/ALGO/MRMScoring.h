@@ -298,6 +298,12 @@ private:
     std::vector< std::vector<double> > mi_precursor_combined_matrix_;
     //@}
 
+    /// cross correlation engine (keeps its buffers between the initializeXCorr* calls)
+    Scoring::NormalizedCrossCorrelator xcorr_correlator_;
+
+    /// Adds the intensities of the fragment (or, if @p precursor is true, precursor) features @p ids to xcorr_correlator_
+    void addXCorrTraces_(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& ids, bool precursor);
+
   };
 }
 
@@ -34,6 +34,7 @@
 
 #pragma once
 
+#include <complex>
 #include <numeric>
 #include <map>
 #include <vector>
@@ -140,6 +141,58 @@ public:
 
     //@}
 
+    /**
+      @brief Normalized cross-correlation between all pairs of a set of traces
+
+      Produces the same arrays as normalizedCrossCorrelation(data_i, data_j, n, 1)
+      for traces of equal length n (e.g. all transitions of a peak group), but
+      standardizes every trace only once and reuses all buffers between pairs.
+
+      Traces of at least @p fft_min_size points are correlated via FFT (the
+      transform of each trace is computed once). The lags whose correlation is
+      within rounding error of the maximum are then recomputed directly, so the
+      position and value of the highest correlation (which the xcorr scores
+      use) are exactly those of the direct computation; all other lags agree
+      within floating-point tolerance.
+    */
+    class OPENSWATHALGO_DLLAPI NormalizedCrossCorrelator
+    {
+public:
+      explicit NormalizedCrossCorrelator(std::size_t fft_min_size = 512);
+
+      /// Removes all traces (allocated buffers are kept)
+      void clear();
+
+      /// Adds a trace (all traces need to have the same length) and returns its index
+      std::size_t addTrace(const std::vector<double>& data);
+
+      /// Number of traces
+      std::size_t size() const;
+
+      /// Computes the normalized cross-correlation of traces @p i and @p j at lags -n ... n into @p result
+      void compute(std::size_t i, std::size_t j, XCorrArrayType& result);
+
+private:
+      /// Unnormalized correlation of traces @p i and @p j at lag @p delay (same summation order as calculateCrossCorrelation())
+      double correlation_(std::size_t i, std::size_t j, int delay) const;
+
+      /// In-place radix-2 FFT of @p data (size fft_size_)
+      void fft_(std::vector<std::complex<double> >& data, bool inverse) const;
+
+      std::size_t fft_min_size_;
+      std::size_t trace_size_;
+      std::size_t nr_traces_;
+      std::size_t fft_size_;
+      /// standardized traces (only the first nr_traces_ are valid)
+      std::vector<std::vector<double> > traces_;
+      /// Euclidean norms of the standardized traces
+      std::vector<double> norms_;
+      /// Fourier transforms of the zero-padded traces (FFT mode only)
+      std::vector<std::vector<std::complex<double> > > spectra_;
+      std::vector<std::complex<double> > twiddles_;
+      std::vector<std::complex<double> > buffer_;
+    };
+
   }
 }
 
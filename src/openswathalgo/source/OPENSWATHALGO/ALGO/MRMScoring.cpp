@@ -49,8 +49,26 @@ namespace OpenSwath
     return xcorr_matrix_;
   }
 
+  void MRMScoring::addXCorrTraces_(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& ids, bool precursor)
+  {
+    std::vector<double> intensity;
+    for (std::size_t i = 0; i < ids.size(); i++)
+    {
+      FeatureType f = precursor ? mrmfeature->getPrecursorFeature(ids[i]) : mrmfeature->getFeature(ids[i]);
+      intensity.clear();
+      f->getIntensity(intensity);
+      xcorr_correlator_.addTrace(intensity);
+    }
+  }
+
   void MRMScoring::initializeXCorrMatrix(const std::vector< std::vector< double > >& data)
   {
+    xcorr_correlator_.clear();
+    for (std::size_t i = 0; i < data.size(); i++)
+    {
+      xcorr_correlator_.addTrace(data[i]);
+    }
+
     xcorr_matrix_.resize(data.size());
     for (std::size_t i = 0; i < data.size(); i++)
     {
@@ -58,9 +76,7 @@ namespace OpenSwath
       for (std::size_t j = i; j < data.size(); j++)
       {
         // compute normalized cross correlation
-        std::vector< double > tmp1(data[i]);
-        std::vector< double > tmp2(data[j]);
-        xcorr_matrix_[i][j] = Scoring::normalizedCrossCorrelation(tmp1, tmp2, boost::numeric_cast<int>(data[i].size()), 1);
+        xcorr_correlator_.compute(i, j, xcorr_matrix_[i][j]);
       }
     }
   }
@@ -82,98 +98,92 @@ namespace OpenSwath
 
   void MRMScoring::initializeXCorrMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
+    xcorr_correlator_.clear();
+    addXCorrTraces_(mrmfeature, native_ids, false);
+
     xcorr_matrix_.resize(native_ids.size());
     for (std::size_t i = 0; i < native_ids.size(); i++)
     {
-      String native_id = native_ids[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
       xcorr_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
       for (std::size_t j = i; j < native_ids.size(); j++)
       {
-        String native_id2 = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
         // compute normalized cross correlation
-        xcorr_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        xcorr_correlator_.compute(i, j, xcorr_matrix_[i][j]);
       }
     }
   }
 
   void MRMScoring::initializeXCorrContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids_set1, const std::vector<String>& native_ids_set2)
   {
-    std::vector<double> intensityi, intensityj;
+    // traces of set 2 follow those of set 1
+    xcorr_correlator_.clear();
+    addXCorrTraces_(mrmfeature, native_ids_set1, false);
+    addXCorrTraces_(mrmfeature, native_ids_set2, false);
+    const std::size_t offset = native_ids_set1.size();
+
     xcorr_contrast_matrix_.resize(native_ids_set1.size());
     for (std::size_t i = 0; i < native_ids_set1.size(); i++)
     { 
-      String native_id = native_ids_set1[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
       xcorr_contrast_matrix_[i].resize(native_ids_set2.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
       for (std::size_t j = 0; j < native_ids_set2.size(); j++)
       {
-        String native_id2 = native_ids_set2[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
         // compute normalized cross correlation
-        xcorr_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        xcorr_correlator_.compute(i, offset + j, xcorr_contrast_matrix_[i][j]);
       }
     }
   }
 
   void MRMScoring::initializeXCorrPrecursorMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids)
   {
-    std::vector<double> intensityi, intensityj;
+    xcorr_correlator_.clear();
+    addXCorrTraces_(mrmfeature, precursor_ids, true);
+
     xcorr_precursor_matrix_.resize(precursor_ids.size());
     for (std::size_t i = 0; i < precursor_ids.size(); i++)
     {
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
       xcorr_precursor_matrix_[i].resize(precursor_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
       for (std::size_t j = i; j < precursor_ids.size(); j++)
       {
-        String precursor_id2 = precursor_ids[j];
-        FeatureType fj = mrmfeature->getPrecursorFeature(precursor_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
         // compute normalized cross correlation
-        xcorr_precursor_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        xcorr_correlator_.compute(i, j, xcorr_precursor_matrix_[i][j]);
       }
     }
   }
 
   void MRMScoring::initializeXCorrPrecursorContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
+    // fragment traces follow the precursor traces
+    xcorr_correlator_.clear();
+    addXCorrTraces_(mrmfeature, precursor_ids, true);
+    addXCorrTraces_(mrmfeature, native_ids, false);
+    const std::size_t offset = precursor_ids.size();
+
     xcorr_precursor_contrast_matrix_.resize(precursor_ids.size());
     for (std::size_t i = 0; i < precursor_ids.size(); i++)
     { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
       xcorr_precursor_contrast_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
       for (std::size_t j = 0; j < native_ids.size(); j++)
       {
-        String native_id = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
         // compute normalized cross correlation
-        xcorr_precursor_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        xcorr_correlator_.compute(i, offset + j, xcorr_precursor_contrast_matrix_[i][j]);
       }
     }
   }
 
   void MRMScoring::initializeXCorrPrecursorContrastMatrix(const std::vector< std::vector< double > >& data_precursor, const std::vector< std::vector< double > >& data_fragments)
   {
+    // fragment traces follow the precursor traces
+    xcorr_correlator_.clear();
+    for (std::size_t i = 0; i < data_precursor.size(); i++)
+    {
+      xcorr_correlator_.addTrace(data_precursor[i]);
+    }
+    for (std::size_t j = 0; j < data_fragments.size(); j++)
+    {
+      xcorr_correlator_.addTrace(data_fragments[j]);
+    }
+    const std::size_t offset = data_precursor.size();
+
     xcorr_precursor_contrast_matrix_.resize(data_precursor.size());
     for (std::size_t i = 0; i < data_precursor.size(); i++)
     { 
@@ -181,11 +191,9 @@ namespace OpenSwath
       for (std::size_t j = 0; j < data_fragments.size(); j++)
       {
         // compute normalized cross correlation
-        std::vector< double > tmp1(data_precursor[i]);
-        std::vector< double > tmp2(data_fragments[j]);
-        xcorr_precursor_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(tmp1, tmp2, boost::numeric_cast<int>(tmp1.size()), 1);
+        xcorr_correlator_.compute(i, offset + j, xcorr_precursor_contrast_matrix_[i][j]);
 #ifdef MRMSCORING_TESTING
-        std::cout << " fill xcorr_precursor_contrast_matrix_ "<< tmp1.size() << " / " << tmp2.size() << " : " << xcorr_precursor_contrast_matrix_[i][j].data.size() << std::endl;
+        std::cout << " fill xcorr_precursor_contrast_matrix_ "<< data_precursor[i].size() << " / " << data_fragments[j].size() << " : " << xcorr_precursor_contrast_matrix_[i][j].data.size() << std::endl;
 #endif
       }
     }
@@ -193,36 +201,20 @@ namespace OpenSwath
 
   void MRMScoring::initializeXCorrPrecursorCombinedMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    std::vector<FeatureType> features;
+    // precursor traces first, then fragment traces
+    xcorr_correlator_.clear();
+    addXCorrTraces_(mrmfeature, precursor_ids, true);
+    addXCorrTraces_(mrmfeature, native_ids, false);
+    const std::size_t nr_features = xcorr_correlator_.size();
 
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
+    xcorr_precursor_combined_matrix_.resize(nr_features);
+    for (std::size_t i = 0; i < nr_features; i++)
     { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      features.push_back(fi);
-    }
-    for (std::size_t j = 0; j < native_ids.size(); j++)
-    {
-      String native_id = native_ids[j];
-      FeatureType fj = mrmfeature->getFeature(native_id);
-      features.push_back(fj);
-    }
-
-    xcorr_precursor_combined_matrix_.resize(features.size());
-    for (std::size_t i = 0; i < features.size(); i++)
-    { 
-      FeatureType fi = features[i];
-      xcorr_precursor_combined_matrix_[i].resize(features.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < features.size(); j++)
+      xcorr_precursor_combined_matrix_[i].resize(nr_features);
+      for (std::size_t j = 0; j < nr_features; j++)
       {
-        FeatureType fj = features[j];
-        intensityj.clear();
-        fj->getIntensity(intensityj);
         // compute normalized cross correlation
-        xcorr_precursor_combined_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        xcorr_correlator_.compute(i, j, xcorr_precursor_combined_matrix_[i][j]);
       }
     }
   }
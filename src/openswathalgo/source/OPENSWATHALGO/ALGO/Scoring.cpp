@@ -36,6 +36,7 @@
 #include <OpenMS/OPENSWATHALGO/Macros.h>
 #include <cmath>
 #include <algorithm>
+#include <limits>
 
 #include <boost/numeric/conversion/cast.hpp>
 
@@ -172,19 +173,17 @@ namespace OpenSwath
       XCorrArrayType result;
       result.data.reserve( (size_t)std::ceil((2*maxdelay + 1) / lag));
       int datasize = boost::numeric_cast<int>(data1.size());
-      int i, j, delay;
+      int i, delay;
 
       for (delay = -maxdelay; delay <= maxdelay; delay = delay + lag)
       {
+        // only positions where both i and i + delay are valid (no branch in the inner loop)
+        const int i_begin = (std::max)(0, -delay);
+        const int i_end = (std::min)(datasize, datasize - delay);
         double sxy = 0;
-        for (i = 0; i < datasize; ++i)
+        for (i = i_begin; i < i_end; ++i)
         {
-          j = i + delay;
-          if (j < 0 || j >= datasize)
-          {
-            continue;
-          }
-          sxy += (data1[i]) * (data2[j]);
+          sxy += (data1[i]) * (data2[i + delay]);
         }
         result.data.push_back(std::make_pair(delay, sxy));
       }
@@ -296,5 +295,183 @@ namespace OpenSwath
       return result;
     }
 
+    NormalizedCrossCorrelator::NormalizedCrossCorrelator(std::size_t fft_min_size) :
+      fft_min_size_(fft_min_size),
+      trace_size_(0),
+      nr_traces_(0),
+      fft_size_(0)
+    {
+    }
+
+    void NormalizedCrossCorrelator::clear()
+    {
+      nr_traces_ = 0;
+    }
+
+    std::size_t NormalizedCrossCorrelator::size() const
+    {
+      return nr_traces_;
+    }
+
+    std::size_t NormalizedCrossCorrelator::addTrace(const std::vector<double>& data)
+    {
+      OPENSWATH_PRECONDITION(data.size() != 0, "Need non-empty array.");
+      OPENSWATH_PRECONDITION(nr_traces_ == 0 || data.size() == trace_size_, "All traces need to have the same length");
+
+      if (nr_traces_ == 0)
+      {
+        trace_size_ = data.size();
+        // linear correlation at lags -(n-1) ... n-1 needs at least 2n - 1 points
+        std::size_t fft_size = 1;
+        while (fft_size < 2 * trace_size_) fft_size <<= 1;
+        if (trace_size_ >= fft_min_size_ && fft_size != fft_size_)
+        {
+          fft_size_ = fft_size;
+          twiddles_.resize(fft_size_ / 2);
+          const double pi = 3.14159265358979323846;
+          for (std::size_t k = 0; k < twiddles_.size(); ++k)
+          {
+            twiddles_[k] = std::polar(1.0, -2.0 * pi * (double)k / (double)fft_size_);
+          }
+        }
+      }
+
+      if (traces_.size() <= nr_traces_)
+      {
+        traces_.resize(nr_traces_ + 1);
+        norms_.resize(nr_traces_ + 1);
+        spectra_.resize(nr_traces_ + 1);
+      }
+      std::vector<double>& trace = traces_[nr_traces_];
+      trace.assign(data.begin(), data.end());
+      standardize_data(trace);
+      double sqsum = 0;
+      for (std::size_t k = 0; k < trace.size(); ++k)
+      {
+        sqsum += trace[k] * trace[k];
+      }
+      norms_[nr_traces_] = std::sqrt(sqsum);
+
+      if (trace_size_ >= fft_min_size_)
+      {
+        std::vector<std::complex<double> >& spectrum = spectra_[nr_traces_];
+        spectrum.assign(fft_size_, std::complex<double>(0.0, 0.0));
+        for (std::size_t k = 0; k < trace.size(); ++k)
+        {
+          spectrum[k] = trace[k];
+        }
+        fft_(spectrum, false);
+      }
+      return nr_traces_++;
+    }
+
+    double NormalizedCrossCorrelator::correlation_(std::size_t i, std::size_t j, int delay) const
+    {
+      const std::vector<double>& data1 = traces_[i];
+      const std::vector<double>& data2 = traces_[j];
+      const int datasize = (int)trace_size_;
+      const int i_begin = (std::max)(0, -delay);
+      const int i_end = (std::min)(datasize, datasize - delay);
+      double sxy = 0;
+      for (int k = i_begin; k < i_end; ++k)
+      {
+        sxy += data1[k] * data2[k + delay];
+      }
+      return sxy;
+    }
+
+    void NormalizedCrossCorrelator::fft_(std::vector<std::complex<double> >& data, bool inverse) const
+    {
+      const std::size_t n = data.size();
+
+      // bit reversal permutation
+      for (std::size_t i = 1, j = 0; i < n; ++i)
+      {
+        std::size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+        {
+          j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) std::swap(data[i], data[j]);
+      }
+
+      // butterflies
+      for (std::size_t len = 2; len <= n; len <<= 1)
+      {
+        const std::size_t half = len / 2;
+        const std::size_t step = n / len;
+        for (std::size_t start = 0; start < n; start += len)
+        {
+          for (std::size_t k = 0; k < half; ++k)
+          {
+            const std::complex<double> w = inverse ? std::conj(twiddles_[k * step]) : twiddles_[k * step];
+            const std::complex<double> u = data[start + k];
+            const std::complex<double> v = data[start + k + half] * w;
+            data[start + k] = u + v;
+            data[start + k + half] = u - v;
+          }
+        }
+      }
+
+      if (inverse)
+      {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          data[i] /= (double)n;
+        }
+      }
+    }
+
+    void NormalizedCrossCorrelator::compute(std::size_t i, std::size_t j, XCorrArrayType& result)
+    {
+      OPENSWATH_PRECONDITION(i < nr_traces_ && j < nr_traces_, "Trace index out of range");
+
+      const int n = (int)trace_size_;
+      result.data.resize(2 * trace_size_ + 1);
+
+      if (trace_size_ < fft_min_size_)
+      {
+        for (int delay = -n; delay <= n; ++delay)
+        {
+          result.data[delay + n] = std::make_pair(delay, correlation_(i, j, delay) / trace_size_);
+        }
+        return;
+      }
+
+      // correlation theorem: corr(a, b) = IFFT(conj(FFT(a)) * FFT(b)), lag d at index d mod N
+      const std::vector<std::complex<double> >& spectrum1 = spectra_[i];
+      const std::vector<std::complex<double> >& spectrum2 = spectra_[j];
+      buffer_.resize(fft_size_);
+      for (std::size_t k = 0; k < fft_size_; ++k)
+      {
+        buffer_[k] = std::conj(spectrum1[k]) * spectrum2[k];
+      }
+      fft_(buffer_, true);
+
+      double max_value = -std::numeric_limits<double>::max();
+      result.data[0] = std::make_pair(-n, 0.0);
+      result.data[2 * n] = std::make_pair(n, 0.0);
+      for (int delay = -n + 1; delay < n; ++delay)
+      {
+        const double value = buffer_[delay < 0 ? fft_size_ + delay : delay].real();
+        result.data[delay + n] = std::make_pair(delay, value);
+        max_value = (std::max)(max_value, value);
+      }
+
+      // recompute all lags that may be the true maximum (the FFT rounding
+      // error is far below this margin), then normalize
+      const double margin = 1e-8 * norms_[i] * norms_[j];
+      for (int delay = -n + 1; delay < n; ++delay)
+      {
+        double& value = result.data[delay + n].second;
+        if (value >= max_value - margin)
+        {
+          value = correlation_(i, j, delay);
+        }
+        value /= trace_size_;
+      }
+    }
+
   } //end namespace Scoring
 }
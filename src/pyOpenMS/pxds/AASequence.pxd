@@ -76,6 +76,12 @@ cdef extern from "<OpenMS/CHEMISTRY/AASequence.h>" namespace "OpenMS":
         double getMonoWeight() nogil except +
         double getMonoWeight(ResidueType type_, Int charge) nogil except +
 
+        # returns the mono isotopic weights of all prefixes of the peptide
+        libcpp_vector[double] getPrefixMonoWeights(ResidueType type_, Int charge) nogil except +
+
+        # returns the average weights of all prefixes of the peptide
+        libcpp_vector[double] getPrefixAverageWeights(ResidueType type_, Int charge) nogil except +
+
         # returns the number of residues
         Size size() nogil except +
 
@@ -44,6 +44,10 @@ cdef extern from "<OpenMS/FORMAT/OPTIONS/PeakFileOptions.h>" namespace "OpenMS":
 
         Size getMaxDataPoolSize() nogil except +
         void setMaxDataPoolSize(Size s) nogil except +
+        bool getParallelWrite() nogil except + # wrap-doc:[mzML only!] Whether to encode spectra and chromatograms in parallel when writing
+        void setParallelWrite(bool parallel_write) nogil except + # wrap-doc:[mzML only!] Set whether to encode spectra and chromatograms in parallel when writing
+        bool getFastParsing() nogil except + # wrap-doc:[consensusXML only!] Whether to parse the consensus elements with the fast pull parser
+        void setFastParsing(bool fast_parsing) nogil except + # wrap-doc:[consensusXML only!] Set whether to parse the consensus elements with the fast pull parser
 
         void setSortSpectraByMZ(bool doSort) nogil except +
         bool getSortSpectraByMZ() nogil except +
@@ -0,0 +1,19 @@
+from Types cimport *
+from String cimport *
+from OpenSwathDataStructures cimport *
+from ISpectrumAccess cimport *
+
+cdef extern from "<OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMSCachedMapped.h>" namespace "OpenMS":
+
+  # TODO missing functions (zero-copy views)
+  cdef cppclass SpectrumAccessOpenMSCachedMapped(ISpectrumAccess):
+        # wrap-inherits:
+        #  ISpectrumAccess
+        #
+        # wrap-doc:
+        #   Thread-safe spectrum access on a memory-mapped cached mzML file
+
+        SpectrumAccessOpenMSCachedMapped() # wrap-pass-constructor
+
+        SpectrumAccessOpenMSCachedMapped(String filename) nogil except +
+        SpectrumAccessOpenMSCachedMapped(SpectrumAccessOpenMSCachedMapped q) nogil except + # wrap-ignore
@@ -154,6 +154,7 @@ set(kernel_executables_list
   MSExperiment_test
   OnDiscMSExperiment_test
   MSSpectrum_test
+  ColumnarSpectrum_test
   Peak1D_test
   Peak2D_test
   PeakIndex_test
@@ -252,6 +253,7 @@ set(format_executables_list
   UnimodXMLFile_test
   XMassFile_test
   XMLFile_test
+  XMLPullTokenizer_test
   XMLValidator_test
   XQuestResultXMLFile_test
   XTandemInfile_test
@@ -260,6 +262,7 @@ set(format_executables_list
   # DATAACCESS
   MSDataCachedConsumer_test
   MSDataTransformingConsumer_test
+  MSDataParallelTransformingConsumer_test
   MSDataChainingConsumer_test
   MSDataStoringConsumer_test
   MSDataAggregatingConsumer_test
@@ -681,6 +684,7 @@ if(NOT DISABLE_OPENSWATH)
     IonMobilityScoring_test
     CachedMzML_test
     CachedMzMLHandler_test
+    SpectrumAccessOpenMSCachedMapped_test
     HDF5_test
   )
 endif(NOT DISABLE_OPENSWATH)
@@ -406,6 +406,66 @@ START_SECTION((double getMonoWeight(Residue::ResidueType type = Residue::Full, I
 }
 END_SECTION
 
+START_SECTION((std::vector<double> getPrefixMonoWeights(Residue::ResidueType type = Residue::Full, Int charge = 0) const))
+{
+  // the weights must be identical to those of the prefixes
+  const Residue::ResidueType types[] = {Residue::Full, Residue::Internal, Residue::NTerminal, Residue::CTerminal,
+                                        Residue::AIon, Residue::BIon, Residue::CIon, Residue::XIon, Residue::YIon, Residue::ZIon};
+  const vector<String> peptides = {"DFPIANGER", "(Acetyl)DFPIANGER(Amidated)", "PEPTM(Oxidation)IDEK[+123.45]", "PEPTX[123.4]IDE"};
+  for (const String& pep : peptides)
+  {
+    AASequence seq = AASequence::fromString(pep);
+    for (Residue::ResidueType type : types)
+    {
+      for (Int charge = 0; charge < 3; ++charge)
+      {
+        std::vector<double> weights = seq.getPrefixMonoWeights(type, charge);
+        TEST_EQUAL(weights.size(), seq.size())
+        Size n_different = 0;
+        for (Size i = 0; i < weights.size(); ++i)
+        {
+          n_different += (weights[i] != seq.getPrefix(i + 1).getMonoWeight(type, charge));
+        }
+        TEST_EQUAL(n_different, 0)
+      }
+    }
+  }
+  TOLERANCE_ABSOLUTE(1e-6)
+  std::vector<double> b_ions = AASequence::fromString("DFPIANGER").getPrefixMonoWeights(Residue::BIon, 1);
+  TEST_REAL_SIMILAR(b_ions[1], AASequence::fromString("DF").getMonoWeight(Residue::BIon, 1))
+  TEST_EQUAL(AASequence().getPrefixMonoWeights().empty(), true)
+  TEST_EXCEPTION(Exception::InvalidValue, AASequence::fromString("PEPTXIDE").getPrefixMonoWeights())
+}
+END_SECTION
+
+START_SECTION((std::vector<double> getPrefixAverageWeights(Residue::ResidueType type = Residue::Full, Int charge = 0) const))
+{
+  const Residue::ResidueType types[] = {Residue::Full, Residue::Internal, Residue::NTerminal, Residue::CTerminal,
+                                        Residue::AIon, Residue::BIon, Residue::CIon, Residue::XIon, Residue::YIon, Residue::ZIon};
+  const vector<String> peptides = {"DFPIANGER", "(Acetyl)DFPIANGER(Amidated)", "PEPTM(Oxidation)IDEK[+123.45]", "PEPTX[123.4]IDE"};
+  for (const String& pep : peptides)
+  {
+    AASequence seq = AASequence::fromString(pep);
+    for (Residue::ResidueType type : types)
+    {
+      for (Int charge = 0; charge < 3; ++charge)
+      {
+        std::vector<double> weights = seq.getPrefixAverageWeights(type, charge);
+        TEST_EQUAL(weights.size(), seq.size())
+        Size n_different = 0;
+        for (Size i = 0; i < weights.size(); ++i)
+        {
+          n_different += (weights[i] != seq.getPrefix(i + 1).getAverageWeight(type, charge));
+        }
+        TEST_EQUAL(n_different, 0)
+      }
+    }
+  }
+  TEST_EQUAL(AASequence().getPrefixAverageWeights().empty(), true)
+  TEST_EXCEPTION(Exception::InvalidValue, AASequence::fromString("PEPTXIDE").getPrefixAverageWeights())
+}
+END_SECTION
+
 START_SECTION(const Residue& operator[](Size index) const)
   AASequence seq = AASequence::fromString("DFPIANGER");
   Size index = 0;
@@ -1509,6 +1569,54 @@ START_SECTION([EXTRA] multithreaded example)
 }
 END_SECTION
 
+START_SECTION([EXTRA] repeated parsing of modified sequences)
+{
+  // modified sequences are cached by fromString; results must not depend on earlier calls
+  AASequence seq1 = AASequence::fromString("PEPT(Phospho)IDEM(Oxidation)K");
+  AASequence seq2 = AASequence::fromString("PEPT(Phospho)IDEM(Oxidation)K");
+  TEST_EQUAL(seq1, seq2)
+  TEST_EQUAL(seq2.toString(), "PEPT(Phospho)IDEM(Oxidation)K")
+  TEST_REAL_SIMILAR(seq2.getMonoWeight(), seq1.getMonoWeight())
+
+  // permissive and strict parsing are cached separately
+  AASequence seq3 = AASequence::fromString("PEP T*IDEM(Oxidation)", true);
+  TEST_EQUAL(seq3.toString(), "PEPTXIDEM(Oxidation)");
+  TEST_EXCEPTION(Exception::ParseError, AASequence::fromString("PEP T*IDEM(Oxidation)", false));
+  TEST_EQUAL(AASequence::fromString("PEP T*IDEM(Oxidation)", true), seq3)
+
+  // new (unknown) modifications are picked up after the cache was filled
+  AASequence seq4 = AASequence::fromString("PEPTIDEK[+1234.5678]");
+  TEST_EQUAL(seq4, AASequence::fromString("PEPTIDEK[+1234.5678]"))
+  TEST_REAL_SIMILAR(seq4.getMonoWeight() - AASequence::fromString("PEPTIDEK").getMonoWeight(), 1234.5678)
+}
+END_SECTION
+
+START_SECTION([EXTRA] parsing more distinct modified sequences than fit into the cache)
+{
+  // the cache is switched off and on again for (nearly) distinct sequences; results must not depend on it
+  const String aa = "ACDEFGHIKLMNPQRSTVWY";
+  vector<String> peptides;
+  for (Size i = 0; i < 30000; ++i)
+  {
+    String pep = "M(Oxidation)";
+    for (Size k = i; k > 0; k /= aa.size())
+    {
+      pep += aa[k % aa.size()];
+    }
+    peptides.push_back(pep);
+  }
+  Size n_equal = 0;
+  for (Size rep = 0; rep < 2; ++rep)
+  {
+    for (const String& pep : peptides)
+    {
+      n_equal += (AASequence::fromString(pep).toString() == pep);
+    }
+  }
+  TEST_EQUAL(n_equal, 2 * peptides.size())
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
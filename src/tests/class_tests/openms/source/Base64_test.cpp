@@ -264,6 +264,68 @@ START_SECTION([EXTRA] zlib functionality)
 }
 END_SECTION
 
+START_SECTION([EXTRA] long arrays (vectorized code paths))
+{
+  // lengths around the block sizes of the SSE / AVX2 kernels (12/16 and 24/32 bytes)
+  for (Size n = 0; n < 100; ++n)
+  {
+    std::vector<double> data_double(n);
+    std::vector<float> data(n);
+    std::vector<Int64> data_int(n);
+    for (Size i = 0; i < n; ++i)
+    {
+      data_double[i] = 300.15 + i * 17.123;
+      data[i] = 120.0f + i * 3.5f;
+      data_int[i] = Int64(i) * 1234567 - 500;
+    }
+    for (Size k = 0; k < 4; ++k)
+    {
+      Base64::ByteOrder byte_order = (k % 2 == 0) ? Base64::BYTEORDER_LITTLEENDIAN : Base64::BYTEORDER_BIGENDIAN;
+      bool zlib = (k >= 2);
+      String str;
+
+      std::vector<double> tmp_double(data_double), res_double;
+      Base64::encode(tmp_double, byte_order, str, zlib);
+      Base64::decode(str, byte_order, res_double, zlib);
+      TEST_EQUAL(res_double == data_double, true)
+
+      std::vector<float> tmp(data), res;
+      Base64::encode(tmp, byte_order, str, zlib);
+      Base64::decode(str, byte_order, res, zlib);
+      TEST_EQUAL(res == data, true)
+
+      std::vector<Int64> tmp_int(data_int), res_int;
+      Base64::encodeIntegers(tmp_int, byte_order, str, zlib);
+      Base64::decodeIntegers(str, byte_order, res_int, zlib);
+      TEST_EQUAL(res_int == data_int, true)
+    }
+  }
+
+  // encoding of a long byte sequence matches the reference implementation (Qt)
+  std::vector<String> strings;
+  strings.push_back(String(500, 'x') + "abcdefghijklmnopqrstuvwxyz0123456789" + String(100, '\xFF'));
+  String str;
+  Base64::encodeStrings(strings, str, false, false);
+  TEST_EQUAL(str, String(QByteArray::fromRawData(strings[0].c_str(), (int)strings[0].size()).toBase64().constData()))
+
+  // decoding skips whitespace (e.g. line breaks inserted by other writers)
+  std::vector<double> data_double(50, 471.568), tmp_double(data_double), res_double;
+  Base64::encode(tmp_double, Base64::BYTEORDER_LITTLEENDIAN, str);
+  str.insert(152, "\r\n");
+  str.insert(76, "\r\n");
+  Base64::decode(str, Base64::BYTEORDER_LITTLEENDIAN, res_double);
+  TEST_EQUAL(res_double == data_double, true)
+
+  // // for quick benchmarking of implementation changes
+  // std::vector<double> bench(4000, 471.568);
+  // Base64::encode(bench, Base64::BYTEORDER_LITTLEENDIAN, str);
+  // for (Size i = 0; i != 1e4; ++i)
+  // {
+  //   Base64::decode(str, Base64::BYTEORDER_LITTLEENDIAN, bench);
+  // }
+}
+END_SECTION
+
 START_SECTION(( void encodeStrings(const std::vector<String> & in, String & out, bool zlib_compression = false, bool append_zero_byte = true)))
 {
   Base64 b64;
@@ -260,6 +260,73 @@ START_SECTION([EXTRA] void extractChromatograms(const OpenSwath::SpectrumAccessP
 }
 END_SECTION
 
+START_SECTION([EXTRA] void extractChromatograms(const OpenSwath::SpectrumAccessPtr input, std::vector< OpenSwath::ChromatogramPtr > &output, std::vector< ExtractionCoordinates >& extraction_coordinates, double mz_extraction_window, bool ppm, String filter) with RT windows)
+{
+  double extract_window = 0.05;
+  boost::shared_ptr<PeakMap > exp(new PeakMap);
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("ChromatogramExtractor_input.mzML"), *exp);
+  OpenSwath::SpectrumAccessPtr expptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+
+  ChromatogramExtractorAlgorithm extractor;
+
+  // full chromatograms
+  const double mzs[] = {618.31, 628.45, 654.38};
+  std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > full_coordinates;
+  std::vector< OpenSwath::ChromatogramPtr > full;
+  for (Size i = 0; i < 3; ++i)
+  {
+    ChromatogramExtractorAlgorithm::ExtractionCoordinates coord;
+    coord.mz = mzs[i]; coord.rt_start = 0; coord.rt_end = -1;
+    full_coordinates.push_back(coord);
+    full.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+  }
+  extractor.extractChromatograms(expptr, full, full_coordinates, extract_window, false, -1, "tophat");
+
+  // many (overlapping) RT windows of different width, mixed with unrestricted coordinates
+  std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > coordinates;
+  std::vector<Size> full_index;
+  for (Size i = 0; i < 3; ++i)
+  {
+    for (Size w = 0; w < 40; ++w)
+    {
+      ChromatogramExtractorAlgorithm::ExtractionCoordinates coord;
+      coord.mz = mzs[i];
+      coord.rt_start = 3000.0 + 5.0 * w;
+      coord.rt_end = coord.rt_start + (w % 3 == 0 ? -1.0 : 10.0 * (w % 7));
+      coordinates.push_back(coord);
+      full_index.push_back(i);
+    }
+  }
+  std::vector< OpenSwath::ChromatogramPtr > out_exp;
+  for (Size k = 0; k < coordinates.size(); ++k)
+  {
+    out_exp.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+  }
+  extractor.extractChromatograms(expptr, out_exp, coordinates, extract_window, false, -1, "tophat");
+
+  // every chromatogram contains exactly the data points of the full chromatogram within its RT window
+  for (Size k = 0; k < coordinates.size(); ++k)
+  {
+    const OpenSwath::ChromatogramPtr& f = full[full_index[k]];
+    std::vector<double> expected_rt, expected_int;
+    for (Size i = 0; i < f->getTimeArray()->data.size(); ++i)
+    {
+      double rt = f->getTimeArray()->data[i];
+      if (coordinates[k].rt_end - coordinates[k].rt_start <= 0 ||
+          (rt >= coordinates[k].rt_start && rt <= coordinates[k].rt_end))
+      {
+        expected_rt.push_back(rt);
+        expected_int.push_back(f->getIntensityArray()->data[i]);
+      }
+    }
+    TEST_EQUAL(out_exp[k]->getTimeArray()->data == expected_rt, true)
+    TEST_EQUAL(out_exp[k]->getIntensityArray()->data == expected_int, true)
+  }
+  TEST_EQUAL(out_exp[0]->getTimeArray()->data.size(), 59)
+  TEST_EQUAL(out_exp[1]->getTimeArray()->data.size() < 59, true)
+}
+END_SECTION
+
 ///////////////////////////////////////////////////////////////////////////
 /// Private functions
 ///////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,312 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg$
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/KERNEL/ColumnarSpectrum.h>
+///////////////////////////
+
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/COMPARISON/SPECTRA/SpectrumAlignment.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(ColumnarSpectrum, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+MSSpectrum spec;
+spec.setRT(12.5);
+spec.push_back(Peak1D(30.0, 3.0f));
+spec.push_back(Peak1D(2.0, 1.0f));
+spec.push_back(Peak1D(10.0, 2.0f));
+spec.push_back(Peak1D(20.0, 5.0f));
+
+ColumnarSpectrum* ptr = nullptr;
+ColumnarSpectrum* nullPointer = nullptr;
+
+START_SECTION((ColumnarSpectrum()))
+{
+  ptr = new ColumnarSpectrum();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->empty(), true)
+}
+END_SECTION
+
+START_SECTION((~ColumnarSpectrum()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((explicit ColumnarSpectrum(const MSSpectrum& spectrum)))
+{
+  ColumnarSpectrum cs(spec);
+  TEST_EQUAL(cs.size(), 4)
+  TEST_REAL_SIMILAR(cs[0].getMZ(), 30.0)
+  TEST_REAL_SIMILAR(cs[1].getMZ(), 2.0)
+  TEST_REAL_SIMILAR(cs[3].getIntensity(), 5.0)
+}
+END_SECTION
+
+START_SECTION((void copyTo(MSSpectrum& spectrum) const))
+{
+  ColumnarSpectrum cs(spec);
+  cs.sortByPosition();
+  MSSpectrum out = spec;
+  cs.copyTo(out);
+  TEST_EQUAL(out.size(), 4)
+  TEST_REAL_SIMILAR(out.getRT(), 12.5)
+  MSSpectrum sorted = spec;
+  sorted.sortByPosition();
+  TEST_EQUAL(out == sorted, true)
+}
+END_SECTION
+
+START_SECTION((const CoordinateType* getMZData() const))
+{
+  ColumnarSpectrum cs(spec);
+  const ColumnarSpectrum& ccs = cs;
+  const double* mz = ccs.getMZData();
+  TEST_REAL_SIMILAR(mz[0], 30.0)
+  TEST_REAL_SIMILAR(mz[3], 20.0)
+  TEST_EQUAL(cs.getMZData() == &cs.getMZArray()[0], true)
+}
+END_SECTION
+
+START_SECTION((const IntensityType* getIntensityData() const))
+{
+  ColumnarSpectrum cs(spec);
+  const float* intensity = static_cast<const ColumnarSpectrum&>(cs).getIntensityData();
+  TEST_REAL_SIMILAR(intensity[0], 3.0)
+  TEST_REAL_SIMILAR(intensity[1], 1.0)
+  cs.getIntensityData()[1] = 7.0f;
+  TEST_REAL_SIMILAR(cs[1].getIntensity(), 7.0)
+}
+END_SECTION
+
+START_SECTION((void push_back(const PeakType& peak)))
+{
+  ColumnarSpectrum cs;
+  cs.push_back(Peak1D(1.0, 2.0f));
+  cs.emplace_back(3.0, 4.0f);
+  TEST_EQUAL(cs.size(), 2)
+  TEST_REAL_SIMILAR(cs[1].getMZ(), 3.0)
+  TEST_REAL_SIMILAR(cs[1].getIntensity(), 4.0)
+  cs.clear();
+  TEST_EQUAL(cs.empty(), true)
+}
+END_SECTION
+
+START_SECTION(([EXTRA] peak iteration))
+{
+  ColumnarSpectrum cs(spec);
+  Size i = 0;
+  for (ColumnarSpectrum::ConstIterator it = cs.cbegin(); it != cs.cend(); ++it, ++i)
+  {
+    TEST_REAL_SIMILAR(it->getMZ(), spec[i].getMZ())
+    TEST_REAL_SIMILAR((*it).getIntensity(), spec[i].getIntensity())
+  }
+  TEST_EQUAL(i, 4)
+  TEST_EQUAL(cs.end() - cs.begin(), 4)
+
+  // mutable access through iterators and proxies
+  for (auto it = cs.begin(); it != cs.end(); ++it)
+  {
+    it->setIntensity(it->getIntensity() * 2);
+  }
+  cs[0].setMZ(31.0);
+  TEST_REAL_SIMILAR(cs[0].getMZ(), 31.0)
+  TEST_REAL_SIMILAR(cs[3].getIntensity(), 10.0)
+
+  Peak1D p = cs[1];
+  TEST_REAL_SIMILAR(p.getMZ(), 2.0)
+  TEST_REAL_SIMILAR(p.getIntensity(), 2.0)
+
+  // range-based loops
+  double sum = 0;
+  for (const auto& peak : static_cast<const ColumnarSpectrum&>(cs)) sum += peak.getMZ();
+  TEST_REAL_SIMILAR(sum, 63.0)
+}
+END_SECTION
+
+START_SECTION((void sortByPosition()))
+{
+  ColumnarSpectrum cs(spec);
+  TEST_EQUAL(cs.isSorted(), false)
+  cs.sortByPosition();
+  TEST_EQUAL(cs.isSorted(), true)
+  TEST_REAL_SIMILAR(cs[0].getMZ(), 2.0)
+  TEST_REAL_SIMILAR(cs[0].getIntensity(), 1.0)
+  TEST_REAL_SIMILAR(cs[3].getMZ(), 30.0)
+  TEST_REAL_SIMILAR(cs[3].getIntensity(), 3.0)
+}
+END_SECTION
+
+START_SECTION((void sortByIntensity(bool reverse = false)))
+{
+  ColumnarSpectrum cs(spec);
+  cs.sortByIntensity();
+  TEST_REAL_SIMILAR(cs[0].getIntensity(), 1.0)
+  TEST_REAL_SIMILAR(cs[0].getMZ(), 2.0)
+  TEST_REAL_SIMILAR(cs[3].getIntensity(), 5.0)
+  cs.sortByIntensity(true);
+  TEST_REAL_SIMILAR(cs[0].getIntensity(), 5.0)
+  TEST_REAL_SIMILAR(cs[0].getMZ(), 20.0)
+}
+END_SECTION
+
+START_SECTION((Size findNearest(CoordinateType mz) const))
+{
+  ColumnarSpectrum cs(spec);
+  cs.sortByPosition();
+  MSSpectrum sorted = spec;
+  sorted.sortByPosition();
+  for (double mz : {0.0, 2.0, 5.9, 6.1, 14.0, 16.0, 29.0, 100.0})
+  {
+    TEST_EQUAL(cs.findNearest(mz), sorted.findNearest(mz))
+  }
+  TEST_EXCEPTION(Exception::Precondition, ColumnarSpectrum().findNearest(1.0))
+}
+END_SECTION
+
+START_SECTION((Int findNearest(CoordinateType mz, CoordinateType tolerance) const))
+{
+  ColumnarSpectrum cs(spec);
+  cs.sortByPosition();
+  TEST_EQUAL(cs.findNearest(10.5, 1.0), 1)
+  TEST_EQUAL(cs.findNearest(15.0, 1.0), -1)
+  TEST_EQUAL(ColumnarSpectrum().findNearest(15.0, 1.0), -1)
+}
+END_SECTION
+
+START_SECTION((ConstIterator MZBegin(CoordinateType mz) const))
+{
+  ColumnarSpectrum cs(spec);
+  cs.sortByPosition();
+  const ColumnarSpectrum& ccs = cs;
+  TEST_EQUAL(ccs.MZBegin(10.0) - ccs.begin(), 1)
+  TEST_EQUAL(ccs.MZBegin(11.0) - ccs.begin(), 2)
+  TEST_EQUAL(ccs.MZBegin(100.0) == ccs.end(), true)
+  TEST_EQUAL(cs.MZBegin(10.0) - cs.begin(), 1)
+}
+END_SECTION
+
+START_SECTION((ConstIterator MZEnd(CoordinateType mz) const))
+{
+  ColumnarSpectrum cs(spec);
+  cs.sortByPosition();
+  const ColumnarSpectrum& ccs = cs;
+  TEST_EQUAL(ccs.MZEnd(10.0) - ccs.begin(), 2)
+  TEST_EQUAL(ccs.MZEnd(1.0) == ccs.begin(), true)
+  TEST_EQUAL(cs.MZEnd(10.0) - cs.begin(), 2)
+}
+END_SECTION
+
+START_SECTION((Size getBasePeakIndex() const))
+{
+  ColumnarSpectrum cs(spec);
+  TEST_EQUAL(cs.getBasePeakIndex(), 3)
+  TEST_EQUAL(ColumnarSpectrum().getBasePeakIndex(), 0)
+}
+END_SECTION
+
+START_SECTION((IntensityType getTIC() const))
+{
+  ColumnarSpectrum cs(spec);
+  TEST_REAL_SIMILAR(cs.getTIC(), spec.getTIC())
+}
+END_SECTION
+
+START_SECTION((bool operator==(const ColumnarSpectrum& rhs) const))
+{
+  ColumnarSpectrum cs1(spec), cs2(spec);
+  TEST_EQUAL(cs1 == cs2, true)
+  cs2[0].setIntensity(0.5);
+  TEST_EQUAL(cs1 != cs2, true)
+}
+END_SECTION
+
+START_SECTION(([EXTRA] generic algorithms: SpectrumAlignment))
+{
+  MSSpectrum s1, s2;
+  for (Size i = 0; i < 20; ++i)
+  {
+    s1.push_back(Peak1D(100.0 + i * 10.0, 1.0f));
+    s2.push_back(Peak1D(100.05 + i * 20.0, 1.0f));
+  }
+  SpectrumAlignment sa;
+  Param p(sa.getParameters());
+  p.setValue("tolerance", 0.1);
+  sa.setParameters(p);
+
+  vector<pair<Size, Size> > alignment_interleaved, alignment_columnar;
+  sa.getSpectrumAlignment(alignment_interleaved, s1, s2);
+  sa.getSpectrumAlignment(alignment_columnar, ColumnarSpectrum(s1), ColumnarSpectrum(s2));
+  TEST_EQUAL(alignment_interleaved.size(), 10)
+  TEST_EQUAL(alignment_interleaved == alignment_columnar, true)
+}
+END_SECTION
+
+// for quick benchmarking of the two layouts (m/z binary search and intensity reduction)
+/*
+START_SECTION(([EXTRA] benchmark interleaved vs. columnar))
+{
+  MSSpectrum s;
+  for (Size i = 0; i < 100000; ++i) s.push_back(Peak1D(100.0 + i * 0.01, (float)(i % 1000)));
+  ColumnarSpectrum cs(s);
+  double sum_interleaved(0), sum_columnar(0);
+  for (Size k = 0; k < 1000; ++k)
+  {
+    for (Size i = 0; i < 1000; ++i) sum_interleaved += s.MZBegin(100.0 + i * 1.0)->getIntensity();
+    sum_interleaved += s.getTIC();
+  }
+  for (Size k = 0; k < 1000; ++k)
+  {
+    for (Size i = 0; i < 1000; ++i) sum_columnar += cs.MZBegin(100.0 + i * 1.0)->getIntensity();
+    sum_columnar += cs.getTIC();
+  }
+  TEST_REAL_SIMILAR(sum_interleaved, sum_columnar)
+}
+END_SECTION
+*/
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -694,6 +694,29 @@ START_SECTION((bool empty() const))
 }
 END_SECTION
 
+START_SECTION(([EXTRA] handles are kept sorted by map index and unique id))
+{
+  ConsensusFeature cf;
+  Peak2D p;
+  for (UInt64 i = 0; i < 100; ++i)
+  {
+    // insert in descending, interleaved order
+    p.setIntensity(float(i));
+    cf.insert((99 - i) / 2, p, i % 2);
+  }
+  TEST_EQUAL(cf.size(), 100)
+  TEST_EXCEPTION(Exception::InvalidValue, cf.insert(10, p, 1))
+
+  UInt64 n = 0;
+  for (ConsensusFeature::const_iterator it = cf.begin(); it != cf.end(); ++it, ++n)
+  {
+    TEST_EQUAL(it->getMapIndex(), n / 2)
+    TEST_EQUAL(it->getUniqueId(), n % 2)
+  }
+  TEST_EQUAL(cf.getFeatures().find(FeatureHandle(10, p, 1)) != cf.getFeatures().end(), true)
+}
+END_SECTION
+
 
 
 /////////////////////////////////////////////////////////////
@@ -70,6 +70,40 @@ START_SECTION(void apply(std::vector<PeptideIdentification>& ids))
 }
 END_SECTION
 
+START_SECTION(void shareSimilarityCache(const ConsensusIDAlgorithmSimilarity& other))
+{
+  // two ID runs for the same spectrum:
+  vector<PeptideIdentification> ids(2);
+  ids[0].setScoreType("Posterior Error Probability");
+  ids[0].setHigherScoreBetter(false);
+  ids[0].insertHit(PeptideHit(0.1, 1, 2, AASequence::fromString("PEPTIDER")));
+  ids[0].insertHit(PeptideHit(0.3, 2, 2, AASequence::fromString("PEPTLDER")));
+  ids[1] = ids[0];
+  ids[1].getHits()[0].setSequence(AASequence::fromString("PEPTIDEK"));
+
+  ConsensusIDAlgorithmPEPIons consensus1, consensus2;
+  consensus2.shareSimilarityCache(consensus1);
+
+  vector<PeptideIdentification> ids1 = ids, ids2 = ids;
+  consensus1.apply(ids1);
+  consensus2.apply(ids2); // uses the similarities cached by "consensus1"
+  TEST_EQUAL(ids1.size(), 1);
+  TEST_EQUAL(ids2.size(), 1);
+  ABORT_IF((ids1.size() != 1) || (ids2.size() != 1));
+  TEST_EQUAL(ids1[0].getHits().size(), 3);
+  TEST_EQUAL(ids1[0].getHits() == ids2[0].getHits(), true);
+
+  // caches can't be shared if the parameters differ:
+  Param param = consensus2.getParameters();
+  param.setValue("mass_tolerance", 0.1);
+  consensus2.setParameters(param);
+  TEST_EXCEPTION(Exception::IllegalArgument, consensus2.shareSimilarityCache(consensus1));
+  vector<PeptideIdentification> ids3 = ids;
+  consensus2.apply(ids3); // computes its own similarities
+  TEST_EQUAL(ids3.size(), 1);
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
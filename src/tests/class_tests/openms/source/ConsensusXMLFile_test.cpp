@@ -228,6 +228,59 @@ START_SECTION((void store(const String &filename, const ConsensusMap &consensus_
 
 END_SECTION
 
+START_SECTION([EXTRA] fast parsing (PeakFileOptions::setFastParsing()))
+{
+  // the pull parser has to produce the same maps as the Xerces code path
+  // (ConsensusXMLFile_1 has PeptideIdentifications in its consensus elements and is parsed by Xerces completely)
+  StringList files = ListUtils::create<String>("ConsensusXMLFile_1.consensusXML,ConsensusXMLFile_2_options.consensusXML,"
+    "ExperimentalDesign_input_3.consensusXML,ExperimentalDesign_input_5.consensusXML,"
+    "FeatureDeconvolution_easy_output.consensusXML,MetaboliteFeatureDeconvolution_easy_output.consensusXML");
+  std::string tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  for (Size i = 0; i < files.size(); ++i)
+  {
+    ConsensusXMLFile f;
+    ConsensusMap xerces_map, fast_map;
+    f.load(OPENMS_GET_TEST_DATA_PATH(files[i]), xerces_map);
+    f.getOptions().setFastParsing(true);
+    f.load(OPENMS_GET_TEST_DATA_PATH(files[i]), fast_map);
+    TEST_EQUAL(fast_map.size(), xerces_map.size())
+    TEST_EQUAL(fast_map == xerces_map, true)
+    // ConsensusMap::operator== does not compare the grouped elements
+    Size different_handles = 0;
+    for (Size j = 0; j < std::min(fast_map.size(), xerces_map.size()); ++j)
+    {
+      if (fast_map[j].getFeatures() != xerces_map[j].getFeatures()) ++different_handles;
+    }
+    TEST_EQUAL(different_handles, 0)
+
+    // files written by store() (i.e. the current format)
+    f.store(tmp_filename, xerces_map);
+    f.getOptions().setFastParsing(false);
+    f.load(tmp_filename, xerces_map);
+    f.getOptions().setFastParsing(true);
+    f.load(tmp_filename, fast_map);
+    TEST_EQUAL(fast_map == xerces_map, true)
+  }
+
+  // range options are applied in the same way
+  ConsensusXMLFile f;
+  ConsensusMap xerces_map, fast_map;
+  f.getOptions().setRTRange(makeRange(815, 818));
+  f.load(OPENMS_GET_TEST_DATA_PATH("ConsensusXMLFile_2_options.consensusXML"), xerces_map);
+  f.getOptions().setFastParsing(true);
+  f.load(OPENMS_GET_TEST_DATA_PATH("ConsensusXMLFile_2_options.consensusXML"), fast_map);
+  TEST_EQUAL(fast_map.size(), 1)
+  TEST_EQUAL(fast_map == xerces_map, true)
+  f.getOptions().setIntensityRange(makeRange(15000, 24000));
+  f.load(OPENMS_GET_TEST_DATA_PATH("ConsensusXMLFile_2_options.consensusXML"), fast_map);
+  TEST_EQUAL(fast_map.size(), 0)
+
+  // errors are reported by Xerces
+  TEST_EXCEPTION(Exception::FileNotFound, f.load("this_file_does_not_exist.consensusXML", fast_map))
+}
+END_SECTION
+
 START_SECTION([EXTRA](bool isValid(const String &filename)))
   ConsensusXMLFile f;
   TEST_EQUAL(f.isValid(OPENMS_GET_TEST_DATA_PATH("ConsensusXMLFile_1.consensusXML"), std::cerr), true);
@@ -246,6 +246,34 @@ START_SECTION(bool operator==(DistanceMatrix< ValueType > const &rhs) const)
 END_SECTION
 
 
+START_SECTION(([EXTRA] void updateMinElement() and void reduce(SizeType j) on a large matrix))
+{
+  // large enough to be scanned in several blocks
+  DistanceMatrix<float> large(700, 1.0f);
+  TEST_EQUAL(large.getValue(699, 0), 1.0f)
+  large.setValueQuick(650, 3, 0.25f);
+  large.setValueQuick(690, 600, 0.25f);
+  large.setValueQuick(12, 5, 0.5f);
+  large.updateMinElement();
+  // first minimal element in row-major order
+  TEST_EQUAL(large.getMinElementCoordinates().first, 650)
+  TEST_EQUAL(large.getMinElementCoordinates().second, 3)
+
+  large.reduce(3);
+  TEST_EQUAL(large.dimensionsize(), 699)
+  TEST_EQUAL(large.getValue(11, 4), 0.5f)
+  TEST_EQUAL(large.getValue(689, 599), 0.25f)
+  large.updateMinElement();
+  TEST_EQUAL(large.getMinElementCoordinates().first, 689)
+  TEST_EQUAL(large.getMinElementCoordinates().second, 599)
+
+  DistanceMatrix<float> large_copy(large);
+  TEST_EQUAL(large_copy == large, true)
+  TEST_EQUAL(large_copy.getValue(599, 689), 0.25f)
+}
+END_SECTION
+
+
 START_SECTION((template <typename Value> std::ostream & operator<<(std::ostream &os, const DistanceMatrix< Value > &matrix)))
 {
   NOT_TESTABLE
@@ -197,6 +197,40 @@ START_SECTION((template <typename PeakType> void filterExperiment(MSExperiment<P
 
 END_SECTION
 
+START_SECTION(([EXTRA] void filterExperiment(PeakMap& map) with many spectra and ppm tolerance))
+{
+  // the (parallel) experiment filter must give the same result as smoothing each spectrum individually
+  PeakMap exp;
+  exp.resize(50);
+  for (Size s = 0; s < exp.size(); ++s)
+  {
+    for (Size i = 0; i < 20; ++i)
+    {
+      Peak1D p(500.0 + 10.0 * s + 0.002 * i, float((i * 7 + s * 3) % 11));
+      exp[s].push_back(p);
+    }
+  }
+  PeakMap expected = exp;
+
+  GaussFilter gauss;
+  Param param;
+  param.setValue("use_ppm_tolerance", "true");
+  param.setValue("ppm_tolerance", 10.0);
+  gauss.setParameters(param);
+  for (Size s = 0; s < expected.size(); ++s)
+  {
+    gauss.filter(expected[s]);
+  }
+  gauss.filterExperiment(exp);
+
+  TEST_EQUAL(exp == expected, true)
+
+  // chromatograms cannot be smoothed with a ppm tolerance
+  exp.addChromatogram(MSChromatogram());
+  TEST_EXCEPTION(Exception::IllegalArgument, gauss.filterExperiment(exp))
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -39,6 +39,7 @@
 ///////////////////////////
 
 #include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/ColumnarSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
 
@@ -117,6 +118,63 @@ START_SECTION((static double compute(double fragment_mass_tolerance, bool fragme
 }
 END_SECTION
 
+START_SECTION((static double compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const ColumnarSpectrum &exp_spectrum, const PeakSpectrum &theo_spectrum)))
+{
+  PeakSpectrum exp_spectrum;
+  PeakSpectrum theo_spectrum;
+
+  AASequence peptide = AASequence::fromString("PEPTIDE");
+
+  // empty spectrum
+  tsg.getSpectrum(theo_spectrum, peptide, 1, 1);
+  TEST_REAL_SIMILAR(HyperScore::compute(0.1, false, ColumnarSpectrum(exp_spectrum), theo_spectrum), 0.0);
+
+  // full match, 11 identical masses, identical intensities (=1)
+  tsg.getSpectrum(exp_spectrum, peptide, 1, 1);
+  TEST_REAL_SIMILAR(HyperScore::compute(0.1, false, ColumnarSpectrum(exp_spectrum), theo_spectrum), 13.8516496);
+  TEST_REAL_SIMILAR(HyperScore::compute(10, true, ColumnarSpectrum(exp_spectrum), theo_spectrum), 13.8516496);
+
+  exp_spectrum.clear(true);
+  theo_spectrum.clear(true);
+
+  // no match
+  tsg.getSpectrum(exp_spectrum, peptide, 1, 3);
+  tsg.getSpectrum(theo_spectrum, AASequence::fromString("YYYYYY"), 1, 3);
+  TEST_REAL_SIMILAR(HyperScore::compute(1e-5, false, ColumnarSpectrum(exp_spectrum), theo_spectrum), 0.0);
+
+  exp_spectrum.clear(true);
+  theo_spectrum.clear(true);
+
+  // full match, 33 identical masses, identical intensities (=1)
+  tsg.getSpectrum(exp_spectrum, peptide, 1, 3);
+  tsg.getSpectrum(theo_spectrum, peptide, 1, 3);
+  TEST_REAL_SIMILAR(HyperScore::compute(0.1, false, ColumnarSpectrum(exp_spectrum), theo_spectrum), 67.8210771);
+  TEST_REAL_SIMILAR(HyperScore::compute(10, true, ColumnarSpectrum(exp_spectrum), theo_spectrum), 67.8210771);
+
+  // full match if ppm tolerance and partial match for Da tolerance
+  for (Size i = 0; i < theo_spectrum.size(); ++i)
+  {
+    double mz = pow( theo_spectrum[i].getMZ(), 2);
+    exp_spectrum[i].setMZ(mz);
+    theo_spectrum[i].setMZ(mz + 9 * 1e-6 * mz); // +9 ppm error
+  }
+
+  TEST_REAL_SIMILAR(HyperScore::compute(0.1, false, ColumnarSpectrum(exp_spectrum), theo_spectrum), 3.401197);
+  TEST_REAL_SIMILAR(HyperScore::compute(10, true, ColumnarSpectrum(exp_spectrum), theo_spectrum), 67.8210771);
+
+  // same score as on the interleaved layout for partially overlapping spectra
+  exp_spectrum.clear(true);
+  theo_spectrum.clear(true);
+  tsg.getSpectrum(exp_spectrum, AASequence::fromString("PEPTIDEK"), 1, 2);
+  tsg.getSpectrum(theo_spectrum, AASequence::fromString("PEPTIDER"), 1, 2);
+  for (Size i = 0; i < exp_spectrum.size(); ++i) exp_spectrum[i].setIntensity(1.0 + i % 7);
+  TEST_REAL_SIMILAR(HyperScore::compute(0.05, false, ColumnarSpectrum(exp_spectrum), theo_spectrum),
+                    HyperScore::compute(0.05, false, exp_spectrum, theo_spectrum));
+  TEST_REAL_SIMILAR(HyperScore::compute(20, true, ColumnarSpectrum(exp_spectrum), theo_spectrum),
+                    HyperScore::compute(20, true, exp_spectrum, theo_spectrum));
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
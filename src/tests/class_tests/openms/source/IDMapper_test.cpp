@@ -590,6 +590,53 @@ START_SECTION((void annotate(ConsensusMap& map, const std::vector<PeptideIdentif
 }
 END_SECTION
 
+START_SECTION(([EXTRA] void annotate(ConsensusMap& map, const std::vector<PeptideIdentification>& ids, const std::vector<ProteinIdentification>& protein_ids, bool measure_from_subelements=false) with several matching features))
+{
+  IDMapper mapper;
+  Param p = mapper.getParameters();
+  p.setValue("rt_tolerance", 5.0);
+  p.setValue("mz_tolerance", 0.01);
+  p.setValue("mz_measure", "Da");
+  p.setValue("ignore_charge", "true");
+  mapper.setParameters(p);
+
+  // features given in decreasing m/z, so the map order differs from the m/z order
+  ConsensusMap cons_map;
+  double mzs[] = {1000.009, 1000.0, 999.991, 500.0};
+  for (Size i = 0; i < 4; ++i)
+  {
+    ConsensusFeature cf;
+    cf.setRT(100.0);
+    cf.setMZ(mzs[i]);
+    cf.setUniqueId(i + 1);
+    cons_map.push_back(cf);
+  }
+
+  vector<PeptideIdentification> ids(3);
+  ids[0].setRT(102.0);
+  ids[0].setMZ(1000.0); // matches the first three features
+  ids[1].setRT(100.0);
+  ids[1].setMZ(500.02); // outside of the m/z tolerance
+  ids[2].setRT(106.0);
+  ids[2].setMZ(500.0); // outside of the RT tolerance
+  for (Size i = 0; i < ids.size(); ++i)
+  {
+    ids[i].insertHit(PeptideHit(1.0, 1, 2, AASequence::fromString("PEPTIDE")));
+  }
+
+  mapper.annotate(cons_map, ids, vector<ProteinIdentification>());
+
+  TEST_EQUAL(cons_map[0].getPeptideIdentifications().size(), 1)
+  TEST_EQUAL(cons_map[1].getPeptideIdentifications().size(), 1)
+  TEST_EQUAL(cons_map[2].getPeptideIdentifications().size(), 1)
+  TEST_EQUAL(cons_map[3].getPeptideIdentifications().size(), 0)
+  TEST_EQUAL(cons_map.getUnassignedPeptideIdentifications().size(), 2)
+  ABORT_IF(cons_map.getUnassignedPeptideIdentifications().size() != 2)
+  TEST_REAL_SIMILAR(cons_map.getUnassignedPeptideIdentifications()[0].getMZ(), 500.02)
+  TEST_REAL_SIMILAR(cons_map.getUnassignedPeptideIdentifications()[1].getRT(), 106.0)
+}
+END_SECTION
+
 START_SECTION([EXTRA] double getAbsoluteMZTolerance_(const double mz) const)
   IDMapper2 mapper;
   Param p = mapper.getParameters();
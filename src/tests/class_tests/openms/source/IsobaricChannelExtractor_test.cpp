@@ -48,6 +48,18 @@
 using namespace OpenMS;
 using namespace std;
 
+// processes the quantification spectra in small blocks, so that block boundaries can be tested with little data
+class SmallBlockChannelExtractor :
+  public IsobaricChannelExtractor
+{
+public:
+  SmallBlockChannelExtractor(const IsobaricQuantitationMethod* const quant_method) :
+    IsobaricChannelExtractor(quant_method)
+  {
+    block_size_ = 3;
+  }
+};
+
 START_TEST(IsobaricChannelExtractor, "$Id$")
 
 /////////////////////////////////////////////////////////////
@@ -572,6 +584,109 @@ START_SECTION(([EXTRA] purity computation without interpolation))
 }
 END_SECTION
 
+START_SECTION(([EXTRA] extraction of more spectra than fit into one block))
+{
+  ItraqFourPlexQuantitationMethod itraq;
+  const IsobaricQuantitationMethod::IsobaricChannelList& channels = itraq.getChannelInformation();
+
+  // MS2 spectra with reporter intensities that encode their position
+  PeakMap exp;
+  for (Size i = 0; i < 11; ++i)
+  {
+    MSSpectrum spec;
+    spec.setMSLevel(2);
+    spec.setRT(10.0 + i);
+    spec.setNativeID(String("scan=") + String(i));
+    Precursor prec;
+    prec.setMZ(500.0 + i);
+    prec.setCharge(2);
+    // the 6th spectrum does not pass the precursor intensity filter
+    prec.setIntensity(i == 5 ? 0.5 : 1000.0);
+    spec.setPrecursors(vector<Precursor>(1, prec));
+    for (Size c = 0; c < channels.size(); ++c)
+    {
+      spec.push_back(Peak1D(channels[c].center, float(100.0 * (i + 1) + c)));
+    }
+    exp.addSpectrum(spec);
+  }
+
+  SmallBlockChannelExtractor ice(&itraq);
+  Param p = ice.getParameters();
+  p.setValue("select_activation", "");
+  ice.setParameters(p);
+
+  // the results of all blocks are merged in the order of the experiment
+  ConsensusMap cm_out;
+  ice.extractChannels(exp, cm_out);
+  TEST_EQUAL(cm_out.size(), 10)
+  ABORT_IF(cm_out.size() != 10)
+  for (Size f = 0; f < cm_out.size(); ++f)
+  {
+    const Size i = (f < 5 ? f : f + 1);
+    TEST_EQUAL(cm_out[f].getMetaValue("scan_id"), String("scan=") + String(i))
+    TEST_REAL_SIMILAR(cm_out[f].getRT(), 10.0 + i)
+    TEST_REAL_SIMILAR(cm_out[f].getMZ(), 500.0 + i)
+    TEST_EQUAL(cm_out[f].size(), channels.size())
+    Size c = 0;
+    for (ConsensusFeature::const_iterator cf_it = cm_out[f].begin(); cf_it != cm_out[f].end(); ++cf_it, ++c)
+    {
+      TEST_EQUAL(cf_it->getMapIndex(), c)
+      // the element index counts the extracted spectra
+      TEST_EQUAL(cf_it->getUniqueId(), f)
+      TEST_REAL_SIMILAR(cf_it->getIntensity(), 100.0 * (i + 1) + c)
+    }
+  }
+
+  // the same result as with a single block
+  IsobaricChannelExtractor ice_single(&itraq);
+  ice_single.setParameters(p);
+  ConsensusMap cm_single;
+  ice_single.extractChannels(exp, cm_single);
+  TEST_EQUAL(cm_single.size(), cm_out.size())
+  for (Size f = 0; f < std::min(cm_single.size(), cm_out.size()); ++f)
+  {
+    TEST_EQUAL(cm_single[f].getMetaValue("scan_id"), cm_out[f].getMetaValue("scan_id"))
+    TEST_REAL_SIMILAR(cm_single[f].getIntensity(), cm_out[f].getIntensity())
+  }
+
+  // MS3 spectra: the 4th and 5th one (i.e. the first two of the second
+  // block) refer to an MS2 spectrum without precursor information; the
+  // error of the first one must be reported, after the first block was stored
+  PeakMap exp_ms3;
+  for (Size i = 0; i < 6; ++i)
+  {
+    if (i == 0 || i == 3)
+    {
+      MSSpectrum ms2;
+      ms2.setMSLevel(2);
+      ms2.setRT(9.5 + i);
+      ms2.setNativeID(String("ms2=") + String(i));
+      if (i == 0)
+      {
+        Precursor prec;
+        prec.setMZ(600.0);
+        ms2.setPrecursors(vector<Precursor>(1, prec));
+      }
+      exp_ms3.addSpectrum(ms2);
+    }
+    MSSpectrum spec = exp[i];
+    spec.setMSLevel(3);
+    exp_ms3.addSpectrum(spec);
+  }
+  String error_message;
+  try
+  {
+    ice.extractChannels(exp_ms3, cm_out);
+  }
+  catch (Exception::MissingInformation& e)
+  {
+    error_message = e.getMessage();
+  }
+  TEST_EQUAL(error_message.hasSubstring("native ID scan=3 with RT"), true)
+  TEST_EQUAL(cm_out.size(), 3)
+}
+END_SECTION
+
 // extra test for tmt10plex to ensure high-res extraction works
 START_SECTION(([EXTRA] TMT 10plex support))
 {
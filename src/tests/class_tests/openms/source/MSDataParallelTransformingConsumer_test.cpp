@@ -0,0 +1,225 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/DATAACCESS/MSDataParallelTransformingConsumer.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataStoringConsumer.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataTransformingConsumer.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+
+
+START_TEST(MSDataParallelTransformingConsumer, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+using namespace OpenMS;
+
+MSDataParallelTransformingConsumer* parallel_consumer_ptr = nullptr;
+MSDataParallelTransformingConsumer* parallel_consumer_nullPointer = nullptr;
+
+PeakMap expc;
+MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML"), expc);
+
+// many spectra, to fill several batches
+PeakMap exp_many;
+for (Size i = 0; i < 50; ++i)
+{
+  MSSpectrum s = expc.getSpectrum(i % expc.size());
+  s.setRT(i);
+  exp_many.addSpectrum(s);
+}
+
+START_SECTION((MSDataParallelTransformingConsumer(Interfaces::IMSDataConsumer* next_consumer, Size batch_size = 0)))
+  MSDataStoringConsumer storing_consumer;
+  parallel_consumer_ptr = new MSDataParallelTransformingConsumer(&storing_consumer);
+  TEST_NOT_EQUAL(parallel_consumer_ptr, parallel_consumer_nullPointer)
+  TEST_EQUAL(parallel_consumer_ptr->getBatchSize() > 0, true)
+  delete parallel_consumer_ptr;
+
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer, 7);
+  TEST_EQUAL(parallel_consumer.getBatchSize(), 7)
+END_SECTION
+
+START_SECTION((~MSDataParallelTransformingConsumer()))
+{
+  // destruction passes pending data on
+  MSDataStoringConsumer storing_consumer;
+  {
+    MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer, 100);
+    MSSpectrum s = expc.getSpectrum(0);
+    parallel_consumer.consumeSpectrum(s);
+    TEST_EQUAL(storing_consumer.getData().size(), 0)
+  }
+  TEST_EQUAL(storing_consumer.getData().size(), 1)
+  TEST_EQUAL(storing_consumer.getData()[0] == expc.getSpectrum(0), true)
+}
+END_SECTION
+
+START_SECTION((void setExpectedSize(Size expectedSpectra, Size expectedChromatograms)))
+  NOT_TESTABLE // only passed on
+END_SECTION
+
+START_SECTION((void setExperimentalSettings(const ExperimentalSettings& exp)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer);
+  ExperimentalSettings settings;
+  settings.setComment("parallel");
+  parallel_consumer.setExperimentalSettings(settings);
+  TEST_EQUAL(storing_consumer.getData().getComment(), "parallel")
+}
+END_SECTION
+
+START_SECTION((void consumeSpectrum(SpectrumType& s)))
+{
+  // no function set: data is passed on unchanged
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer, 4);
+  PeakMap exp = exp_many;
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    parallel_consumer.consumeSpectrum(exp.getSpectrum(i));
+  }
+  parallel_consumer.flush();
+  TEST_EQUAL(storing_consumer.getData().size(), exp_many.size())
+  for (Size i = 0; i < exp_many.size(); ++i)
+  {
+    TEST_EQUAL(storing_consumer.getData()[i] == exp_many[i], true)
+  }
+}
+END_SECTION
+
+START_SECTION((void consumeChromatogram(ChromatogramType& c)))
+{
+  // spectra and chromatograms keep their relative order
+  std::vector<String> order;
+  auto f_spec = [](MSSpectrum& s) { s.setComment("s"); };
+  MSDataTransformingConsumer recorder;
+  recorder.setSpectraProcessingFunc([&order](MSSpectrum& s) { order.push_back(s.getComment() + String((Int)s.getRT())); });
+  recorder.setChromatogramProcessingFunc([&order](MSChromatogram& c) { order.push_back(c.getNativeID()); });
+
+  MSDataParallelTransformingConsumer parallel_consumer(&recorder, 3);
+  parallel_consumer.setSpectraProcessingFunc(f_spec);
+
+  PeakMap exp = exp_many;
+  MSChromatogram c1, c2;
+  c1.setNativeID("c1");
+  c2.setNativeID("c2");
+  parallel_consumer.consumeSpectrum(exp.getSpectrum(0));
+  parallel_consumer.consumeSpectrum(exp.getSpectrum(1));
+  parallel_consumer.consumeChromatogram(c1);
+  parallel_consumer.consumeSpectrum(exp.getSpectrum(2));
+  parallel_consumer.consumeChromatogram(c2);
+  parallel_consumer.flush();
+
+  TEST_EQUAL(order.size(), 5)
+  ABORT_IF(order.size() != 5)
+  TEST_EQUAL(order[0], "s0")
+  TEST_EQUAL(order[1], "s1")
+  TEST_EQUAL(order[2], "c1")
+  TEST_EQUAL(order[3], "s2")
+  TEST_EQUAL(order[4], "c2")
+}
+END_SECTION
+
+START_SECTION((void setSpectraProcessingFunc(std::function<void (SpectrumType&)> f_spec)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer, 8);
+  parallel_consumer.setSpectraProcessingFunc([](MSSpectrum& s) { s.sortByIntensity(); s.setRT(s.getRT() * 2); });
+
+  PeakMap exp = exp_many;
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    parallel_consumer.consumeSpectrum(exp.getSpectrum(i));
+  }
+  parallel_consumer.flush();
+
+  // same result (and order) as the serial transformation
+  TEST_EQUAL(storing_consumer.getData().size(), exp_many.size())
+  for (Size i = 0; i < exp_many.size(); ++i)
+  {
+    MSSpectrum expected = exp_many[i];
+    expected.sortByIntensity();
+    expected.setRT(expected.getRT() * 2);
+    TEST_EQUAL(storing_consumer.getData()[i] == expected, true)
+  }
+
+  // exceptions in the processing function are passed on
+  MSDataParallelTransformingConsumer throwing_consumer(&storing_consumer, 2);
+  throwing_consumer.setSpectraProcessingFunc([](MSSpectrum&) { throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "test", ""); });
+  MSSpectrum s1 = expc.getSpectrum(0), s2 = expc.getSpectrum(0);
+  throwing_consumer.consumeSpectrum(s1);
+  TEST_EXCEPTION(Exception::InvalidValue, throwing_consumer.consumeSpectrum(s2))
+}
+END_SECTION
+
+START_SECTION((void setChromatogramProcessingFunc(std::function<void (ChromatogramType&)> f_chrom)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer, 2);
+  parallel_consumer.setChromatogramProcessingFunc([](MSChromatogram& c) { c.sortByIntensity(); });
+
+  PeakMap exp = expc;
+  TEST_EQUAL(exp.getNrChromatograms() > 0, true)
+  exp.getChromatogram(0).sortByPosition();
+  MSChromatogram expected = exp.getChromatogram(0);
+  expected.sortByIntensity();
+  parallel_consumer.consumeChromatogram(exp.getChromatogram(0));
+  parallel_consumer.flush();
+
+  TEST_EQUAL(storing_consumer.getData().getNrChromatograms(), 1)
+  TEST_EQUAL(storing_consumer.getData().getChromatogram(0) == expected, true)
+}
+END_SECTION
+
+START_SECTION((void flush()))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION((Size getBatchSize() const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -175,6 +175,47 @@ START_SECTION((void run(const PeakMap &, std::vector< MassTrace > &)))
 }
 END_SECTION
 
+START_SECTION((void run(const PeakMap &, std::vector< MassTrace > &, const Size max_traces)))
+{
+  // many well separated traces (enough apices to split the m/z range for parallel extension)
+  PeakMap synthetic;
+  for (Size scan = 0; scan < 100; ++scan)
+  {
+    MSSpectrum s;
+    s.setRT(100.0 + scan);
+    for (Size t = 0; t < 200; ++t)
+    {
+      Peak1D p;
+      p.setMZ(300.0 + 5.0 * t);
+      p.setIntensity((1000.0 + 10.0 * t) * std::exp(-(scan - 50.0) * (scan - 50.0) / 200.0));
+      s.push_back(p);
+    }
+    synthetic.addSpectrum(s);
+  }
+
+  MassTraceDetection mtd;
+  std::vector<MassTrace> all_traces, first_traces;
+  mtd.run(synthetic, all_traces);
+  TEST_EQUAL(all_traces.size(), 200);
+  for (Size i = 0; i < all_traces.size(); ++i)
+  {
+    // traces are reported in order of decreasing apex intensity
+    TEST_EQUAL(all_traces[i].getLabel(), "T" + String(i + 1));
+    TEST_REAL_SIMILAR(all_traces[i].getCentroidMZ(), 300.0 + 5.0 * (199 - i));
+    TEST_EQUAL(all_traces[i].getSize() > 50, true);
+  }
+
+  mtd.run(synthetic, first_traces, 10);
+  TEST_EQUAL(first_traces.size(), 10);
+  for (Size i = 0; i < first_traces.size(); ++i)
+  {
+    TEST_EQUAL(first_traces[i].getLabel(), all_traces[i].getLabel());
+    TEST_EQUAL(first_traces[i].getSize(), all_traces[i].getSize());
+    TEST_REAL_SIMILAR(first_traces[i].getCentroidMZ(), all_traces[i].getCentroidMZ());
+  }
+}
+END_SECTION
+
 std::vector<MassTrace> filt;
 
 //START_SECTION((void filterByPeakWidth(std::vector< MassTrace > &, std::vector< MassTrace > &)))
@@ -234,6 +234,25 @@ START_SECTION([EXTRA] multithreaded example)
 }
 END_SECTION
 
+START_SECTION([EXTRA] getIndex after assignment)
+{
+  // lookups are cached per thread; assignment must not return stale indices
+  MetaInfoRegistry r1, r2;
+  r1.registerName("first");
+  r2.registerName("second");
+  r2.registerName("first");
+  TEST_EQUAL(r1.getIndex("first"), 1024)
+  TEST_EQUAL(r1.getIndex("second"), UInt(-1))
+  TEST_EQUAL(r2.getIndex("first"), 1025)
+  r1 = r2;
+  TEST_EQUAL(r1.getIndex("first"), 1025)
+  TEST_EQUAL(r1.getIndex("second"), 1024)
+  r1.registerName("third");
+  TEST_EQUAL(r1.getIndex("third"), 1026)
+  TEST_EQUAL(r2.getIndex("third"), UInt(-1))
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
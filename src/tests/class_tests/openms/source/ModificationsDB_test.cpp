@@ -296,6 +296,24 @@ START_SECTION((bool addModification(ResidueModification* modification)))
 }
 END_SECTION
 
+START_SECTION(Size getGeneration() const)
+{
+  Size generation = ptr->getGeneration();
+  ResidueModification* modification = new ResidueModification();
+  modification->setFullId("GenerationTest (D)");
+  ptr->addModification(modification);
+  TEST_EQUAL(ptr->getGeneration() > generation, true)
+
+  // already known, not added
+  generation = ptr->getGeneration();
+  ResidueModification* duplicate = new ResidueModification();
+  duplicate->setFullId("GenerationTest (D)");
+  ptr->addModification(duplicate);
+  TEST_EQUAL(ptr->getGeneration(), generation)
+  delete duplicate;
+}
+END_SECTION
+
 START_SECTION([EXTRA] multithreaded example)
 {
   // All measurements are best of three (wall time, Linux, 8 threads)
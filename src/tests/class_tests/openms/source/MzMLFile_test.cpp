@@ -1096,6 +1096,27 @@ START_SECTION((void storeBuffer(std::string & output, const PeakMap& map) const)
     TEST_EQUAL(String(out).hasSubstring("<chromatogramList count=\"2\" defaultDataProcessingRef=\"dp_sp_0\">"), true)
   }
 
+  // test parallel writing (must be byte-identical to the serial path, including the index)
+  {
+    PeakMap exp_original;
+    file.load(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML"), exp_original);
+
+    MzMLFile file_serial;
+    file_serial.getOptions().setCompression(true);
+    std::string out_serial;
+    file_serial.storeBuffer(out_serial, exp_original);
+
+    MzMLFile file_parallel;
+    file_parallel.getOptions().setCompression(true);
+    file_parallel.getOptions().setParallelWrite(true);
+    file_parallel.getOptions().setMaxDataPoolSize(3); // batch boundary within the spectra
+    std::string out_parallel;
+    file_parallel.storeBuffer(out_parallel, exp_original);
+
+    TEST_EQUAL(out_parallel.size(), out_serial.size())
+    TEST_EQUAL(out_parallel == out_serial, true)
+  }
+
   //test with empty map
   {
     PeakMap empty;
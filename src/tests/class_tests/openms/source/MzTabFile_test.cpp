@@ -54,6 +54,29 @@ class MzTabFile2 : public MzTabFile
     }
 };
 
+// counts rows and remembers the first PSM
+class CountingRowConsumer : public MzTabFile::RowConsumer
+{
+  public:
+    void consumeMetaData(const MzTabMetaData& meta_data) override
+    {
+      ++n_meta_data;
+      meta = meta_data;
+    }
+    void consumeProteinRow(MzTabProteinSectionRow&) override { ++n_protein; }
+    void consumePeptideRow(MzTabPeptideSectionRow&) override { ++n_peptide; }
+    void consumePSMRow(MzTabPSMSectionRow& row) override
+    {
+      if (n_psm == 0) first_psm = row;
+      ++n_psm;
+    }
+    void consumeCommentRow(Size, const String&) override { ++n_comment; }
+
+    Size n_meta_data = 0, n_protein = 0, n_peptide = 0, n_psm = 0, n_comment = 0;
+    MzTabMetaData meta;
+    MzTabPSMSectionRow first_psm;
+};
+
 START_TEST(MzTabFile, "$Id$")
 
 /////////////////////////////////////////////////////////////
@@ -73,6 +96,29 @@ START_SECTION(void load(const String& filename, MzTab& mzTab) )
   MzTabFile().load(OPENMS_GET_TEST_DATA_PATH("MzTabFile_SILAC.mzTab"), mzTab);
 END_SECTION
 
+START_SECTION(void transform(const String& filename, RowConsumer* consumer))
+{
+  MzTab mzTab;
+  MzTabFile().load(OPENMS_GET_TEST_DATA_PATH("MzTabFile_SILAC.mzTab"), mzTab);
+
+  CountingRowConsumer consumer;
+  MzTabFile().transform(OPENMS_GET_TEST_DATA_PATH("MzTabFile_SILAC.mzTab"), &consumer);
+  TEST_EQUAL(consumer.n_meta_data, 1)
+  TEST_EQUAL(consumer.n_protein, 57)
+  TEST_EQUAL(consumer.n_peptide, 80)
+  TEST_EQUAL(consumer.n_psm, 946)
+  TEST_EQUAL(consumer.n_comment, mzTab.getCommentRows().size())
+  TEST_EQUAL(consumer.n_protein, mzTab.getProteinSectionRows().size())
+  TEST_EQUAL(consumer.n_peptide, mzTab.getPeptideSectionRows().size())
+  TEST_EQUAL(consumer.n_psm, mzTab.getPSMSectionRows().size())
+  ABORT_IF(mzTab.getPSMSectionRows().empty())
+  TEST_EQUAL(consumer.first_psm.sequence.toCellString(), mzTab.getPSMSectionRows()[0].sequence.toCellString())
+  TEST_EQUAL(consumer.meta.mz_tab_version.toCellString(), mzTab.getMetaData().mz_tab_version.toCellString())
+
+  TEST_EXCEPTION(Exception::FileNotFound, MzTabFile().transform("this_file_does_not_exist.mzTab", &consumer))
+}
+END_SECTION
+
 START_SECTION(void store(const String& filename, MzTab& mzTab) )
 {
   std::vector<String> files_to_test;
@@ -246,6 +246,40 @@ START_SECTION(void setMaxDataPoolSize(Size size))
 }
 END_SECTION
 
+START_SECTION(bool getParallelWrite() const)
+{
+	PeakFileOptions tmp;
+	TEST_EQUAL(tmp.getParallelWrite(), false);
+}
+END_SECTION
+
+START_SECTION(void setParallelWrite(bool parallel_write))
+{
+	PeakFileOptions tmp;
+	tmp.setParallelWrite(true);
+	TEST_EQUAL(tmp.getParallelWrite(), true);
+	PeakFileOptions tmp2(tmp);
+	TEST_EQUAL(tmp2.getParallelWrite(), true);
+}
+END_SECTION
+
+START_SECTION(bool getFastParsing() const)
+{
+	PeakFileOptions tmp;
+	TEST_EQUAL(tmp.getFastParsing(), false);
+}
+END_SECTION
+
+START_SECTION(void setFastParsing(bool fast_parsing))
+{
+	PeakFileOptions tmp;
+	tmp.setFastParsing(true);
+	TEST_EQUAL(tmp.getFastParsing(), true);
+	PeakFileOptions tmp2(tmp);
+	TEST_EQUAL(tmp2.getFastParsing(), true);
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
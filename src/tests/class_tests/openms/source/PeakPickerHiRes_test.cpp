@@ -35,6 +35,8 @@
 #include <OpenMS/CONCEPT/ClassTest.h>
 #include <OpenMS/test_config.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataStoringConsumer.h>
+#include <OpenMS/KERNEL/OnDiscMSExperiment.h>
 
 ///////////////////////////
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
@@ -388,6 +390,77 @@ START_SECTION([EXTRA] test spectrum level selection)
   }
 END_SECTION
 
+START_SECTION([EXTRA] exceptions thrown while picking chromatograms in parallel are rethrown)
+{
+  PeakMap in_chrom;
+  for (Size c = 0; c < 20; ++c)
+  {
+    MSChromatogram chrom;
+    for (Size i = 0; i < 50; ++i)
+    {
+      chrom.push_back(ChromatogramPeak(10.0 + i, 100.0 + (i % 7) * 50.0));
+    }
+    in_chrom.addChromatogram(chrom);
+  }
+
+  // S/N estimation with manual but invalid maximal intensity throws for every chromatogram
+  PeakPickerHiRes pp_chrom;
+  Param param_chrom = pp_chrom.getParameters();
+  param_chrom.setValue("signal_to_noise", 1.0);
+  param_chrom.setValue("SignalToNoise:auto_mode", -1);
+  pp_chrom.setParameters(param_chrom);
+
+  PeakMap out_chrom;
+  TEST_EXCEPTION(Exception::InvalidValue, pp_chrom.pickExperiment(in_chrom, out_chrom))
+}
+END_SECTION
+
+START_SECTION((void pickExperiment(OnDiscMSExperiment& input, Interfaces::IMSDataConsumer& output, const bool check_spectrum_type = true) const))
+{
+  // write indexed mzML for on-disc access
+  PeakMap in_memory;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("PeakPickerHiRes_spectrum_selection.mzML"), in_memory);
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename)
+  MzMLFile().store(tmp_filename, in_memory);
+  MzMLFile().load(tmp_filename, in_memory);
+
+  Param pp_param;
+  pp_param.setValue("ms_levels", ListUtils::create<Int>("1,2"));
+  PeakPickerHiRes pp;
+  pp.setParameters(pp_param);
+
+  PeakMap expected;
+  pp.pickExperiment(in_memory, expected, false);
+
+  OnDiscMSExperiment on_disc;
+  on_disc.openFile(tmp_filename);
+  MSDataStoringConsumer consumer;
+  pp.pickExperiment(on_disc, consumer, false);
+  const PeakMap& streamed = consumer.getData();
+
+  // on-disc variant with PeakMap output
+  PeakMap on_disc_output;
+  pp.pickExperiment(on_disc, on_disc_output, false);
+
+  TEST_EQUAL(streamed.size(), expected.size())
+  TEST_EQUAL(on_disc_output.size(), expected.size())
+  ABORT_IF(streamed.size() != expected.size() || on_disc_output.size() != expected.size())
+  for (Size i = 0; i < expected.size(); ++i)
+  {
+    TEST_EQUAL(streamed[i].getNativeID(), expected[i].getNativeID())
+    TEST_EQUAL(streamed[i].size(), expected[i].size())
+    TEST_EQUAL(on_disc_output[i].size(), expected[i].size())
+    for (Size j = 0; j < expected[i].size() && j < streamed[i].size() && j < on_disc_output[i].size(); ++j)
+    {
+      TEST_REAL_SIMILAR(streamed[i][j].getMZ(), expected[i][j].getMZ())
+      TEST_REAL_SIMILAR(streamed[i][j].getIntensity(), expected[i][j].getIntensity())
+      TEST_REAL_SIMILAR(on_disc_output[i][j].getMZ(), expected[i][j].getMZ())
+    }
+  }
+}
+END_SECTION
+
 //////////////////////////////////////////////
 // check peak boundaries on simulation data //
 //////////////////////////////////////////////
@@ -151,6 +151,36 @@ START_SECTION((char getAAAfter() const ))
 }
 END_SECTION
 
+START_SECTION(([EXTRA] shared protein accessions))
+{
+  PeptideEvidence pe1("PROT_A", 1, 5, 'K', 'A');
+  PeptideEvidence pe2;
+  pe2.setProteinAccession(String("PROT_") + "A");
+  TEST_EQUAL(&pe1.getProteinAccession() == &pe2.getProteinAccession(), true)
+  pe2.setProteinAccession("PROT_B");
+  TEST_STRING_EQUAL(pe1.getProteinAccession(), "PROT_A")
+  TEST_STRING_EQUAL(pe2.getProteinAccession(), "PROT_B")
+  TEST_EQUAL(pe1 < pe2, true)
+  TEST_EQUAL(pe2 < pe1, false)
+  pe2.setProteinAccession("");
+  TEST_STRING_EQUAL(pe2.getProteinAccession(), "")
+  TEST_EQUAL(pe2 == PeptideEvidence(), true)
+
+  // accessions are released with the last evidence referring to them
+  {
+    PeptideEvidence pe3("PROT_C", 1, 5, 'K', 'A');
+    PeptideEvidence pe4(pe3);
+    pe3.setProteinAccession("PROT_D");
+    TEST_STRING_EQUAL(pe4.getProteinAccession(), "PROT_C")
+  }
+  PeptideEvidence pe5("PROT_C", 1, 5, 'K', 'A');
+  PeptideEvidence pe6;
+  pe6.setProteinAccession("PROT_C");
+  TEST_STRING_EQUAL(pe5.getProteinAccession(), "PROT_C")
+  TEST_EQUAL(&pe5.getProteinAccession() == &pe6.getProteinAccession(), true)
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
@@ -197,6 +197,41 @@ START_SECTION((void setPeptideEvidences(const vector<PeptideEvidence> & peptide_
 END_SECTION
 
 
+START_SECTION(([EXTRA] shared peptide evidences))
+{
+  vector<PeptideEvidence> pes;
+  pes.push_back(PeptideEvidence("ACC392", 10, 20, 'K', 'A'));
+  pes.push_back(PeptideEvidence("ACD392", 30, 40, 'R', 'G'));
+  PeptideHit hit1, hit2;
+  hit1.setPeptideEvidences(pes);
+  hit2.setPeptideEvidences(vector<PeptideEvidence>(pes));
+  TEST_EQUAL(&hit1.getPeptideEvidences() == &hit2.getPeptideEvidences(), true)
+  TEST_EQUAL(hit1 == hit2, true)
+
+  // adding evidences leaves other hits untouched
+  PeptideHit hit3(hit1);
+  hit1.addPeptideEvidence(PeptideEvidence("ACE392", 50, 60, 'K', 'P'));
+  TEST_EQUAL(hit1.getPeptideEvidences().size(), 3)
+  TEST_EQUAL(hit2.getPeptideEvidences().size(), 2)
+  TEST_EQUAL(hit3.getPeptideEvidences().size(), 2)
+  TEST_EQUAL(hit1 == hit2, false)
+  TEST_EQUAL(hit2 == hit3, true)
+
+  // equal lists built independently compare equal
+  PeptideHit hit4;
+  for (const PeptideEvidence& pe : hit1.getPeptideEvidences())
+  {
+    hit4.addPeptideEvidence(pe);
+  }
+  TEST_EQUAL(hit1 == hit4, true)
+
+  hit2.setPeptideEvidences(vector<PeptideEvidence>());
+  TEST_EQUAL(hit2.getPeptideEvidences().empty(), true)
+  TEST_EQUAL(hit3.getPeptideEvidences().size(), 2)
+  TEST_EQUAL(hit2 == PeptideHit(), true)
+}
+END_SECTION
+
 START_SECTION((const std::set<String>& extractProteinAccessionsSet() const))
      PeptideHit hit;
      vector<PeptideEvidence> pes(2, PeptideEvidence());
@@ -329,6 +329,49 @@ END_SECTION
         }
     END_SECTION
 
+START_SECTION(([EXTRA] bool fit(std::vector<double>& search_engine_scores, std::vector<double>& probabilities, const String& outlier_handling) with binned scores))
+{
+  vector<double> scores;
+  CsvFile gauss_mix (OPENMS_GET_TEST_DATA_PATH("GaussMix_2_1D.csv"), ';');
+  StringList gauss_mix_strings;
+  gauss_mix.getRow(0, gauss_mix_strings);
+  for (StringList::const_iterator it = gauss_mix_strings.begin(); it != gauss_mix_strings.end(); ++it)
+  {
+    if (!it->empty())
+    {
+      scores.push_back(it->toDouble());
+    }
+  }
+  TEST_EQUAL(scores.size(), 2000)
+
+  Param param;
+  param.setValue("incorrectly_assigned", "Gauss");
+  PosteriorErrorProbabilityModel exact;
+  exact.setParameters(param);
+  vector<double> exact_scores(scores), exact_probabilities;
+  TEST_EQUAL(exact.fit(exact_scores, exact_probabilities, "none"), true)
+
+  // the EM algorithm on 200 bins gives (nearly) the same fit
+  param.setValue("number_of_fit_bins", 200);
+  PosteriorErrorProbabilityModel binned;
+  binned.setParameters(param);
+  vector<double> binned_scores(scores), binned_probabilities;
+  TEST_EQUAL(binned.fit(binned_scores, binned_probabilities, "none"), true)
+
+  TOLERANCE_ABSOLUTE(0.01)
+  TEST_REAL_SIMILAR(binned.getCorrectlyAssignedFitResult().x0, exact.getCorrectlyAssignedFitResult().x0)
+  TEST_REAL_SIMILAR(binned.getCorrectlyAssignedFitResult().sigma, exact.getCorrectlyAssignedFitResult().sigma)
+  TEST_REAL_SIMILAR(binned.getIncorrectlyAssignedFitResult().x0, exact.getIncorrectlyAssignedFitResult().x0)
+  TEST_REAL_SIMILAR(binned.getIncorrectlyAssignedFitResult().sigma, exact.getIncorrectlyAssignedFitResult().sigma)
+  TEST_REAL_SIMILAR(binned.getNegativePrior(), exact.getNegativePrior())
+  TEST_EQUAL(binned_probabilities.size(), exact_probabilities.size())
+  for (Size i = 0; i < exact_probabilities.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(binned_probabilities[i], exact_probabilities[i])
+  }
+}
+END_SECTION
+
 START_SECTION((const String getBothGnuplotFormula(const GaussFitter::GaussFitResult& incorrect, const GaussFitter::GaussFitResult& correct) const))
 NOT_TESTABLE
 delete ptr;
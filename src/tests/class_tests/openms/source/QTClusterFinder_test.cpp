@@ -264,6 +264,57 @@ START_SECTION((void run(const std::vector<ConsensusMap>& input_maps, ConsensusMa
 }
 END_SECTION
 
+START_SECTION(([EXTRA] void run(const std::vector<FeatureMap >& input_maps, ConsensusMap& result_map) with several partitions))
+{
+  // 50 well separated groups of features, one feature per map and group
+  vector<FeatureMap> input(4);
+  for (Size map_index = 0; map_index < input.size(); ++map_index)
+  {
+    for (Size group = 0; group < 50; ++group)
+    {
+      Feature feat;
+      feat.setRT(100.0 + map_index);
+      feat.setMZ(300.0 + 10.0 * group + 0.001 * map_index);
+      feat.setIntensity(1000.0);
+      feat.setUniqueId(group);
+      input[map_index].push_back(feat);
+    }
+    input[map_index].updateRanges();
+  }
+
+  QTClusterFinder finder;
+  Param param = finder.getDefaults();
+  param.setValue("distance_RT:max_difference", 5.1);
+  param.setValue("distance_MZ:max_difference", 0.1);
+  param.setValue("distance_MZ:unit", "Da");
+
+  ConsensusMap single, partitioned;
+  param.setValue("nr_partitions", 1);
+  finder.setParameters(param);
+  finder.run(input, single);
+  param.setValue("nr_partitions", 10);
+  finder.setParameters(param);
+  finder.run(input, partitioned);
+
+  TEST_EQUAL(single.size(), 50);
+  TEST_EQUAL(partitioned.size(), 50);
+  ABORT_IF(partitioned.size() != 50);
+
+  std::set<Size> groups;
+  for (Size i = 0; i < partitioned.size(); ++i)
+  {
+    TEST_EQUAL(partitioned[i].size(), 4);
+    Size group = Size((partitioned[i].getMZ() - 300.0) / 10.0 + 0.5);
+    groups.insert(group);
+    for (ConsensusFeature::HandleSetType::const_iterator it = partitioned[i].begin(); it != partitioned[i].end(); ++it)
+    {
+      TEST_EQUAL(it->getUniqueId(), group);
+    }
+  }
+  TEST_EQUAL(groups.size(), 50);
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
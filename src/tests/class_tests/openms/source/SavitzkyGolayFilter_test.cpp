@@ -39,6 +39,7 @@
 
 #include <OpenMS/FILTERING/SMOOTHING/SavitzkyGolayFilter.h>
 #include <OpenMS/KERNEL/Peak2D.h>
+#include <cmath>
 
 ///////////////////////////
 
@@ -157,6 +158,88 @@ START_SECTION((template <typename PeakType> void filterExperiment(MSExperiment<P
 
 END_SECTION
 
+START_SECTION(([EXTRA] void filter(MSSpectrum& spectrum) is identical to the copy-based filter(first, last, d_first)))
+{
+  // filter(MSSpectrum&) and filter(MSChromatogram&) smooth in place; the result must be bit-identical to the low level template
+  SavitzkyGolayFilter sgolay;
+  Param p = sgolay.getDefaults();
+  p.setValue("frame_length", 7);
+  p.setValue("polynomial_order", 3);
+  sgolay.setParameters(p);
+
+  for (Size n = 5; n < 40; n += 3)
+  {
+    MSSpectrum spectrum;
+    MSChromatogram chrom;
+    for (Size i = 0; i < n; ++i)
+    {
+      spectrum.push_back(Peak1D(500.0 + 0.01 * i, float(std::sin(0.37 * i) * 100.0 + 0.13 * (i % 5))));
+      chrom.push_back(ChromatogramPeak(10.0 * i, float(std::cos(0.41 * i) * 50.0 + 0.29 * (i % 3))));
+    }
+
+    MSSpectrum spectrum_copy = spectrum;
+    sgolay.filter(spectrum.begin(), spectrum.end(), spectrum_copy.begin());
+    MSChromatogram chrom_copy = chrom;
+    sgolay.filter(chrom.begin(), chrom.end(), chrom_copy.begin());
+
+    sgolay.filter(spectrum);
+    sgolay.filter(chrom);
+
+    for (Size i = 0; i < n; ++i)
+    {
+      TEST_EQUAL(spectrum[i].getIntensity(), spectrum_copy[i].getIntensity())
+      TEST_EQUAL(chrom[i].getIntensity(), chrom_copy[i].getIntensity())
+    }
+    TEST_EQUAL(spectrum == spectrum_copy, true)
+    TEST_EQUAL(chrom == chrom_copy, true)
+  }
+}
+END_SECTION
+
+START_SECTION(([EXTRA] void filterExperiment(PeakMap& map) with many spectra and chromatograms))
+{
+  // the (parallel) experiment filter must give the same result as smoothing each spectrum/chromatogram individually
+  PeakMap exp;
+  exp.resize(50);
+  for (Size s = 0; s < exp.size(); ++s)
+  {
+    for (Size i = 0; i < 5 + s; ++i)
+    {
+      Peak1D p(500.0 + 0.01 * i, float((i * 7 + s * 3) % 11));
+      exp[s].push_back(p);
+    }
+  }
+  for (Size c = 0; c < 30; ++c)
+  {
+    MSChromatogram chrom;
+    for (Size i = 0; i < 3 + c; ++i)
+    {
+      ChromatogramPeak p(10.0 * i, float((i * 5 + c) % 13));
+      chrom.push_back(p);
+    }
+    exp.addChromatogram(chrom);
+  }
+  PeakMap expected = exp;
+
+  SavitzkyGolayFilter sgolay;
+  Param p = sgolay.getDefaults();
+  p.setValue("frame_length", 7);
+  p.setValue("polynomial_order", 3);
+  sgolay.setParameters(p);
+  for (Size s = 0; s < expected.size(); ++s)
+  {
+    sgolay.filter(expected[s]);
+  }
+  for (Size c = 0; c < expected.getChromatograms().size(); ++c)
+  {
+    sgolay.filter(expected.getChromatogram(c));
+  }
+  sgolay.filterExperiment(exp);
+
+  TEST_EQUAL(exp == expected, true)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -114,6 +114,70 @@ START_SECTION([EXTRA](virtual void init(const PeakIterator& it_begin, const Peak
 
 END_SECTION
 
+START_SECTION([EXTRA](virtual void init(const PeakIterator& it_begin, const PeakIterator& it_end)) with exact median)
+{
+  MSSpectrum raw_data;
+  double intensities[] = {10.0, 50.0, 20.0, 40.0, 30.0, 60.0};
+  for (Size i = 0; i < 6; ++i)
+  {
+    Peak1D peak;
+    peak.setMZ(100.0 + i);
+    peak.setIntensity(intensities[i]);
+    raw_data.push_back(peak);
+  }
+
+  SignalToNoiseEstimatorMedian< MSSpectrum > sne;
+  Param p;
+  p.setValue("win_len", 4.0);
+  p.setValue("min_required_elements", 1);
+  p.setValue("exact_median", "true");
+  sne.setParameters(p);
+  sne.init(raw_data);
+
+  // windows: {10, 50, 20} -> 20; {10, 50, 20, 40} -> 30; {10, 50, 20, 40, 30} -> 30;
+  // {50, 20, 40, 30, 60} -> 40; {20, 40, 30, 60} -> 35; {40, 30, 60} -> 40
+  TEST_REAL_SIMILAR(sne.getSignalToNoise(raw_data[0]), 10.0 / 20.0)
+  TEST_REAL_SIMILAR(sne.getSignalToNoise(raw_data[1]), 50.0 / 30.0)
+  TEST_REAL_SIMILAR(sne.getSignalToNoise(raw_data[2]), 20.0 / 30.0)
+  TEST_REAL_SIMILAR(sne.getSignalToNoise(raw_data[3]), 40.0 / 40.0)
+  TEST_REAL_SIMILAR(sne.getSignalToNoise(raw_data[4]), 30.0 / 35.0)
+  TEST_REAL_SIMILAR(sne.getSignalToNoise(raw_data[5]), 60.0 / 40.0)
+}
+END_SECTION
+
+START_SECTION((void estimateBatch(const std::vector<Container>& containers, std::vector<std::vector<double> >& stn) const))
+{
+  MSSpectrum raw_data;
+  DTAFile().load(OPENMS_GET_TEST_DATA_PATH("SignalToNoiseEstimator_test.dta"), raw_data);
+
+  SignalToNoiseEstimatorMedian< MSSpectrum > sne;
+  Param p;
+  p.setValue("win_len", 40.0);
+  p.setValue("noise_for_empty_window", 2.0);
+  p.setValue("min_required_elements", 10);
+  sne.setParameters(p);
+
+  vector<MSSpectrum> spectra(3, raw_data);
+  spectra[1].clear(false);
+  vector<vector<double> > stn;
+  sne.estimateBatch(spectra, stn);
+
+  TEST_EQUAL(stn.size(), 3)
+  ABORT_IF(stn.size() != 3)
+  TEST_EQUAL(stn[0].size(), raw_data.size())
+  TEST_EQUAL(stn[1].size(), 0)
+  TEST_EQUAL(stn[2].size(), raw_data.size())
+  ABORT_IF((stn[0].size() != raw_data.size()) || (stn[2].size() != raw_data.size()))
+
+  sne.init(raw_data);
+  for (Size i = 0; i < raw_data.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(stn[0][i], sne.getSignalToNoise(raw_data[i]))
+    TEST_REAL_SIMILAR(stn[2][i], sne.getSignalToNoise(raw_data[i]))
+  }
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
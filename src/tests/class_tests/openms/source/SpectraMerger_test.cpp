@@ -146,6 +146,59 @@ START_SECTION((template < typename MapType > void mergeSpectraPrecursors(MapType
 
 END_SECTION
 
+START_SECTION(([EXTRA] template < typename MapType > void mergeSpectraPrecursors(MapType &exp)))
+{
+  // precursors (RT, m/z): 0-1-2 are chained within the tolerances (0 and 2
+  // are not), 3 is close in RT but not in m/z, 4 is close in m/z but not in RT
+  const double rts[] = {100.0, 104.0, 108.0, 102.0, 130.0};
+  const double mzs[] = {500.0, 500.0005, 500.001, 501.0, 500.0};
+  PeakMap exp;
+  MSSpectrum ms1;
+  ms1.setMSLevel(1);
+  ms1.setRT(99.0);
+  exp.addSpectrum(ms1);
+  for (Size i = 0; i < 5; ++i)
+  {
+    MSSpectrum spec;
+    spec.setMSLevel(2);
+    spec.setRT(rts[i]);
+    Precursor prec;
+    prec.setMZ(mzs[i]);
+    spec.setPrecursors(vector<Precursor>(1, prec));
+    Peak1D peak;
+    peak.setMZ(200.0 + i);
+    peak.setIntensity(10.0);
+    spec.push_back(peak);
+    exp.addSpectrum(spec);
+  }
+
+  SpectraMerger merger;
+  Param p;
+  p.setValue("mz_binning_width", 0.3);
+  p.setValue("mz_binning_width_unit", "Da");
+  p.setValue("precursor_method:mz_tolerance", 0.0006);
+  p.setValue("precursor_method:rt_tolerance", 5.0);
+  merger.setParameters(p);
+  merger.mergeSpectraPrecursors(exp);
+
+  // MS1 + merged (0, 1, 2) + 3 + 4
+  TEST_EQUAL(exp.size(), 4)
+  ABORT_IF(exp.size() != 4)
+  TEST_EQUAL(exp[0].getMSLevel(), 1)
+  TEST_REAL_SIMILAR(exp[1].getRT(), 102.0) // unmerged spectrum 3
+  TEST_REAL_SIMILAR(exp[2].getRT(), 104.0) // average of 0, 1, 2
+  TEST_EQUAL(exp[2].size(), 3)
+  TEST_REAL_SIMILAR(exp[2].getPrecursors()[0].getMZ(), 500.0005)
+  TEST_REAL_SIMILAR(exp[3].getRT(), 130.0)
+
+  // nothing to merge without MS2 spectra
+  PeakMap exp_ms1;
+  exp_ms1.addSpectrum(ms1);
+  merger.mergeSpectraPrecursors(exp_ms1);
+  TEST_EQUAL(exp_ms1.size(), 1)
+}
+END_SECTION
+
 START_SECTION((template < typename MapType > void averageGaussian(MapType &exp)))
 	PeakMap exp;
 	MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("SpectraMerger_input_3.mzML"), exp);    // profile mode
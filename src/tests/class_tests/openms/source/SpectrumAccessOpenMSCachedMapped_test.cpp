@@ -0,0 +1,251 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: Hannes Roest $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMSCachedMapped.h>
+///////////////////////////
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMSCached.h>
+#include <OpenMS/FORMAT/CachedMzML.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+
+#include <fstream>
+#include <iterator>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(SpectrumAccessOpenMSCachedMapped, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+PeakMap exp;
+MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML"), exp);
+
+std::string tmpf;
+NEW_TMP_FILE(tmpf);
+CachedmzML::store(tmpf, exp);
+
+SpectrumAccessOpenMSCachedMapped* ptr = nullptr;
+SpectrumAccessOpenMSCachedMapped* nullPointer = nullptr;
+
+START_SECTION(SpectrumAccessOpenMSCachedMapped(const String& filename))
+{
+  ptr = new SpectrumAccessOpenMSCachedMapped(tmpf);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+
+  TEST_EXCEPTION(Exception::FileNotFound, SpectrumAccessOpenMSCachedMapped(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML")))
+}
+END_SECTION
+
+START_SECTION(~SpectrumAccessOpenMSCachedMapped())
+{
+  delete ptr;
+}
+END_SECTION
+
+SpectrumAccessOpenMSCachedMapped mapped(tmpf);
+SpectrumAccessOpenMSCached cached(tmpf);
+
+START_SECTION(size_t getNrSpectra() const)
+{
+  TEST_EQUAL(mapped.getNrSpectra(), 4)
+}
+END_SECTION
+
+START_SECTION(size_t getNrChromatograms() const)
+{
+  TEST_EQUAL(mapped.getNrChromatograms(), exp.getChromatograms().size())
+}
+END_SECTION
+
+START_SECTION(OpenSwath::SpectrumPtr getSpectrumById(int id))
+{
+  for (int i = 0; i < (int)mapped.getNrSpectra(); ++i)
+  {
+    OpenSwath::SpectrumPtr s1 = mapped.getSpectrumById(i);
+    OpenSwath::SpectrumPtr s2 = cached.getSpectrumById(i);
+    TEST_EQUAL(s1->getDataArrays().size(), s2->getDataArrays().size())
+    for (Size k = 0; k < s1->getDataArrays().size(); ++k)
+    {
+      TEST_EQUAL(s1->getDataArrays()[k]->data == s2->getDataArrays()[k]->data, true)
+      TEST_EQUAL(s1->getDataArrays()[k]->description, s2->getDataArrays()[k]->description)
+    }
+  }
+
+  // spectrum 1 has two additional float data arrays
+  OpenSwath::SpectrumPtr s = mapped.getSpectrumById(1);
+  TEST_EQUAL(s->getDataArrays().size(), 4)
+  TEST_EQUAL(s->getDataArrays()[2]->description, "signal to noise array")
+  TEST_EQUAL(s->getDataArrays()[3]->description, "user-defined name")
+  TEST_EQUAL(s->getMZArray()->data.size(), exp[1].size())
+}
+END_SECTION
+
+START_SECTION(void getSpectrumViewById(int id, RecordView& view) const)
+{
+  SpectrumAccessOpenMSCachedMapped::RecordView view;
+  for (int i = 0; i < (int)mapped.getNrSpectra(); ++i)
+  {
+    mapped.getSpectrumViewById(i, view);
+    TEST_EQUAL(view.ms_level, exp[i].getMSLevel())
+    TEST_REAL_SIMILAR(view.rt, exp[i].getRT())
+    TEST_EQUAL(view.arrays.size(), 2 + exp[i].getFloatDataArrays().size() + exp[i].getIntegerDataArrays().size())
+    TEST_EQUAL(view.arrays[0].size(), exp[i].size())
+    for (Size k = 0; k < exp[i].size(); ++k)
+    {
+      TEST_REAL_SIMILAR(view.arrays[0][k], exp[i][k].getMZ())
+      TEST_REAL_SIMILAR(view.arrays[1][k], exp[i][k].getIntensity())
+    }
+  }
+
+  mapped.getSpectrumViewById(1, view);
+  TEST_EQUAL(view.arrays[2].getName(), "signal to noise array")
+  TEST_EQUAL(view.arrays[2].size(), exp[1].getFloatDataArrays()[0].size())
+  TEST_REAL_SIMILAR(view.arrays[2][0], exp[1].getFloatDataArrays()[0][0])
+}
+END_SECTION
+
+START_SECTION(OpenSwath::ChromatogramPtr getChromatogramById(int id))
+{
+  for (int i = 0; i < (int)mapped.getNrChromatograms(); ++i)
+  {
+    OpenSwath::ChromatogramPtr c1 = mapped.getChromatogramById(i);
+    OpenSwath::ChromatogramPtr c2 = cached.getChromatogramById(i);
+    TEST_EQUAL(c1->getDataArrays().size(), c2->getDataArrays().size())
+    TEST_EQUAL(c1->getTimeArray()->data == c2->getTimeArray()->data, true)
+    TEST_EQUAL(c1->getIntensityArray()->data == c2->getIntensityArray()->data, true)
+  }
+}
+END_SECTION
+
+START_SECTION(void getChromatogramViewById(int id, RecordView& view) const)
+{
+  SpectrumAccessOpenMSCachedMapped::RecordView view;
+  for (int i = 0; i < (int)mapped.getNrChromatograms(); ++i)
+  {
+    const MSChromatogram& chrom = exp.getChromatograms()[i];
+    mapped.getChromatogramViewById(i, view);
+    TEST_EQUAL(view.ms_level, -1)
+    TEST_EQUAL(view.arrays[0].size(), chrom.size())
+    for (Size k = 0; k < chrom.size(); ++k)
+    {
+      TEST_REAL_SIMILAR(view.arrays[0][k], chrom[k].getRT())
+      TEST_REAL_SIMILAR(view.arrays[1][k], chrom[k].getIntensity())
+    }
+  }
+}
+END_SECTION
+
+START_SECTION(OpenSwath::SpectrumMeta getSpectrumMetaById(int id) const)
+{
+  for (int i = 0; i < (int)mapped.getNrSpectra(); ++i)
+  {
+    TEST_REAL_SIMILAR(mapped.getSpectrumMetaById(i).RT, exp[i].getRT())
+    TEST_EQUAL(mapped.getSpectrumMetaById(i).ms_level, exp[i].getMSLevel())
+  }
+}
+END_SECTION
+
+START_SECTION(std::vector<std::size_t> getSpectraByRT(double RT, double deltaRT) const)
+{
+  TEST_EQUAL(mapped.getSpectraByRT(exp[2].getRT(), 0.0).size(), cached.getSpectraByRT(exp[2].getRT(), 0.0).size())
+  TEST_EQUAL(mapped.getSpectraByRT(exp[2].getRT(), 1e6).size(), 4)
+}
+END_SECTION
+
+START_SECTION(std::string getChromatogramNativeID(int id) const)
+{
+  for (int i = 0; i < (int)mapped.getNrChromatograms(); ++i)
+  {
+    TEST_EQUAL(mapped.getChromatogramNativeID(i), exp.getChromatograms()[i].getNativeID())
+  }
+}
+END_SECTION
+
+START_SECTION(boost::shared_ptr<OpenSwath::ISpectrumAccess> lightClone() const)
+{
+  boost::shared_ptr<OpenSwath::ISpectrumAccess> clone = mapped.lightClone();
+  TEST_EQUAL(clone->getNrSpectra(), mapped.getNrSpectra())
+  TEST_EQUAL(clone->getSpectrumById(1)->getMZArray()->data == mapped.getSpectrumById(1)->getMZArray()->data, true)
+
+  // the clone shares the meta data
+  const SpectrumAccessOpenMSCachedMapped* c = dynamic_cast<const SpectrumAccessOpenMSCachedMapped*>(clone.get());
+  TEST_EQUAL(&c->getMetaData() == &mapped.getMetaData(), true)
+}
+END_SECTION
+
+START_SECTION(([EXTRA] concurrent access))
+{
+  Size nr_errors = 0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+: nr_errors)
+#endif
+  for (SignedSize i = 0; i < 400; ++i)
+  {
+    int id = i % 4;
+    OpenSwath::SpectrumPtr s = mapped.getSpectrumById(id);
+    if (s->getMZArray()->data.size() != exp[id].size()) ++nr_errors;
+  }
+  TEST_EQUAL(nr_errors, 0)
+}
+END_SECTION
+
+START_SECTION(([EXTRA] corrupt cache file))
+{
+  std::string tmp_corrupt;
+  NEW_TMP_FILE(tmp_corrupt);
+  CachedmzML::store(tmp_corrupt, exp);
+
+  // truncate the binary file in the middle of the data
+  std::ifstream ifs((tmp_corrupt + ".cached").c_str(), std::ios::binary);
+  std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  ifs.close();
+  std::ofstream ofs((tmp_corrupt + ".cached").c_str(), std::ios::binary);
+  ofs.write(content.data(), content.size() / 2);
+  ofs.close();
+
+  TEST_EXCEPTION(Exception::ParseError, SpectrumAccessOpenMSCachedMapped mapped_corrupt(tmp_corrupt))
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
+
@@ -0,0 +1,192 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/FORMAT/HANDLERS/XMLPullTokenizer.h>
+
+///////////////////////////
+
+START_TEST(XMLPullTokenizer, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+using namespace OpenMS;
+using namespace OpenMS::Internal;
+using namespace std;
+
+const std::string xml = "<list>\n"
+                        "  <!-- comment with <tags> -->\n"
+                        "  <item id=\"e_12\" quality='0.5' charge=\"-2\">\n"
+                        "    <point rt=\"1.5e3\" mz=\" 445.1 \"/>\n"
+                        "    <param value=\"a&amp;b&lt;&#65;&#x42;\ttab\"/>\n"
+                        "  </item>\n"
+                        "</list>\n";
+
+XMLPullTokenizer* ptr = nullptr;
+XMLPullTokenizer* nullPointer = nullptr;
+
+START_SECTION(XMLPullTokenizer(const char* begin, const char* end))
+  ptr = new XMLPullTokenizer(xml.data(), xml.data() + xml.size());
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->depth(), 0)
+  delete ptr;
+END_SECTION
+
+START_SECTION(TokenType next())
+  XMLPullTokenizer tokenizer(xml.data(), xml.data() + xml.size());
+  TEST_EQUAL(tokenizer.next(), XMLPullTokenizer::START_TAG)
+  TEST_EQUAL(tokenizer.getTag(), "list")
+  TEST_EQUAL(tokenizer.next(), XMLPullTokenizer::START_TAG)
+  TEST_EQUAL(tokenizer.getTag(), "item")
+  TEST_EQUAL(tokenizer.next(), XMLPullTokenizer::START_TAG)
+  TEST_EQUAL(tokenizer.getTag(), "point")
+  // empty elements are reported as start and end tag
+  TEST_EQUAL(tokenizer.next(), XMLPullTokenizer::END_TAG)
+  TEST_EQUAL(tokenizer.getTag(), "point")
+  TEST_EQUAL(tokenizer.next(), XMLPullTokenizer::START_TAG)
+  TEST_EQUAL(tokenizer.next(), XMLPullTokenizer::END_TAG)
+  TEST_EQUAL(tokenizer.next(), XMLPullTokenizer::END_TAG)
+  TEST_EQUAL(tokenizer.getTag(), "item")
+  TEST_EQUAL(tokenizer.next(), XMLPullTokenizer::END_TAG)
+  TEST_EQUAL(tokenizer.getTag(), "list")
+  TEST_EQUAL(tokenizer.next(), XMLPullTokenizer::END_OF_INPUT)
+
+  // unsupported or malformed content
+  std::string text = "<a>text</a>";
+  XMLPullTokenizer t1(text.data(), text.data() + text.size());
+  t1.next();
+  TEST_EXCEPTION(Exception::ParseError, t1.next())
+  std::string unbalanced = "<a><b></a>";
+  XMLPullTokenizer t2(unbalanced.data(), unbalanced.data() + unbalanced.size());
+  t2.next();
+  t2.next();
+  TEST_EXCEPTION(Exception::ParseError, t2.next())
+  std::string unclosed = "<a><b/>";
+  XMLPullTokenizer t3(unclosed.data(), unclosed.data() + unclosed.size());
+  t3.next();
+  t3.next();
+  t3.next();
+  TEST_EXCEPTION(Exception::ParseError, t3.next())
+  std::string cdata = "<a><![CDATA[x]]></a>";
+  XMLPullTokenizer t4(cdata.data(), cdata.data() + cdata.size());
+  t4.next();
+  TEST_EXCEPTION(Exception::ParseError, t4.next())
+  std::string non_ascii = "<a name=\"\xC3\xA4\"/>";
+  XMLPullTokenizer t5(non_ascii.data(), non_ascii.data() + non_ascii.size());
+  TEST_EXCEPTION(Exception::ParseError, t5.next())
+END_SECTION
+
+START_SECTION(Size depth() const)
+  XMLPullTokenizer tokenizer(xml.data(), xml.data() + xml.size());
+  tokenizer.next();
+  TEST_EQUAL(tokenizer.depth(), 1)
+  tokenizer.next();
+  TEST_EQUAL(tokenizer.depth(), 2)
+  tokenizer.next();
+  TEST_EQUAL(tokenizer.depth(), 3)
+  tokenizer.next();
+  TEST_EQUAL(tokenizer.depth(), 2)
+END_SECTION
+
+START_SECTION(bool isTag(const char* name) const)
+  XMLPullTokenizer tokenizer(xml.data(), xml.data() + xml.size());
+  tokenizer.next();
+  TEST_EQUAL(tokenizer.isTag("list"), true)
+  TEST_EQUAL(tokenizer.isTag("lis"), false)
+  TEST_EQUAL(tokenizer.isTag("list2"), false)
+END_SECTION
+
+START_SECTION(String getTag() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(bool getAttribute(const char* name, String& value) const)
+  XMLPullTokenizer tokenizer(xml.data(), xml.data() + xml.size());
+  tokenizer.next();
+  tokenizer.next();
+  String value;
+  TEST_EQUAL(tokenizer.getAttribute("id", value), true)
+  TEST_EQUAL(value, "e_12")
+  TEST_EQUAL(tokenizer.getAttribute("quality", value), true)
+  TEST_EQUAL(value, "0.5")
+  TEST_EQUAL(tokenizer.getAttribute("missing", value), false)
+  tokenizer.next();
+  tokenizer.next();
+  tokenizer.next();
+  // entities are decoded, tabs are normalized to spaces
+  TEST_EQUAL(tokenizer.getAttribute("value", value), true)
+  TEST_EQUAL(value, "a&b<AB tab")
+
+  std::string unknown = "<a name=\"&auml;\"/>";
+  XMLPullTokenizer t1(unknown.data(), unknown.data() + unknown.size());
+  t1.next();
+  TEST_EXCEPTION(Exception::ParseError, t1.getAttribute("name", value))
+END_SECTION
+
+START_SECTION(bool getAttribute(const char* name, double& value) const)
+  XMLPullTokenizer tokenizer(xml.data(), xml.data() + xml.size());
+  tokenizer.next();
+  tokenizer.next();
+  double value = 0.0;
+  TEST_EQUAL(tokenizer.getAttribute("quality", value), true)
+  TEST_REAL_SIMILAR(value, 0.5)
+  TEST_EXCEPTION(Exception::ParseError, tokenizer.getAttribute("id", value))
+  tokenizer.next();
+  TEST_EQUAL(tokenizer.getAttribute("rt", value), true)
+  TEST_REAL_SIMILAR(value, 1500.0)
+  // surrounding whitespace is accepted (as by String::toDouble())
+  TEST_EQUAL(tokenizer.getAttribute("mz", value), true)
+  TEST_REAL_SIMILAR(value, 445.1)
+  TEST_EQUAL(tokenizer.getAttribute("it", value), false)
+END_SECTION
+
+START_SECTION(bool getAttribute(const char* name, Int& value) const)
+  XMLPullTokenizer tokenizer(xml.data(), xml.data() + xml.size());
+  tokenizer.next();
+  tokenizer.next();
+  Int value = 0;
+  TEST_EQUAL(tokenizer.getAttribute("charge", value), true)
+  TEST_EQUAL(value, -2)
+  TEST_EXCEPTION(Exception::ParseError, tokenizer.getAttribute("quality", value))
+  TEST_EQUAL(tokenizer.getAttribute("missing", value), false)
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -35,6 +35,7 @@
 #include "OpenMS/OPENSWATHALGO/OpenSwathAlgoConfig.h"
 
 #include "OpenMS/OPENSWATHALGO/ALGO/Scoring.h"
+#include <cmath>
 
 #ifdef USE_BOOST_UNIT_TEST
 
@@ -353,6 +354,56 @@ m1 = mi(x_ranking,y_ranking)
 }
 END_SECTION
 
+BOOST_AUTO_TEST_CASE(test_NormalizedCrossCorrelator)
+{
+  // compare against normalizedCrossCorrelation for the direct (short) and FFT (long) code path
+  for (std::size_t n = 11; n <= 1100; n += 1089)
+  {
+    std::vector<std::vector<double> > traces(3, std::vector<double>(n));
+    for (std::size_t k = 0; k < n; ++k)
+    {
+      double x = (double)k / n;
+      traces[0][k] = 100.0 * std::exp(-(x - 0.5) * (x - 0.5) * 50.0) + (k * 7919 % 13);
+      traces[1][k] = 80.0 * std::exp(-(x - 0.52) * (x - 0.52) * 40.0) + (k * 104729 % 17);
+      traces[2][k] = (k * 7907 % 23) + 1.0;
+    }
+
+    Scoring::NormalizedCrossCorrelator correlator(512);
+    for (std::size_t i = 0; i < traces.size(); ++i)
+    {
+      TEST_EQUAL(correlator.addTrace(traces[i]), i)
+    }
+    TEST_EQUAL(correlator.size(), 3)
+
+    Scoring::XCorrArrayType result;
+    for (std::size_t i = 0; i < traces.size(); ++i)
+    {
+      for (std::size_t j = i; j < traces.size(); ++j)
+      {
+        std::vector<double> data1 = traces[i], data2 = traces[j];
+        Scoring::XCorrArrayType expected = Scoring::normalizedCrossCorrelation(data1, data2, (int)n, 1);
+        correlator.compute(i, j, result);
+
+        TEST_EQUAL(result.data.size(), expected.data.size())
+        for (std::size_t k = 0; k < expected.data.size(); k += 7)
+        {
+          TEST_EQUAL(result.data[k].first, expected.data[k].first)
+          TEST_EQUAL(std::fabs(result.data[k].second - expected.data[k].second) < 1e-10, true)
+        }
+        // the maximum is recomputed exactly
+        Scoring::XCorrArrayType::const_iterator max_result = Scoring::xcorrArrayGetMaxPeak(result);
+        Scoring::XCorrArrayType::const_iterator max_expected = Scoring::xcorrArrayGetMaxPeak(expected);
+        TEST_EQUAL(max_result->first, max_expected->first)
+        TEST_EQUAL(max_result->second, max_expected->second)
+      }
+    }
+
+    correlator.clear();
+    TEST_EQUAL(correlator.size(), 0)
+  }
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
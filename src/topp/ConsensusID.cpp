@@ -49,8 +49,15 @@
 #include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/FORMAT/FileTypes.h>
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
+
+#include <exception>
+#include <memory>
 #include <unordered_set>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
@@ -144,6 +151,10 @@ protected:
   String algorithm_; // algorithm for consensus calculation (input parameter)
   bool keep_old_scores_;
 
+  // the algorithms keep state while processing a group of IDs, so there is one
+  // instance per thread:
+  vector<unique_ptr<ConsensusIDAlgorithm>> consensus_;
+
   void registerOptionsAndFlags_() override
   {
     registerInputFileList_("in", "<file(s)>", {}, "input file");
@@ -393,9 +404,76 @@ protected:
   }
 
 
+  ConsensusIDAlgorithm* createAlgorithm_() const
+  {
+    if (algorithm_ == "PEPMatrix")
+    {
+      return new ConsensusIDAlgorithmPEPMatrix();
+    }
+    else if (algorithm_ == "PEPIons")
+    {
+      return new ConsensusIDAlgorithmPEPIons();
+    }
+    else if (algorithm_ == "best")
+    {
+      return new ConsensusIDAlgorithmBest();
+    }
+    else if (algorithm_ == "worst")
+    {
+      return new ConsensusIDAlgorithmWorst();
+    }
+    else if (algorithm_ == "average")
+    {
+      return new ConsensusIDAlgorithmAverage();
+    }
+    // algorithm_ == "ranks"
+    return new ConsensusIDAlgorithmRanks();
+  }
+
+
+  // compute the consensus for each group of peptide IDs (in parallel)
+  void applyConsensus_(vector<vector<PeptideIdentification>*>& groups,
+                       const map<String, String>& se_info,
+                       const vector<Size>& numbers_of_runs)
+  {
+    Size errCount = 0;
+    std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)groups.size(); ++i)
+    {
+      // parallel exception catching and re-throwing business
+      if (errCount) continue;
+      try
+      {
+#ifdef _OPENMP
+        ConsensusIDAlgorithm& consensus = *consensus_[omp_get_thread_num()];
+#else
+        ConsensusIDAlgorithm& consensus = *consensus_[0];
+#endif
+        consensus.apply(*groups[i], se_info, numbers_of_runs[i]);
+      }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical (ConsensusID_applyConsensus)
+#endif
+        {
+          if (!errCount) error = std::current_exception();
+          ++errCount;
+        }
+      }
+    }
+    if (error)
+    {
+      std::rethrow_exception(error);
+    }
+  }
+
+
   template <typename MapType>
-  void processFeatureOrConsensusMap_(MapType& input_map,
-                                     ConsensusIDAlgorithm* consensus)
+  void processFeatureOrConsensusMap_(MapType& input_map)
   {
     // Problem with feature data: IDs from multiple spectra may be attached to
     // a (consensus) feature, so we may have multiple IDs from the same search
@@ -419,6 +497,10 @@ protected:
     }
 
     // compute consensus:
+    vector<vector<PeptideIdentification>*> groups;
+    vector<Size> numbers_of_runs;
+    groups.reserve(input_map.size());
+    numbers_of_runs.reserve(input_map.size());
     for (typename MapType::Iterator map_it = input_map.begin();
          map_it != input_map.end(); ++map_it)
     {
@@ -431,8 +513,10 @@ protected:
       }
       Size n_repeats = *max_element(times_seen.begin(), times_seen.end());
 
-      consensus->apply(ids, runid_to_se, number_of_runs * n_repeats);
+      groups.push_back(&ids);
+      numbers_of_runs.push_back(number_of_runs * n_repeats);
     }
+    applyConsensus_(groups, runid_to_se, numbers_of_runs);
 
     // create new identification run:
     setProteinIdentifications_(input_map.getProteinIdentifications());
@@ -453,40 +537,33 @@ protected:
     //----------------------------------------------------------------
     // set up ConsensusID
     //----------------------------------------------------------------
-    ConsensusIDAlgorithm* consensus;
     // general algorithm parameters:
     Param algo_params = ConsensusIDAlgorithmBest().getDefaults();
     algorithm_ = getStringOption_("algorithm");
-    if (algorithm_ == "PEPMatrix")
-    {
-      consensus = new ConsensusIDAlgorithmPEPMatrix();
-      // add algorithm-specific parameters:
-      algo_params.merge(getParam_().copy("PEPMatrix:", true));
-    }
-    else if (algorithm_ == "PEPIons")
+    if ((algorithm_ == "PEPMatrix") || (algorithm_ == "PEPIons"))
     {
-      consensus = new ConsensusIDAlgorithmPEPIons();
       // add algorithm-specific parameters:
-      algo_params.merge(getParam_().copy("PEPIons:", true));
-    }
-    else if (algorithm_ == "best")
-    {
-      consensus = new ConsensusIDAlgorithmBest();
-    }
-    else if (algorithm_ == "worst")
-    {
-      consensus = new ConsensusIDAlgorithmWorst();
+      algo_params.merge(getParam_().copy(algorithm_ + ":", true));
     }
-    else if (algorithm_ == "average")
-    {
-      consensus = new ConsensusIDAlgorithmAverage();
-    }
-    else // algorithm_ == "ranks"
+    algo_params.update(getParam_(), false, OpenMS_Log_debug); // update general params.
+
+#ifdef _OPENMP
+    Size n_threads = omp_get_max_threads();
+#else
+    Size n_threads = 1;
+#endif
+    consensus_.clear();
+    for (Size i = 0; i < n_threads; ++i)
     {
-      consensus = new ConsensusIDAlgorithmRanks();
+      consensus_.emplace_back(createAlgorithm_());
+      consensus_.back()->setParameters(algo_params);
+      // similarity-based algorithms: compute each sequence similarity only once
+      ConsensusIDAlgorithmSimilarity* similarity = dynamic_cast<ConsensusIDAlgorithmSimilarity*>(consensus_.back().get());
+      if ((i > 0) && (similarity != nullptr))
+      {
+        similarity->shareSimilarityCache(dynamic_cast<ConsensusIDAlgorithmSimilarity&>(*consensus_[0]));
+      }
     }
-    algo_params.update(getParam_(), false, OpenMS_Log_debug); // update general params.
-    consensus->setParameters(algo_params);
 
     //----------------------------------------------------------------
     // idXML
@@ -588,21 +665,26 @@ protected:
           // we could keep track of it but IMHO we should not allow raw there at all (just complicates things)
           to_put.setPrimaryMSRunPath({file_ref_peps.first + ".mzML"});
           setProteinIdentificationSettings_(to_put, mzml_to_sesettings[new_run_id]);
-          for (const auto& ref_peps : file_ref_peps.second)
+          vector<vector<PeptideIdentification>*> groups;
+          vector<tuple<double, double, String>> precursors; // m/z, RT, spectrum reference
+          for (auto& ref_peps : file_ref_peps.second)
           {
-            vector<PeptideIdentification> peps = ref_peps.second;
+            vector<PeptideIdentification>& peps = ref_peps.second;
             if (peps.empty()) continue; //sth went wrong. skip
-            double mz = peps[0].getMZ();
-            double rt = peps[0].getRT();
             // has to have a ref, save it, since apply might modify everything
             String ref = peps[0].getMetaValue("spectrum_reference");
-            consensus->apply(peps, runid_to_old_se, mzml_to_sesettings[new_run_id].size());
-            for (auto& p : peps)
+            precursors.emplace_back(peps[0].getMZ(), peps[0].getRT(), ref);
+            groups.push_back(&peps);
+          }
+          applyConsensus_(groups, runid_to_old_se, vector<Size>(groups.size(), mzml_to_sesettings[new_run_id].size()));
+          for (Size i = 0; i < groups.size(); ++i)
+          {
+            for (auto& p : *groups[i])
             {
               p.setIdentifier(to_put.getIdentifier());
-              p.setMZ(mz);
-              p.setRT(rt);
-              p.setMetaValue("spectrum_reference", ref);
+              p.setMZ(get<0>(precursors[i]));
+              p.setRT(get<1>(precursors[i]));
+              p.setMetaValue("spectrum_reference", get<2>(precursors[i]));
               //TODO copy other meta values from the originals? They need to be collected
               // in the algorithm subclasses though first
               pep_ids.emplace_back(std::move(p));
@@ -667,10 +749,17 @@ protected:
 
         // compute consensus
         pep_ids.clear();
+        vector<vector<PeptideIdentification>*> groups;
+        groups.reserve(grouping.size());
+        for (ConsensusMap::Iterator it = grouping.begin(); it != grouping.end();
+             ++it)
+        {
+          groups.push_back(&(it->getPeptideIdentifications()));
+        }
+        applyConsensus_(groups, runid_to_se, vector<Size>(groups.size(), prot_ids.size()));
         for (ConsensusMap::Iterator it = grouping.begin(); it != grouping.end();
              ++it)
         {
-          consensus->apply(it->getPeptideIdentifications(), runid_to_se, prot_ids.size());
           if (!it->getPeptideIdentifications().empty())
           {
             PeptideIdentification& pep_id = it->getPeptideIdentifications()[0];
@@ -699,7 +788,7 @@ protected:
       FeatureMap map;
       FeatureXMLFile().load(in[0], map);
 
-      processFeatureOrConsensusMap_(map, consensus);
+      processFeatureOrConsensusMap_(map);
 
       FeatureXMLFile().store(out, map);
     }
@@ -712,13 +801,11 @@ protected:
       ConsensusMap map;
       ConsensusXMLFile().load(in[0], map);
 
-      processFeatureOrConsensusMap_(map, consensus);
+      processFeatureOrConsensusMap_(map);
 
       ConsensusXMLFile().store(out, map);
     }
 
-    delete consensus;
-
     return EXECUTION_OK;
   }
 };
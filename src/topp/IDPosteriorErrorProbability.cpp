@@ -37,6 +37,13 @@
 #include <OpenMS/MATH/STATISTICS/PosteriorErrorProbabilityModel.h>
 #include <OpenMS/FORMAT/IdXMLFile.h>
 
+#include <exception>
+#include <memory>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace Math; //PosteriorErrorProbabilityModel
 using namespace std;
@@ -168,8 +175,6 @@ protected:
     vector<ProteinIdentification> protein_ids;
     vector<PeptideIdentification> peptide_ids;
     file.load(inputfile_name, protein_ids, peptide_ids);
-    PosteriorErrorProbabilityModel PEP_model;
-    PEP_model.setParameters(fit_algorithm);
     //-------------------------------------------------------------
     // calculations
     //-------------------------------------------------------------
@@ -206,26 +211,70 @@ protected:
 
     String out_plot = fit_algorithm.getValue("out_plot").toString().trim();
 
-    for (auto & score : all_scores)
+    vector<map<String, vector<vector<double> > >::iterator> entries;
+    vector<String> engines;
+    vector<Int> charges;
+    for (auto it = all_scores.begin(); it != all_scores.end(); ++it)
     {
       vector<String> engine_info;
-      score.first.split(',', engine_info);
-      String engine = engine_info[0];
-      Int charge = (engine_info.size() == 2) ? engine_info[1].toInt() : -1;
+      it->first.split(',', engine_info);
+      entries.push_back(it);
+      engines.push_back(engine_info[0]);
+      charges.push_back((engine_info.size() == 2) ? engine_info[1].toInt() : -1);
+    }
 
-      if (split_charge)
+    // the fits for different search engines (and charge states) are independent and are done in parallel,
+    // unless plots are requested (fits without 'split_charge' would write to the same plot file)
+    vector<unique_ptr<PosteriorErrorProbabilityModel> > PEP_models(entries.size());
+    vector<char> fit_successful(entries.size(), false);
+    Size errCount = 0;
+    std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if (out_plot.empty())
+#endif
+    for (SignedSize i = 0; i < (SignedSize)entries.size(); ++i)
+    {
+      // parallel exception catching and re-throwing business
+      if (errCount) continue; // no need to process further if error was raised
+
+      try
       {
-        // only adapt plot output if plot is requested (this badly violates the output rules and needs to change!)
-        // one way to fix this: plot charges into a single file (no renaming of output file needed) - but this requires major code restructuring
-        if (!out_plot.empty()) fit_algorithm.setValue("out_plot", out_plot + "_charge_" + String(charge));
-        PEP_model.setParameters(fit_algorithm);
+        Param model_param = fit_algorithm;
+        if (split_charge)
+        {
+          // only adapt plot output if plot is requested (this badly violates the output rules and needs to change!)
+          // one way to fix this: plot charges into a single file (no renaming of output file needed) - but this requires major code restructuring
+          if (!out_plot.empty()) model_param.setValue("out_plot", out_plot + "_charge_" + String(charges[i]));
+        }
+        PEP_models[i].reset(new PosteriorErrorProbabilityModel());
+        PEP_models[i]->setParameters(model_param);
+
+        // fit to score vector
+        //TODO choose outlier handling based on search engine? If not set by user?
+        //XTandem is prone to accumulation at min values/censoring
+        //OMSSA is prone to outliers
+        fit_successful[i] = PEP_models[i]->fit(entries[i]->second[0], outlier_handling);
       }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical (IDPosteriorErrorProbability_fit)
+#endif
+        {
+          if (!errCount) error = std::current_exception();
+          ++errCount;
+        }
+      }
+    }
+    if (error) std::rethrow_exception(error);
 
-      // fit to score vector
-      //TODO choose outlier handling based on search engine? If not set by user?
-      //XTandem is prone to accumulation at min values/censoring
-      //OMSSA is prone to outliers
-      bool return_value = PEP_model.fit(score.second[0], outlier_handling);
+    for (Size i = 0; i < entries.size(); ++i)
+    {
+      const String& engine = engines[i];
+      const Int charge = charges[i];
+      vector<vector<double> >& scores = entries[i]->second;
+      PosteriorErrorProbabilityModel& PEP_model = *PEP_models[i];
+      bool return_value = fit_successful[i];
 
       if (!return_value) 
       {
@@ -239,9 +288,9 @@ protected:
         if (!out_plot.empty() 
          && top_hits_only 
          && target_decoy_available 
-         && (!score.second[0].empty()))
+         && (!scores[0].empty()))
         {
-          PEP_model.plotTargetDecoyEstimation(score.second[1], score.second[2]); //target, decoy
+          PEP_model.plotTargetDecoyEstimation(scores[1], scores[2]); //target, decoy
         }
         
         bool unable_to_fit_data(true), data_might_not_be_well_fit(true);
@@ -435,6 +435,13 @@ protected:
   //id <tab> label <tab> scannr <tab> calcmass <tab> expmass <tab> feature1 <tab> ... <tab> featureN <tab> peptide <tab> proteinId1 <tab> .. <tab> proteinIdM
   void preparePin_(vector<PeptideIdentification>& peptide_ids, StringList& feature_set, std::string& enz, TextFile& txt, int min_charge, int max_charge)
   {
+    // resolve feature names once instead of for every PSM
+    vector<UInt> feature_indices;
+    for (const String& feat : feature_set)
+    {
+      feature_indices.push_back(MetaInfoInterface::metaRegistry().registerName(feat));
+    }
+
     for (vector<PeptideIdentification>::iterator it = peptide_ids.begin(); it != peptide_ids.end(); ++it)
     {
       String scan_identifier = getScanIdentifier_(it, peptide_ids.begin());
@@ -554,12 +561,12 @@ protected:
         hit.setMetaValue("Proteins", ListUtils::concatenate(proteins, '\t'));
         
         StringList feats;
-        for (vector<String>::const_iterator feat = feature_set.begin(); feat != feature_set.end(); ++feat)
+        for (UInt feat : feature_indices)
         {
         // Some Hits have no NumMatchedMainIons, and MeanError, etc. values. Have to ignore them!
-          if (hit.metaValueExists(*feat))
+          if (hit.metaValueExists(feat))
           {
-            feats.push_back(hit.getMetaValue(*feat).toString());
+            feats.push_back(hit.getMetaValue(feat).toString());
           }
         }
         if (feats.size() == feature_set.size())
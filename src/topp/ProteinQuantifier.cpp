@@ -850,8 +850,8 @@ protected:
         const bool report_unmapped(true);
         const bool report_unidentified_features(false);
         const bool report_subfeatures(false);
-        MzTab m = MzTab::exportConsensusMapToMzTab(consensus, in, !inference_in_cxml, report_unidentified_features, report_unmapped, report_subfeatures);
-        MzTabFile().store(mztab, m);
+        // rows are streamed to disc, no MzTab object is built
+        MzTabFile().store(mztab, consensus, !inference_in_cxml, report_unidentified_features, report_unmapped, report_subfeatures);
       }
     }
 
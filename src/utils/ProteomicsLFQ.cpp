@@ -1856,18 +1856,19 @@ protected:
       ConsensusXMLFile().store(getStringOption_("out_cxml"), consensus);
     }
 
-    // Fill MzTab with meta data and quants annotated in identification data structure
+    // Stream meta data and quants annotated in identification data structure to mzTab
+    // (rows are written as they are generated, no MzTab object is built)
     const bool report_unmapped(true);
     const bool report_unidentified_features(false);
+    const bool report_subfeatures(true);
 
-    MzTab m = MzTab::exportConsensusMapToMzTab(
-      consensus, 
-      String("null"),
+    MzTabFile().store(
+      out,
+      consensus,
       true,
-      report_unidentified_features, 
+      report_unidentified_features,
       report_unmapped,
-      "Export from ProteomicsLFQ workflow in OpenMS.");
-    MzTabFile().store(out, m);
+      report_subfeatures);
 
     if (!out_msstats.empty())
     {